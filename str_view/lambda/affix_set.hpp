@@ -0,0 +1,346 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Precompiled prefix / suffix sets answering "which key does this view start (end) with"
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_AFFIX_SET_H
+#define STR_VIEW_AFFIX_SET_H
+
+#include "hash.hpp"
+#include "str_view.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+namespace lambda
+{
+
+/// <summary>
+/// End of the view a basic_affix_set matches at.
+/// </summary>
+enum class affix
+{
+    prefix,
+    suffix
+};
+
+/// <summary>
+/// Set of keys matched against the start (prefix) or the end (suffix) of a view, e.g. for routing:
+///
+///     const lambda::prefix_set routes{"/api/v1/"_sv, "/api/"_sv, "/static/"_sv};
+///     switch (routes.match(path)) { ... }
+///
+/// Keys are bucketed by length. A query loads the first (last) 8 bytes of the view once, and for every key length
+/// that fits masks that word down and probes a single open addressing table keyed by (bytes, length); longer keys
+/// are confirmed with one equals(). Keys are copied, so the set does not depend on their lifetime. Duplicate keys
+/// throw std::invalid_argument; an empty key matches every view.
+/// </summary>
+template <typename CharT, affix Side, typename Traits = std::char_traits<CharT>> struct basic_affix_set
+{
+    static_assert(utility::_bitwise_traits_<CharT, Traits>::value,
+                  "basic_affix_set compares raw code units and needs std::char_traits");
+
+    using view_type = basic_str_view<CharT, Traits>;
+    using size_type = size_t;
+
+    static constexpr size_type npos = size_type(-1);
+
+    basic_affix_set(std::initializer_list<view_type> keys);
+
+    template <typename InputIt> basic_affix_set(InputIt first, InputIt last);
+
+    basic_affix_set(const basic_affix_set &) = delete;
+    basic_affix_set &operator=(const basic_affix_set &) = delete;
+    basic_affix_set(basic_affix_set &&) = default;
+    basic_affix_set &operator=(basic_affix_set &&) = default;
+
+    /// <summary>
+    /// Index of the longest key v starts (ends) with, or npos.
+    /// </summary>
+    /// <param name="v"></param>
+    /// <returns></returns>
+    size_type match(view_type v) const noexcept;
+
+    bool matches(view_type v) const noexcept;
+
+    /// <summary>
+    /// Calls f(index) for every key v starts (ends) with, longest first.
+    /// </summary>
+    template <typename F> void for_each_match(view_type v, F f) const;
+
+    size_type size() const noexcept;
+
+    /// <summary>
+    /// Returns key i.
+    /// </summary>
+    view_type operator[](size_type i) const noexcept;
+
+  private:
+    struct slot
+    {
+        uint64_t key;
+        uint32_t length;
+        uint32_t index;
+    };
+
+    static constexpr uint32_t empty_slot = uint32_t(-1);
+
+    void build();
+
+    /// <summary>
+    /// The 8 bytes at the matched end of v, zero padded when v is shorter.
+    /// </summary>
+    static uint64_t load(view_type v) noexcept;
+
+    /// <summary>
+    /// Cuts the loaded word down to the bytes a key of length units covers.
+    /// </summary>
+    static uint64_t key_of(uint64_t word, size_type length) noexcept;
+
+    size_type probe(uint64_t key, size_type length) const noexcept;
+
+    /// <summary>
+    /// Calls f(index) for every key v starts (ends) with, longest first, until it returns false.
+    /// </summary>
+    template <typename F> void visit(view_type v, F f) const;
+
+    std::vector<CharT> m_text;
+    std::vector<view_type> m_keys;
+    std::vector<size_type> m_lengths;
+    std::vector<slot> m_slots;
+    size_type m_mask;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits = std::char_traits<CharT>>
+using basic_prefix_set = basic_affix_set<CharT, affix::prefix, Traits>;
+template <typename CharT, typename Traits = std::char_traits<CharT>>
+using basic_suffix_set = basic_affix_set<CharT, affix::suffix, Traits>;
+
+using prefix_set = basic_prefix_set<char>;
+using wprefix_set = basic_prefix_set<wchar_t>;
+using u16prefix_set = basic_prefix_set<char16_t>;
+using u32prefix_set = basic_prefix_set<char32_t>;
+
+using suffix_set = basic_suffix_set<char>;
+using wsuffix_set = basic_suffix_set<wchar_t>;
+using u16suffix_set = basic_suffix_set<char16_t>;
+using u32suffix_set = basic_suffix_set<char32_t>;
+
+template <typename CharT, affix Side, typename Traits>
+constexpr typename basic_affix_set<CharT, Side, Traits>::size_type basic_affix_set<CharT, Side, Traits>::npos;
+
+template <typename CharT, affix Side, typename Traits>
+constexpr uint32_t basic_affix_set<CharT, Side, Traits>::empty_slot;
+
+template <typename CharT, affix Side, typename Traits>
+inline basic_affix_set<CharT, Side, Traits>::basic_affix_set(std::initializer_list<view_type> keys)
+    : basic_affix_set(keys.begin(), keys.end())
+{
+}
+
+template <typename CharT, affix Side, typename Traits>
+template <typename InputIt>
+inline basic_affix_set<CharT, Side, Traits>::basic_affix_set(InputIt first, InputIt last) : m_mask(0)
+{
+    std::vector<size_type> lengths;
+    for (; first != last; ++first)
+    {
+        const view_type key(*first);
+        m_text.insert(m_text.end(), key.begin(), key.end());
+        lengths.push_back(key.size());
+    }
+
+    size_type offset = 0;
+    for (size_type length : lengths)
+    {
+        m_keys.emplace_back(m_text.data() + offset, length);
+        offset += length;
+    }
+    build();
+}
+
+template <typename CharT, affix Side, typename Traits> inline void basic_affix_set<CharT, Side, Traits>::build()
+{
+    size_type capacity = 4;
+    while (capacity < 2 * m_keys.size())
+    {
+        capacity *= 2;
+    }
+    m_slots.assign(capacity, slot{0, 0, empty_slot});
+    m_mask = capacity - 1;
+
+    for (size_type i = 0; i < m_keys.size(); ++i)
+    {
+        const view_type key = m_keys[i];
+        const uint64_t word = key_of(load(key), key.size());
+        size_type at = probe(word, key.size());
+        while (m_slots[at].index != empty_slot)
+        {
+            if (m_keys[m_slots[at].index] == key)
+            {
+                throw std::invalid_argument("Duplicate key in lambda::basic_affix_set");
+            }
+            at = (at + 1) & m_mask;
+        }
+        m_slots[at] = slot{word, static_cast<uint32_t>(key.size()), static_cast<uint32_t>(i)};
+        m_lengths.push_back(key.size());
+    }
+
+    std::sort(m_lengths.begin(), m_lengths.end(), [](size_type a, size_type b) { return a > b; });
+    m_lengths.erase(std::unique(m_lengths.begin(), m_lengths.end()), m_lengths.end());
+}
+
+template <typename CharT, affix Side, typename Traits>
+inline uint64_t basic_affix_set<CharT, Side, Traits>::load(view_type v) noexcept
+{
+    const size_type bytes = v.size() * sizeof(CharT);
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(v.data());
+    uint64_t word = 0;
+    if (bytes >= 8)
+    {
+        std::memcpy(&word, Side == affix::prefix ? p : p + bytes - 8, 8);
+    }
+    else if (bytes != 0)
+    {
+        // Keep the matched end of the view at the matched end of the word.
+        unsigned char buffer[8] = {};
+        std::memcpy(Side == affix::prefix ? buffer : buffer + 8 - bytes, p, bytes);
+        std::memcpy(&word, buffer, 8);
+    }
+    return word;
+}
+
+template <typename CharT, affix Side, typename Traits>
+inline uint64_t basic_affix_set<CharT, Side, Traits>::key_of(uint64_t word, size_type length) noexcept
+{
+    const size_type bytes = length * sizeof(CharT);
+    if (bytes >= 8)
+    {
+        return word;
+    }
+    if (bytes == 0)
+    {
+        return 0;
+    }
+
+    // Byte k of the buffer is bits [8k, 8k + 8) on little endian targets and bits [56 - 8k, 64 - 8k) on big endian.
+    const unsigned drop = static_cast<unsigned>(8 * (8 - bytes));
+    const bool low = (Side == affix::prefix) == (LAMBDA_LITTLE_ENDIAN != 0);
+    return low ? word & (~uint64_t(0) >> drop) : word >> drop;
+}
+
+template <typename CharT, affix Side, typename Traits>
+inline typename basic_affix_set<CharT, Side, Traits>::size_type basic_affix_set<CharT, Side, Traits>::probe(
+    uint64_t key, size_type length) const noexcept
+{
+    return static_cast<size_type>(hashing::detail::_mix_(key, length)) & m_mask;
+}
+
+template <typename CharT, affix Side, typename Traits>
+template <typename F>
+inline void basic_affix_set<CharT, Side, Traits>::visit(view_type v, F f) const
+{
+    const uint64_t word = load(v);
+    for (size_type length : m_lengths)
+    {
+        if (length > v.size())
+        {
+            continue;
+        }
+
+        const uint64_t key = key_of(word, length);
+        const view_type end = Side == affix::prefix ? v.first(length) : v.last(length);
+        for (size_type at = probe(key, length); m_slots[at].index != empty_slot; at = (at + 1) & m_mask)
+        {
+            const slot &s = m_slots[at];
+            if (s.key == key && s.length == length &&
+                (length * sizeof(CharT) <= 8 || m_keys[s.index].equals(end)))
+            {
+                if (!f(static_cast<size_type>(s.index)))
+                {
+                    return;
+                }
+                // Keys are unique, so no other slot holds this length.
+                break;
+            }
+        }
+    }
+}
+
+template <typename CharT, affix Side, typename Traits>
+inline typename basic_affix_set<CharT, Side, Traits>::size_type basic_affix_set<CharT, Side, Traits>::match(
+    view_type v) const noexcept
+{
+    size_type found = npos;
+    visit(v, [&found](size_type i) {
+        found = i;
+        return false;
+    });
+    return found;
+}
+
+template <typename CharT, affix Side, typename Traits>
+inline bool basic_affix_set<CharT, Side, Traits>::matches(view_type v) const noexcept
+{
+    return match(v) != npos;
+}
+
+template <typename CharT, affix Side, typename Traits>
+template <typename F>
+inline void basic_affix_set<CharT, Side, Traits>::for_each_match(view_type v, F f) const
+{
+    visit(v, [&f](size_type i) {
+        f(i);
+        return true;
+    });
+}
+
+template <typename CharT, affix Side, typename Traits>
+inline typename basic_affix_set<CharT, Side, Traits>::size_type basic_affix_set<CharT, Side, Traits>::size()
+    const noexcept
+{
+    return m_keys.size();
+}
+
+template <typename CharT, affix Side, typename Traits>
+inline typename basic_affix_set<CharT, Side, Traits>::view_type basic_affix_set<CharT, Side, Traits>::operator[](
+    size_type i) const noexcept
+{
+    return m_keys[i];
+}
+
+} // namespace lambda
+
+#endif
@@ -0,0 +1,218 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Monotonic bump arena backing materialized str_view copies
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_ARENA_H
+#define STR_VIEW_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace lambda
+{
+
+/// <summary>
+/// Bump allocator over a list of large blocks. Allocation is a pointer increment; individual allocations are never
+/// freed. reset() rewinds to the first block in O(1) and keeps the blocks for reuse, so everything allocated for one
+/// request can be dropped at once. Not thread safe.
+/// </summary>
+struct monotonic_arena
+{
+    using size_type = size_t;
+
+    /// <summary>
+    /// Constructs an empty arena. Blocks are allocated lazily, block_size bytes at a time (larger requests get a block
+    /// of their own size).
+    /// </summary>
+    /// <param name="block_size"></param>
+    explicit monotonic_arena(size_type block_size = 64 * 1024) noexcept;
+
+    monotonic_arena(const monotonic_arena &) = delete;
+    monotonic_arena &operator=(const monotonic_arena &) = delete;
+
+    /// <summary>
+    /// Returns bytes of storage aligned to align (a power of two). Throws std::bad_alloc when out of memory.
+    /// </summary>
+    /// <param name="bytes"></param>
+    /// <param name="align"></param>
+    /// <returns></returns>
+    void *allocate(size_type bytes, size_type align = alignof(std::max_align_t));
+
+    /// <summary>
+    /// Returns uninitialized storage for count objects of type T.
+    /// </summary>
+    template <typename T> T *allocate_array(size_type count);
+
+    /// <summary>
+    /// Makes all the memory handed out so far reusable. The blocks are kept.
+    /// </summary>
+    void reset() noexcept;
+
+    /// <summary>
+    /// Frees every block.
+    /// </summary>
+    void release() noexcept;
+
+    /// <summary>
+    /// Bytes handed out since the last reset(), including alignment padding.
+    /// </summary>
+    size_type used() const noexcept;
+
+    /// <summary>
+    /// Total size of the blocks owned by the arena.
+    /// </summary>
+    size_type capacity() const noexcept;
+
+  private:
+    struct block
+    {
+        std::unique_ptr<unsigned char[]> data;
+        size_type size;
+    };
+
+    void *allocate_slow(size_type bytes, size_type align);
+
+    std::vector<block> m_blocks;
+    size_type m_current;
+    uintptr_t m_cursor;
+    uintptr_t m_end;
+    size_type m_used_before;
+    size_type m_block_size;
+};
+
+// -----------------------------------------------------------------------------------------------------------------------
+
+inline monotonic_arena::monotonic_arena(size_type block_size) noexcept
+    : m_blocks(), m_current(0), m_cursor(0), m_end(0), m_used_before(0), m_block_size(block_size ? block_size : 1)
+{
+}
+
+inline void *monotonic_arena::allocate(size_type bytes, size_type align)
+{
+    // Rounding up can carry p past m_end, where m_end - p would wrap.
+    const uintptr_t p = (m_cursor + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+    if (m_cursor != 0 && p >= m_cursor && p <= m_end && bytes <= m_end - p)
+    {
+        m_cursor = p + bytes;
+        return reinterpret_cast<void *>(p);
+    }
+    return allocate_slow(bytes, align);
+}
+
+inline void *monotonic_arena::allocate_slow(size_type bytes, size_type align)
+{
+    if (bytes > size_type(-1) - align)
+    {
+        throw std::bad_alloc();
+    }
+
+    // Account for the unused tail of the block being left.
+    if (!m_blocks.empty())
+    {
+        m_used_before += m_blocks[m_current].size;
+    }
+
+    const size_type needed = bytes + align;
+    size_type next = m_blocks.empty() ? 0 : m_current + 1;
+    while (next < m_blocks.size() && m_blocks[next].size < needed)
+    {
+        m_used_before += m_blocks[next].size;
+        ++next;
+    }
+    if (next == m_blocks.size())
+    {
+        const size_type size = needed > m_block_size ? needed : m_block_size;
+        m_blocks.push_back(block{std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+    }
+
+    m_current = next;
+    m_cursor = reinterpret_cast<uintptr_t>(m_blocks[next].data.get());
+    m_end = m_cursor + m_blocks[next].size;
+
+    const uintptr_t p = (m_cursor + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+    m_cursor = p + bytes;
+    return reinterpret_cast<void *>(p);
+}
+
+template <typename T> inline T *monotonic_arena::allocate_array(size_type count)
+{
+    if (count > size_type(-1) / sizeof(T))
+    {
+        throw std::bad_alloc();
+    }
+    return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+}
+
+inline void monotonic_arena::reset() noexcept
+{
+    m_current = 0;
+    m_used_before = 0;
+    if (m_blocks.empty())
+    {
+        m_cursor = m_end = 0;
+        return;
+    }
+    m_cursor = reinterpret_cast<uintptr_t>(m_blocks.front().data.get());
+    m_end = m_cursor + m_blocks.front().size;
+}
+
+inline void monotonic_arena::release() noexcept
+{
+    m_blocks.clear();
+    m_current = 0;
+    m_cursor = m_end = 0;
+    m_used_before = 0;
+}
+
+inline monotonic_arena::size_type monotonic_arena::used() const noexcept
+{
+    if (m_blocks.empty())
+    {
+        return 0;
+    }
+    const uintptr_t base = reinterpret_cast<uintptr_t>(m_blocks[m_current].data.get());
+    return m_used_before + static_cast<size_type>(m_cursor - base);
+}
+
+inline monotonic_arena::size_type monotonic_arena::capacity() const noexcept
+{
+    size_type total = 0;
+    for (const block &b : m_blocks)
+    {
+        total += b.size;
+    }
+    return total;
+}
+
+} // namespace lambda
+
+#endif
@@ -0,0 +1,392 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Columnar batches of str_views and the hash / compare / search kernels that run over a whole batch
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_BATCH_H
+#define STR_VIEW_BATCH_H
+
+#include "config.hpp"
+#include "hash.hpp"
+#include "searcher.hpp"
+#include "simd.hpp"
+#include "str_view.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace lambda
+{
+
+/// <summary>
+/// Views stored as two columns, the data pointers and the lengths, as a columnar engine keeps a string column:
+///
+///     lambda::view_batch rows(cells.begin(), cells.end());
+///     std::vector<uint64_t> hits(lambda::batch_mask_words(rows.size()));
+///     lambda::equals_batch(rows, "GET"_sv, hits.data());
+///
+/// The kernels below scan the length column first, which is a dense loop the compiler vectorizes, and only then touch
+/// the characters of the rows still in play, prefetching a few rows ahead. The characters are not copied and must
+/// outlive the batch.
+/// </summary>
+template <typename CharT, typename Traits = std::char_traits<CharT>> struct basic_view_batch
+{
+    using view_type = basic_str_view<CharT, Traits>;
+    using traits_type = Traits;
+    using size_type = size_t;
+
+    basic_view_batch() = default;
+
+    /// <summary>
+    /// Builds from a range of anything that converts to view_type.
+    /// </summary>
+    template <typename InputIt> basic_view_batch(InputIt first, InputIt last);
+    basic_view_batch(std::initializer_list<view_type> views);
+
+    void reserve(size_type n);
+    void push_back(view_type v);
+    void clear() noexcept;
+
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+    view_type operator[](size_type i) const noexcept;
+
+    /// <summary>
+    /// The data and length columns, size() entries each.
+    /// </summary>
+    const CharT *const *data() const noexcept;
+    const size_type *sizes() const noexcept;
+
+  private:
+    std::vector<const CharT *> m_data;
+    std::vector<size_type> m_sizes;
+};
+
+/// <summary>
+/// Number of uint64_t words in the result mask of the _batch predicates over n rows: bit i % 64 of word i / 64 is
+/// row i, and the bits past the last row are zero.
+/// </summary>
+constexpr size_t batch_mask_words(size_t n) noexcept
+{
+    return (n + 63) / 64;
+}
+
+namespace detail
+{
+
+/// Rows ahead of the current one whose characters are prefetched.
+static constexpr size_t _batch_prefetch_distance_ = 8;
+
+/// <summary>
+/// Shared body of equals_batch and starts_with_batch. Per block of 64 rows the length column is reduced to the mask of
+/// rows that can match, then the characters of those rows are compared against v[0, m), with the candidates gathered
+/// first so their data can be prefetched ahead of the compare.
+/// </summary>
+template <bool Exact, typename CharT, typename Traits>
+inline size_t _match_batch_(const basic_view_batch<CharT, Traits> &batch, basic_str_view<CharT, Traits> v,
+                            uint64_t *mask)
+{
+    const CharT *const *data = batch.data();
+    const size_t *sizes = batch.sizes();
+    const size_t n = batch.size();
+    const size_t m = v.size();
+    const bool bitwise = utility::_bitwise_traits_<CharT, Traits>::value;
+
+    size_t matches = 0;
+    uint32_t candidates[64];
+    for (size_t base = 0; base < n; base += 64)
+    {
+        const size_t rows = n - base < 64 ? n - base : 64;
+
+        uint64_t bits = 0;
+        for (size_t j = 0; j < rows; ++j)
+        {
+            const bool fits = Exact ? sizes[base + j] == m : sizes[base + j] >= m;
+            bits |= static_cast<uint64_t>(fits) << j;
+        }
+
+        if (bits != 0 && m != 0)
+        {
+            size_t count = 0;
+            for (uint64_t rest = bits; rest != 0; rest &= rest - 1)
+            {
+                candidates[count++] = simd::detail::_ctz_(rest);
+            }
+            for (size_t k = 0; k < count; ++k)
+            {
+                if (k + _batch_prefetch_distance_ < count)
+                {
+                    LAMBDA_PREFETCH(data[base + candidates[k + _batch_prefetch_distance_]]);
+                }
+                const CharT *s = data[base + candidates[k]];
+                const bool same = bitwise ? simd::equal_bytes(s, v.data(), m * sizeof(CharT))
+                                          : Traits::compare(s, v.data(), m) == 0;
+                if (!same)
+                {
+                    bits &= ~(uint64_t(1) << candidates[k]);
+                }
+            }
+        }
+
+        mask[base / 64] = bits;
+        for (uint64_t rest = bits; rest != 0; rest &= rest - 1)
+        {
+            ++matches;
+        }
+    }
+    return matches;
+}
+
+/// <summary>
+/// Body of find_batch, shared by both overloads: rows shorter than the needle are skipped, the others searched in order
+/// with the data of later rows prefetched.
+/// </summary>
+template <typename CharT, typename Traits>
+inline void _find_batch_(const basic_view_batch<CharT, Traits> &batch, const basic_searcher<CharT> &s,
+                         size_t *out) noexcept
+{
+    const CharT *const *data = batch.data();
+    const size_t *sizes = batch.sizes();
+    const size_t n = batch.size();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (sizes[i] < s.size())
+        {
+            out[i] = basic_searcher<CharT>::npos;
+            continue;
+        }
+        if (i + _batch_prefetch_distance_ < n)
+        {
+            LAMBDA_PREFETCH(data[i + _batch_prefetch_distance_]);
+        }
+        out[i] = s.find(data[i], sizes[i]);
+    }
+}
+
+} // namespace detail
+
+/// <summary>
+/// Hashes every row: out[i] == hash_value(batch[i], seed), including the folded hash of case insensitive views.
+/// The characters of row i + 8 are prefetched while row i is hashed; the hash itself (64 x 64 -> 128 bit multiplies)
+/// runs one row at a time.
+/// </summary>
+/// <param name="batch"></param>
+/// <param name="out">Room for batch.size() hashes.</param>
+/// <param name="seed"></param>
+template <typename CharT, typename Traits>
+inline void hash_batch(const basic_view_batch<CharT, Traits> &batch, uint64_t *out,
+                       uint64_t seed = hashing::default_seed) noexcept;
+
+/// <summary>
+/// Sets bit i of mask when batch[i] == v. Rows of another length are rejected from the length column alone.
+/// </summary>
+/// <param name="batch"></param>
+/// <param name="v"></param>
+/// <param name="mask">Room for batch_mask_words(batch.size()) words.</param>
+/// <returns>The number of matching rows.</returns>
+template <typename CharT, typename Traits>
+inline size_t equals_batch(const basic_view_batch<CharT, Traits> &batch, basic_str_view<CharT, Traits> v,
+                           uint64_t *mask) noexcept;
+
+/// <summary>
+/// Sets bit i of mask when batch[i].starts_with(prefix). Rows shorter than the prefix are rejected from the length
+/// column alone.
+/// </summary>
+/// <param name="batch"></param>
+/// <param name="prefix"></param>
+/// <param name="mask">Room for batch_mask_words(batch.size()) words.</param>
+/// <returns>The number of matching rows.</returns>
+template <typename CharT, typename Traits>
+inline size_t starts_with_batch(const basic_view_batch<CharT, Traits> &batch, basic_str_view<CharT, Traits> prefix,
+                                uint64_t *mask) noexcept;
+
+/// <summary>
+/// Stores batch[i].find(needle), or npos, in out[i]. The needle is preprocessed once for the whole batch; rows
+/// shorter than it are answered from the length column alone.
+/// </summary>
+/// <param name="batch"></param>
+/// <param name="needle"></param>
+/// <param name="out">Room for batch.size() positions.</param>
+template <typename CharT, typename Traits>
+inline void find_batch(const basic_view_batch<CharT, Traits> &batch, basic_str_view<CharT, Traits> needle,
+                       size_t *out) noexcept;
+
+/// <summary>
+/// Stores batch[i].find(s), or npos, in out[i]: the same search with a searcher built by the caller, e.g. at compile
+/// time. The searcher matches raw units, so Traits must be std::char_traits.
+/// </summary>
+/// <param name="batch"></param>
+/// <param name="s"></param>
+/// <param name="out">Room for batch.size() positions.</param>
+template <typename CharT, typename Traits>
+inline void find_batch(const basic_view_batch<CharT, Traits> &batch, const basic_searcher<CharT> &s,
+                       size_t *out) noexcept;
+
+using view_batch = basic_view_batch<char>;
+using wview_batch = basic_view_batch<wchar_t>;
+using u16view_batch = basic_view_batch<char16_t>;
+using u32view_batch = basic_view_batch<char32_t>;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// basic_view_batch
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits>
+template <typename InputIt>
+inline basic_view_batch<CharT, Traits>::basic_view_batch(InputIt first, InputIt last)
+{
+    for (; first != last; ++first)
+    {
+        push_back(view_type(*first));
+    }
+}
+
+template <typename CharT, typename Traits>
+inline basic_view_batch<CharT, Traits>::basic_view_batch(std::initializer_list<view_type> views)
+    : basic_view_batch(views.begin(), views.end())
+{
+}
+
+template <typename CharT, typename Traits> inline void basic_view_batch<CharT, Traits>::reserve(size_type n)
+{
+    m_data.reserve(n);
+    m_sizes.reserve(n);
+}
+
+template <typename CharT, typename Traits> inline void basic_view_batch<CharT, Traits>::push_back(view_type v)
+{
+    m_data.push_back(v.data());
+    m_sizes.push_back(v.size());
+}
+
+template <typename CharT, typename Traits> inline void basic_view_batch<CharT, Traits>::clear() noexcept
+{
+    m_data.clear();
+    m_sizes.clear();
+}
+
+template <typename CharT, typename Traits>
+inline typename basic_view_batch<CharT, Traits>::size_type basic_view_batch<CharT, Traits>::size() const noexcept
+{
+    return m_sizes.size();
+}
+
+template <typename CharT, typename Traits> inline bool basic_view_batch<CharT, Traits>::empty() const noexcept
+{
+    return m_sizes.empty();
+}
+
+template <typename CharT, typename Traits>
+inline typename basic_view_batch<CharT, Traits>::view_type basic_view_batch<CharT, Traits>::operator[](
+    size_type i) const noexcept
+{
+    LAMBDA_STR_VIEW_ASSERT(i < size());
+    return view_type(m_data[i], m_sizes[i]);
+}
+
+template <typename CharT, typename Traits>
+inline const CharT *const *basic_view_batch<CharT, Traits>::data() const noexcept
+{
+    return m_data.data();
+}
+
+template <typename CharT, typename Traits>
+inline const typename basic_view_batch<CharT, Traits>::size_type *basic_view_batch<CharT, Traits>::sizes()
+    const noexcept
+{
+    return m_sizes.data();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Kernels
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits>
+inline void hash_batch(const basic_view_batch<CharT, Traits> &batch, uint64_t *out, uint64_t seed) noexcept
+{
+    const CharT *const *data = batch.data();
+    const size_t *sizes = batch.sizes();
+    const size_t n = batch.size();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i + detail::_batch_prefetch_distance_ < n)
+        {
+            LAMBDA_PREFETCH(data[i + detail::_batch_prefetch_distance_]);
+        }
+        out[i] = hash_value(basic_str_view<CharT, Traits>(data[i], sizes[i]), seed);
+    }
+}
+
+template <typename CharT, typename Traits>
+inline size_t equals_batch(const basic_view_batch<CharT, Traits> &batch, basic_str_view<CharT, Traits> v,
+                           uint64_t *mask) noexcept
+{
+    return detail::_match_batch_<true>(batch, v, mask);
+}
+
+template <typename CharT, typename Traits>
+inline size_t starts_with_batch(const basic_view_batch<CharT, Traits> &batch, basic_str_view<CharT, Traits> prefix,
+                                uint64_t *mask) noexcept
+{
+    return detail::_match_batch_<false>(batch, prefix, mask);
+}
+
+template <typename CharT, typename Traits>
+inline void find_batch(const basic_view_batch<CharT, Traits> &batch, basic_str_view<CharT, Traits> needle,
+                       size_t *out) noexcept
+{
+    if (utility::_bitwise_traits_<CharT, Traits>::value)
+    {
+        detail::_find_batch_(batch, basic_searcher<CharT>(needle.data(), needle.size()), out);
+        return;
+    }
+
+    const CharT *const *data = batch.data();
+    const size_t *sizes = batch.sizes();
+    for (size_t i = 0, n = batch.size(); i < n; ++i)
+    {
+        out[i] = sizes[i] < needle.size() ? needle.npos : basic_str_view<CharT, Traits>(data[i], sizes[i]).find(needle);
+    }
+}
+
+template <typename CharT, typename Traits>
+inline void find_batch(const basic_view_batch<CharT, Traits> &batch, const basic_searcher<CharT> &s,
+                       size_t *out) noexcept
+{
+    static_assert(utility::_bitwise_traits_<CharT, Traits>::value,
+                  "basic_searcher compares raw code units and needs std::char_traits");
+    detail::_find_batch_(batch, s, out);
+}
+
+} // namespace lambda
+
+#endif
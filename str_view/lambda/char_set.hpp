@@ -0,0 +1,253 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Precomputed character set matcher for the find_*_of families
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_CHAR_SET_H
+#define STR_VIEW_CHAR_SET_H
+
+#include "config.hpp"
+#include "simd.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace lambda
+{
+
+template <typename CharT, typename Traits> struct basic_str_view;
+
+namespace utility
+{
+template <typename CharT, typename Traits> struct _bitwise_traits_;
+} // namespace utility
+
+/// <summary>
+/// Set of code units built once (at compile time for literals) and reused for membership tests.
+///
+/// Units below 256 live in a 256-bit table, which is also stored as two 16 byte nibble tables for the vectorized
+/// classifier used by str_view. Wider units (wstr_view, u16str_view, u32str_view) fall back to a scan of the source
+/// characters, so the source must outlive the set in that case. Units are matched exactly, so the views it is built
+/// from or applied to must use std::char_traits.
+/// </summary>
+template <typename CharT> struct basic_char_set
+{
+    using char_type = CharT;
+    using size_type = size_t;
+
+    /// <summary>
+    /// Constructs an empty set.
+    /// </summary>
+    constexpr basic_char_set() noexcept;
+
+    /// <summary>
+    /// Constructs a set of the characters in [s, s + count).
+    /// </summary>
+    /// <param name="s"></param>
+    /// <param name="count"></param>
+    constexpr basic_char_set(const CharT *s, size_type count) noexcept;
+
+    /// <summary>
+    /// Constructs a set of the characters in the view, which must use std::char_traits.
+    /// </summary>
+    /// <param name="v"></param>
+    template <typename Traits> constexpr explicit basic_char_set(basic_str_view<CharT, Traits> v) noexcept;
+
+    /// <summary>
+    /// Checks whether c is in the set.
+    /// </summary>
+    /// <param name="c"></param>
+    /// <returns></returns>
+    constexpr bool contains(CharT c) const noexcept;
+
+    /// <summary>
+    /// Runtime scans used by basic_str_view. Return the first / last index of [s, s + n) whose membership equals
+    /// Member, or npos.
+    /// </summary>
+    template <bool Member> size_type find(const CharT *s, size_type n) const noexcept;
+    template <bool Member> size_type rfind(const CharT *s, size_type n) const noexcept;
+
+  private:
+    using unit_type = typename std::make_unsigned<CharT>::type;
+
+    constexpr void insert(CharT c) noexcept;
+
+    template <bool Member> size_type find(const CharT *s, size_type n, std::true_type /*byte*/) const noexcept;
+    template <bool Member> size_type find(const CharT *s, size_type n, std::false_type /*byte*/) const noexcept;
+    template <bool Member> size_type rfind(const CharT *s, size_type n, std::true_type /*byte*/) const noexcept;
+    template <bool Member> size_type rfind(const CharT *s, size_type n, std::false_type /*byte*/) const noexcept;
+
+    uint64_t m_bits[4];
+    uint8_t m_nibble_lo[16];
+    uint8_t m_nibble_hi[16];
+    const CharT *m_wide;
+    size_type m_wide_count;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+using char_set = basic_char_set<char>;
+using wchar_set = basic_char_set<wchar_t>;
+using u16char_set = basic_char_set<char16_t>;
+using u32char_set = basic_char_set<char32_t>;
+
+template <typename CharT>
+inline constexpr basic_char_set<CharT>::basic_char_set() noexcept
+    : m_bits{}, m_nibble_lo{}, m_nibble_hi{}, m_wide(nullptr), m_wide_count(0)
+{
+}
+
+template <typename CharT>
+inline constexpr basic_char_set<CharT>::basic_char_set(const CharT *s, size_type count) noexcept
+    : m_bits{}, m_nibble_lo{}, m_nibble_hi{}, m_wide(nullptr), m_wide_count(0)
+{
+    for (size_type i = 0; i < count; ++i)
+    {
+        insert(s[i]);
+        if (static_cast<unit_type>(s[i]) >= 256u)
+        {
+            m_wide = s;
+            m_wide_count = count;
+        }
+    }
+}
+
+template <typename CharT>
+template <typename Traits>
+inline constexpr basic_char_set<CharT>::basic_char_set(basic_str_view<CharT, Traits> v) noexcept
+    : basic_char_set(v.data(), v.size())
+{
+    static_assert(utility::_bitwise_traits_<CharT, Traits>::value,
+                  "basic_char_set compares raw code units and needs std::char_traits");
+}
+
+template <typename CharT> inline constexpr void basic_char_set<CharT>::insert(CharT c) noexcept
+{
+    const unit_type u = static_cast<unit_type>(c);
+    if (u >= 256u)
+    {
+        return;
+    }
+
+    m_bits[u >> 6] |= uint64_t(1) << (u & 63u);
+    if ((u >> 4) < 8u)
+    {
+        m_nibble_lo[u & 15u] = static_cast<uint8_t>(m_nibble_lo[u & 15u] | (1u << (u >> 4)));
+    }
+    else
+    {
+        m_nibble_hi[u & 15u] = static_cast<uint8_t>(m_nibble_hi[u & 15u] | (1u << ((u >> 4) - 8u)));
+    }
+}
+
+template <typename CharT> inline constexpr bool basic_char_set<CharT>::contains(CharT c) const noexcept
+{
+    const unit_type u = static_cast<unit_type>(c);
+    if (u < 256u)
+    {
+        return ((m_bits[u >> 6] >> (u & 63u)) & 1u) != 0;
+    }
+
+    for (size_type i = 0; i < m_wide_count; ++i)
+    {
+        if (m_wide[i] == c)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT>
+template <bool Member>
+inline typename basic_char_set<CharT>::size_type basic_char_set<CharT>::find(const CharT *s,
+                                                                             size_type n) const noexcept
+{
+    return find<Member>(s, n, std::integral_constant<bool, sizeof(CharT) == 1>());
+}
+
+template <typename CharT>
+template <bool Member>
+inline typename basic_char_set<CharT>::size_type basic_char_set<CharT>::rfind(const CharT *s,
+                                                                              size_type n) const noexcept
+{
+    return rfind<Member>(s, n, std::integral_constant<bool, sizeof(CharT) == 1>());
+}
+
+template <typename CharT>
+template <bool Member>
+inline typename basic_char_set<CharT>::size_type basic_char_set<CharT>::find(const CharT *s, size_type n,
+                                                                             std::true_type) const noexcept
+{
+    return simd::find_in_set<Member>(reinterpret_cast<const uint8_t *>(s), n, m_nibble_lo, m_nibble_hi);
+}
+
+template <typename CharT>
+template <bool Member>
+inline typename basic_char_set<CharT>::size_type basic_char_set<CharT>::find(const CharT *s, size_type n,
+                                                                             std::false_type) const noexcept
+{
+    for (size_type i = 0; i < n; ++i)
+    {
+        if (contains(s[i]) == Member)
+        {
+            return i;
+        }
+    }
+    return simd::npos;
+}
+
+template <typename CharT>
+template <bool Member>
+inline typename basic_char_set<CharT>::size_type basic_char_set<CharT>::rfind(const CharT *s, size_type n,
+                                                                              std::true_type) const noexcept
+{
+    return simd::rfind_in_set<Member>(reinterpret_cast<const uint8_t *>(s), n, m_nibble_lo, m_nibble_hi);
+}
+
+template <typename CharT>
+template <bool Member>
+inline typename basic_char_set<CharT>::size_type basic_char_set<CharT>::rfind(const CharT *s, size_type n,
+                                                                              std::false_type) const noexcept
+{
+    for (size_type i = n; i-- > 0;)
+    {
+        if (contains(s[i]) == Member)
+        {
+            return i;
+        }
+    }
+    return simd::npos;
+}
+
+} // namespace lambda
+
+#endif
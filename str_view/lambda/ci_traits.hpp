@@ -0,0 +1,736 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Case-insensitive char traits and the ci_str_view aliases
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ *
+ * ci_char_traits folds both sides to lower case before comparing. basic_str_view keeps its zero-copy semantics, so
+ * ci_str_view(header_name) == "content-type" needs no temporary lower-cased string.
+ *
+ * For 1 byte units the folding is ASCII only (a UTF-8 code unit is not a code point), and compare / find fold 16 or 32
+ * bytes per instruction at runtime. Wider units can use case_fold::simple, a subset of the Unicode simple case
+ * folding covering Latin-1, Latin Extended-A, Greek, Cyrillic and the fullwidth Latin letters.
+ */
+
+#ifndef STR_VIEW_CI_TRAITS_H
+#define STR_VIEW_CI_TRAITS_H
+
+#include "hash.hpp"
+#include "simd.hpp"
+#include "str_view.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace lambda
+{
+
+/// <summary>
+/// Which characters ci_char_traits treats as case variants of each other.
+/// </summary>
+enum class case_fold
+{
+    /// A-Z and a-z only.
+    ascii,
+    /// Unicode simple case folding for the scripts listed in the header; ASCII only for 1 byte units.
+    simple
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Kernels
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace simd
+{
+
+namespace detail
+{
+
+inline unsigned char _fold_byte_(unsigned char c) noexcept
+{
+    return static_cast<unsigned char>(static_cast<unsigned>(c) - 'A' < 26u ? c + 32 : c);
+}
+
+/// <summary>
+/// Lower-cases the ASCII letters of 8 packed bytes. Bytes at or above 0x80 are left alone.
+/// </summary>
+inline uint64_t _fold64_(uint64_t x) noexcept
+{
+    const uint64_t heptets = x & 0x7f7f7f7f7f7f7f7full;
+    const uint64_t ge_a = heptets + 0x3f3f3f3f3f3f3f3full;   // high bit set from 'A'
+    const uint64_t above_z = heptets + 0x2525252525252525ull; // high bit set past 'Z'
+    return x | (((ge_a ^ above_z) & ~x & 0x8080808080808080ull) >> 2);
+}
+
+} // namespace detail
+
+namespace scalar
+{
+
+/// <summary>
+/// Index of the first byte where a and b differ after ASCII folding, or n.
+/// </summary>
+inline size_t ci_mismatch(const unsigned char *a, const unsigned char *b, size_t n) noexcept
+{
+    size_t i = 0;
+#if LAMBDA_LITTLE_ENDIAN
+    for (; i + 8 <= n; i += 8)
+    {
+        const uint64_t diff = simd::detail::_fold64_(simd::detail::_load64_(a + i)) ^
+                              simd::detail::_fold64_(simd::detail::_load64_(b + i));
+        if (diff != 0)
+        {
+            return i + simd::detail::_ctz_(diff) / 8;
+        }
+    }
+#endif
+    while (i < n && simd::detail::_fold_byte_(a[i]) == simd::detail::_fold_byte_(b[i]))
+    {
+        ++i;
+    }
+    return i;
+}
+
+/// <summary>
+/// Index of the first byte equal to c after ASCII folding, or npos.
+/// </summary>
+inline size_t ci_find_char(const unsigned char *s, size_t n, unsigned char c) noexcept
+{
+    const unsigned char folded = simd::detail::_fold_byte_(c);
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (simd::detail::_fold_byte_(s[i]) == folded)
+        {
+            return i;
+        }
+    }
+    return npos;
+}
+
+} // namespace scalar
+
+#if LAMBDA_SIMD_X86
+
+namespace sse2
+{
+
+namespace detail
+{
+
+/// <summary>
+/// Adding 0x3f moves 'A'..'Z' to the bottom of the signed range, so one signed compare selects the upper case lanes.
+/// </summary>
+inline __m128i _fold_(__m128i v) noexcept
+{
+    const __m128i upper = _mm_cmplt_epi8(_mm_add_epi8(v, _mm_set1_epi8(0x3f)), _mm_set1_epi8(-128 + 26));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+inline uint32_t _ci_diff_(const unsigned char *a, const unsigned char *b) noexcept
+{
+    const __m128i eq = _mm_cmpeq_epi8(_fold_(_load_(a)), _fold_(_load_(b)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(eq)) ^ 0xffffu;
+}
+
+} // namespace detail
+
+/// <summary>
+/// The last block is loaded at n - 16, overlapping bytes already known to match.
+/// </summary>
+inline size_t ci_mismatch(const unsigned char *a, const unsigned char *b, size_t n) noexcept
+{
+    if (n < 16)
+    {
+        return scalar::ci_mismatch(a, b, n);
+    }
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const uint32_t diff = detail::_ci_diff_(a + i, b + i);
+        if (diff != 0)
+        {
+            return i + simd::detail::_ctz_(diff);
+        }
+    }
+    if (i < n)
+    {
+        const uint32_t diff = detail::_ci_diff_(a + n - 16, b + n - 16);
+        if (diff != 0)
+        {
+            return n - 16 + simd::detail::_ctz_(diff);
+        }
+    }
+    return n;
+}
+
+/// <summary>
+/// For a letter, OR-ing 0x20 into the haystack maps both cases onto the lower case needle; other needles need an exact
+/// match, so the OR mask is zero.
+/// </summary>
+inline size_t ci_find_char(const unsigned char *s, size_t n, unsigned char c) noexcept
+{
+    const unsigned char folded = simd::detail::_fold_byte_(c);
+    const bool letter = static_cast<unsigned>(folded) - 'a' < 26u;
+    const __m128i bit = _mm_set1_epi8(static_cast<char>(letter ? 0x20 : 0));
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(folded));
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i eq = _mm_cmpeq_epi8(_mm_or_si128(detail::_load_(s + i), bit), needle);
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(eq));
+        if (mask != 0)
+        {
+            return i + simd::detail::_ctz_(mask);
+        }
+    }
+    const size_t idx = scalar::ci_find_char(s + i, n - i, c);
+    return idx == npos ? npos : i + idx;
+}
+
+} // namespace sse2
+
+namespace avx2
+{
+
+namespace detail
+{
+
+LAMBDA_TARGET_AVX2 inline __m256i _fold_(__m256i v) noexcept
+{
+    const __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8(0x3f));
+    const __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), shifted);
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+LAMBDA_TARGET_AVX2 inline uint32_t _ci_diff_(const unsigned char *a, const unsigned char *b) noexcept
+{
+    const __m256i eq = _mm256_cmpeq_epi8(_fold_(_load_(a)), _fold_(_load_(b)));
+    return ~static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+}
+
+} // namespace detail
+
+/// <summary>
+/// Same as sse2::ci_mismatch on 32 byte blocks. Only call when cpu_has_avx2() is true.
+/// </summary>
+LAMBDA_TARGET_AVX2 inline size_t ci_mismatch(const unsigned char *a, const unsigned char *b, size_t n) noexcept
+{
+    if (n < 32)
+    {
+        return sse2::ci_mismatch(a, b, n);
+    }
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        const uint32_t diff = detail::_ci_diff_(a + i, b + i);
+        if (diff != 0)
+        {
+            return i + simd::detail::_ctz_(diff);
+        }
+    }
+    if (i < n)
+    {
+        const uint32_t diff = detail::_ci_diff_(a + n - 32, b + n - 32);
+        if (diff != 0)
+        {
+            return n - 32 + simd::detail::_ctz_(diff);
+        }
+    }
+    return n;
+}
+
+LAMBDA_TARGET_AVX2 inline size_t ci_find_char(const unsigned char *s, size_t n, unsigned char c) noexcept
+{
+    const unsigned char folded = simd::detail::_fold_byte_(c);
+    const bool letter = static_cast<unsigned>(folded) - 'a' < 26u;
+    const __m256i bit = _mm256_set1_epi8(static_cast<char>(letter ? 0x20 : 0));
+    const __m256i needle = _mm256_set1_epi8(static_cast<char>(folded));
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        const __m256i eq = _mm256_cmpeq_epi8(_mm256_or_si256(detail::_load_(s + i), bit), needle);
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+        if (mask != 0)
+        {
+            return i + simd::detail::_ctz_(mask);
+        }
+    }
+    const size_t idx = sse2::ci_find_char(s + i, n - i, c);
+    return idx == npos ? npos : i + idx;
+}
+
+} // namespace avx2
+
+#elif LAMBDA_SIMD_NEON
+
+namespace neon
+{
+
+namespace detail
+{
+
+inline uint8x16_t _fold_(uint8x16_t v) noexcept
+{
+    const uint8x16_t upper = vcltq_u8(vsubq_u8(v, vdupq_n_u8('A')), vdupq_n_u8(26));
+    return vorrq_u8(v, vandq_u8(upper, vdupq_n_u8(0x20)));
+}
+
+inline uint64_t _ci_diff_(const unsigned char *a, const unsigned char *b) noexcept
+{
+    return _mask_(vmvnq_u8(vceqq_u8(_fold_(vld1q_u8(a)), _fold_(vld1q_u8(b)))));
+}
+
+} // namespace detail
+
+inline size_t ci_mismatch(const unsigned char *a, const unsigned char *b, size_t n) noexcept
+{
+    if (n < 16)
+    {
+        return scalar::ci_mismatch(a, b, n);
+    }
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const uint64_t diff = detail::_ci_diff_(a + i, b + i);
+        if (diff != 0)
+        {
+            return i + simd::detail::_ctz_(diff) / 4;
+        }
+    }
+    if (i < n)
+    {
+        const uint64_t diff = detail::_ci_diff_(a + n - 16, b + n - 16);
+        if (diff != 0)
+        {
+            return n - 16 + simd::detail::_ctz_(diff) / 4;
+        }
+    }
+    return n;
+}
+
+inline size_t ci_find_char(const unsigned char *s, size_t n, unsigned char c) noexcept
+{
+    const unsigned char folded = simd::detail::_fold_byte_(c);
+    const bool letter = static_cast<unsigned>(folded) - 'a' < 26u;
+    const uint8x16_t bit = vdupq_n_u8(letter ? 0x20 : 0);
+    const uint8x16_t needle = vdupq_n_u8(folded);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const uint64_t mask = detail::_mask_(vceqq_u8(vorrq_u8(vld1q_u8(s + i), bit), needle));
+        if (mask != 0)
+        {
+            return i + simd::detail::_ctz_(mask) / 4;
+        }
+    }
+    const size_t idx = scalar::ci_find_char(s + i, n - i, c);
+    return idx == npos ? npos : i + idx;
+}
+
+} // namespace neon
+
+#endif
+
+/// <summary>
+/// Index of the first byte where a and b differ after ASCII folding, or n.
+/// </summary>
+inline size_t ci_mismatch(const unsigned char *a, const unsigned char *b, size_t n) noexcept
+{
+#if LAMBDA_SIMD_X86
+    return cpu_has_avx2() ? avx2::ci_mismatch(a, b, n) : sse2::ci_mismatch(a, b, n);
+#elif LAMBDA_SIMD_NEON
+    return neon::ci_mismatch(a, b, n);
+#else
+    return scalar::ci_mismatch(a, b, n);
+#endif
+}
+
+/// <summary>
+/// Index of the first byte equal to c after ASCII folding, or npos.
+/// </summary>
+inline size_t ci_find_char(const unsigned char *s, size_t n, unsigned char c) noexcept
+{
+#if LAMBDA_SIMD_X86
+    return cpu_has_avx2() ? avx2::ci_find_char(s, n, c) : sse2::ci_find_char(s, n, c);
+#elif LAMBDA_SIMD_NEON
+    return neon::ci_find_char(s, n, c);
+#else
+    return scalar::ci_find_char(s, n, c);
+#endif
+}
+
+} // namespace simd
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Traits
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace detail
+{
+
+/// <summary>
+/// Unicode simple case folding (CaseFolding.txt, status C and S) restricted to ASCII, Latin-1, Latin Extended-A,
+/// Greek, Cyrillic, the Kelvin / Angstrom signs, capital sharp s and the fullwidth Latin letters. Other code points
+/// are returned unchanged.
+/// </summary>
+inline constexpr char32_t _simple_fold_(char32_t c) noexcept
+{
+    if (c < 0x80)
+    {
+        return c - U'A' < 26u ? c + 32 : c;
+    }
+    if (c < 0x100)
+    {
+        if (c == 0xB5)
+        {
+            return 0x3BC;
+        }
+        return c >= 0xC0 && c <= 0xDE && c != 0xD7 ? c + 32 : c;
+    }
+    if (c < 0x180)
+    {
+        if (c == 0x130 || c == 0x131 || c == 0x138 || c == 0x149)
+        {
+            return c;
+        }
+        if (c == 0x178)
+        {
+            return 0xFF;
+        }
+        if (c == 0x17F)
+        {
+            return U's';
+        }
+        if ((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E))
+        {
+            return (c & 1) != 0 ? c + 1 : c;
+        }
+        return (c & 1) != 0 ? c : c + 1;
+    }
+    if (c >= 0x370 && c < 0x400)
+    {
+        if (c == 0x386)
+        {
+            return 0x3AC;
+        }
+        if (c >= 0x388 && c <= 0x38A)
+        {
+            return c + 37;
+        }
+        if (c == 0x38C)
+        {
+            return 0x3CC;
+        }
+        if (c == 0x38E || c == 0x38F)
+        {
+            return c + 63;
+        }
+        if (c >= 0x391 && c <= 0x3AB && c != 0x3A2)
+        {
+            return c + 32;
+        }
+        return c == 0x3C2 ? 0x3C3 : c;
+    }
+    if (c >= 0x400 && c < 0x530)
+    {
+        if (c < 0x410)
+        {
+            return c + 80;
+        }
+        if (c < 0x430)
+        {
+            return c + 32;
+        }
+        if ((c >= 0x460 && c <= 0x481) || (c >= 0x48A && c <= 0x4BF) || (c >= 0x4D0 && c <= 0x52F))
+        {
+            return (c & 1) != 0 ? c : c + 1;
+        }
+        if (c == 0x4C0)
+        {
+            return 0x4CF;
+        }
+        if (c >= 0x4C1 && c <= 0x4CE)
+        {
+            return (c & 1) != 0 ? c + 1 : c;
+        }
+        return c;
+    }
+    if (c == 0x1E9E)
+    {
+        return 0xDF;
+    }
+    if (c == 0x212A)
+    {
+        return U'k';
+    }
+    if (c == 0x212B)
+    {
+        return 0xE5;
+    }
+    return c >= 0xFF21 && c <= 0xFF3A ? c + 32 : c;
+}
+
+} // namespace detail
+
+/// <summary>
+/// Char traits comparing characters by their folded (lower case) form. Derives everything else (length, copy, assign,
+/// int_type conversions) from std::char_traits, so it also works with std::basic_string.
+/// </summary>
+template <typename CharT, case_fold Fold = case_fold::ascii> struct ci_char_traits : std::char_traits<CharT>
+{
+    using char_type = CharT;
+
+    /// <summary>
+    /// The canonical (lower case) form of c.
+    /// </summary>
+    static constexpr CharT fold(CharT c) noexcept;
+
+    static constexpr bool eq(CharT a, CharT b) noexcept;
+    static constexpr bool lt(CharT a, CharT b) noexcept;
+
+    /// <summary>
+    /// Three way comparison of the folded units, ordered as unsigned values like std::char_traits.
+    /// </summary>
+    static constexpr int compare(const CharT *a, const CharT *b, size_t count) noexcept;
+
+    /// <summary>
+    /// First unit of s[0, count) equal to c after folding, or nullptr.
+    /// </summary>
+    static constexpr const CharT *find(const CharT *s, size_t count, const CharT &c) noexcept;
+
+  private:
+    using unit_type = typename std::make_unsigned<CharT>::type;
+
+    static int _runtime_compare_(const CharT *a, const CharT *b, size_t count) noexcept;
+    static const CharT *_runtime_find_(const CharT *s, size_t count, CharT c) noexcept;
+};
+
+template <typename CharT, case_fold Fold>
+inline constexpr CharT ci_char_traits<CharT, Fold>::fold(CharT c) noexcept
+{
+    const unit_type u = static_cast<unit_type>(c);
+    if (Fold == case_fold::ascii || sizeof(CharT) == 1)
+    {
+        return static_cast<uint32_t>(u) - 'A' < 26u ? static_cast<CharT>(u + 32) : c;
+    }
+    return static_cast<CharT>(detail::_simple_fold_(static_cast<char32_t>(u)));
+}
+
+template <typename CharT, case_fold Fold>
+inline constexpr bool ci_char_traits<CharT, Fold>::eq(CharT a, CharT b) noexcept
+{
+    return fold(a) == fold(b);
+}
+
+template <typename CharT, case_fold Fold>
+inline constexpr bool ci_char_traits<CharT, Fold>::lt(CharT a, CharT b) noexcept
+{
+    return static_cast<unit_type>(fold(a)) < static_cast<unit_type>(fold(b));
+}
+
+/// <summary>
+/// 1 byte units go through the folding kernels; wider units keep the per unit loop.
+/// </summary>
+template <typename CharT, case_fold Fold>
+inline int ci_char_traits<CharT, Fold>::_runtime_compare_(const CharT *a, const CharT *b, size_t count) noexcept
+{
+    const size_t i = simd::ci_mismatch(reinterpret_cast<const unsigned char *>(a),
+                                       reinterpret_cast<const unsigned char *>(b), count);
+    return i == count ? 0 : (lt(a[i], b[i]) ? -1 : 1);
+}
+
+template <typename CharT, case_fold Fold>
+inline const CharT *ci_char_traits<CharT, Fold>::_runtime_find_(const CharT *s, size_t count, CharT c) noexcept
+{
+    const size_t idx =
+        simd::ci_find_char(reinterpret_cast<const unsigned char *>(s), count, static_cast<unsigned char>(c));
+    return idx == simd::npos ? nullptr : s + idx;
+}
+
+template <typename CharT, case_fold Fold>
+inline constexpr int ci_char_traits<CharT, Fold>::compare(const CharT *a, const CharT *b, size_t count) noexcept
+{
+    if (sizeof(CharT) == 1 && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return _runtime_compare_(a, b, count);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!eq(a[i], b[i]))
+        {
+            return lt(a[i], b[i]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+template <typename CharT, case_fold Fold>
+inline constexpr const CharT *ci_char_traits<CharT, Fold>::find(const CharT *s, size_t count, const CharT &c) noexcept
+{
+    if (sizeof(CharT) == 1 && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return _runtime_find_(s, count, c);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (eq(s[i], c))
+        {
+            return s + i;
+        }
+    }
+    return nullptr;
+}
+
+template <typename CharT, case_fold Fold = case_fold::ascii>
+using basic_ci_str_view = basic_str_view<CharT, ci_char_traits<CharT, Fold>>;
+
+using ci_str_view = basic_ci_str_view<char>;
+using wci_str_view = basic_ci_str_view<wchar_t>;
+using u16ci_str_view = basic_ci_str_view<char16_t>;
+using u32ci_str_view = basic_ci_str_view<char32_t>;
+
+/// <summary>
+/// Reinterprets a view as case-insensitive (or back, with the target traits given). No characters are copied.
+/// </summary>
+/// <param name="v"></param>
+/// <returns></returns>
+template <case_fold Fold = case_fold::ascii, typename CharT, typename Traits>
+inline constexpr basic_ci_str_view<CharT, Fold> as_ci(basic_str_view<CharT, Traits> v) noexcept
+{
+    return basic_ci_str_view<CharT, Fold>(v.data(), v.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Hashing
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace hashing
+{
+namespace detail
+{
+
+/// <summary>
+/// _unit_reader_ over the folded units. Constant evaluable.
+/// </summary>
+template <typename CharT, typename Traits> struct _folded_unit_reader_
+{
+    using unit_type = typename std::make_unsigned<CharT>::type;
+
+    const CharT *p;
+
+    constexpr uint64_t byte(size_t i) const noexcept
+    {
+        return (static_cast<uint64_t>(static_cast<unit_type>(Traits::fold(p[i / sizeof(CharT)]))) >>
+                (8 * (i % sizeof(CharT)))) &
+               0xffu;
+    }
+    constexpr uint64_t r4(size_t i) const noexcept
+    {
+        return byte(i) | (byte(i + 1) << 8) | (byte(i + 2) << 16) | (byte(i + 3) << 24);
+    }
+    constexpr uint64_t r8(size_t i) const noexcept
+    {
+        return r4(i) | (r4(i + 4) << 32);
+    }
+};
+
+/// <summary>
+/// _memory_reader_ folding ASCII bytes on the fly, 8 at a time.
+/// </summary>
+struct _folded_memory_reader_
+{
+    const unsigned char *p;
+
+    uint64_t byte(size_t i) const noexcept
+    {
+        return simd::detail::_fold_byte_(p[i]);
+    }
+    uint64_t r4(size_t i) const noexcept
+    {
+        return simd::detail::_fold64_(simd::detail::_load32_(p + i));
+    }
+    uint64_t r8(size_t i) const noexcept
+    {
+        return simd::detail::_fold64_(simd::detail::_load64_(p + i));
+    }
+};
+
+template <typename CharT> inline uint64_t _runtime_folded_hash_(const CharT *s, size_t count, uint64_t seed) noexcept
+{
+    return _wyhash_(_folded_memory_reader_{reinterpret_cast<const unsigned char *>(s)}, count, seed);
+}
+
+} // namespace detail
+} // namespace hashing
+
+/// <summary>
+/// Hashes the folded code units, so views that compare equal hash equal. The value is the hash_value of the lower
+/// cased characters: hash_value(ci_str_view("Host")) == hash_value("host"_sv).
+/// </summary>
+/// <param name="v"></param>
+/// <param name="seed"></param>
+/// <returns></returns>
+template <typename CharT, case_fold Fold>
+inline constexpr uint64_t hash_value(basic_ci_str_view<CharT, Fold> v, uint64_t seed = hashing::default_seed) noexcept
+{
+#if LAMBDA_LITTLE_ENDIAN
+    if (sizeof(CharT) == 1 && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return hashing::detail::_runtime_folded_hash_(v.data(), v.size(), seed);
+    }
+#endif
+    using reader = hashing::detail::_folded_unit_reader_<CharT, ci_char_traits<CharT, Fold>>;
+    return hashing::detail::_wyhash_(reader{v.data()}, v.size() * sizeof(CharT), seed);
+}
+
+} // namespace lambda
+
+namespace std
+{
+
+/// <summary>
+/// std::hash for the case-insensitive views, consistent with their operator==.
+/// </summary>
+template <typename CharT, lambda::case_fold Fold> struct hash<lambda::basic_ci_str_view<CharT, Fold>>
+{
+    constexpr size_t operator()(lambda::basic_ci_str_view<CharT, Fold> v) const noexcept
+    {
+        return static_cast<size_t>(lambda::hash_value(v));
+    }
+};
+
+} // namespace std
+
+#endif
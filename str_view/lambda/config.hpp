@@ -0,0 +1,171 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Compiler / platform configuration shared by the lambda headers
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_CONFIG_H
+#define STR_VIEW_CONFIG_H
+
+// -----------------------------------------------------------------------------------------------------------------------
+// Constant evaluation detection
+//
+// C++14 has no std::is_constant_evaluated, but every compiler we care about exposes the builtin in all language modes.
+// When the builtin is missing, LAMBDA_IS_CONSTANT_EVALUATED() is always true, so the constexpr (scalar) code paths are
+// taken both at compile time and at runtime. Defining LAMBDA_HAS_CONSTANT_EVALUATED=0 forces that fallback.
+// -----------------------------------------------------------------------------------------------------------------------
+
+#if !defined(LAMBDA_HAS_CONSTANT_EVALUATED) && defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define LAMBDA_HAS_CONSTANT_EVALUATED 1
+#endif
+#endif
+
+#if !defined(LAMBDA_HAS_CONSTANT_EVALUATED)
+#if (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define LAMBDA_HAS_CONSTANT_EVALUATED 1
+#else
+#define LAMBDA_HAS_CONSTANT_EVALUATED 0
+#endif
+#endif
+
+#if LAMBDA_HAS_CONSTANT_EVALUATED
+#define LAMBDA_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define LAMBDA_IS_CONSTANT_EVALUATED() true
+#endif
+
+// -----------------------------------------------------------------------------------------------------------------------
+// SIMD availability
+//
+// Define LAMBDA_STR_VIEW_NO_SIMD to force the portable scalar implementation everywhere.
+// -----------------------------------------------------------------------------------------------------------------------
+
+#if !defined(LAMBDA_STR_VIEW_NO_SIMD)
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LAMBDA_SIMD_X86 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define LAMBDA_SIMD_NEON 1
+#endif
+#endif
+
+#if !defined(LAMBDA_SIMD_X86)
+#define LAMBDA_SIMD_X86 0
+#endif
+
+#if !defined(LAMBDA_SIMD_NEON)
+#define LAMBDA_SIMD_NEON 0
+#endif
+
+/// Functions using AVX2 intrinsics must be compiled for that target on gcc/clang; msvc accepts them as is.
+#if LAMBDA_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define LAMBDA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define LAMBDA_TARGET_AVX2
+#endif
+
+/// The length kernels read whole aligned blocks around the string, which never crosses a page but does touch bytes
+/// outside the object. That is fine for the hardware and only trips AddressSanitizer.
+#if defined(__GNUC__) || defined(__clang__)
+#define LAMBDA_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#elif defined(_MSC_VER) && _MSC_VER >= 1928
+#define LAMBDA_NO_SANITIZE_ADDRESS __declspec(no_sanitize_address)
+#else
+#define LAMBDA_NO_SANITIZE_ADDRESS
+#endif
+
+// -----------------------------------------------------------------------------------------------------------------------
+// Inlining and preconditions
+//
+// The unchecked slicing primitives are forced inline, and the throwing paths of the checked API live in out of line
+// helpers, so a checked call inlines to one compare and a branch. Preconditions of the unchecked API are verified
+// with assert() in debug builds only; define LAMBDA_STR_VIEW_ASSERT before including to route them elsewhere.
+// -----------------------------------------------------------------------------------------------------------------------
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define LAMBDA_FORCE_INLINE __forceinline
+#define LAMBDA_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__) || defined(__clang__)
+#define LAMBDA_FORCE_INLINE inline __attribute__((always_inline))
+#define LAMBDA_NOINLINE __attribute__((noinline))
+#else
+#define LAMBDA_FORCE_INLINE inline
+#define LAMBDA_NOINLINE
+#endif
+
+/// Read prefetch of the cache line holding p, for searches that know their next few probes; a no-op elsewhere.
+#if defined(__GNUC__) || defined(__clang__)
+#define LAMBDA_PREFETCH(p) __builtin_prefetch((p), 0, 3)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define LAMBDA_PREFETCH(p) _mm_prefetch(reinterpret_cast<const char *>(p), _MM_HINT_T0)
+#else
+#define LAMBDA_PREFETCH(p) ((void)(p))
+#endif
+
+#if !defined(LAMBDA_STR_VIEW_ASSERT)
+#include <cassert>
+#define LAMBDA_STR_VIEW_ASSERT(cond) assert(cond)
+#endif
+
+// -----------------------------------------------------------------------------------------------------------------------
+// Instrumentation
+//
+// Define LAMBDA_STR_VIEW_INSTRUMENT to count calls, sizes, throws and cycles of the basic_str_view operations in per
+// thread counters (see instrument.hpp). Without it the hooks expand to nothing. The definition changes the bodies of
+// inline functions, so it must be the same in every translation unit of a program.
+// -----------------------------------------------------------------------------------------------------------------------
+
+#if defined(LAMBDA_STR_VIEW_INSTRUMENT)
+#define LAMBDA_INSTRUMENT 1
+#else
+#define LAMBDA_INSTRUMENT 0
+#endif
+
+// -----------------------------------------------------------------------------------------------------------------------
+// Coroutines
+//
+// The generator overloads of pipeline.hpp need C++20 coroutines; the callback overloads work from C++14.
+// -----------------------------------------------------------------------------------------------------------------------
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define LAMBDA_HAS_COROUTINES 1
+#else
+#define LAMBDA_HAS_COROUTINES 0
+#endif
+
+// -----------------------------------------------------------------------------------------------------------------------
+// Byte order
+// -----------------------------------------------------------------------------------------------------------------------
+
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define LAMBDA_LITTLE_ENDIAN 1
+#else
+#define LAMBDA_LITTLE_ENDIAN 0
+#endif
+
+#endif
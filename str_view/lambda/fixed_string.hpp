@@ -0,0 +1,602 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Owning, inline storage string of at most N code units, interoperable with basic_str_view
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_FIXED_STRING_H
+#define STR_VIEW_FIXED_STRING_H
+
+#include "config.hpp"
+#include "str_view.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace lambda
+{
+
+namespace detail
+{
+
+[[noreturn]] LAMBDA_NOINLINE inline void _throw_fixed_length_error_(const char *what)
+{
+    throw std::length_error(what);
+}
+
+/// <summary>
+/// N + 1 code units rounded up to whole 8 byte words.
+/// </summary>
+template <typename CharT> constexpr size_t _fixed_storage_size_(size_t n) noexcept
+{
+    return sizeof(CharT) >= sizeof(uint64_t)
+               ? n + 1
+               : (n + 1 + sizeof(uint64_t) / sizeof(CharT) - 1) / (sizeof(uint64_t) / sizeof(CharT)) *
+                     (sizeof(uint64_t) / sizeof(CharT));
+}
+
+} // namespace detail
+
+/// <summary>
+/// A string of at most N code units stored inline: no allocation, trivially copyable, and usable in constant
+/// expressions, so vectors of short keys stay contiguous and constexpr tables can be built from literals:
+///
+///     constexpr auto key = lambda::make_fixed_string("user:") + "42";    // fixed_string<7>
+///     static_assert(key.view().ends_with("42"), "");
+///
+/// The storage past size() is always zero and is padded to whole 8 byte words, so for the standard traits equality
+/// of two fixed strings of the same N is a fixed number of word compares (two for a fixed_string<15>) with no
+/// length dependent loop. data() is null-terminated. Converts implicitly to basic_str_view.
+/// </summary>
+template <typename CharT, size_t N, typename Traits = std::char_traits<CharT>> struct basic_fixed_string
+{
+    using view_type = basic_str_view<CharT, Traits>;
+    using trait_type = Traits;
+    using value_type = CharT;
+    using size_type = typename view_type::size_type;
+    using reference = CharT &;
+    using const_reference = const CharT &;
+    using iterator = CharT *;
+    using const_iterator = const CharT *;
+
+    static constexpr size_type npos = view_type::npos;
+
+    /// Code units of storage, including the terminator and the padding.
+    static constexpr size_type storage_size = detail::_fixed_storage_size_<CharT>(N);
+
+    constexpr basic_fixed_string() noexcept;
+
+    /// <summary>
+    /// From a literal or array that fits, checked at compile time. The length runs to the first terminator, as for
+    /// basic_str_view::starts_with on the same array; an array of N + 1 units without one throws std::length_error.
+    /// </summary>
+    template <size_t M> constexpr basic_fixed_string(const CharT (&s)[M]);
+
+    /// <summary>
+    /// Copies v. Throws std::length_error if v is longer than N.
+    /// </summary>
+    constexpr explicit basic_fixed_string(view_type v);
+    constexpr basic_fixed_string(const CharT *s, size_type count);
+
+    constexpr size_type size() const noexcept;
+    constexpr size_type length() const noexcept;
+    constexpr bool empty() const noexcept;
+    static constexpr size_type capacity() noexcept;
+    static constexpr size_type max_size() noexcept;
+
+    constexpr const CharT *data() const noexcept;
+    constexpr CharT *data() noexcept;
+    constexpr const CharT *c_str() const noexcept;
+
+    constexpr const_iterator begin() const noexcept;
+    constexpr const_iterator end() const noexcept;
+    constexpr iterator begin() noexcept;
+    constexpr iterator end() noexcept;
+
+    constexpr const_reference operator[](size_type pos) const noexcept;
+    constexpr reference operator[](size_type pos) noexcept;
+    constexpr const_reference front() const noexcept;
+    constexpr const_reference back() const noexcept;
+
+    constexpr view_type view() const noexcept;
+    constexpr operator view_type() const noexcept;
+
+    template <typename Allocator = std::allocator<CharT>>
+    std::basic_string<CharT, Traits, Allocator> to_string(const Allocator &all = Allocator()) const;
+
+    /// <summary>
+    /// Appends v, or a single character. Throws std::length_error, leaving the string unchanged, if the result would
+    /// be longer than N.
+    /// </summary>
+    constexpr basic_fixed_string &append(view_type v);
+    constexpr basic_fixed_string &push_back(CharT c);
+    constexpr basic_fixed_string &operator+=(view_type v);
+    constexpr basic_fixed_string &operator+=(CharT c);
+
+    /// <summary>
+    /// Removes the last character; the string must not be empty.
+    /// </summary>
+    constexpr void pop_back() noexcept;
+    constexpr void clear() noexcept;
+
+    /// <summary>
+    /// Same as view() == other, comparing whole padded words at runtime.
+    /// </summary>
+    constexpr bool equals(const basic_fixed_string &other) const noexcept;
+    constexpr int compare(view_type v) const noexcept;
+
+  private:
+    constexpr void assign_units(const CharT *s, size_type count) noexcept;
+
+    CharT m_data[storage_size];
+    size_type m_length;
+};
+
+template <size_t N> using fixed_string = basic_fixed_string<char, N>;
+template <size_t N> using wfixed_string = basic_fixed_string<wchar_t, N>;
+template <size_t N> using u16fixed_string = basic_fixed_string<char16_t, N>;
+template <size_t N> using u32fixed_string = basic_fixed_string<char32_t, N>;
+
+template <typename CharT, size_t N, typename Traits>
+constexpr typename basic_fixed_string<CharT, N, Traits>::size_type basic_fixed_string<CharT, N, Traits>::npos;
+
+template <typename CharT, size_t N, typename Traits>
+constexpr typename basic_fixed_string<CharT, N, Traits>::size_type basic_fixed_string<CharT, N, Traits>::storage_size;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr basic_fixed_string<CharT, N, Traits>::basic_fixed_string() noexcept : m_data{}, m_length(0)
+{
+}
+
+template <typename CharT, size_t N, typename Traits>
+template <size_t M>
+inline constexpr basic_fixed_string<CharT, N, Traits>::basic_fixed_string(const CharT (&s)[M])
+    : m_data{}, m_length(0)
+{
+    static_assert(M <= N + 1, "literal longer than the fixed_string capacity");
+    const size_type count = utility::_array_length_<CharT, Traits>(s);
+    if (count > N)
+    {
+        detail::_throw_fixed_length_error_("Unterminated array longer than the capacity in lambda::fixed_string");
+    }
+    assign_units(s, count);
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr basic_fixed_string<CharT, N, Traits>::basic_fixed_string(view_type v) : m_data{}, m_length(0)
+{
+    if (v.size() > N)
+    {
+        detail::_throw_fixed_length_error_("View longer than the capacity in lambda::fixed_string");
+    }
+    assign_units(v.data(), v.size());
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr basic_fixed_string<CharT, N, Traits>::basic_fixed_string(const CharT *s, size_type count)
+    : basic_fixed_string(view_type(s, count))
+{
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr void basic_fixed_string<CharT, N, Traits>::assign_units(const CharT *s, size_type count) noexcept
+{
+    for (size_type i = 0; i < count; ++i)
+    {
+        m_data[i] = s[i];
+    }
+    m_length = count;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_fixed_string<CharT, N, Traits>::size_type
+basic_fixed_string<CharT, N, Traits>::size() const noexcept
+{
+    return m_length;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_fixed_string<CharT, N, Traits>::size_type
+basic_fixed_string<CharT, N, Traits>::length() const noexcept
+{
+    return m_length;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr bool basic_fixed_string<CharT, N, Traits>::empty() const noexcept
+{
+    return m_length == 0;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_fixed_string<CharT, N, Traits>::size_type
+basic_fixed_string<CharT, N, Traits>::capacity() noexcept
+{
+    return N;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_fixed_string<CharT, N, Traits>::size_type
+basic_fixed_string<CharT, N, Traits>::max_size() noexcept
+{
+    return N;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr const CharT *basic_fixed_string<CharT, N, Traits>::data() const noexcept
+{
+    return m_data;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr CharT *basic_fixed_string<CharT, N, Traits>::data() noexcept
+{
+    return m_data;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr const CharT *basic_fixed_string<CharT, N, Traits>::c_str() const noexcept
+{
+    return m_data;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_fixed_string<CharT, N, Traits>::const_iterator
+basic_fixed_string<CharT, N, Traits>::begin() const noexcept
+{
+    return m_data;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_fixed_string<CharT, N, Traits>::const_iterator
+basic_fixed_string<CharT, N, Traits>::end() const noexcept
+{
+    return m_data + m_length;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_fixed_string<CharT, N, Traits>::iterator
+basic_fixed_string<CharT, N, Traits>::begin() noexcept
+{
+    return m_data;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_fixed_string<CharT, N, Traits>::iterator
+basic_fixed_string<CharT, N, Traits>::end() noexcept
+{
+    return m_data + m_length;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_fixed_string<CharT, N, Traits>::const_reference
+basic_fixed_string<CharT, N, Traits>::operator[](size_type pos) const noexcept
+{
+    return m_data[pos];
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_fixed_string<CharT, N, Traits>::reference
+basic_fixed_string<CharT, N, Traits>::operator[](size_type pos) noexcept
+{
+    return m_data[pos];
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_fixed_string<CharT, N, Traits>::const_reference
+basic_fixed_string<CharT, N, Traits>::front() const noexcept
+{
+    return m_data[0];
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_fixed_string<CharT, N, Traits>::const_reference
+basic_fixed_string<CharT, N, Traits>::back() const noexcept
+{
+    return m_data[m_length - 1];
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr basic_str_view<CharT, Traits> basic_fixed_string<CharT, N, Traits>::view() const noexcept
+{
+    // m_length never exceeds N, which every constructor and append checks; saying so lets the compiler drop the word
+    // loads of the view kernels that would read past a small object, and the -Warray-bounds warnings they raise.
+    return view_type(m_data, m_length < N ? m_length : N);
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr basic_fixed_string<CharT, N, Traits>::operator basic_str_view<CharT, Traits>() const noexcept
+{
+    return view();
+}
+
+template <typename CharT, size_t N, typename Traits>
+template <typename Allocator>
+inline std::basic_string<CharT, Traits, Allocator> basic_fixed_string<CharT, N, Traits>::to_string(
+    const Allocator &all) const
+{
+    return std::basic_string<CharT, Traits, Allocator>(m_data, m_length, all);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr basic_fixed_string<CharT, N, Traits> &basic_fixed_string<CharT, N, Traits>::append(view_type v)
+{
+    if (v.size() > N - m_length)
+    {
+        detail::_throw_fixed_length_error_("Result longer than the capacity in lambda::fixed_string::append");
+    }
+    for (size_type i = 0; i < v.size(); ++i)
+    {
+        m_data[m_length + i] = v[i];
+    }
+    m_length += v.size();
+    return *this;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr basic_fixed_string<CharT, N, Traits> &basic_fixed_string<CharT, N, Traits>::push_back(CharT c)
+{
+    if (m_length == N)
+    {
+        detail::_throw_fixed_length_error_("Result longer than the capacity in lambda::fixed_string::push_back");
+    }
+    m_data[m_length++] = c;
+    return *this;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr basic_fixed_string<CharT, N, Traits> &basic_fixed_string<CharT, N, Traits>::operator+=(view_type v)
+{
+    return append(v);
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr basic_fixed_string<CharT, N, Traits> &basic_fixed_string<CharT, N, Traits>::operator+=(CharT c)
+{
+    return push_back(c);
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr void basic_fixed_string<CharT, N, Traits>::pop_back() noexcept
+{
+    LAMBDA_STR_VIEW_ASSERT(m_length != 0);
+    m_data[--m_length] = CharT();
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr void basic_fixed_string<CharT, N, Traits>::clear() noexcept
+{
+    for (size_type i = 0; i < m_length; ++i)
+    {
+        m_data[i] = CharT();
+    }
+    m_length = 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr bool basic_fixed_string<CharT, N, Traits>::equals(const basic_fixed_string &other) const noexcept
+{
+    if (m_length != other.m_length)
+    {
+        return false;
+    }
+    if (utility::_bitwise_traits_<CharT, Traits>::value && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        // Both tails are zero, so the whole storage compares equal exactly when the characters do. The trip count
+        // is a constant, and the loop unrolls into plain word loads.
+        uint64_t diff = 0;
+        for (size_type i = 0; i < sizeof(m_data) / sizeof(uint64_t); ++i)
+        {
+            uint64_t a = 0;
+            uint64_t b = 0;
+            std::memcpy(&a, reinterpret_cast<const char *>(m_data) + i * sizeof(uint64_t), sizeof(uint64_t));
+            std::memcpy(&b, reinterpret_cast<const char *>(other.m_data) + i * sizeof(uint64_t), sizeof(uint64_t));
+            diff |= a ^ b;
+        }
+        return diff == 0;
+    }
+    return view().equals(other.view());
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr int basic_fixed_string<CharT, N, Traits>::compare(view_type v) const noexcept
+{
+    return view().compare(v);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Construction helpers and concatenation. The result capacity is the sum of the operand capacities, so literals can
+// be joined in constant expressions without naming a size.
+// ---------------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// A fixed string holding exactly the literal: make_fixed_string("abc") is a fixed_string<3>.
+/// </summary>
+template <typename CharT, size_t M>
+inline constexpr basic_fixed_string<CharT, M - 1> make_fixed_string(const CharT (&s)[M])
+{
+    return basic_fixed_string<CharT, M - 1>(s);
+}
+
+template <typename CharT, size_t N, size_t M, typename Traits>
+inline constexpr basic_fixed_string<CharT, N + M, Traits> operator+(const basic_fixed_string<CharT, N, Traits> &lhs,
+                                                                    const basic_fixed_string<CharT, M, Traits> &rhs)
+{
+    basic_fixed_string<CharT, N + M, Traits> result(lhs.view());
+    result.append(rhs.view());
+    return result;
+}
+
+template <typename CharT, size_t N, size_t M, typename Traits>
+inline constexpr basic_fixed_string<CharT, N + M - 1, Traits> operator+(const basic_fixed_string<CharT, N, Traits> &lhs,
+                                                                        const CharT (&rhs)[M])
+{
+    return lhs + basic_fixed_string<CharT, M - 1, Traits>(rhs);
+}
+
+template <typename CharT, size_t N, size_t M, typename Traits>
+inline constexpr basic_fixed_string<CharT, N + M - 1, Traits> operator+(const CharT (&lhs)[M],
+                                                                        const basic_fixed_string<CharT, N, Traits> &rhs)
+{
+    return basic_fixed_string<CharT, M - 1, Traits>(lhs) + rhs;
+}
+
+/// <summary>
+/// Copy of s with every occurrence of from, taken left to right without overlap, replaced by to, built in a fixed
+/// string of capacity N, so literals can be rewritten in constant expressions:
+///
+///     constexpr auto route = lambda::replace_all<32>("/users/{id}/posts"_sv, "{id}"_sv, "42"_sv);
+///
+/// Throws std::length_error when the result is longer than N, which in a constant expression is a compile error. An
+/// empty from leaves s unchanged.
+/// </summary>
+/// <param name="s"></param>
+/// <param name="from"></param>
+/// <param name="to"></param>
+/// <returns></returns>
+template <size_t N, typename CharT, typename Traits>
+inline constexpr basic_fixed_string<CharT, N, Traits> replace_all(basic_str_view<CharT, Traits> s,
+                                                                  basic_str_view<CharT, Traits> from,
+                                                                  basic_str_view<CharT, Traits> to)
+{
+    basic_fixed_string<CharT, N, Traits> result;
+    if (from.empty())
+    {
+        result.append(s);
+        return result;
+    }
+    size_t begin = 0;
+    for (size_t at = s.find(from); at != s.npos; at = s.find(from, begin))
+    {
+        result.append(s.unchecked_substr(begin, at - begin));
+        result.append(to);
+        begin = at + from.size();
+    }
+    result.append(s.drop(begin));
+    return result;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Comparison. Two fixed strings of the same capacity use the padded compare; anything else compares as views.
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr bool operator==(const basic_fixed_string<CharT, N, Traits> &lhs,
+                                 const basic_fixed_string<CharT, N, Traits> &rhs) noexcept
+{
+    return lhs.equals(rhs);
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr bool operator!=(const basic_fixed_string<CharT, N, Traits> &lhs,
+                                 const basic_fixed_string<CharT, N, Traits> &rhs) noexcept
+{
+    return !lhs.equals(rhs);
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr bool operator<(const basic_fixed_string<CharT, N, Traits> &lhs,
+                                const basic_fixed_string<CharT, N, Traits> &rhs) noexcept
+{
+    return lhs.compare(rhs.view()) < 0;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr bool operator==(const basic_fixed_string<CharT, N, Traits> &lhs,
+                                 basic_str_view<CharT, Traits> rhs) noexcept
+{
+    return lhs.view().equals(rhs);
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr bool operator==(basic_str_view<CharT, Traits> lhs,
+                                 const basic_fixed_string<CharT, N, Traits> &rhs) noexcept
+{
+    return lhs.equals(rhs.view());
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr bool operator!=(const basic_fixed_string<CharT, N, Traits> &lhs,
+                                 basic_str_view<CharT, Traits> rhs) noexcept
+{
+    return !lhs.view().equals(rhs);
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr bool operator!=(basic_str_view<CharT, Traits> lhs,
+                                 const basic_fixed_string<CharT, N, Traits> &rhs) noexcept
+{
+    return !lhs.equals(rhs.view());
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline std::basic_ostream<CharT, Traits> &operator<<(std::basic_ostream<CharT, Traits> &os,
+                                                     const basic_fixed_string<CharT, N, Traits> &s)
+{
+    return os << s.view();
+}
+
+/// <summary>
+/// Same value as hash_value(s.view()), so fixed strings and views of the same characters hash alike.
+/// </summary>
+template <typename CharT, size_t N, typename Traits>
+inline constexpr uint64_t hash_value(const basic_fixed_string<CharT, N, Traits> &s,
+                                     uint64_t seed = hashing::default_seed) noexcept
+{
+    return hash_value(s.view(), seed);
+}
+
+} // namespace lambda
+
+namespace std
+{
+
+/// <summary>
+/// std::hash for the fixed strings of the standard traits, consistent with std::hash of the views.
+/// </summary>
+template <typename CharT, size_t N> struct hash<lambda::basic_fixed_string<CharT, N, std::char_traits<CharT>>>
+{
+    constexpr size_t operator()(const lambda::basic_fixed_string<CharT, N, std::char_traits<CharT>> &s) const noexcept
+    {
+        return static_cast<size_t>(lambda::hash_value(s.view()));
+    }
+};
+
+} // namespace std
+
+#endif
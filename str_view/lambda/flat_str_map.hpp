@@ -0,0 +1,577 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Immutable sorted map keyed by str_view, packed into flat arrays with an Eytzinger search index
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_FLAT_STR_MAP_H
+#define STR_VIEW_FLAT_STR_MAP_H
+
+#include "config.hpp"
+#include "simd.hpp"
+#include "str_view.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lambda
+{
+
+/// <summary>
+/// Read-mostly sorted dictionary, built once from (key, value) pairs. It replaces std::map<std::string, T> without a
+/// heap node per entry:
+///  - the keys are packed back to back in one character buffer, in sorted order, and key(i) is a view into it;
+///  - their offsets are a separate array, and the values another, both indexed by rank;
+///  - lookups descend an Eytzinger (breadth first) tree of 8 byte key prefixes. Every node is one integer compare
+///    and the next levels are prefetched, so a search costs a few cache misses instead of one per tree level. The
+///    key buffer is only touched when a node's prefix ties with the probe's.
+///
+/// The prefix that all keys share (a namespace such as "user:") is stored once and skipped by the node prefixes,
+/// so those 8 bytes go to the part of the keys that actually differs.
+///
+///     lambda::flat_str_map<int> ports{{"http"_sv, 80}, {"https"_sv, 443}, {"ssh"_sv, 22}};
+///     auto it = ports.find("https"_sv);               // it.key() == "https", it.value() == 443
+///     for (auto r = ports.prefix_range("http"_sv); r.first != r.second; ++r.first) { ... }
+///
+/// Duplicate keys are rejected with std::invalid_argument. Values can be modified in place; keys cannot. The prefix
+/// index needs the ordering of the standard traits on unsigned code units (char, char16_t, char32_t); other
+/// instantiations compare whole keys at every node and remain correct.
+/// </summary>
+template <typename T, typename CharT = char, typename Traits = std::char_traits<CharT>> struct basic_flat_str_map
+{
+    static_assert(sizeof(CharT) <= sizeof(uint32_t), "code units wider than 32 bits are not supported");
+
+    using view_type = basic_str_view<CharT, Traits>;
+    using key_type = view_type;
+    using mapped_type = T;
+    using size_type = size_t;
+    using value_type = std::pair<view_type, T>;
+    using reference = std::pair<view_type, const T &>;
+
+    static constexpr size_type npos = size_type(-1);
+
+    struct const_iterator;
+    using iterator = const_iterator;
+
+    basic_flat_str_map();
+
+    /// <summary>
+    /// Builds from a range of pairs whose first converts to view_type and second to T, such as a
+    /// std::map<std::string, T>. The keys are copied; the values are copied or, from move iterators, moved.
+    /// </summary>
+    template <typename InputIt> basic_flat_str_map(InputIt first, InputIt last);
+    basic_flat_str_map(std::initializer_list<value_type> entries);
+
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+
+    /// <summary>
+    /// Key and value of rank i, 0 being the smallest key.
+    /// </summary>
+    view_type key(size_type i) const noexcept;
+    const T &value(size_type i) const noexcept;
+    T &value(size_type i) noexcept;
+
+    /// <summary>
+    /// The prefix shared by every key.
+    /// </summary>
+    view_type common_prefix() const noexcept;
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+
+    const_iterator find(view_type key) const noexcept;
+    bool contains(view_type key) const noexcept;
+    size_type count(view_type key) const noexcept;
+
+    /// <summary>
+    /// The value of key. Throws std::out_of_range if there is none.
+    /// </summary>
+    const T &at(view_type key) const;
+    T &at(view_type key);
+
+    /// <summary>
+    /// First key not less than key, first key greater than key, and the range of keys equal to key (at most one).
+    /// </summary>
+    const_iterator lower_bound(view_type key) const noexcept;
+    const_iterator upper_bound(view_type key) const noexcept;
+    std::pair<const_iterator, const_iterator> equal_range(view_type key) const noexcept;
+
+    /// <summary>
+    /// The keys that start with prefix, which are contiguous in key order. An empty prefix selects every key.
+    /// </summary>
+    std::pair<const_iterator, const_iterator> prefix_range(view_type prefix) const noexcept;
+
+    /// <summary>
+    /// Rank of the first key not less than key, size() if there is none.
+    /// </summary>
+    size_type lower_bound_rank(view_type key) const noexcept;
+
+  private:
+    static uint64_t normalized_prefix(view_type v) noexcept;
+    void build(std::vector<value_type> &entries);
+    size_type fill_tree(size_type node, size_type rank);
+
+    std::vector<CharT> m_chars;
+    std::vector<size_type> m_offsets; // n + 1 entries, key i is [m_offsets[i], m_offsets[i + 1])
+    std::vector<T> m_values;
+    std::vector<uint64_t> m_tree_prefixes; // Eytzinger order, node k has children 2k and 2k + 1, the root is 1
+    std::vector<size_type> m_tree_ranks;
+    size_type m_common;
+};
+
+template <typename T> using flat_str_map = basic_flat_str_map<T, char>;
+template <typename T> using wflat_str_map = basic_flat_str_map<T, wchar_t>;
+template <typename T> using u16flat_str_map = basic_flat_str_map<T, char16_t>;
+template <typename T> using u32flat_str_map = basic_flat_str_map<T, char32_t>;
+
+template <typename T, typename CharT, typename Traits>
+constexpr typename basic_flat_str_map<T, CharT, Traits>::size_type basic_flat_str_map<T, CharT, Traits>::npos;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Iterator over the entries in key order
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename T, typename CharT, typename Traits> struct basic_flat_str_map<T, CharT, Traits>::const_iterator
+{
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename basic_flat_str_map::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = typename basic_flat_str_map::reference;
+    using pointer = void;
+
+    const_iterator() noexcept : m_map(nullptr), m_rank(0)
+    {
+    }
+
+    const_iterator(const basic_flat_str_map *map, size_type rank) noexcept : m_map(map), m_rank(rank)
+    {
+    }
+
+    view_type key() const noexcept
+    {
+        return m_map->key(m_rank);
+    }
+
+    const T &value() const noexcept
+    {
+        return m_map->value(m_rank);
+    }
+
+    size_type rank() const noexcept
+    {
+        return m_rank;
+    }
+
+    reference operator*() const noexcept
+    {
+        return reference(key(), value());
+    }
+
+    const_iterator &operator++() noexcept
+    {
+        ++m_rank;
+        return *this;
+    }
+
+    const_iterator operator++(int) noexcept
+    {
+        const_iterator copy = *this;
+        ++m_rank;
+        return copy;
+    }
+
+    const_iterator &operator--() noexcept
+    {
+        --m_rank;
+        return *this;
+    }
+
+    const_iterator operator--(int) noexcept
+    {
+        const_iterator copy = *this;
+        --m_rank;
+        return copy;
+    }
+
+    const_iterator &operator+=(difference_type d) noexcept
+    {
+        m_rank += d;
+        return *this;
+    }
+
+    const_iterator operator+(difference_type d) const noexcept
+    {
+        return const_iterator(m_map, m_rank + d);
+    }
+
+    difference_type operator-(const const_iterator &other) const noexcept
+    {
+        return static_cast<difference_type>(m_rank) - static_cast<difference_type>(other.m_rank);
+    }
+
+    bool operator==(const const_iterator &other) const noexcept
+    {
+        return m_rank == other.m_rank && m_map == other.m_map;
+    }
+
+    bool operator!=(const const_iterator &other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+    bool operator<(const const_iterator &other) const noexcept
+    {
+        return m_rank < other.m_rank;
+    }
+
+  private:
+    const basic_flat_str_map *m_map;
+    size_type m_rank;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Construction
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename T, typename CharT, typename Traits>
+inline basic_flat_str_map<T, CharT, Traits>::basic_flat_str_map() : m_offsets(1, 0), m_common(0)
+{
+}
+
+template <typename T, typename CharT, typename Traits>
+template <typename InputIt>
+inline basic_flat_str_map<T, CharT, Traits>::basic_flat_str_map(InputIt first, InputIt last) : m_common(0)
+{
+    std::vector<value_type> entries;
+    for (; first != last; ++first)
+    {
+        entries.emplace_back(view_type((*first).first), (*first).second);
+    }
+    build(entries);
+}
+
+template <typename T, typename CharT, typename Traits>
+inline basic_flat_str_map<T, CharT, Traits>::basic_flat_str_map(std::initializer_list<value_type> entries)
+    : m_common(0)
+{
+    std::vector<value_type> copy(entries.begin(), entries.end());
+    build(copy);
+}
+
+template <typename T, typename CharT, typename Traits>
+inline void basic_flat_str_map<T, CharT, Traits>::build(std::vector<value_type> &entries)
+{
+    const size_type n = entries.size();
+    std::vector<size_type> order(n);
+    for (size_type i = 0; i < n; ++i)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(),
+              [&](size_type a, size_type b) { return entries[a].first.compare(entries[b].first) < 0; });
+
+    size_type total = 0;
+    for (size_type i = 0; i < n; ++i)
+    {
+        if (i != 0 && entries[order[i - 1]].first.equals(entries[order[i]].first))
+        {
+            throw std::invalid_argument("Duplicate key in lambda::flat_str_map");
+        }
+        total += entries[order[i]].first.size();
+    }
+
+    m_chars.resize(total);
+    m_offsets.resize(n + 1);
+    m_values.reserve(n);
+    size_type offset = 0;
+    for (size_type i = 0; i < n; ++i)
+    {
+        const view_type k = entries[order[i]].first;
+        m_offsets[i] = offset;
+        k.copy(m_chars.data() + offset, k.size());
+        offset += k.size();
+        m_values.push_back(std::move(entries[order[i]].second));
+    }
+    m_offsets[n] = offset;
+
+    // Sorted, so the first and the last key share the prefix of them all.
+    if (n != 0)
+    {
+        const view_type lo = key(0);
+        const view_type hi = key(n - 1);
+        while (m_common < lo.size() && m_common < hi.size() && Traits::eq(lo[m_common], hi[m_common]))
+        {
+            ++m_common;
+        }
+    }
+
+    m_tree_prefixes.assign(n + 1, 0);
+    m_tree_ranks.assign(n + 1, n);
+    fill_tree(1, 0);
+}
+
+/// In-order walk of the implicit tree: the ranks come out sorted. The depth is log2(n).
+template <typename T, typename CharT, typename Traits>
+inline typename basic_flat_str_map<T, CharT, Traits>::size_type basic_flat_str_map<T, CharT, Traits>::fill_tree(
+    size_type node, size_type rank)
+{
+    if (node >= m_tree_ranks.size())
+    {
+        return rank;
+    }
+    rank = fill_tree(2 * node, rank);
+    m_tree_ranks[node] = rank;
+    m_tree_prefixes[node] = normalized_prefix(key(rank).drop(m_common));
+    return fill_tree(2 * node + 1, rank + 1);
+}
+
+template <typename T, typename CharT, typename Traits>
+inline uint64_t basic_flat_str_map<T, CharT, Traits>::normalized_prefix(view_type v) noexcept
+{
+    return utility::_ordered_units_<CharT, Traits>::value ? utility::_prefix_key_(v.data(), v.size()) : 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Access
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename T, typename CharT, typename Traits>
+inline typename basic_flat_str_map<T, CharT, Traits>::size_type basic_flat_str_map<T, CharT, Traits>::size()
+    const noexcept
+{
+    return m_values.size();
+}
+
+template <typename T, typename CharT, typename Traits>
+inline bool basic_flat_str_map<T, CharT, Traits>::empty() const noexcept
+{
+    return m_values.empty();
+}
+
+template <typename T, typename CharT, typename Traits>
+inline basic_str_view<CharT, Traits> basic_flat_str_map<T, CharT, Traits>::key(size_type i) const noexcept
+{
+    return view_type(m_chars.data() + m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+}
+
+template <typename T, typename CharT, typename Traits>
+inline const T &basic_flat_str_map<T, CharT, Traits>::value(size_type i) const noexcept
+{
+    return m_values[i];
+}
+
+template <typename T, typename CharT, typename Traits>
+inline T &basic_flat_str_map<T, CharT, Traits>::value(size_type i) noexcept
+{
+    return m_values[i];
+}
+
+template <typename T, typename CharT, typename Traits>
+inline basic_str_view<CharT, Traits> basic_flat_str_map<T, CharT, Traits>::common_prefix() const noexcept
+{
+    return empty() ? view_type() : key(0).first(m_common);
+}
+
+template <typename T, typename CharT, typename Traits>
+inline typename basic_flat_str_map<T, CharT, Traits>::const_iterator basic_flat_str_map<T, CharT, Traits>::begin()
+    const noexcept
+{
+    return const_iterator(this, 0);
+}
+
+template <typename T, typename CharT, typename Traits>
+inline typename basic_flat_str_map<T, CharT, Traits>::const_iterator basic_flat_str_map<T, CharT, Traits>::end()
+    const noexcept
+{
+    return const_iterator(this, size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Search
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename T, typename CharT, typename Traits>
+inline typename basic_flat_str_map<T, CharT, Traits>::size_type basic_flat_str_map<T, CharT, Traits>::
+    lower_bound_rank(view_type probe) const noexcept
+{
+    const size_type n = size();
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    // Outside the shared prefix the probe sorts before or after every key.
+    const size_type p = std::min(m_common, probe.size());
+    const int c = probe.first(p).compare(key(0).first(p));
+    if (c != 0)
+    {
+        return c < 0 ? 0 : n;
+    }
+    if (probe.size() < m_common)
+    {
+        return 0;
+    }
+
+    const view_type rest = probe.drop(m_common);
+    const uint64_t prefix = normalized_prefix(rest);
+    const uint64_t *const prefixes = m_tree_prefixes.data();
+    size_type k = 1;
+    while (k <= n)
+    {
+        // The 16 descendants four levels down are adjacent; fetch them while this level is compared.
+        if (16 * k <= n)
+        {
+            LAMBDA_PREFETCH(prefixes + 16 * k);
+        }
+        const uint64_t node = prefixes[k];
+        const bool less = node != prefix ? node < prefix : key(m_tree_ranks[k]).drop(m_common).compare(rest) < 0;
+        k = 2 * k + (less ? 1 : 0);
+    }
+
+    // The answer is the last node where the descent went left: strip the trailing right turns and that left turn.
+    k >>= simd::detail::_ctz_(static_cast<uint64_t>(~k)) + 1;
+    return k == 0 ? n : m_tree_ranks[k];
+}
+
+template <typename T, typename CharT, typename Traits>
+inline typename basic_flat_str_map<T, CharT, Traits>::const_iterator basic_flat_str_map<T, CharT, Traits>::
+    lower_bound(view_type key) const noexcept
+{
+    return const_iterator(this, lower_bound_rank(key));
+}
+
+template <typename T, typename CharT, typename Traits>
+inline typename basic_flat_str_map<T, CharT, Traits>::const_iterator basic_flat_str_map<T, CharT, Traits>::
+    upper_bound(view_type key) const noexcept
+{
+    return equal_range(key).second;
+}
+
+template <typename T, typename CharT, typename Traits>
+inline std::pair<typename basic_flat_str_map<T, CharT, Traits>::const_iterator,
+                 typename basic_flat_str_map<T, CharT, Traits>::const_iterator>
+basic_flat_str_map<T, CharT, Traits>::equal_range(view_type k) const noexcept
+{
+    const size_type lo = lower_bound_rank(k);
+    const size_type hi = lo < size() && key(lo).equals(k) ? lo + 1 : lo;
+    return std::make_pair(const_iterator(this, lo), const_iterator(this, hi));
+}
+
+template <typename T, typename CharT, typename Traits>
+inline std::pair<typename basic_flat_str_map<T, CharT, Traits>::const_iterator,
+                 typename basic_flat_str_map<T, CharT, Traits>::const_iterator>
+basic_flat_str_map<T, CharT, Traits>::prefix_range(view_type prefix) const noexcept
+{
+    const size_type n = size();
+    const size_type lo = lower_bound_rank(prefix);
+
+    if (lo == n || !key(lo).starts_with(prefix))
+    {
+        return std::make_pair(const_iterator(this, lo), const_iterator(this, lo));
+    }
+
+    // Gallop from lo until a key lacks the prefix, then bisect the last step; short scans stay near lo.
+    size_type good = lo;
+    size_type bad = n;
+    for (size_type step = 1; good + step < n; step *= 2)
+    {
+        if (!key(good + step).starts_with(prefix))
+        {
+            bad = good + step;
+            break;
+        }
+        good += step;
+    }
+    while (bad - good > 1)
+    {
+        const size_type mid = good + (bad - good) / 2;
+        if (key(mid).starts_with(prefix))
+        {
+            good = mid;
+        }
+        else
+        {
+            bad = mid;
+        }
+    }
+    return std::make_pair(const_iterator(this, lo), const_iterator(this, good + 1));
+}
+
+template <typename T, typename CharT, typename Traits>
+inline typename basic_flat_str_map<T, CharT, Traits>::const_iterator basic_flat_str_map<T, CharT, Traits>::find(
+    view_type k) const noexcept
+{
+    const size_type r = lower_bound_rank(k);
+    return r < size() && key(r).equals(k) ? const_iterator(this, r) : end();
+}
+
+template <typename T, typename CharT, typename Traits>
+inline bool basic_flat_str_map<T, CharT, Traits>::contains(view_type k) const noexcept
+{
+    return find(k) != end();
+}
+
+template <typename T, typename CharT, typename Traits>
+inline typename basic_flat_str_map<T, CharT, Traits>::size_type basic_flat_str_map<T, CharT, Traits>::count(
+    view_type k) const noexcept
+{
+    return contains(k) ? 1 : 0;
+}
+
+template <typename T, typename CharT, typename Traits>
+inline const T &basic_flat_str_map<T, CharT, Traits>::at(view_type k) const
+{
+    const size_type r = find(k).rank();
+    if (r == size())
+    {
+        utility::_throw_out_of_range_("Key not found in lambda::flat_str_map::at");
+    }
+    return m_values[r];
+}
+
+template <typename T, typename CharT, typename Traits>
+inline T &basic_flat_str_map<T, CharT, Traits>::at(view_type k)
+{
+    const size_type r = find(k).rank();
+    if (r == size())
+    {
+        utility::_throw_out_of_range_("Key not found in lambda::flat_str_map::at");
+    }
+    return m_values[r];
+}
+
+} // namespace lambda
+
+#endif
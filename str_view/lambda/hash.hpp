@@ -0,0 +1,240 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Seedable wyhash-style hashing of code unit sequences, usable at compile time
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ *
+ * The hash is defined over the little-endian byte representation of the code units, so the constexpr evaluation and
+ * the runtime (memcpy based) evaluation give the same value on every target.
+ */
+
+#ifndef STR_VIEW_HASH_H
+#define STR_VIEW_HASH_H
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace lambda
+{
+namespace hashing
+{
+
+/// <summary>
+/// Seed used by std::hash and when no seed is given.
+/// </summary>
+static constexpr uint64_t default_seed = 0;
+
+namespace detail
+{
+
+inline constexpr uint64_t _secret_(size_t i) noexcept
+{
+    return i == 0 ? 0x2d358dccaa6c78a5ull
+                  : (i == 1 ? 0x8bb84b93962eacc9ull : (i == 2 ? 0x4b33a62ed433d4a3ull : 0x4d5a2da51de1aa47ull));
+}
+
+/// <summary>
+/// 64x64 -> 128 bit multiply; a receives the low half, b the high half.
+/// </summary>
+inline constexpr void _mum_(uint64_t &a, uint64_t &b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    const uint128 r = static_cast<uint128>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+#else
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        uint64_t hi = 0;
+        a = _umul128(a, b, &hi);
+        b = hi;
+        return;
+    }
+#endif
+    const uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    uint64_t carry = t < rl ? 1 : 0;
+    const uint64_t lo = t + (rm1 << 32);
+    carry += lo < t ? 1 : 0;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+inline constexpr uint64_t _mix_(uint64_t a, uint64_t b) noexcept
+{
+    _mum_(a, b);
+    return a ^ b;
+}
+
+/// <summary>
+/// Reads the little-endian bytes of the code units one by one. Constant evaluable.
+/// </summary>
+template <typename CharT> struct _unit_reader_
+{
+    using unit_type = typename std::make_unsigned<CharT>::type;
+
+    const CharT *p;
+
+    constexpr uint64_t byte(size_t i) const noexcept
+    {
+        return (static_cast<uint64_t>(static_cast<unit_type>(p[i / sizeof(CharT)])) >> (8 * (i % sizeof(CharT)))) &
+               0xffu;
+    }
+    constexpr uint64_t r4(size_t i) const noexcept
+    {
+        return byte(i) | (byte(i + 1) << 8) | (byte(i + 2) << 16) | (byte(i + 3) << 24);
+    }
+    constexpr uint64_t r8(size_t i) const noexcept
+    {
+        return r4(i) | (r4(i + 4) << 32);
+    }
+};
+
+/// <summary>
+/// Reads 4 / 8 bytes at a time straight from memory. Only equivalent to _unit_reader_ on little-endian targets.
+/// </summary>
+struct _memory_reader_
+{
+    const unsigned char *p;
+
+    uint64_t byte(size_t i) const noexcept
+    {
+        return p[i];
+    }
+    uint64_t r4(size_t i) const noexcept
+    {
+        uint32_t v;
+        std::memcpy(&v, p + i, sizeof(v));
+        return v;
+    }
+    uint64_t r8(size_t i) const noexcept
+    {
+        uint64_t v;
+        std::memcpy(&v, p + i, sizeof(v));
+        return v;
+    }
+};
+
+/// <summary>
+/// wyhash (final version 4) over len bytes. Processes 48 bytes per round in three independent lanes.
+/// </summary>
+template <typename Reader> inline constexpr uint64_t _wyhash_(const Reader &r, size_t len, uint64_t seed) noexcept
+{
+    seed ^= _mix_(seed ^ _secret_(0), _secret_(1));
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            const size_t q = (len >> 3) << 2;
+            a = (r.r4(0) << 32) | r.r4(q);
+            b = (r.r4(len - 4) << 32) | r.r4(len - 4 - q);
+        }
+        else if (len > 0)
+        {
+            a = (r.byte(0) << 16) | (r.byte(len >> 1) << 8) | r.byte(len - 1);
+        }
+    }
+    else
+    {
+        size_t p = 0;
+        size_t i = len;
+        if (i > 48)
+        {
+            uint64_t see1 = seed;
+            uint64_t see2 = seed;
+            do
+            {
+                seed = _mix_(r.r8(p) ^ _secret_(1), r.r8(p + 8) ^ seed);
+                see1 = _mix_(r.r8(p + 16) ^ _secret_(2), r.r8(p + 24) ^ see1);
+                see2 = _mix_(r.r8(p + 32) ^ _secret_(3), r.r8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = _mix_(r.r8(p) ^ _secret_(1), r.r8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = r.r8(p + i - 16);
+        b = r.r8(p + i - 8);
+    }
+
+    a ^= _secret_(1);
+    b ^= seed;
+    _mum_(a, b);
+    return _mix_(a ^ _secret_(0) ^ len, b ^ _secret_(1));
+}
+
+template <typename CharT> inline uint64_t _runtime_hash_(const CharT *s, size_t count, uint64_t seed) noexcept
+{
+#if LAMBDA_LITTLE_ENDIAN
+    return _wyhash_(_memory_reader_{reinterpret_cast<const unsigned char *>(s)}, count * sizeof(CharT), seed);
+#else
+    return _wyhash_(_unit_reader_<CharT>{s}, count * sizeof(CharT), seed);
+#endif
+}
+
+} // namespace detail
+
+/// <summary>
+/// Hashes the code units [s, s + count). Gives the same value in constant evaluation and at runtime.
+/// </summary>
+/// <param name="s"></param>
+/// <param name="count"></param>
+/// <param name="seed"></param>
+/// <returns></returns>
+template <typename CharT>
+inline constexpr uint64_t wyhash(const CharT *s, size_t count, uint64_t seed = default_seed) noexcept
+{
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return detail::_runtime_hash_(s, count, seed);
+    }
+    return detail::_wyhash_(detail::_unit_reader_<CharT>{s}, count * sizeof(CharT), seed);
+}
+
+} // namespace hashing
+} // namespace lambda
+
+#endif
@@ -0,0 +1,473 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Opt-in per-thread counters for basic_str_view operations
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_INSTRUMENT_H
+#define STR_VIEW_INSTRUMENT_H
+
+#include "config.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace lambda
+{
+namespace instrument
+{
+
+/// <summary>
+/// Instrumented basic_str_view operations. Overloads share one entry (find(CharT), find(view) and find(searcher) are
+/// all op::find), and an operation called from inside another one is attributed to the outer one.
+/// </summary>
+enum class op : unsigned
+{
+    find,
+    rfind,
+    find_first_of,
+    find_last_of,
+    find_first_not_of,
+    find_last_not_of,
+    compare,
+    equals,
+    starts_with,
+    ends_with,
+    substr,
+    at,
+    copy
+};
+
+constexpr size_t op_count = 13;
+constexpr size_t size_buckets = 32;
+
+/// <summary>
+/// Histogram bucket of a size: bucket 0 holds 0, bucket b holds [2^(b-1), 2^b), the last bucket everything larger.
+/// </summary>
+constexpr size_t size_bucket(size_t n) noexcept
+{
+    size_t b = 0;
+    while (n != 0 && b + 1 < size_buckets)
+    {
+        n >>= 1;
+        ++b;
+    }
+    return b;
+}
+
+/// <summary>
+/// Counters of one operation.
+///  - units: sum of the view sizes, so units / calls is the mean haystack length. A quadratic find loop shows up as
+///    units far above the bytes the program actually handles.
+///  - sizes: histogram of the view sizes.
+///  - arguments: histogram of the second size, the needle or other operand length (1 for a character), the requested
+///    count for substr and copy, and the index for at.
+///  - cycles: time stamp counter ticks spent inside the operation (steady_clock nanoseconds on other targets).
+/// </summary>
+struct op_counters
+{
+    uint64_t calls;
+    uint64_t throws;
+    uint64_t cycles;
+    uint64_t units;
+    uint64_t sizes[size_buckets];
+    uint64_t arguments[size_buckets];
+};
+
+/// <summary>
+/// Copy of the counters of every operation.
+/// </summary>
+struct snapshot
+{
+    op_counters ops[op_count];
+
+    const op_counters &operator[](op o) const noexcept;
+    snapshot &operator+=(const snapshot &other) noexcept;
+
+    /// <summary>
+    /// Writes a header line and one line per operation that was called:
+    /// op,calls,throws,cycles,units,size_0..size_31,arg_0..arg_31
+    /// </summary>
+    void write_csv(std::ostream &os) const;
+};
+
+/// <summary>
+/// Name of an operation as written by write_csv.
+/// </summary>
+inline const char *name(op o) noexcept;
+
+/// <summary>
+/// Counters of the calling thread.
+/// </summary>
+inline snapshot thread_snapshot() noexcept;
+
+/// <summary>
+/// Sum of the counters of every running thread and of every thread that has exited. Safe to call while other threads
+/// are counting; their in-flight updates may or may not be included.
+/// </summary>
+inline snapshot global_snapshot();
+
+/// <summary>
+/// Clears the counters of the calling thread.
+/// </summary>
+inline void reset() noexcept;
+
+/// <summary>
+/// Time stamp counter where the target has one that is cheap to read, steady_clock nanoseconds otherwise.
+/// </summary>
+inline uint64_t ticks() noexcept;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Hooks called by basic_str_view when LAMBDA_STR_VIEW_INSTRUMENT is defined
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct probe
+{
+    uint64_t start;
+    op which;
+    bool outer;
+};
+
+/// <summary>
+/// Counts a call of o on a view of n units with second size m and starts its clock, unless another operation is
+/// already running on this thread.
+/// </summary>
+inline probe enter(op o, size_t n, size_t m) noexcept;
+
+/// <summary>
+/// Stops the clock started by enter.
+/// </summary>
+inline void leave(const probe &p) noexcept;
+
+/// <summary>
+/// Counts a throw of the running operation, which then never reaches leave.
+/// </summary>
+inline void on_throw() noexcept;
+
+namespace detail
+{
+
+/// Only the owning thread writes its counters, so a relaxed load and store does; other threads only read them.
+struct _atomic_counters_
+{
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> throws;
+    std::atomic<uint64_t> cycles;
+    std::atomic<uint64_t> units;
+    std::atomic<uint64_t> sizes[size_buckets];
+    std::atomic<uint64_t> arguments[size_buckets];
+};
+
+inline void _bump_(std::atomic<uint64_t> &c, uint64_t by) noexcept
+{
+    c.store(c.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+inline uint64_t _read_(const std::atomic<uint64_t> &c) noexcept
+{
+    return c.load(std::memory_order_relaxed);
+}
+
+struct _thread_counters_;
+
+struct _registry_
+{
+    std::mutex lock;
+    std::vector<const _thread_counters_ *> live;
+    snapshot retired;
+};
+
+inline _registry_ &_registry_instance_()
+{
+    static _registry_ registry{};
+    return registry;
+}
+
+/// An aggregate, value initialized by the thread_local below: that is constant initialization both with the trivial
+/// std::atomic constructor before C++20 and the constexpr one after, so reaching it takes no initialization guard.
+struct _thread_counters_
+{
+    _atomic_counters_ ops[op_count];
+    unsigned depth;
+    op current;
+    bool registered;
+
+    snapshot read() const noexcept
+    {
+        snapshot s{};
+        for (size_t i = 0; i < op_count; ++i)
+        {
+            s.ops[i].calls = _read_(ops[i].calls);
+            s.ops[i].throws = _read_(ops[i].throws);
+            s.ops[i].cycles = _read_(ops[i].cycles);
+            s.ops[i].units = _read_(ops[i].units);
+            for (size_t b = 0; b < size_buckets; ++b)
+            {
+                s.ops[i].sizes[b] = _read_(ops[i].sizes[b]);
+                s.ops[i].arguments[b] = _read_(ops[i].arguments[b]);
+            }
+        }
+        return s;
+    }
+};
+
+/// Lists the counters of a thread in the registry, and moves them into the retired total when the thread exits. The
+/// registration runs inside noexcept operations, so when the lock or the allocation fails the thread is left unlisted
+/// instead, and its operations go uncounted.
+struct _registration_
+{
+    const _thread_counters_ *counters;
+    bool listed;
+
+    explicit _registration_(const _thread_counters_ *c) noexcept : counters(c), listed(false)
+    {
+        try
+        {
+            _registry_ &r = _registry_instance_();
+            std::lock_guard<std::mutex> guard(r.lock);
+            r.live.push_back(counters);
+            listed = true;
+        }
+        catch (...)
+        {
+        }
+    }
+
+    ~_registration_()
+    {
+        if (!listed)
+        {
+            return;
+        }
+        _registry_ &r = _registry_instance_();
+        std::lock_guard<std::mutex> guard(r.lock);
+        r.retired += counters->read();
+        for (size_t i = 0; i < r.live.size(); ++i)
+        {
+            if (r.live[i] == counters)
+            {
+                r.live[i] = r.live.back();
+                r.live.pop_back();
+                break;
+            }
+        }
+    }
+
+    _registration_(const _registration_ &) = delete;
+    _registration_ &operator=(const _registration_ &) = delete;
+};
+
+inline _thread_counters_ &_local_() noexcept
+{
+    static thread_local _thread_counters_ counters{};
+    return counters;
+}
+
+/// Called on the first counted operation of a thread, and on every later one if the registration failed. Returns
+/// whether the thread is counted.
+LAMBDA_NOINLINE inline bool _register_(_thread_counters_ &t) noexcept
+{
+    static thread_local _registration_ registration(&t);
+    t.registered = registration.listed;
+    return t.registered;
+}
+
+} // namespace detail
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+inline const op_counters &snapshot::operator[](op o) const noexcept
+{
+    return ops[static_cast<unsigned>(o)];
+}
+
+inline snapshot &snapshot::operator+=(const snapshot &other) noexcept
+{
+    for (size_t i = 0; i < op_count; ++i)
+    {
+        ops[i].calls += other.ops[i].calls;
+        ops[i].throws += other.ops[i].throws;
+        ops[i].cycles += other.ops[i].cycles;
+        ops[i].units += other.ops[i].units;
+        for (size_t b = 0; b < size_buckets; ++b)
+        {
+            ops[i].sizes[b] += other.ops[i].sizes[b];
+            ops[i].arguments[b] += other.ops[i].arguments[b];
+        }
+    }
+    return *this;
+}
+
+inline void snapshot::write_csv(std::ostream &os) const
+{
+    os << "op,calls,throws,cycles,units";
+    for (size_t b = 0; b < size_buckets; ++b)
+    {
+        os << ",size_" << b;
+    }
+    for (size_t b = 0; b < size_buckets; ++b)
+    {
+        os << ",arg_" << b;
+    }
+    os << '\n';
+
+    for (size_t i = 0; i < op_count; ++i)
+    {
+        const op_counters &c = ops[i];
+        if (c.calls == 0)
+        {
+            continue;
+        }
+        os << name(static_cast<op>(i)) << ',' << c.calls << ',' << c.throws << ',' << c.cycles << ',' << c.units;
+        for (size_t b = 0; b < size_buckets; ++b)
+        {
+            os << ',' << c.sizes[b];
+        }
+        for (size_t b = 0; b < size_buckets; ++b)
+        {
+            os << ',' << c.arguments[b];
+        }
+        os << '\n';
+    }
+}
+
+inline const char *name(op o) noexcept
+{
+    static const char *const names[op_count] = {"find",    "rfind",       "find_first_of", "find_last_of",
+                                                "find_first_not_of", "find_last_not_of", "compare", "equals",
+                                                "starts_with", "ends_with", "substr", "at", "copy"};
+    return static_cast<unsigned>(o) < op_count ? names[static_cast<unsigned>(o)] : "";
+}
+
+inline snapshot thread_snapshot() noexcept
+{
+    return detail::_local_().read();
+}
+
+inline snapshot global_snapshot()
+{
+    detail::_registry_ &r = detail::_registry_instance_();
+    std::lock_guard<std::mutex> guard(r.lock);
+    snapshot s = r.retired;
+    for (const detail::_thread_counters_ *t : r.live)
+    {
+        s += t->read();
+    }
+    return s;
+}
+
+inline void reset() noexcept
+{
+    detail::_thread_counters_ &t = detail::_local_();
+    for (detail::_atomic_counters_ &c : t.ops)
+    {
+        c.calls.store(0, std::memory_order_relaxed);
+        c.throws.store(0, std::memory_order_relaxed);
+        c.cycles.store(0, std::memory_order_relaxed);
+        c.units.store(0, std::memory_order_relaxed);
+        for (size_t b = 0; b < size_buckets; ++b)
+        {
+            c.sizes[b].store(0, std::memory_order_relaxed);
+            c.arguments[b].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+inline uint64_t ticks() noexcept
+{
+#if (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t v;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+inline probe enter(op o, size_t n, size_t m) noexcept
+{
+    detail::_thread_counters_ &t = detail::_local_();
+    if (t.depth++ != 0)
+    {
+        return probe{0, o, false};
+    }
+    if (!t.registered && !detail::_register_(t))
+    {
+        return probe{0, o, false};
+    }
+
+    detail::_atomic_counters_ &c = t.ops[static_cast<unsigned>(o)];
+    detail::_bump_(c.calls, 1);
+    detail::_bump_(c.units, n);
+    detail::_bump_(c.sizes[size_bucket(n)], 1);
+    detail::_bump_(c.arguments[size_bucket(m)], 1);
+    t.current = o;
+    return probe{ticks(), o, true};
+}
+
+inline void leave(const probe &p) noexcept
+{
+    detail::_thread_counters_ &t = detail::_local_();
+    --t.depth;
+    if (p.outer)
+    {
+        detail::_bump_(t.ops[static_cast<unsigned>(p.which)].cycles, ticks() - p.start);
+    }
+}
+
+/// Unwinding skips every leave of the running operations, so the nesting depth starts over.
+inline void on_throw() noexcept
+{
+    detail::_thread_counters_ &t = detail::_local_();
+    if (t.depth != 0)
+    {
+        detail::_bump_(t.ops[static_cast<unsigned>(t.current)].throws, 1);
+        t.depth = 0;
+    }
+}
+
+} // namespace instrument
+} // namespace lambda
+
+#endif
@@ -0,0 +1,240 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Thread-safe string intern pool handing out canonical str_view handles
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_INTERN_POOL_H
+#define STR_VIEW_INTERN_POOL_H
+
+#include "str_view.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace lambda
+{
+
+/// <summary>
+/// Interns strings: intern() copies a view's characters into the pool once and returns the canonical view for that
+/// content, so two interned views are equal exactly when their data() pointers are equal (see same()).
+///
+/// Characters are appended to large blocks (no allocation per string) and are null terminated. Nothing is released
+/// before the pool is destroyed, which keeps every returned view valid for the pool's lifetime.
+///
+/// find() and the hit path of intern() are lock-free: they probe an open addressing table of atomic entry pointers.
+/// Inserts are serialized by a mutex and publish entries with release stores. When the table grows, the new table
+/// is published atomically and the old one is retired (kept alive) so concurrent readers never see freed memory.
+/// </summary>
+template <typename CharT, typename Traits = std::char_traits<CharT>> struct basic_intern_pool
+{
+    static_assert(utility::_bitwise_traits_<CharT, Traits>::value,
+                  "basic_intern_pool hashes raw code units and needs std::char_traits");
+
+    using view_type = basic_str_view<CharT, Traits>;
+    using size_type = size_t;
+
+    /// <summary>
+    /// Constructs an empty pool. Characters are stored in arena blocks of block_size code units.
+    /// </summary>
+    /// <param name="block_size"></param>
+    explicit basic_intern_pool(size_type block_size = 64 * 1024 / sizeof(CharT));
+
+    basic_intern_pool(const basic_intern_pool &) = delete;
+    basic_intern_pool &operator=(const basic_intern_pool &) = delete;
+
+    /// <summary>
+    /// Returns the canonical view for v's content, copying it into the pool the first time. Thread safe.
+    /// </summary>
+    /// <param name="v"></param>
+    /// <returns></returns>
+    view_type intern(view_type v);
+
+    /// <summary>
+    /// Returns the canonical view for v's content, or an empty view with data() == nullptr if v was never interned.
+    /// Lock-free.
+    /// </summary>
+    /// <param name="v"></param>
+    /// <returns></returns>
+    view_type find(view_type v) const noexcept;
+
+    /// <summary>
+    /// Number of distinct strings in the pool.
+    /// </summary>
+    /// <returns></returns>
+    size_type size() const noexcept;
+
+    /// <summary>
+    /// O(1) equality of two views returned by the same pool.
+    /// </summary>
+    static bool same(view_type a, view_type b) noexcept;
+
+  private:
+    struct entry
+    {
+        view_type view;
+        uint64_t hash;
+    };
+
+    struct table
+    {
+        explicit table(size_type capacity);
+
+        size_type mask;
+        std::unique_ptr<std::atomic<const entry *>[]> slots;
+    };
+
+    const entry *lookup(const table &t, view_type v, uint64_t h) const noexcept;
+    static void place(table &t, const entry *e) noexcept;
+
+    std::atomic<table *> m_table;
+    std::atomic<size_type> m_count;
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<table>> m_tables;
+    std::deque<entry> m_entries;
+    monotonic_arena m_arena;
+};
+
+using intern_pool = basic_intern_pool<char>;
+using wintern_pool = basic_intern_pool<wchar_t>;
+using u16intern_pool = basic_intern_pool<char16_t>;
+using u32intern_pool = basic_intern_pool<char32_t>;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits>
+inline basic_intern_pool<CharT, Traits>::table::table(size_type capacity)
+    : mask(capacity - 1), slots(new std::atomic<const entry *>[capacity])
+{
+    for (size_type i = 0; i < capacity; ++i)
+    {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template <typename CharT, typename Traits>
+inline basic_intern_pool<CharT, Traits>::basic_intern_pool(size_type block_size)
+    : m_table(nullptr), m_count(0), m_arena((block_size ? block_size : 1) * sizeof(CharT))
+{
+    m_tables.emplace_back(new table(64));
+    m_table.store(m_tables.back().get(), std::memory_order_release);
+}
+
+template <typename CharT, typename Traits>
+inline const typename basic_intern_pool<CharT, Traits>::entry *basic_intern_pool<CharT, Traits>::lookup(
+    const table &t, view_type v, uint64_t h) const noexcept
+{
+    for (size_type i = static_cast<size_type>(h) & t.mask;; i = (i + 1) & t.mask)
+    {
+        const entry *e = t.slots[i].load(std::memory_order_acquire);
+        if (e == nullptr)
+        {
+            return nullptr;
+        }
+        if (e->hash == h && e->view == v)
+        {
+            return e;
+        }
+    }
+}
+
+template <typename CharT, typename Traits>
+inline void basic_intern_pool<CharT, Traits>::place(table &t, const entry *e) noexcept
+{
+    size_type i = static_cast<size_type>(e->hash) & t.mask;
+    while (t.slots[i].load(std::memory_order_relaxed) != nullptr)
+    {
+        i = (i + 1) & t.mask;
+    }
+    t.slots[i].store(e, std::memory_order_release);
+}
+
+template <typename CharT, typename Traits>
+inline typename basic_intern_pool<CharT, Traits>::view_type basic_intern_pool<CharT, Traits>::find(
+    view_type v) const noexcept
+{
+    const entry *e = lookup(*m_table.load(std::memory_order_acquire), v, hash_value(v));
+    return e ? e->view : view_type();
+}
+
+template <typename CharT, typename Traits>
+inline typename basic_intern_pool<CharT, Traits>::view_type basic_intern_pool<CharT, Traits>::intern(view_type v)
+{
+    const uint64_t h = hash_value(v);
+    if (const entry *e = lookup(*m_table.load(std::memory_order_acquire), v, h))
+    {
+        return e->view;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    table *t = m_table.load(std::memory_order_relaxed);
+    if (const entry *e = lookup(*t, v, h))
+    {
+        return e->view;
+    }
+
+    const size_type count = m_count.load(std::memory_order_relaxed) + 1;
+    if (2 * count > t->mask + 1)
+    {
+        m_tables.emplace_back(new table(2 * (t->mask + 1)));
+        t = m_tables.back().get();
+        for (const entry &old : m_entries)
+        {
+            place(*t, &old);
+        }
+        m_table.store(t, std::memory_order_release);
+    }
+
+    m_entries.push_back(entry{v.materialize(m_arena), h});
+    place(*t, &m_entries.back());
+    m_count.store(count, std::memory_order_release);
+
+    return m_entries.back().view;
+}
+
+template <typename CharT, typename Traits>
+inline typename basic_intern_pool<CharT, Traits>::size_type basic_intern_pool<CharT, Traits>::size() const noexcept
+{
+    return m_count.load(std::memory_order_acquire);
+}
+
+template <typename CharT, typename Traits>
+inline bool basic_intern_pool<CharT, Traits>::same(view_type a, view_type b) noexcept
+{
+    return a.data() == b.data();
+}
+
+} // namespace lambda
+
+#endif
@@ -0,0 +1,491 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Read-only memory mapped file exposed as a str_view
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_MAPPED_FILE_H
+#define STR_VIEW_MAPPED_FILE_H
+
+#include "str_view.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+
+#if defined(_WIN32)
+// Without the min/max macros, and without winsock.h, which would clash with a later winsock2.h (segmented_view.hpp).
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#define LAMBDA_UNDEF_NOMINMAX
+#endif
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#define LAMBDA_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#if defined(LAMBDA_UNDEF_WIN32_LEAN_AND_MEAN)
+#undef WIN32_LEAN_AND_MEAN
+#undef LAMBDA_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#if defined(LAMBDA_UNDEF_NOMINMAX)
+#undef NOMINMAX
+#undef LAMBDA_UNDEF_NOMINMAX
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lambda
+{
+
+/// <summary>
+/// How the mapping is going to be read; forwarded to madvise() / the Windows file cache.
+/// </summary>
+enum class access_hint
+{
+    normal,
+    sequential,
+    random
+};
+
+/// <summary>
+/// Options for mapped_file::open().
+///  - populate  : fault the whole file in up front (MAP_POPULATE on Linux, a full prefetch elsewhere).
+///  - huge_pages: ask for transparent huge pages (MADV_HUGEPAGE). Only Linux file systems with file THP support
+///                honour it; it is a no-op everywhere else.
+/// </summary>
+struct map_options
+{
+    access_hint hint = access_hint::normal;
+    bool populate = false;
+    bool huge_pages = false;
+};
+
+/// <summary>
+/// Read-only, move-only mapping of a whole file. view() exposes the bytes without copying them; views stay valid until
+/// the mapped_file is closed or destroyed. Errors are reported with std::system_error. An empty file maps to an empty
+/// view.
+///
+///     lambda::mapped_file file("access.log", {lambda::access_hint::sequential});
+///     for (auto line : lambda::split(file.view(), '\n')) { ... }
+/// </summary>
+struct mapped_file
+{
+    using size_type = size_t;
+
+    mapped_file() noexcept;
+    explicit mapped_file(const char *path, const map_options &opt = map_options());
+#if defined(_WIN32)
+    explicit mapped_file(const wchar_t *path, const map_options &opt = map_options());
+#endif
+
+    mapped_file(mapped_file &&other) noexcept;
+    mapped_file &operator=(mapped_file &&other) noexcept;
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    ~mapped_file();
+
+    /// <summary>
+    /// Maps path, closing the current mapping first.
+    /// </summary>
+    /// <param name="path"></param>
+    /// <param name="opt"></param>
+    void open(const char *path, const map_options &opt = map_options());
+#if defined(_WIN32)
+    void open(const wchar_t *path, const map_options &opt = map_options());
+#endif
+
+    void close() noexcept;
+
+    bool is_open() const noexcept;
+    const char *data() const noexcept;
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+
+    /// <summary>
+    /// The whole file.
+    /// </summary>
+    str_view view() const noexcept;
+
+    /// <summary>
+    /// Changes the access pattern hint for the whole mapping. Best effort.
+    /// </summary>
+    void advise(access_hint hint) const noexcept;
+
+    /// <summary>
+    /// Asks the OS to start reading [offset, offset + count) ahead of use (MADV_WILLNEED / PrefetchVirtualMemory).
+    /// Best effort; out of range parts are ignored.
+    /// </summary>
+    void prefetch(size_type offset = 0, size_type count = size_type(-1)) const noexcept;
+
+  private:
+    void swap(mapped_file &other) noexcept;
+    void apply(const map_options &opt) const noexcept;
+#if defined(_WIN32)
+    void map(const map_options &opt);
+#endif
+
+    const char *m_data;
+    size_type m_size;
+#if defined(_WIN32)
+    HANDLE m_file;
+    HANDLE m_mapping;
+#endif
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+inline mapped_file::mapped_file() noexcept
+    : m_data(nullptr), m_size(0)
+#if defined(_WIN32)
+      ,
+      m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+#endif
+{
+}
+
+inline mapped_file::mapped_file(const char *path, const map_options &opt) : mapped_file()
+{
+    open(path, opt);
+}
+
+inline mapped_file::mapped_file(mapped_file &&other) noexcept : mapped_file()
+{
+    swap(other);
+}
+
+inline mapped_file &mapped_file::operator=(mapped_file &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        swap(other);
+    }
+    return *this;
+}
+
+inline mapped_file::~mapped_file()
+{
+    close();
+}
+
+inline void mapped_file::swap(mapped_file &other) noexcept
+{
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+#if defined(_WIN32)
+    std::swap(m_file, other.m_file);
+    std::swap(m_mapping, other.m_mapping);
+#endif
+}
+
+inline bool mapped_file::is_open() const noexcept
+{
+#if defined(_WIN32)
+    return m_file != INVALID_HANDLE_VALUE;
+#else
+    // Empty files have no mapping; a non-null sentinel marks them open.
+    return m_data != nullptr;
+#endif
+}
+
+inline const char *mapped_file::data() const noexcept
+{
+    return m_size != 0 ? m_data : nullptr;
+}
+
+inline mapped_file::size_type mapped_file::size() const noexcept
+{
+    return m_size;
+}
+
+inline bool mapped_file::empty() const noexcept
+{
+    return m_size == 0;
+}
+
+inline str_view mapped_file::view() const noexcept
+{
+    return str_view(data(), m_size);
+}
+
+inline void mapped_file::apply(const map_options &opt) const noexcept
+{
+    if (opt.hint != access_hint::normal)
+    {
+        advise(opt.hint);
+    }
+#if defined(MADV_HUGEPAGE)
+    if (opt.huge_pages && m_size != 0)
+    {
+        ::madvise(const_cast<char *>(m_data), m_size, MADV_HUGEPAGE);
+    }
+#endif
+#if !defined(MAP_POPULATE)
+    if (opt.populate)
+    {
+        prefetch();
+    }
+#endif
+}
+
+#if defined(_WIN32)
+
+inline mapped_file::mapped_file(const wchar_t *path, const map_options &opt) : mapped_file()
+{
+    open(path, opt);
+}
+
+namespace detail
+{
+
+inline DWORD _map_flags_(access_hint hint) noexcept
+{
+    switch (hint)
+    {
+    case access_hint::sequential:
+        return FILE_FLAG_SEQUENTIAL_SCAN;
+    case access_hint::random:
+        return FILE_FLAG_RANDOM_ACCESS;
+    default:
+        return FILE_ATTRIBUTE_NORMAL;
+    }
+}
+
+[[noreturn]] inline void _throw_last_error_(const char *what)
+{
+    throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), what);
+}
+
+} // namespace detail
+
+inline void mapped_file::open(const char *path, const map_options &opt)
+{
+    close();
+    m_file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                           detail::_map_flags_(opt.hint), nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        detail::_throw_last_error_("lambda::mapped_file: cannot open file");
+    }
+    map(opt);
+}
+
+inline void mapped_file::open(const wchar_t *path, const map_options &opt)
+{
+    close();
+    m_file = ::CreateFileW(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                           detail::_map_flags_(opt.hint), nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        detail::_throw_last_error_("lambda::mapped_file: cannot open file");
+    }
+    map(opt);
+}
+
+inline void mapped_file::map(const map_options &opt)
+{
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(m_file, &size))
+    {
+        const DWORD error = ::GetLastError();
+        close();
+        throw std::system_error(static_cast<int>(error), std::system_category(), "lambda::mapped_file: cannot stat");
+    }
+    if (size.QuadPart == 0)
+    {
+        return;
+    }
+
+    m_mapping = ::CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void *view = m_mapping ? ::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr)
+    {
+        const DWORD error = ::GetLastError();
+        close();
+        throw std::system_error(static_cast<int>(error), std::system_category(), "lambda::mapped_file: cannot map");
+    }
+
+    m_data = static_cast<const char *>(view);
+    m_size = static_cast<size_type>(size.QuadPart);
+    apply(opt);
+    if (opt.populate)
+    {
+        prefetch();
+    }
+}
+
+inline void mapped_file::close() noexcept
+{
+    if (m_data != nullptr)
+    {
+        ::UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr)
+    {
+        ::CloseHandle(m_mapping);
+    }
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(m_file);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+}
+
+inline void mapped_file::advise(access_hint) const noexcept
+{
+    // Windows takes the access pattern when the file is opened (FILE_FLAG_SEQUENTIAL_SCAN / RANDOM_ACCESS).
+}
+
+inline void mapped_file::prefetch(size_type offset, size_type count) const noexcept
+{
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+    if (offset >= m_size)
+    {
+        return;
+    }
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<char *>(m_data + offset);
+    range.NumberOfBytes = count < m_size - offset ? count : m_size - offset;
+    ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+#else
+    (void)offset;
+    (void)count;
+#endif
+}
+
+#else
+
+namespace detail
+{
+
+/// <summary>
+/// Stands in for the data pointer of an open but empty file, which has no mapping.
+/// </summary>
+inline const char *_empty_mapping_() noexcept
+{
+    static const char empty = '\0';
+    return &empty;
+}
+
+} // namespace detail
+
+inline void mapped_file::open(const char *path, const map_options &opt)
+{
+    close();
+
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "lambda::mapped_file: cannot open file");
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "lambda::mapped_file: cannot stat");
+    }
+    if (st.st_size == 0)
+    {
+        ::close(fd);
+        m_data = detail::_empty_mapping_();
+        return;
+    }
+
+    int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+    if (opt.populate)
+    {
+        flags |= MAP_POPULATE;
+    }
+#endif
+    void *p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, flags, fd, 0);
+    const int error = errno;
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+    if (p == MAP_FAILED)
+    {
+        throw std::system_error(error, std::generic_category(), "lambda::mapped_file: cannot map");
+    }
+
+    m_data = static_cast<const char *>(p);
+    m_size = static_cast<size_type>(st.st_size);
+    apply(opt);
+}
+
+inline void mapped_file::close() noexcept
+{
+    if (m_size != 0)
+    {
+        ::munmap(const_cast<char *>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+inline void mapped_file::advise(access_hint hint) const noexcept
+{
+    if (m_size == 0)
+    {
+        return;
+    }
+    const int advice = hint == access_hint::sequential ? MADV_SEQUENTIAL
+                       : hint == access_hint::random   ? MADV_RANDOM
+                                                       : MADV_NORMAL;
+    ::madvise(const_cast<char *>(m_data), m_size, advice);
+}
+
+inline void mapped_file::prefetch(size_type offset, size_type count) const noexcept
+{
+    if (offset >= m_size)
+    {
+        return;
+    }
+
+    // madvise wants a page aligned start; the mapping itself is page aligned.
+    const size_type page = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+    const size_type begin = offset - offset % page;
+    const size_type end = count < m_size - offset ? offset + count : m_size;
+    ::madvise(const_cast<char *>(m_data + begin), end - begin, MADV_WILLNEED);
+}
+
+#endif
+
+} // namespace lambda
+
+#endif
@@ -0,0 +1,881 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Multi-needle search over a single pass of a str_view
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_MULTI_SEARCH_H
+#define STR_VIEW_MULTI_SEARCH_H
+
+#include "char_set.hpp"
+#include "simd.hpp"
+#include "str_view.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace lambda
+{
+
+/// <summary>
+/// One occurrence reported by a multi matcher: needle index (in construction order) and the position it starts at.
+/// Both are npos when there is no match.
+/// </summary>
+struct multi_match
+{
+    static constexpr size_t npos = size_t(-1);
+
+    size_t position;
+    size_t needle;
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return needle != npos;
+    }
+};
+
+constexpr size_t multi_match::npos;
+
+inline constexpr bool operator==(const multi_match &lhs, const multi_match &rhs) noexcept
+{
+    return lhs.position == rhs.position && lhs.needle == rhs.needle;
+}
+
+inline constexpr bool operator!=(const multi_match &lhs, const multi_match &rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+/// <summary>
+/// How basic_multi_matcher searches. automatic picks filtered below 64 needles and automaton otherwise.
+/// </summary>
+enum class multi_mode
+{
+    automatic,
+    /// SIMD scan for any first code unit of a needle, then verify the needles starting with that unit.
+    filtered,
+    /// Aho-Corasick automaton; one table lookup per byte regardless of the number of needles.
+    automaton
+};
+
+namespace detail
+{
+
+/// <summary>
+/// No state / no needle in the automaton tables.
+/// </summary>
+static constexpr uint32_t _ac_none_ = uint32_t(-1);
+
+/// <summary>
+/// After the build every transition holds the target row offset (state * classes), saving a multiply on the critical
+/// path, with the top bit set when the target state ends a needle or has a dictionary link.
+/// </summary>
+static constexpr uint32_t _ac_output_ = uint32_t(1) << 31;
+
+/// <summary>
+/// The automaton runs over the bytes of the code units (least significant first), so one 256 entry byte class table
+/// works for every CharT. Matches are only reported at whole code unit boundaries, which keeps them aligned.
+/// </summary>
+template <typename CharT> constexpr uint8_t _ac_byte_(CharT u, size_t k) noexcept
+{
+    return static_cast<uint8_t>(static_cast<typename std::make_unsigned<CharT>::type>(u) >> (8 * k));
+}
+
+struct _ac_tables_
+{
+    const uint16_t *cls;
+    const uint32_t *trans;
+    const uint32_t *out;
+    const uint32_t *dict;
+    size_t classes;
+};
+
+/// <summary>
+/// Maps every byte that occurs in a needle to its own class, all the others to class 0. Returns the class count.
+/// </summary>
+template <typename View> constexpr size_t _ac_classes_(const View *needles, size_t n, uint16_t *cls)
+{
+    using char_type = typename View::char_type;
+
+    for (size_t b = 0; b < 256; ++b)
+    {
+        cls[b] = 0;
+    }
+
+    size_t classes = 1;
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < needles[i].size(); ++j)
+        {
+            for (size_t k = 0; k < sizeof(char_type); ++k)
+            {
+                const uint8_t b = _ac_byte_(needles[i][j], k);
+                if (cls[b] == 0)
+                {
+                    cls[b] = static_cast<uint16_t>(classes++);
+                }
+            }
+        }
+    }
+    return classes;
+}
+
+/// <summary>
+/// Builds the trie and turns it into a full DFA in breadth first order. trans must hold states * classes zeros, the
+/// other arrays one entry per state, where states is at most 1 + the total needle size in bytes. Returns the number of
+/// states used.
+/// </summary>
+template <typename View>
+constexpr size_t _ac_build_(const View *needles, size_t n, const uint16_t *cls, size_t classes, uint32_t *trans,
+                            uint32_t *out, uint32_t *dict, uint32_t *fail, uint32_t *queue)
+{
+    using char_type = typename View::char_type;
+
+    size_t states = 1;
+    out[0] = _ac_none_;
+    dict[0] = _ac_none_;
+    fail[0] = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const View v = needles[i];
+        if (v.empty())
+        {
+            throw std::invalid_argument("Empty needle in lambda::multi_matcher");
+        }
+
+        uint32_t s = 0;
+        for (size_t j = 0; j < v.size(); ++j)
+        {
+            for (size_t k = 0; k < sizeof(char_type); ++k)
+            {
+                uint32_t &t = trans[s * classes + cls[_ac_byte_(v[j], k)]];
+                if (t == 0)
+                {
+                    t = static_cast<uint32_t>(states);
+                    out[states] = _ac_none_;
+                    dict[states] = _ac_none_;
+                    ++states;
+                }
+                s = t;
+            }
+        }
+
+        if (out[s] != _ac_none_)
+        {
+            throw std::invalid_argument("Duplicate needle in lambda::multi_matcher");
+        }
+        out[s] = static_cast<uint32_t>(i);
+    }
+
+    size_t head = 0;
+    size_t tail = 0;
+    for (size_t c = 0; c < classes; ++c)
+    {
+        const uint32_t t = trans[c];
+        if (t != 0)
+        {
+            fail[t] = 0;
+            queue[tail++] = t;
+        }
+    }
+
+    // Missing transitions borrow the fail state's row, which is complete because it is shallower.
+    while (head < tail)
+    {
+        const uint32_t s = queue[head++];
+        for (size_t c = 0; c < classes; ++c)
+        {
+            const uint32_t f = trans[fail[s] * classes + c];
+            uint32_t &t = trans[s * classes + c];
+            if (t != 0)
+            {
+                fail[t] = f;
+                dict[t] = out[f] != _ac_none_ ? f : dict[f];
+                queue[tail++] = t;
+            }
+            else
+            {
+                t = f;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < states * classes; ++i)
+    {
+        const uint32_t t = trans[i];
+        const bool output = out[t] != _ac_none_ || dict[t] != _ac_none_;
+        trans[i] = static_cast<uint32_t>(t * classes) | (output ? _ac_output_ : 0);
+    }
+    return states;
+}
+
+/// <summary>
+/// Runs the automaton over h[pos, size()). visit.match(end, needle) is called for every occurrence ending at end,
+/// visit.done(end) after each code unit; either returning false / true stops the scan.
+/// </summary>
+template <typename View, typename Visitor>
+constexpr void _ac_scan_(const _ac_tables_ &t, View h, size_t pos, Visitor &visit)
+{
+    using char_type = typename View::char_type;
+
+    uint32_t row = 0;
+    for (size_t i = pos; i < h.size(); ++i)
+    {
+        uint32_t next = 0;
+        for (size_t k = 0; k < sizeof(char_type); ++k)
+        {
+            next = t.trans[row + t.cls[_ac_byte_(h[i], k)]];
+            row = next & ~_ac_output_;
+        }
+        if (next & _ac_output_)
+        {
+            const uint32_t s = static_cast<uint32_t>(row / t.classes);
+            for (uint32_t x = t.out[s] != _ac_none_ ? s : t.dict[s]; x != _ac_none_; x = t.dict[x])
+            {
+                if (!visit.match(i + 1, t.out[x]))
+                {
+                    return;
+                }
+            }
+        }
+        if (visit.done(i + 1))
+        {
+            return;
+        }
+    }
+}
+
+/// <summary>
+/// Keeps the leftmost occurrence, the lowest needle index among those starting there. Once the scan is a longest
+/// needle past that start nothing can beat it.
+/// </summary>
+template <typename View> struct _ac_first_
+{
+    const View *needles;
+    size_t max_len;
+    multi_match best;
+
+    constexpr bool match(size_t end, size_t needle) noexcept
+    {
+        const size_t start = end - needles[needle].size();
+        if (start < best.position || (start == best.position && needle < best.needle))
+        {
+            best = multi_match{start, needle};
+        }
+        return true;
+    }
+
+    constexpr bool done(size_t end) const noexcept
+    {
+        return best.needle != multi_match::npos && end >= best.position + max_len;
+    }
+};
+
+template <typename View> struct _ac_count_
+{
+    size_t count;
+
+    constexpr bool match(size_t, size_t) noexcept
+    {
+        ++count;
+        return true;
+    }
+
+    constexpr bool done(size_t) const noexcept
+    {
+        return false;
+    }
+};
+
+template <typename View> struct _ac_collect_
+{
+    const View *needles;
+    std::vector<multi_match> *matches;
+
+    bool match(size_t end, size_t needle)
+    {
+        matches->push_back(multi_match{end - needles[needle].size(), needle});
+        return true;
+    }
+
+    constexpr bool done(size_t) const noexcept
+    {
+        return false;
+    }
+};
+
+inline void _sort_matches_(std::vector<multi_match> &matches)
+{
+    std::sort(matches.begin(), matches.end(), [](const multi_match &a, const multi_match &b) {
+        return a.position < b.position || (a.position == b.position && a.needle < b.needle);
+    });
+}
+
+constexpr size_t _sum_()
+{
+    return 0;
+}
+
+template <typename... Rest> constexpr size_t _sum_(size_t first, Rest... rest)
+{
+    return first + _sum_(rest...);
+}
+
+} // namespace detail
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Runtime matcher
+// ---------------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Compiled set of needles searched in one pass over the haystack, instead of one find() per needle. The needles are
+/// copied, so the views passed in need not outlive the matcher. Empty and duplicate needles are rejected with
+/// std::invalid_argument.
+///
+/// find() reports the leftmost occurrence (the lowest needle index among those starting there), find_all() every
+/// occurrence, overlapping ones included, ordered by position and then needle index. Both modes give the same results.
+/// </summary>
+template <typename CharT, typename Traits = std::char_traits<CharT>> struct basic_multi_matcher
+{
+    static_assert(utility::_bitwise_traits_<CharT, Traits>::value,
+                  "basic_multi_matcher compares raw code units and needs std::char_traits");
+
+    using view_type = basic_str_view<CharT, Traits>;
+    using size_type = size_t;
+
+    static constexpr size_type npos = size_type(-1);
+
+    /// <summary>
+    /// Largest needle count for which multi_mode::automatic picks the filtered mode.
+    /// </summary>
+    static constexpr size_type filtered_limit = 64;
+
+    basic_multi_matcher(std::initializer_list<view_type> needles, multi_mode mode = multi_mode::automatic);
+
+    template <typename InputIt>
+    basic_multi_matcher(InputIt first, InputIt last, multi_mode mode = multi_mode::automatic);
+
+    basic_multi_matcher(const basic_multi_matcher &) = delete;
+    basic_multi_matcher &operator=(const basic_multi_matcher &) = delete;
+    basic_multi_matcher(basic_multi_matcher &&) = default;
+    basic_multi_matcher &operator=(basic_multi_matcher &&) = default;
+
+    /// <summary>
+    /// Leftmost occurrence of any needle in h[pos, h.size()).
+    /// </summary>
+    /// <param name="h"></param>
+    /// <param name="pos"></param>
+    /// <returns></returns>
+    multi_match find(view_type h, size_type pos = 0) const noexcept;
+
+    bool contains(view_type h) const noexcept;
+
+    /// <summary>
+    /// Every occurrence in h, by position and then needle index.
+    /// </summary>
+    std::vector<multi_match> find_all(view_type h) const;
+
+    size_type count(view_type h) const noexcept;
+
+    size_type size() const noexcept;
+
+    multi_mode mode() const noexcept;
+
+    /// <summary>
+    /// Returns needle i.
+    /// </summary>
+    view_type operator[](size_type i) const noexcept;
+
+  private:
+    void build(multi_mode mode);
+
+    /// <summary>
+    /// Calls f(needle) for every needle starting at h[i], in index order, until it returns false.
+    /// </summary>
+    template <typename F> bool for_each_at(view_type h, size_type i, F f) const;
+
+    detail::_ac_tables_ tables() const noexcept;
+
+    multi_mode m_mode;
+    std::vector<CharT> m_text;
+    std::vector<view_type> m_needles;
+    size_type m_max_len;
+
+    // filtered
+    std::vector<CharT> m_first_units;
+    basic_char_set<CharT> m_first;
+    std::vector<size_type> m_order;
+    std::vector<CharT> m_order_units;
+
+    // automaton
+    uint16_t m_class[256];
+    size_type m_classes;
+    std::vector<uint32_t> m_trans;
+    std::vector<uint32_t> m_out;
+    std::vector<uint32_t> m_dict;
+};
+
+template <typename CharT, typename Traits>
+constexpr typename basic_multi_matcher<CharT, Traits>::size_type basic_multi_matcher<CharT, Traits>::npos;
+
+template <typename CharT, typename Traits>
+constexpr typename basic_multi_matcher<CharT, Traits>::size_type basic_multi_matcher<CharT, Traits>::filtered_limit;
+
+using multi_matcher = basic_multi_matcher<char>;
+using wmulti_matcher = basic_multi_matcher<wchar_t>;
+using u16multi_matcher = basic_multi_matcher<char16_t>;
+using u32multi_matcher = basic_multi_matcher<char32_t>;
+
+template <typename CharT, typename Traits>
+inline basic_multi_matcher<CharT, Traits>::basic_multi_matcher(std::initializer_list<view_type> needles,
+                                                               multi_mode mode)
+    : basic_multi_matcher(needles.begin(), needles.end(), mode)
+{
+}
+
+template <typename CharT, typename Traits>
+template <typename InputIt>
+inline basic_multi_matcher<CharT, Traits>::basic_multi_matcher(InputIt first, InputIt last, multi_mode mode)
+    : m_mode(mode), m_max_len(0), m_class{}, m_classes(0)
+{
+    std::vector<size_type> offsets(1, 0);
+    for (; first != last; ++first)
+    {
+        const view_type v(*first);
+        m_text.insert(m_text.end(), v.begin(), v.end());
+        offsets.push_back(m_text.size());
+    }
+
+    // Views are taken once the text buffer stops growing.
+    for (size_type i = 0; i + 1 < offsets.size(); ++i)
+    {
+        m_needles.push_back(view_type(m_text.data() + offsets[i], offsets[i + 1] - offsets[i]));
+        m_max_len = std::max(m_max_len, m_needles.back().size());
+    }
+
+    build(mode);
+}
+
+template <typename CharT, typename Traits> inline void basic_multi_matcher<CharT, Traits>::build(multi_mode mode)
+{
+    const size_type n = m_needles.size();
+    if (mode == multi_mode::automatic)
+    {
+        mode = n < filtered_limit ? multi_mode::filtered : multi_mode::automaton;
+    }
+    m_mode = mode;
+
+    if (mode == multi_mode::automaton)
+    {
+        size_type bytes = 0;
+        for (const view_type &v : m_needles)
+        {
+            bytes += v.size() * sizeof(CharT);
+        }
+
+        m_classes = detail::_ac_classes_(m_needles.data(), n, m_class);
+        m_trans.assign((bytes + 1) * m_classes, 0);
+        m_out.resize(bytes + 1);
+        m_dict.resize(bytes + 1);
+        std::vector<uint32_t> fail(bytes + 1);
+        std::vector<uint32_t> queue(bytes + 1);
+
+        const size_type states = detail::_ac_build_(m_needles.data(), n, m_class, m_classes, m_trans.data(),
+                                                    m_out.data(), m_dict.data(), fail.data(), queue.data());
+        m_trans.resize(states * m_classes);
+        m_out.resize(states);
+        m_dict.resize(states);
+        return;
+    }
+
+    // Sorting by content finds empty and duplicate needles; the second sort makes the buckets by first unit.
+    m_order.resize(n);
+    for (size_type i = 0; i < n; ++i)
+    {
+        m_order[i] = i;
+    }
+    std::sort(m_order.begin(), m_order.end(),
+              [this](size_type a, size_type b) { return m_needles[a] < m_needles[b]; });
+    for (size_type i = 0; i < n; ++i)
+    {
+        if (m_needles[m_order[i]].empty())
+        {
+            throw std::invalid_argument("Empty needle in lambda::multi_matcher");
+        }
+        if (i > 0 && m_needles[m_order[i]] == m_needles[m_order[i - 1]])
+        {
+            throw std::invalid_argument("Duplicate needle in lambda::multi_matcher");
+        }
+    }
+    std::sort(m_order.begin(), m_order.end(), [this](size_type a, size_type b) {
+        return m_needles[a][0] < m_needles[b][0] || (m_needles[a][0] == m_needles[b][0] && a < b);
+    });
+
+    for (size_type i = 0; i < n; ++i)
+    {
+        const CharT c = m_needles[m_order[i]][0];
+        m_order_units.push_back(c);
+        if (m_first_units.empty() || m_first_units.back() != c)
+        {
+            m_first_units.push_back(c);
+        }
+    }
+    m_first = basic_char_set<CharT>(m_first_units.data(), m_first_units.size());
+}
+
+template <typename CharT, typename Traits>
+inline detail::_ac_tables_ basic_multi_matcher<CharT, Traits>::tables() const noexcept
+{
+    return detail::_ac_tables_{m_class, m_trans.data(), m_out.data(), m_dict.data(), m_classes};
+}
+
+template <typename CharT, typename Traits>
+template <typename F>
+inline bool basic_multi_matcher<CharT, Traits>::for_each_at(view_type h, size_type i, F f) const
+{
+    const CharT c = h[i];
+    size_type j = static_cast<size_type>(std::lower_bound(m_order_units.begin(), m_order_units.end(), c) -
+                                         m_order_units.begin());
+    for (; j < m_order.size() && m_order_units[j] == c; ++j)
+    {
+        const view_type &v = m_needles[m_order[j]];
+        if (v.size() <= h.size() - i && simd::equal_bytes(h.data() + i, v.data(), v.size() * sizeof(CharT)))
+        {
+            if (!f(m_order[j]))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename CharT, typename Traits>
+inline multi_match basic_multi_matcher<CharT, Traits>::find(view_type h, size_type pos) const noexcept
+{
+    multi_match best{npos, npos};
+    if (pos >= h.size() || m_needles.empty())
+    {
+        return best;
+    }
+
+    if (m_mode == multi_mode::automaton)
+    {
+        detail::_ac_first_<view_type> visit{m_needles.data(), m_max_len, best};
+        detail::_ac_scan_(tables(), h, pos, visit);
+        return visit.best;
+    }
+
+    for (size_type i = pos; i < h.size(); ++i)
+    {
+        const size_type hit = m_first.template find<true>(h.data() + i, h.size() - i);
+        if (hit == npos)
+        {
+            break;
+        }
+        i += hit;
+
+        // Indices within a bucket ascend, so the first hit is the lowest one.
+        for_each_at(h, i, [&](size_type k) {
+            best = multi_match{i, k};
+            return false;
+        });
+        if (best)
+        {
+            break;
+        }
+    }
+    return best;
+}
+
+template <typename CharT, typename Traits>
+inline bool basic_multi_matcher<CharT, Traits>::contains(view_type h) const noexcept
+{
+    return static_cast<bool>(find(h));
+}
+
+template <typename CharT, typename Traits>
+inline std::vector<multi_match> basic_multi_matcher<CharT, Traits>::find_all(view_type h) const
+{
+    std::vector<multi_match> matches;
+    if (m_needles.empty())
+    {
+        return matches;
+    }
+
+    if (m_mode == multi_mode::automaton)
+    {
+        detail::_ac_collect_<view_type> visit{m_needles.data(), &matches};
+        detail::_ac_scan_(tables(), h, 0, visit);
+        detail::_sort_matches_(matches);
+        return matches;
+    }
+
+    for (size_type i = 0; i < h.size(); ++i)
+    {
+        const size_type hit = m_first.template find<true>(h.data() + i, h.size() - i);
+        if (hit == npos)
+        {
+            break;
+        }
+        i += hit;
+        for_each_at(h, i, [&](size_type k) {
+            matches.push_back(multi_match{i, k});
+            return true;
+        });
+    }
+    return matches;
+}
+
+template <typename CharT, typename Traits>
+inline typename basic_multi_matcher<CharT, Traits>::size_type basic_multi_matcher<CharT, Traits>::count(
+    view_type h) const noexcept
+{
+    if (m_needles.empty())
+    {
+        return 0;
+    }
+
+    if (m_mode == multi_mode::automaton)
+    {
+        detail::_ac_count_<view_type> visit{0};
+        detail::_ac_scan_(tables(), h, 0, visit);
+        return visit.count;
+    }
+
+    size_type total = 0;
+    for (size_type i = 0; i < h.size(); ++i)
+    {
+        const size_type hit = m_first.template find<true>(h.data() + i, h.size() - i);
+        if (hit == npos)
+        {
+            break;
+        }
+        i += hit;
+        for_each_at(h, i, [&](size_type) {
+            ++total;
+            return true;
+        });
+    }
+    return total;
+}
+
+template <typename CharT, typename Traits>
+inline typename basic_multi_matcher<CharT, Traits>::size_type basic_multi_matcher<CharT, Traits>::size()
+    const noexcept
+{
+    return m_needles.size();
+}
+
+template <typename CharT, typename Traits>
+inline multi_mode basic_multi_matcher<CharT, Traits>::mode() const noexcept
+{
+    return m_mode;
+}
+
+template <typename CharT, typename Traits>
+inline typename basic_multi_matcher<CharT, Traits>::view_type basic_multi_matcher<CharT, Traits>::operator[](
+    size_type i) const noexcept
+{
+    return m_needles[i];
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Compile time matcher
+// ---------------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Upper bound on the automaton states of a needle list: one per needle byte plus the root.
+/// </summary>
+template <typename CharT, typename Traits, size_t N>
+inline constexpr size_t multi_matcher_states(const basic_str_view<CharT, Traits> (&needles)[N]) noexcept
+{
+    size_t states = 1;
+    for (size_t i = 0; i < N; ++i)
+    {
+        states += needles[i].size() * sizeof(CharT);
+    }
+    return states;
+}
+
+/// <summary>
+/// Aho-Corasick matcher whose automaton is built by the compiler. N is the needle count, States the capacity from
+/// multi_matcher_states(). The needles are referenced, not copied, so they should be literals. Search results are the
+/// same as basic_multi_matcher's, and find / contains / count are constexpr.
+///
+///     constexpr auto banned = lambda::make_multi_matcher("DROP", "DELETE", "--");
+///     static_assert(banned.contains("x; DROP TABLE"_sv), "");
+/// </summary>
+template <typename CharT, size_t N, size_t States, typename Traits = std::char_traits<CharT>>
+struct basic_static_multi_matcher
+{
+    static_assert(N > 0, "basic_static_multi_matcher needs at least one needle");
+    static_assert(utility::_bitwise_traits_<CharT, Traits>::value,
+                  "basic_static_multi_matcher compares raw code units and needs std::char_traits");
+
+    using view_type = basic_str_view<CharT, Traits>;
+    using size_type = size_t;
+
+    static constexpr size_type max_classes = States < 257 ? States : 257;
+
+    constexpr explicit basic_static_multi_matcher(const view_type (&needles)[N]);
+
+    constexpr multi_match find(view_type h, size_type pos = 0) const noexcept;
+
+    constexpr bool contains(view_type h) const noexcept;
+
+    std::vector<multi_match> find_all(view_type h) const;
+
+    constexpr size_type count(view_type h) const noexcept;
+
+    constexpr size_type size() const noexcept;
+
+    constexpr view_type operator[](size_type i) const noexcept;
+
+  private:
+    constexpr detail::_ac_tables_ tables() const noexcept;
+
+    view_type m_needles[N];
+    size_type m_max_len;
+    uint16_t m_class[256];
+    size_type m_classes;
+    uint32_t m_trans[States * max_classes];
+    uint32_t m_out[States];
+    uint32_t m_dict[States];
+};
+
+template <typename CharT, size_t N, size_t States, typename Traits>
+constexpr typename basic_static_multi_matcher<CharT, N, States, Traits>::size_type
+    basic_static_multi_matcher<CharT, N, States, Traits>::max_classes;
+
+template <size_t N, size_t States> using static_multi_matcher = basic_static_multi_matcher<char, N, States>;
+template <size_t N, size_t States> using wstatic_multi_matcher = basic_static_multi_matcher<wchar_t, N, States>;
+template <size_t N, size_t States> using u16static_multi_matcher = basic_static_multi_matcher<char16_t, N, States>;
+template <size_t N, size_t States> using u32static_multi_matcher = basic_static_multi_matcher<char32_t, N, States>;
+
+template <typename CharT, size_t N, size_t States, typename Traits>
+inline constexpr basic_static_multi_matcher<CharT, N, States, Traits>::basic_static_multi_matcher(
+    const view_type (&needles)[N])
+    : m_needles{}, m_max_len(0), m_class{}, m_classes(0), m_trans{}, m_out{}, m_dict{}
+{
+    if (multi_matcher_states(needles) > States)
+    {
+        throw std::invalid_argument("States too small in lambda::basic_static_multi_matcher");
+    }
+
+    for (size_type i = 0; i < N; ++i)
+    {
+        m_needles[i] = needles[i];
+        m_max_len = m_max_len < needles[i].size() ? needles[i].size() : m_max_len;
+    }
+
+    uint32_t fail[States] = {};
+    uint32_t queue[States] = {};
+    m_classes = detail::_ac_classes_(m_needles, N, m_class);
+    detail::_ac_build_(m_needles, N, m_class, m_classes, m_trans, m_out, m_dict, fail, queue);
+}
+
+template <typename CharT, size_t N, size_t States, typename Traits>
+inline constexpr detail::_ac_tables_ basic_static_multi_matcher<CharT, N, States, Traits>::tables() const noexcept
+{
+    return detail::_ac_tables_{m_class, m_trans, m_out, m_dict, m_classes};
+}
+
+template <typename CharT, size_t N, size_t States, typename Traits>
+inline constexpr multi_match basic_static_multi_matcher<CharT, N, States, Traits>::find(view_type h,
+                                                                                        size_type pos) const noexcept
+{
+    detail::_ac_first_<view_type> visit{m_needles, m_max_len, multi_match{multi_match::npos, multi_match::npos}};
+    if (pos < h.size())
+    {
+        detail::_ac_scan_(tables(), h, pos, visit);
+    }
+    return visit.best;
+}
+
+template <typename CharT, size_t N, size_t States, typename Traits>
+inline constexpr bool basic_static_multi_matcher<CharT, N, States, Traits>::contains(view_type h) const noexcept
+{
+    return static_cast<bool>(find(h));
+}
+
+template <typename CharT, size_t N, size_t States, typename Traits>
+inline std::vector<multi_match> basic_static_multi_matcher<CharT, N, States, Traits>::find_all(view_type h) const
+{
+    std::vector<multi_match> matches;
+    detail::_ac_collect_<view_type> visit{m_needles, &matches};
+    detail::_ac_scan_(tables(), h, 0, visit);
+    detail::_sort_matches_(matches);
+    return matches;
+}
+
+template <typename CharT, size_t N, size_t States, typename Traits>
+inline constexpr typename basic_static_multi_matcher<CharT, N, States, Traits>::size_type basic_static_multi_matcher<
+    CharT, N, States, Traits>::count(view_type h) const noexcept
+{
+    detail::_ac_count_<view_type> visit{0};
+    detail::_ac_scan_(tables(), h, 0, visit);
+    return visit.count;
+}
+
+template <typename CharT, size_t N, size_t States, typename Traits>
+inline constexpr typename basic_static_multi_matcher<CharT, N, States, Traits>::size_type basic_static_multi_matcher<
+    CharT, N, States, Traits>::size() const noexcept
+{
+    return N;
+}
+
+template <typename CharT, size_t N, size_t States, typename Traits>
+inline constexpr typename basic_static_multi_matcher<CharT, N, States, Traits>::view_type basic_static_multi_matcher<
+    CharT, N, States, Traits>::operator[](size_type i) const noexcept
+{
+    return m_needles[i];
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Builds a basic_static_multi_matcher from string literals, sizing the automaton from the literal lengths.
+/// </summary>
+template <typename CharT, size_t... L>
+inline constexpr basic_static_multi_matcher<CharT, sizeof...(L), 1 + sizeof(CharT) * detail::_sum_((L - 1)...)>
+make_multi_matcher(const CharT (&... needles)[L])
+{
+    const basic_str_view<CharT> views[] = {basic_str_view<CharT>(needles, L - 1)...};
+    return basic_static_multi_matcher<CharT, sizeof...(L), 1 + sizeof(CharT) * detail::_sum_((L - 1)...)>(views);
+}
+
+} // namespace lambda
+
+#endif
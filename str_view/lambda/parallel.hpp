@@ -0,0 +1,360 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Chunked multi-threaded search over very large str_views
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_PARALLEL_H
+#define STR_VIEW_PARALLEL_H
+
+#include "str_view.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace lambda
+{
+
+/// <summary>
+/// Tuning for the parallel_* functions. threads == 0 uses std::thread::hardware_concurrency(). chunk_size is the
+/// haystack bytes per task; the default keeps a chunk inside L2.
+/// </summary>
+struct parallel_options
+{
+    size_t threads = 0;
+    size_t chunk_size = 256 * 1024;
+};
+
+namespace detail
+{
+
+inline size_t _parallel_threads_(const parallel_options &opt) noexcept
+{
+    const size_t hw = opt.threads != 0 ? opt.threads : std::thread::hardware_concurrency();
+    return hw != 0 ? hw : 1;
+}
+
+/// <summary>
+/// Calls body(c) for every chunk c in [0, chunks) on up to threads threads, the caller included. Chunks are claimed in
+/// increasing order from a shared counter, so a fast thread simply takes more of them. A worker stops once body returns
+/// false. The first exception thrown by body is rethrown after all workers have joined.
+/// </summary>
+template <typename Body> inline void _parallel_chunks_(size_t chunks, size_t threads, Body &body)
+{
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto work = [&]() {
+        try
+        {
+            for (size_t c = next.fetch_add(1, std::memory_order_relaxed); c < chunks;
+                 c = next.fetch_add(1, std::memory_order_relaxed))
+            {
+                if (!body(c))
+                {
+                    break;
+                }
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+            // Drain the counter so the other workers stop too.
+            next.store(chunks, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    const size_t extra = std::min(threads, chunks) - 1;
+    pool.reserve(extra);
+    for (size_t t = 0; t < extra; ++t)
+    {
+        // The workers share one chunk counter and this thread always takes part, so when the system refuses more
+        // threads the ones already running finish the job.
+        try
+        {
+            pool.emplace_back(work);
+        }
+        catch (const std::system_error &)
+        {
+            break;
+        }
+    }
+    work();
+    for (std::thread &t : pool)
+    {
+        t.join();
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+/// <summary>
+/// Splits the candidate start positions of an m unit needle in h into chunks of opt.chunk_size bytes. Chunk c covers
+/// the starts [c * units, (c + 1) * units) and reads m - 1 units past its end, so a match straddling two chunks belongs
+/// to the one it starts in.
+/// </summary>
+template <typename CharT, typename Traits> struct _parallel_plan_
+{
+    _parallel_plan_(basic_str_view<CharT, Traits> h, size_t m, const parallel_options &opt) noexcept
+        : hay(h), needle_size(m), units(std::max<size_t>(opt.chunk_size / sizeof(CharT), 1)), chunks(0),
+          threads(_parallel_threads_(opt))
+    {
+        if (m <= h.size())
+        {
+            const size_t starts = h.size() - m + 1;
+            chunks = (starts + units - 1) / units;
+        }
+    }
+
+    /// <summary>
+    /// The haystack slice chunk c searches, beginning at its first start position.
+    /// </summary>
+    basic_str_view<CharT, Traits> slice(size_t c) const noexcept
+    {
+        const size_t begin = c * units;
+        const size_t end = std::min(begin + units + needle_size - 1, hay.size());
+        return hay.unchecked_substr(begin, end - begin);
+    }
+
+    bool serial() const noexcept
+    {
+        return chunks <= 1 || threads <= 1;
+    }
+
+    basic_str_view<CharT, Traits> hay;
+    size_t needle_size;
+    size_t units;
+    size_t chunks;
+    size_t threads;
+};
+
+/// <summary>
+/// Calls f(pos) for every occurrence of needle in h, overlapping ones included.
+/// </summary>
+template <typename CharT, typename Traits, typename Needle, typename F>
+inline void _for_each_occurrence_(basic_str_view<CharT, Traits> h, Needle needle, F &&f)
+{
+    for (size_t pos = h.find(needle); pos != basic_str_view<CharT, Traits>::npos; pos = h.find(needle, pos + 1))
+    {
+        f(pos);
+    }
+}
+
+template <typename CharT> inline size_t _needle_size_(CharT) noexcept
+{
+    return 1;
+}
+
+template <typename CharT, typename Traits> inline size_t _needle_size_(basic_str_view<CharT, Traits> v) noexcept
+{
+    return v.size();
+}
+
+template <typename CharT, typename Traits, typename Needle>
+inline size_t _parallel_find_(basic_str_view<CharT, Traits> h, Needle needle, const parallel_options &opt)
+{
+    using view_type = basic_str_view<CharT, Traits>;
+
+    const _parallel_plan_<CharT, Traits> plan(h, _needle_size_(needle), opt);
+    if (plan.serial())
+    {
+        return h.find(needle);
+    }
+
+    // Chunks are claimed in order, so once a match is known every chunk claimed later starts after it.
+    std::atomic<size_t> best(view_type::npos);
+    auto body = [&](size_t c) {
+        if (c * plan.units > best.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        const size_t hit = plan.slice(c).find(needle);
+        if (hit != view_type::npos && hit < plan.units)
+        {
+            const size_t pos = c * plan.units + hit;
+            size_t current = best.load(std::memory_order_relaxed);
+            while (pos < current && !best.compare_exchange_weak(current, pos, std::memory_order_relaxed))
+            {
+            }
+        }
+        return true;
+    };
+    _parallel_chunks_(plan.chunks, plan.threads, body);
+    return best.load(std::memory_order_relaxed);
+}
+
+template <typename CharT, typename Traits, typename Needle>
+inline size_t _parallel_count_(basic_str_view<CharT, Traits> h, Needle needle, const parallel_options &opt)
+{
+    const _parallel_plan_<CharT, Traits> plan(h, _needle_size_(needle), opt);
+    size_t total = 0;
+    if (plan.serial())
+    {
+        if (plan.chunks != 0)
+        {
+            _for_each_occurrence_(h, needle, [&](size_t) { ++total; });
+        }
+        return total;
+    }
+
+    std::atomic<size_t> count(0);
+    auto body = [&](size_t c) {
+        size_t local = 0;
+        _for_each_occurrence_(plan.slice(c), needle, [&](size_t pos) { local += pos < plan.units ? 1 : 0; });
+        count.fetch_add(local, std::memory_order_relaxed);
+        return true;
+    };
+    _parallel_chunks_(plan.chunks, plan.threads, body);
+    return count.load(std::memory_order_relaxed);
+}
+
+template <typename CharT, typename Traits, typename Needle>
+inline std::vector<size_t> _parallel_find_all_(basic_str_view<CharT, Traits> h, Needle needle,
+                                               const parallel_options &opt)
+{
+    const _parallel_plan_<CharT, Traits> plan(h, _needle_size_(needle), opt);
+    std::vector<size_t> all;
+    if (plan.serial())
+    {
+        if (plan.chunks != 0)
+        {
+            _for_each_occurrence_(h, needle, [&](size_t pos) { all.push_back(pos); });
+        }
+        return all;
+    }
+
+    // One result list per chunk keeps the merge a plain concatenation in chunk order.
+    std::vector<std::vector<size_t>> parts(plan.chunks);
+    auto body = [&](size_t c) {
+        std::vector<size_t> &part = parts[c];
+        const size_t base = c * plan.units;
+        _for_each_occurrence_(plan.slice(c), needle, [&](size_t pos) {
+            if (pos < plan.units)
+            {
+                part.push_back(base + pos);
+            }
+        });
+        return true;
+    };
+    _parallel_chunks_(plan.chunks, plan.threads, body);
+
+    size_t total = 0;
+    for (const std::vector<size_t> &part : parts)
+    {
+        total += part.size();
+    }
+    all.reserve(total);
+    for (const std::vector<size_t> &part : parts)
+    {
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    return all;
+}
+
+} // namespace detail
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Same result as h.find(needle), with the haystack split into chunks searched on several threads. Chunks past the
+/// first match found are not searched.
+/// </summary>
+/// <param name="h"></param>
+/// <param name="needle"></param>
+/// <param name="opt"></param>
+/// <returns></returns>
+template <typename CharT, typename Traits>
+inline size_t parallel_find(basic_str_view<CharT, Traits> h, basic_str_view<CharT, Traits> needle,
+                            const parallel_options &opt = parallel_options())
+{
+    if (needle.empty())
+    {
+        return h.find(needle);
+    }
+    return detail::_parallel_find_(h, needle, opt);
+}
+
+template <typename CharT, typename Traits>
+inline size_t parallel_find(basic_str_view<CharT, Traits> h, CharT c, const parallel_options &opt = parallel_options())
+{
+    return detail::_parallel_find_(h, c, opt);
+}
+
+/// <summary>
+/// Number of occurrences of needle in h, overlapping ones included ("aa" occurs twice in "aaa"). An empty needle
+/// counts 0.
+/// </summary>
+template <typename CharT, typename Traits>
+inline size_t parallel_count(basic_str_view<CharT, Traits> h, basic_str_view<CharT, Traits> needle,
+                             const parallel_options &opt = parallel_options())
+{
+    return needle.empty() ? 0 : detail::_parallel_count_(h, needle, opt);
+}
+
+template <typename CharT, typename Traits>
+inline size_t parallel_count(basic_str_view<CharT, Traits> h, CharT c, const parallel_options &opt = parallel_options())
+{
+    return detail::_parallel_count_(h, c, opt);
+}
+
+/// <summary>
+/// Start positions of every occurrence of needle in h, overlapping ones included, in increasing order. An empty needle
+/// has none.
+/// </summary>
+template <typename CharT, typename Traits>
+inline std::vector<size_t> parallel_find_all(basic_str_view<CharT, Traits> h, basic_str_view<CharT, Traits> needle,
+                                             const parallel_options &opt = parallel_options())
+{
+    return needle.empty() ? std::vector<size_t>() : detail::_parallel_find_all_(h, needle, opt);
+}
+
+template <typename CharT, typename Traits>
+inline std::vector<size_t> parallel_find_all(basic_str_view<CharT, Traits> h, CharT c,
+                                             const parallel_options &opt = parallel_options())
+{
+    return detail::_parallel_find_all_(h, c, opt);
+}
+
+} // namespace lambda
+
+#endif
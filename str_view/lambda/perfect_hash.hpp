@@ -0,0 +1,296 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Compile time perfect hash over a fixed list of str_view literals
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_PERFECT_HASH_H
+#define STR_VIEW_PERFECT_HASH_H
+
+#include "str_view.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace lambda
+{
+
+namespace utility
+{
+
+/// <summary>
+/// Smallest power of two holding 2 * n slots, so the displacement search succeeds after a few seeds per bucket.
+/// </summary>
+constexpr size_t _perfect_hash_slots_(size_t n)
+{
+    size_t slots = 1;
+    while (slots < 2 * n)
+    {
+        slots <<= 1;
+    }
+    return slots;
+}
+
+/// <summary>
+/// Second level hash: remixes the key hash with the bucket's displacement seed (murmur3 finalizer).
+/// </summary>
+constexpr uint64_t _perfect_hash_mix_(uint64_t h, uint32_t seed)
+{
+    uint64_t x = h ^ (static_cast<uint64_t>(seed) * 0x9e3779b97f4a7c15ull);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+} // namespace utility
+
+/// <summary>
+/// Immutable set of N keys with O(1) lookup: one hash of the probe, one table load and a single verifying compare.
+/// Built with hash-and-displace: keys are spread over N buckets by their hash, then each bucket (largest first) gets
+/// the first seed that moves all its keys to free slots. Construction is constexpr, so the tables of a literal key
+/// list are generated by the compiler. Duplicate keys are rejected with std::invalid_argument (a compile error in a
+/// constant expression).
+///
+///     constexpr auto methods = lambda::make_perfect_hash("GET"_sv, "HEAD"_sv, "POST"_sv);
+///     switch (methods.find(method)) { case 0: ...; case 1: ...; default: ... }
+/// </summary>
+template <typename CharT, size_t N, typename Traits = std::char_traits<CharT>> struct basic_perfect_hash_set
+{
+    static_assert(N > 0, "basic_perfect_hash_set needs at least one key");
+
+    using view_type = basic_str_view<CharT, Traits>;
+    using size_type = size_t;
+
+    static constexpr size_type npos = size_type(-1);
+    static constexpr size_type slot_count = utility::_perfect_hash_slots_(N);
+
+    /// <summary>
+    /// Builds the tables for keys. Key i is reported as index i by find().
+    /// </summary>
+    /// <param name="keys"></param>
+    constexpr explicit basic_perfect_hash_set(const view_type (&keys)[N]);
+
+    /// <summary>
+    /// Returns the index of key in the list given at construction, or npos.
+    /// </summary>
+    /// <param name="key"></param>
+    /// <returns></returns>
+    constexpr size_type find(view_type key) const noexcept;
+
+    /// <summary>
+    /// Maps key to the enumerator with the same index (the enum must be declared in key order), or not_found.
+    /// </summary>
+    template <typename Enum> constexpr Enum find_as(view_type key, Enum not_found) const noexcept;
+
+    constexpr bool contains(view_type key) const noexcept;
+
+    constexpr size_type size() const noexcept;
+
+    /// <summary>
+    /// Returns key i.
+    /// </summary>
+    constexpr view_type operator[](size_type i) const noexcept;
+
+  private:
+    constexpr size_type bucket(uint64_t h) const noexcept;
+    constexpr size_type slot(uint64_t h, uint32_t seed) const noexcept;
+
+    view_type m_keys[N];
+    uint64_t m_hashes[N];
+    uint32_t m_seeds[N];
+    size_type m_slots[slot_count];
+};
+
+template <typename CharT, size_t N, typename Traits>
+constexpr typename basic_perfect_hash_set<CharT, N, Traits>::size_type basic_perfect_hash_set<CharT, N, Traits>::npos;
+
+template <typename CharT, size_t N, typename Traits>
+constexpr typename basic_perfect_hash_set<CharT, N, Traits>::size_type
+    basic_perfect_hash_set<CharT, N, Traits>::slot_count;
+
+template <size_t N> using perfect_hash_set = basic_perfect_hash_set<char, N>;
+template <size_t N> using wperfect_hash_set = basic_perfect_hash_set<wchar_t, N>;
+template <size_t N> using u16perfect_hash_set = basic_perfect_hash_set<char16_t, N>;
+template <size_t N> using u32perfect_hash_set = basic_perfect_hash_set<char32_t, N>;
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr basic_perfect_hash_set<CharT, N, Traits>::basic_perfect_hash_set(const view_type (&keys)[N])
+    : m_keys{}, m_hashes{}, m_seeds{}, m_slots{}
+{
+    size_type head[N] = {};
+    size_type next[N] = {};
+    size_type bucket_size[N] = {};
+    size_type largest = 0;
+
+    for (size_type b = 0; b < N; ++b)
+    {
+        head[b] = npos;
+    }
+    for (size_type s = 0; s < slot_count; ++s)
+    {
+        m_slots[s] = npos;
+    }
+    for (size_type i = 0; i < N; ++i)
+    {
+        m_keys[i] = keys[i];
+        m_hashes[i] = hash_value(keys[i]);
+
+        const size_type b = bucket(m_hashes[i]);
+        next[i] = head[b];
+        head[b] = i;
+        largest = std::max(largest, ++bucket_size[b]);
+    }
+
+    for (size_type size = largest; size > 0; --size)
+    {
+        for (size_type b = 0; b < N; ++b)
+        {
+            if (bucket_size[b] != size)
+            {
+                continue;
+            }
+
+            for (uint32_t seed = 0;; ++seed)
+            {
+                if (seed == 0x10000u)
+                {
+                    throw std::invalid_argument("Duplicate key in lambda::basic_perfect_hash_set");
+                }
+
+                bool placed = true;
+                for (size_type i = head[b]; i != npos; i = next[i])
+                {
+                    const size_type s = slot(m_hashes[i], seed);
+                    if (m_slots[s] != npos)
+                    {
+                        placed = false;
+                        break;
+                    }
+                    m_slots[s] = i;
+                }
+
+                if (placed)
+                {
+                    m_seeds[b] = seed;
+                    break;
+                }
+
+                // Undo the slots this attempt claimed before the collision.
+                for (size_type i = head[b]; i != npos; i = next[i])
+                {
+                    const size_type s = slot(m_hashes[i], seed);
+                    if (m_slots[s] == i)
+                    {
+                        m_slots[s] = npos;
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_perfect_hash_set<CharT, N, Traits>::size_type basic_perfect_hash_set<
+    CharT, N, Traits>::bucket(uint64_t h) const noexcept
+{
+    return static_cast<size_type>(((h >> 32) * N) >> 32);
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_perfect_hash_set<CharT, N, Traits>::size_type basic_perfect_hash_set<
+    CharT, N, Traits>::slot(uint64_t h, uint32_t seed) const noexcept
+{
+    return static_cast<size_type>(utility::_perfect_hash_mix_(h, seed) & (slot_count - 1));
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_perfect_hash_set<CharT, N, Traits>::size_type basic_perfect_hash_set<
+    CharT, N, Traits>::find(view_type key) const noexcept
+{
+    const uint64_t h = hash_value(key);
+    const size_type i = m_slots[slot(h, m_seeds[bucket(h)])];
+    return i != npos && m_hashes[i] == h && m_keys[i] == key ? i : npos;
+}
+
+template <typename CharT, size_t N, typename Traits>
+template <typename Enum>
+inline constexpr Enum basic_perfect_hash_set<CharT, N, Traits>::find_as(view_type key, Enum not_found) const noexcept
+{
+    const size_type i = find(key);
+    return i == npos ? not_found : static_cast<Enum>(i);
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr bool basic_perfect_hash_set<CharT, N, Traits>::contains(view_type key) const noexcept
+{
+    return find(key) != npos;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_perfect_hash_set<CharT, N, Traits>::size_type basic_perfect_hash_set<
+    CharT, N, Traits>::size() const noexcept
+{
+    return N;
+}
+
+template <typename CharT, size_t N, typename Traits>
+inline constexpr typename basic_perfect_hash_set<CharT, N, Traits>::view_type basic_perfect_hash_set<
+    CharT, N, Traits>::operator[](size_type i) const noexcept
+{
+    return m_keys[i];
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Builds a basic_perfect_hash_set from an array of keys.
+/// </summary>
+template <typename CharT, typename Traits, size_t N>
+inline constexpr basic_perfect_hash_set<CharT, N, Traits> make_perfect_hash(
+    const basic_str_view<CharT, Traits> (&keys)[N])
+{
+    return basic_perfect_hash_set<CharT, N, Traits>(keys);
+}
+
+/// <summary>
+/// Builds a basic_perfect_hash_set from a list of _sv literals.
+/// </summary>
+template <typename CharT, typename Traits, typename... Views>
+inline constexpr basic_perfect_hash_set<CharT, sizeof...(Views) + 1, Traits> make_perfect_hash(
+    basic_str_view<CharT, Traits> first, Views... rest)
+{
+    const basic_str_view<CharT, Traits> keys[] = {first, rest...};
+    return basic_perfect_hash_set<CharT, sizeof...(Views) + 1, Traits>(keys);
+}
+
+} // namespace lambda
+
+#endif
@@ -0,0 +1,848 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Streaming search / split stages over chunked input, with reading overlapped with scanning
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_PIPELINE_H
+#define STR_VIEW_PIPELINE_H
+
+#include "config.hpp"
+#include "str_view.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if LAMBDA_HAS_COROUTINES
+#include <coroutine>
+#endif
+
+namespace lambda
+{
+
+/// <summary>
+/// Fixed capacity FIFO between two threads. push() waits while the queue is full, which is how a slow consumer holds
+/// back its producer, and pop() waits while it is empty. After close() pushes fail and pops drain what is left.
+/// </summary>
+template <typename T> struct bounded_queue
+{
+    using value_type = T;
+    using size_type = size_t;
+
+    explicit bounded_queue(size_type capacity);
+
+    bounded_queue(const bounded_queue &) = delete;
+    bounded_queue &operator=(const bounded_queue &) = delete;
+
+    /// <summary>
+    /// Appends value, waiting for room.
+    /// </summary>
+    /// <param name="value"></param>
+    /// <returns>false, leaving value unqueued, when the queue is or gets closed.</returns>
+    bool push(T value);
+
+    /// <summary>
+    /// Removes the oldest value into value, waiting for one.
+    /// </summary>
+    /// <param name="value"></param>
+    /// <returns>false once the queue is closed and empty.</returns>
+    bool pop(T &value);
+
+    /// <summary>
+    /// Wakes every waiting push() and pop(); idempotent.
+    /// </summary>
+    void close();
+
+    bool closed() const;
+    size_type capacity() const noexcept;
+
+  private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    std::deque<T> m_items;
+    size_type m_capacity;
+    bool m_closed;
+};
+
+/// <summary>
+/// Search stage fed one chunk at a time: every occurrence of the needle in the concatenated chunks, overlapping ones
+/// included, is reported once by its offset from the start of the stream, as soon as the chunk completing it arrives.
+/// Only the last needle.size() - 1 units are kept between chunks, so chunks need not outlive feed(). The needle is not
+/// copied.
+/// </summary>
+template <typename CharT, typename Traits = std::char_traits<CharT>> struct basic_stream_scanner
+{
+    using view_type = basic_str_view<CharT, Traits>;
+    using size_type = size_t;
+
+    /// <summary>
+    /// Throws std::invalid_argument for an empty needle, which has no useful streaming answer.
+    /// </summary>
+    explicit basic_stream_scanner(view_type needle);
+
+    /// <summary>
+    /// Calls on_match(offset) for every occurrence that ends inside chunk, in increasing offset order.
+    /// </summary>
+    /// <param name="chunk"></param>
+    /// <param name="on_match"></param>
+    /// <returns>The number of occurrences reported.</returns>
+    template <typename F> size_type feed(view_type chunk, F &&on_match);
+
+    /// <summary>
+    /// Units fed so far.
+    /// </summary>
+    size_type offset() const noexcept;
+
+    view_type needle() const noexcept;
+
+  private:
+    view_type m_needle;
+    std::vector<CharT> m_carry;
+    std::vector<CharT> m_window;
+    size_type m_offset;
+};
+
+/// <summary>
+/// Split stage fed one chunk at a time, with the record rules of basic_record_reader: the delimiter is not part of a
+/// record and a final record without one is returned by finish() unless it is empty. Records inside a chunk point into
+/// it; a record straddling chunks is assembled in the splitter and stays valid until the next feed() or finish().
+/// </summary>
+template <typename CharT, typename Traits = std::char_traits<CharT>> struct basic_stream_splitter
+{
+    using view_type = basic_str_view<CharT, Traits>;
+    using size_type = size_t;
+
+    explicit basic_stream_splitter(CharT delim = CharT('\n'));
+
+    /// <summary>
+    /// Calls on_record(record) for every record that ends inside chunk.
+    /// </summary>
+    /// <param name="chunk"></param>
+    /// <param name="on_record"></param>
+    /// <returns>The number of records reported.</returns>
+    template <typename F> size_type feed(view_type chunk, F &&on_record);
+
+    /// <summary>
+    /// Reports the unterminated last record, if any, and resets the splitter for a new stream.
+    /// </summary>
+    /// <param name="on_record"></param>
+    /// <returns>The number of records reported, 0 or 1.</returns>
+    template <typename F> size_type finish(F &&on_record);
+
+    CharT delimiter() const noexcept;
+
+  private:
+    std::vector<CharT> m_carry;
+    std::vector<CharT> m_record;
+    CharT m_delim;
+};
+
+/// <summary>
+/// Buffering for the stream_* functions: buffers chunks of chunk_size units are in flight between the reading thread
+/// and the scanning one, so at most buffers * chunk_size units are read ahead of the scan.
+/// </summary>
+struct stream_options
+{
+    size_t chunk_size = 64 * 1024;
+    size_t buffers = 4;
+};
+
+namespace detail
+{
+
+/// <summary>
+/// Runs source on a reading thread that fills a fixed pool of buffers, handed to the consumer in read order through
+/// next() and back through release(). The reader waits when every buffer is with the consumer. An exception thrown by
+/// source is rethrown by next() after the chunks read before it. The destructor stops the reader, after the read in
+/// progress returns.
+/// </summary>
+template <typename CharT, typename Source> struct _chunk_pump_
+{
+    _chunk_pump_(Source &source, const stream_options &opt);
+    ~_chunk_pump_();
+
+    _chunk_pump_(const _chunk_pump_ &) = delete;
+    _chunk_pump_ &operator=(const _chunk_pump_ &) = delete;
+
+    /// <summary>
+    /// Waits for the next chunk. The previous one must have been released.
+    /// </summary>
+    /// <returns>false at the end of input.</returns>
+    bool next(const CharT *&data, size_t &size);
+    void release();
+
+  private:
+    struct filled
+    {
+        size_t buffer;
+        size_t size;
+    };
+
+    void read_loop();
+
+    Source &m_source;
+    size_t m_chunk_size;
+    std::unique_ptr<CharT[]> m_storage;
+    bounded_queue<size_t> m_free;
+    bounded_queue<filled> m_filled;
+    std::exception_ptr m_error;
+    size_t m_current;
+    std::thread m_reader;
+};
+
+} // namespace detail
+
+/// <summary>
+/// Reads source (a size_t(CharT *dst, size_t capacity) callable as for basic_record_reader, run on a reading thread)
+/// and calls on_match(offset) on the calling thread for every occurrence of needle, while the next chunks are being
+/// read. Matches are reported as soon as the chunk completing them arrives, not when the input ends; a downstream stage
+/// on another thread can be fed through a bounded_queue, whose push() then holds back the scan and the reads.
+/// </summary>
+/// <param name="source"></param>
+/// <param name="needle">Not empty.</param>
+/// <param name="on_match"></param>
+/// <param name="opt"></param>
+/// <returns>The number of occurrences.</returns>
+template <typename CharT, typename Traits, typename Source, typename F>
+inline size_t stream_find_all(Source &&source, basic_str_view<CharT, Traits> needle, F &&on_match,
+                              const stream_options &opt = stream_options());
+
+/// <summary>
+/// Reads source as stream_find_all does and calls on_record(record) for every delim terminated record, with the
+/// lifetime rules of basic_stream_splitter: a record is only valid during the call.
+/// </summary>
+/// <param name="source"></param>
+/// <param name="delim"></param>
+/// <param name="on_record"></param>
+/// <param name="opt"></param>
+/// <returns>The number of records.</returns>
+template <typename CharT, typename Source, typename F>
+inline size_t stream_split(Source &&source, CharT delim, F &&on_record, const stream_options &opt = stream_options());
+
+#if LAMBDA_HAS_COROUTINES
+
+/// <summary>
+/// Lazily produced sequence of the values a coroutine co_yields, iterated once:
+///
+///     for (size_t offset : lambda::stream_matches<char>(read_socket, "\r\n\r\n"_sv)) { ... }
+///
+/// Each increment resumes the coroutine up to its next co_yield, and an exception it throws leaves through the
+/// increment. Destroying the generator early stops the coroutine and everything it owns.
+/// </summary>
+template <typename T> struct basic_stream_generator
+{
+    struct promise_type
+    {
+        const T *m_value = nullptr;
+        std::exception_ptr m_error;
+
+        basic_stream_generator get_return_object() noexcept;
+        std::suspend_always initial_suspend() const noexcept;
+        std::suspend_always final_suspend() const noexcept;
+        std::suspend_always yield_value(const T &value) noexcept;
+        void return_void() const noexcept;
+        void unhandled_exception() noexcept;
+    };
+
+    struct sentinel
+    {
+    };
+
+    struct iterator
+    {
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        reference operator*() const noexcept;
+        pointer operator->() const noexcept;
+        iterator &operator++();
+        void operator++(int);
+
+        friend bool operator==(const iterator &it, sentinel) noexcept
+        {
+            return it.m_handle.done();
+        }
+        friend bool operator!=(const iterator &it, sentinel s) noexcept
+        {
+            return !(it == s);
+        }
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    basic_stream_generator(basic_stream_generator &&other) noexcept;
+    basic_stream_generator &operator=(basic_stream_generator &&other) noexcept;
+    ~basic_stream_generator();
+
+    /// <summary>
+    /// Runs the coroutine to its first value; call once.
+    /// </summary>
+    iterator begin();
+    sentinel end() const noexcept;
+
+  private:
+    explicit basic_stream_generator(std::coroutine_handle<promise_type> handle) noexcept;
+
+    static void advance(std::coroutine_handle<promise_type> handle);
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+/// <summary>
+/// stream_find_all as a generator: yields the offsets of needle in the input read by source, so the caller pulls
+/// matches as the input arrives instead of handing out a callback. source is moved into the generator; the needle
+/// must outlive it.
+/// </summary>
+template <typename CharT, typename Traits, typename Source>
+basic_stream_generator<size_t> stream_matches(Source source, basic_str_view<CharT, Traits> needle,
+                                              stream_options opt = stream_options());
+
+/// <summary>
+/// stream_split as a generator: yields the records of the input read by source. A record is valid until the
+/// generator is incremented.
+/// </summary>
+template <typename CharT, typename Source, typename Traits = std::char_traits<CharT>>
+basic_stream_generator<basic_str_view<CharT, Traits>> stream_records(Source source, CharT delim = CharT('\n'),
+                                                                     stream_options opt = stream_options());
+
+#endif // LAMBDA_HAS_COROUTINES
+
+using stream_scanner = basic_stream_scanner<char>;
+using wstream_scanner = basic_stream_scanner<wchar_t>;
+using u16stream_scanner = basic_stream_scanner<char16_t>;
+using u32stream_scanner = basic_stream_scanner<char32_t>;
+
+using stream_splitter = basic_stream_splitter<char>;
+using wstream_splitter = basic_stream_splitter<wchar_t>;
+using u16stream_splitter = basic_stream_splitter<char16_t>;
+using u32stream_splitter = basic_stream_splitter<char32_t>;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// bounded_queue
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+inline bounded_queue<T>::bounded_queue(size_type capacity)
+    : m_capacity(capacity != 0 ? capacity : 1), m_closed(false)
+{
+}
+
+template <typename T> inline bool bounded_queue<T>::push(T value)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_full.wait(lock, [this] { return m_closed || m_items.size() < m_capacity; });
+    if (m_closed)
+    {
+        return false;
+    }
+    m_items.push_back(std::move(value));
+    lock.unlock();
+    m_not_empty.notify_one();
+    return true;
+}
+
+template <typename T> inline bool bounded_queue<T>::pop(T &value)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_empty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+    if (m_items.empty())
+    {
+        return false;
+    }
+    value = std::move(m_items.front());
+    m_items.pop_front();
+    lock.unlock();
+    m_not_full.notify_one();
+    return true;
+}
+
+template <typename T> inline void bounded_queue<T>::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+}
+
+template <typename T> inline bool bounded_queue<T>::closed() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_closed;
+}
+
+template <typename T> inline typename bounded_queue<T>::size_type bounded_queue<T>::capacity() const noexcept
+{
+    return m_capacity;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// basic_stream_scanner
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits>
+inline basic_stream_scanner<CharT, Traits>::basic_stream_scanner(view_type needle) : m_needle(needle), m_offset(0)
+{
+    if (needle.empty())
+    {
+        throw std::invalid_argument("basic_stream_scanner: empty needle");
+    }
+    m_carry.reserve(needle.size() - 1);
+    m_window.reserve(2 * (needle.size() - 1));
+}
+
+template <typename CharT, typename Traits>
+template <typename F>
+inline typename basic_stream_scanner<CharT, Traits>::size_type basic_stream_scanner<CharT, Traits>::feed(
+    view_type chunk, F &&on_match)
+{
+    const size_type keep = m_needle.size() - 1;
+    size_type found = 0;
+
+    // Matches starting in the carried tail end in the first keep units of the chunk at the latest. One starting in the
+    // last keep units of the stream so far cannot be complete yet, so none is reported twice.
+    if (!m_carry.empty())
+    {
+        m_window.assign(m_carry.begin(), m_carry.end());
+        const view_type head = chunk.first(chunk.size() < keep ? chunk.size() : keep);
+        m_window.insert(m_window.end(), head.begin(), head.end());
+        const view_type window(m_window.data(), m_window.size());
+        const size_type base = m_offset - m_carry.size();
+        for (size_type pos = window.find(m_needle); pos < m_carry.size(); pos = window.find(m_needle, pos + 1))
+        {
+            on_match(base + pos);
+            ++found;
+        }
+    }
+
+    for (size_type pos = chunk.find(m_needle); pos != view_type::npos; pos = chunk.find(m_needle, pos + 1))
+    {
+        on_match(m_offset + pos);
+        ++found;
+    }
+
+    if (chunk.size() >= keep)
+    {
+        m_carry.assign(chunk.end() - keep, chunk.end());
+    }
+    else
+    {
+        m_carry.insert(m_carry.end(), chunk.begin(), chunk.end());
+        m_carry.erase(m_carry.begin(), m_carry.end() - (m_carry.size() < keep ? m_carry.size() : keep));
+    }
+    m_offset += chunk.size();
+    return found;
+}
+
+template <typename CharT, typename Traits>
+inline typename basic_stream_scanner<CharT, Traits>::size_type basic_stream_scanner<CharT, Traits>::offset()
+    const noexcept
+{
+    return m_offset;
+}
+
+template <typename CharT, typename Traits>
+inline typename basic_stream_scanner<CharT, Traits>::view_type basic_stream_scanner<CharT, Traits>::needle()
+    const noexcept
+{
+    return m_needle;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// basic_stream_splitter
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits>
+inline basic_stream_splitter<CharT, Traits>::basic_stream_splitter(CharT delim) : m_delim(delim)
+{
+}
+
+template <typename CharT, typename Traits>
+template <typename F>
+inline typename basic_stream_splitter<CharT, Traits>::size_type basic_stream_splitter<CharT, Traits>::feed(
+    view_type chunk, F &&on_record)
+{
+    size_type at = chunk.find(m_delim);
+    if (at == view_type::npos)
+    {
+        m_carry.insert(m_carry.end(), chunk.begin(), chunk.end());
+        return 0;
+    }
+
+    size_type found = 1;
+    if (m_carry.empty())
+    {
+        on_record(chunk.first(at));
+    }
+    else
+    {
+        // The straddling record moves to its own buffer, so the carry can refill while the record is still in use.
+        m_carry.insert(m_carry.end(), chunk.begin(), chunk.begin() + at);
+        m_record.swap(m_carry);
+        m_carry.clear();
+        on_record(view_type(m_record.data(), m_record.size()));
+    }
+
+    size_type begin = at + 1;
+    for (; (at = chunk.find(m_delim, begin)) != view_type::npos; begin = at + 1)
+    {
+        on_record(chunk.unchecked_substr(begin, at - begin));
+        ++found;
+    }
+    m_carry.insert(m_carry.end(), chunk.begin() + begin, chunk.end());
+    return found;
+}
+
+template <typename CharT, typename Traits>
+template <typename F>
+inline typename basic_stream_splitter<CharT, Traits>::size_type basic_stream_splitter<CharT, Traits>::finish(
+    F &&on_record)
+{
+    if (m_carry.empty())
+    {
+        return 0;
+    }
+    m_record.swap(m_carry);
+    m_carry.clear();
+    on_record(view_type(m_record.data(), m_record.size()));
+    return 1;
+}
+
+template <typename CharT, typename Traits>
+inline CharT basic_stream_splitter<CharT, Traits>::delimiter() const noexcept
+{
+    return m_delim;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Reading thread
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace detail
+{
+
+template <typename CharT, typename Source>
+inline _chunk_pump_<CharT, Source>::_chunk_pump_(Source &source, const stream_options &opt)
+    : m_source(source), m_chunk_size(opt.chunk_size != 0 ? opt.chunk_size : 1),
+      m_storage(new CharT[m_chunk_size * (opt.buffers != 0 ? opt.buffers : 1)]),
+      m_free(opt.buffers != 0 ? opt.buffers : 1), m_filled(m_free.capacity()), m_current(0)
+{
+    for (size_t b = 0; b < m_free.capacity(); ++b)
+    {
+        m_free.push(b);
+    }
+    m_reader = std::thread([this] { read_loop(); });
+}
+
+template <typename CharT, typename Source> inline _chunk_pump_<CharT, Source>::~_chunk_pump_()
+{
+    m_free.close();
+    m_filled.close();
+    m_reader.join();
+}
+
+template <typename CharT, typename Source> inline void _chunk_pump_<CharT, Source>::read_loop()
+{
+    try
+    {
+        // There are as many filled slots as buffers, so only taking a free buffer ever waits.
+        for (size_t b; m_free.pop(b);)
+        {
+            const size_t got = m_source(m_storage.get() + b * m_chunk_size, m_chunk_size);
+            if (got == 0 || !m_filled.push(filled{b, got}))
+            {
+                break;
+            }
+        }
+    }
+    catch (...)
+    {
+        m_error = std::current_exception();
+    }
+    m_filled.close();
+}
+
+template <typename CharT, typename Source>
+inline bool _chunk_pump_<CharT, Source>::next(const CharT *&data, size_t &size)
+{
+    filled chunk;
+    if (!m_filled.pop(chunk))
+    {
+        // The reader has stopped and closed the queue, so reading m_error is ordered after its write.
+        if (m_error)
+        {
+            std::rethrow_exception(m_error);
+        }
+        return false;
+    }
+    m_current = chunk.buffer;
+    data = m_storage.get() + chunk.buffer * m_chunk_size;
+    size = chunk.size;
+    return true;
+}
+
+template <typename CharT, typename Source> inline void _chunk_pump_<CharT, Source>::release()
+{
+    m_free.push(m_current);
+}
+
+} // namespace detail
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Callback pipelines
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits, typename Source, typename F>
+inline size_t stream_find_all(Source &&source, basic_str_view<CharT, Traits> needle, F &&on_match,
+                              const stream_options &opt)
+{
+    basic_stream_scanner<CharT, Traits> scanner(needle);
+    detail::_chunk_pump_<CharT, typename std::remove_reference<Source>::type> pump(source, opt);
+
+    size_t found = 0;
+    const CharT *data;
+    size_t size;
+    while (pump.next(data, size))
+    {
+        found += scanner.feed(basic_str_view<CharT, Traits>(data, size), on_match);
+        pump.release();
+    }
+    return found;
+}
+
+template <typename CharT, typename Source, typename F>
+inline size_t stream_split(Source &&source, CharT delim, F &&on_record, const stream_options &opt)
+{
+    basic_stream_splitter<CharT> splitter(delim);
+    detail::_chunk_pump_<CharT, typename std::remove_reference<Source>::type> pump(source, opt);
+
+    size_t found = 0;
+    const CharT *data;
+    size_t size;
+    while (pump.next(data, size))
+    {
+        found += splitter.feed(basic_str_view<CharT>(data, size), on_record);
+        pump.release();
+    }
+    return found + splitter.finish(on_record);
+}
+
+#if LAMBDA_HAS_COROUTINES
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Generator pipelines
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+inline basic_stream_generator<T> basic_stream_generator<T>::promise_type::get_return_object() noexcept
+{
+    return basic_stream_generator(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+template <typename T>
+inline std::suspend_always basic_stream_generator<T>::promise_type::initial_suspend() const noexcept
+{
+    return {};
+}
+
+template <typename T>
+inline std::suspend_always basic_stream_generator<T>::promise_type::final_suspend() const noexcept
+{
+    return {};
+}
+
+template <typename T>
+inline std::suspend_always basic_stream_generator<T>::promise_type::yield_value(const T &value) noexcept
+{
+    // The value lives in the suspended coroutine frame until the next resume.
+    m_value = std::addressof(value);
+    return {};
+}
+
+template <typename T> inline void basic_stream_generator<T>::promise_type::return_void() const noexcept
+{
+}
+
+template <typename T> inline void basic_stream_generator<T>::promise_type::unhandled_exception() noexcept
+{
+    m_error = std::current_exception();
+}
+
+template <typename T>
+inline typename basic_stream_generator<T>::iterator::reference basic_stream_generator<T>::iterator::operator*()
+    const noexcept
+{
+    return *m_handle.promise().m_value;
+}
+
+template <typename T>
+inline typename basic_stream_generator<T>::iterator::pointer basic_stream_generator<T>::iterator::operator->()
+    const noexcept
+{
+    return m_handle.promise().m_value;
+}
+
+template <typename T>
+inline typename basic_stream_generator<T>::iterator &basic_stream_generator<T>::iterator::operator++()
+{
+    advance(m_handle);
+    return *this;
+}
+
+template <typename T> inline void basic_stream_generator<T>::iterator::operator++(int)
+{
+    ++*this;
+}
+
+template <typename T>
+inline basic_stream_generator<T>::basic_stream_generator(std::coroutine_handle<promise_type> handle) noexcept
+    : m_handle(handle)
+{
+}
+
+template <typename T>
+inline basic_stream_generator<T>::basic_stream_generator(basic_stream_generator &&other) noexcept
+    : m_handle(std::exchange(other.m_handle, nullptr))
+{
+}
+
+template <typename T>
+inline basic_stream_generator<T> &basic_stream_generator<T>::operator=(basic_stream_generator &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+        m_handle = std::exchange(other.m_handle, nullptr);
+    }
+    return *this;
+}
+
+template <typename T> inline basic_stream_generator<T>::~basic_stream_generator()
+{
+    if (m_handle)
+    {
+        m_handle.destroy();
+    }
+}
+
+template <typename T> inline void basic_stream_generator<T>::advance(std::coroutine_handle<promise_type> handle)
+{
+    handle.resume();
+    if (handle.done() && handle.promise().m_error)
+    {
+        std::rethrow_exception(std::exchange(handle.promise().m_error, nullptr));
+    }
+}
+
+template <typename T> inline typename basic_stream_generator<T>::iterator basic_stream_generator<T>::begin()
+{
+    advance(m_handle);
+    return iterator{m_handle};
+}
+
+template <typename T>
+inline typename basic_stream_generator<T>::sentinel basic_stream_generator<T>::end() const noexcept
+{
+    return {};
+}
+
+template <typename CharT, typename Traits, typename Source>
+inline basic_stream_generator<size_t> stream_matches(Source source, basic_str_view<CharT, Traits> needle,
+                                                     stream_options opt)
+{
+    basic_stream_scanner<CharT, Traits> scanner(needle);
+    detail::_chunk_pump_<CharT, Source> pump(source, opt);
+
+    std::vector<size_t> found;
+    const CharT *data;
+    size_t size;
+    while (pump.next(data, size))
+    {
+        found.clear();
+        scanner.feed(basic_str_view<CharT, Traits>(data, size), [&found](size_t pos) { found.push_back(pos); });
+        pump.release();
+        for (const size_t pos : found)
+        {
+            co_yield pos;
+        }
+    }
+}
+
+template <typename CharT, typename Source, typename Traits>
+inline basic_stream_generator<basic_str_view<CharT, Traits>> stream_records(Source source, CharT delim,
+                                                                            stream_options opt)
+{
+    using view_type = basic_str_view<CharT, Traits>;
+
+    basic_stream_splitter<CharT, Traits> splitter(delim);
+    detail::_chunk_pump_<CharT, Source> pump(source, opt);
+
+    // The records point into the chunk, so it goes back to the reader only after they have all been yielded.
+    std::vector<view_type> found;
+    const CharT *data;
+    size_t size;
+    while (pump.next(data, size))
+    {
+        found.clear();
+        splitter.feed(view_type(data, size), [&found](view_type record) { found.push_back(record); });
+        for (const view_type record : found)
+        {
+            co_yield record;
+        }
+        pump.release();
+    }
+    found.clear();
+    splitter.finish([&found](view_type record) { found.push_back(record); });
+    for (const view_type record : found)
+    {
+        co_yield record;
+    }
+}
+
+#endif // LAMBDA_HAS_COROUTINES
+
+} // namespace lambda
+
+#endif
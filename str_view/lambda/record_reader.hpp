@@ -0,0 +1,239 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Buffered reader handing out basic_str_view records from a stream
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_RECORD_READER_H
+#define STR_VIEW_RECORD_READER_H
+
+#include "str_view.hpp"
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace lambda
+{
+
+/// <summary>
+/// Splits a stream into delimiter terminated records without allocating per record. Source is any callable
+/// size_t(CharT *dst, size_t capacity) that stores up to capacity units and returns how many it stored; 0 means end of
+/// input and errors should be thrown. Partial reads are fine, so read()/recv() wrap directly:
+///
+///     auto reader = lambda::make_record_reader([fd](char *p, size_t n) { ... ::read(fd, p, n) ... }, '\n');
+///     for (lambda::str_view line; reader.next(line);) { ... }
+///
+/// Records point into the reader's buffer and stay valid until the next call to next(). A record that straddles a
+/// refill is moved to the front of the same buffer; the buffer only grows (doubling) when a single record is longer
+/// than it. The delimiter is not part of the record. A final record without a delimiter is still returned, an empty
+/// one is not.
+/// </summary>
+template <typename CharT, typename Source, typename Traits = std::char_traits<CharT>> struct basic_record_reader
+{
+    using view_type = basic_str_view<CharT, Traits>;
+    using size_type = typename view_type::size_type;
+
+    static constexpr size_type default_capacity = 64 * 1024;
+
+    explicit basic_record_reader(Source source, CharT delim = CharT('\n'), size_type capacity = default_capacity);
+
+    /// <summary>
+    /// Reads the next record into record.
+    /// </summary>
+    /// <param name="record"></param>
+    /// <returns>false once the input is exhausted.</returns>
+    bool next(view_type &record);
+
+    CharT delimiter() const noexcept;
+
+    /// <summary>
+    /// Buffer size in units of CharT.
+    /// </summary>
+    size_type capacity() const noexcept;
+
+    Source &source() noexcept;
+
+  private:
+    bool fill();
+
+    std::unique_ptr<CharT[]> m_buffer;
+    size_type m_capacity;
+    size_type m_begin;
+    size_type m_scan;
+    size_type m_end;
+    Source m_source;
+    CharT m_delim;
+    bool m_eof;
+};
+
+/// <summary>
+/// Source reading from a std::basic_istream. istream::read() only returns short at end of file, so prefer a
+/// read()/recv() source for pipes and sockets where records should be handed out as soon as they arrive.
+/// </summary>
+template <typename CharT, typename Traits = std::char_traits<CharT>> struct basic_istream_source
+{
+    explicit basic_istream_source(std::basic_istream<CharT, Traits> &in) noexcept;
+
+    size_t operator()(CharT *dst, size_t capacity);
+
+  private:
+    std::basic_istream<CharT, Traits> *m_in;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename Source> using record_reader = basic_record_reader<char, Source>;
+template <typename Source> using wrecord_reader = basic_record_reader<wchar_t, Source>;
+template <typename Source> using u16record_reader = basic_record_reader<char16_t, Source>;
+template <typename Source> using u32record_reader = basic_record_reader<char32_t, Source>;
+
+using istream_source = basic_istream_source<char>;
+using wistream_source = basic_istream_source<wchar_t>;
+
+/// <summary>
+/// Deduces the reader type from the source and the delimiter.
+/// </summary>
+template <typename CharT, typename Source,
+          typename Reader = basic_record_reader<CharT, typename std::decay<Source>::type>>
+inline Reader make_record_reader(Source &&source, CharT delim, size_t capacity = Reader::default_capacity)
+{
+    return Reader(std::forward<Source>(source), delim, capacity);
+}
+
+template <typename CharT, typename Source, typename Traits>
+constexpr typename basic_record_reader<CharT, Source, Traits>::size_type
+    basic_record_reader<CharT, Source, Traits>::default_capacity;
+
+template <typename CharT, typename Source, typename Traits>
+inline basic_record_reader<CharT, Source, Traits>::basic_record_reader(Source source, CharT delim, size_type capacity)
+    : m_buffer(new CharT[capacity != 0 ? capacity : 1]), m_capacity(capacity != 0 ? capacity : 1), m_begin(0),
+      m_scan(0), m_end(0), m_source(std::move(source)), m_delim(delim), m_eof(false)
+{
+}
+
+template <typename CharT, typename Source, typename Traits>
+inline bool basic_record_reader<CharT, Source, Traits>::next(view_type &record)
+{
+    for (;;)
+    {
+        // Only the bytes that arrived since the last refill are searched.
+        const size_type at = view_type(m_buffer.get() + m_scan, m_end - m_scan).find(m_delim);
+        if (at != view_type::npos)
+        {
+            const size_type stop = m_scan + at;
+            record = view_type(m_buffer.get() + m_begin, stop - m_begin);
+            m_begin = m_scan = stop + 1;
+            return true;
+        }
+        m_scan = m_end;
+
+        if (!fill())
+        {
+            if (m_begin == m_end)
+            {
+                return false;
+            }
+            record = view_type(m_buffer.get() + m_begin, m_end - m_begin);
+            m_begin = m_scan = m_end;
+            return true;
+        }
+    }
+}
+
+template <typename CharT, typename Source, typename Traits>
+inline bool basic_record_reader<CharT, Source, Traits>::fill()
+{
+    if (m_eof)
+    {
+        return false;
+    }
+
+    // Move the unfinished record to the front so the whole tail is free for the next read.
+    if (m_begin != 0)
+    {
+        Traits::move(m_buffer.get(), m_buffer.get() + m_begin, m_end - m_begin);
+        m_scan -= m_begin;
+        m_end -= m_begin;
+        m_begin = 0;
+    }
+
+    if (m_end == m_capacity)
+    {
+        std::unique_ptr<CharT[]> grown(new CharT[m_capacity * 2]);
+        Traits::copy(grown.get(), m_buffer.get(), m_end);
+        m_buffer = std::move(grown);
+        m_capacity *= 2;
+    }
+
+    const size_type got = m_source(m_buffer.get() + m_end, m_capacity - m_end);
+    if (got == 0)
+    {
+        m_eof = true;
+        return false;
+    }
+    m_end += got;
+    return true;
+}
+
+template <typename CharT, typename Source, typename Traits>
+inline CharT basic_record_reader<CharT, Source, Traits>::delimiter() const noexcept
+{
+    return m_delim;
+}
+
+template <typename CharT, typename Source, typename Traits>
+inline typename basic_record_reader<CharT, Source, Traits>::size_type basic_record_reader<
+    CharT, Source, Traits>::capacity() const noexcept
+{
+    return m_capacity;
+}
+
+template <typename CharT, typename Source, typename Traits>
+inline Source &basic_record_reader<CharT, Source, Traits>::source() noexcept
+{
+    return m_source;
+}
+
+template <typename CharT, typename Traits>
+inline basic_istream_source<CharT, Traits>::basic_istream_source(std::basic_istream<CharT, Traits> &in) noexcept
+    : m_in(&in)
+{
+}
+
+template <typename CharT, typename Traits>
+inline size_t basic_istream_source<CharT, Traits>::operator()(CharT *dst, size_t capacity)
+{
+    m_in->read(dst, static_cast<std::streamsize>(capacity));
+    return static_cast<size_t>(m_in->gcount());
+}
+
+} // namespace lambda
+
+#endif
@@ -0,0 +1,522 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Needle preprocessed once (at compile time for literals) and reused by find()
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_SEARCHER_H
+#define STR_VIEW_SEARCHER_H
+
+#include "config.hpp"
+#include "simd.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace lambda
+{
+
+template <typename CharT, typename Traits> struct basic_str_view;
+
+/// <summary>
+/// Substring search algorithms a basic_searcher can use.
+///  - anchored: the SIMD filter of str_view::find, on the two rarest needle units instead of the first and last.
+///  - horspool: Boyer-Moore-Horspool with a 256 entry skip table; jumps up to the needle length per probe.
+///  - two_way:  Crochemore-Perrin two-way on the critical factorization; linear in the worst case, constant space.
+/// </summary>
+enum class search_algorithm
+{
+    automatic,
+    anchored,
+    horspool,
+    two_way
+};
+
+/// <summary>
+/// Needle with all substring search tables built in the constructor, so a constexpr searcher costs nothing at runtime:
+///
+///     constexpr auto boundary = lambda::make_searcher("\r\n--frontier\r\n"_sv);
+///     for (size_t at = body.find(boundary); at != body.npos; at = body.find(boundary, at + 1)) { ... }
+///
+/// With search_algorithm::automatic the algorithm is chosen from the needle: long periodic needles (where the others
+/// degrade towards n * m) use two_way, needles whose Horspool jump over typical text is long use horspool, and the
+/// rest use the anchored SIMD filter. The needle is not copied and must outlive the searcher, which is
+/// automatic for literals. Units are matched exactly, so the views it searches must use std::char_traits.
+/// </summary>
+template <typename CharT> struct basic_searcher
+{
+    using char_type = CharT;
+    using size_type = size_t;
+
+    static constexpr size_type npos = size_type(-1);
+
+    /// <summary>
+    /// Constructs a searcher for the empty needle, which matches at every position.
+    /// </summary>
+    constexpr basic_searcher() noexcept;
+
+    /// <summary>
+    /// Preprocesses the needle [s, s + count).
+    /// </summary>
+    /// <param name="s"></param>
+    /// <param name="count"></param>
+    /// <param name="algorithm">Forces an algorithm; needles shorter than two units always use the trivial one.</param>
+    constexpr basic_searcher(const CharT *s, size_type count,
+                             search_algorithm algorithm = search_algorithm::automatic) noexcept;
+
+    /// <summary>
+    /// Preprocesses the needle v.
+    /// </summary>
+    /// <param name="v"></param>
+    /// <param name="algorithm"></param>
+    template <typename Traits>
+    constexpr explicit basic_searcher(basic_str_view<CharT, Traits> v,
+                                      search_algorithm algorithm = search_algorithm::automatic) noexcept;
+
+    constexpr const CharT *data() const noexcept;
+    constexpr size_type size() const noexcept;
+
+    /// <summary>
+    /// The algorithm find() runs; never search_algorithm::automatic.
+    /// </summary>
+    constexpr search_algorithm algorithm() const noexcept;
+
+    /// <summary>
+    /// Finds the first occurrence of the needle in h[0, n) at or after pos.
+    /// </summary>
+    /// <param name="h"></param>
+    /// <param name="n"></param>
+    /// <param name="pos"></param>
+    /// <returns>The index of the match, or npos.</returns>
+    constexpr size_type find(const CharT *h, size_type n, size_type pos = 0) const noexcept;
+
+  private:
+    using unit_type = typename std::make_unsigned<CharT>::type;
+
+    constexpr void prepare_anchors() noexcept;
+    constexpr void prepare_horspool() noexcept;
+    constexpr void prepare_two_way() noexcept;
+    constexpr void maximal_suffix(bool reversed, std::ptrdiff_t &suffix, std::ptrdiff_t &period) const noexcept;
+
+    constexpr size_type find_horspool(const CharT *h, size_type n, size_type pos) const noexcept;
+    constexpr size_type find_two_way(const CharT *h, size_type n, size_type pos) const noexcept;
+
+    static constexpr bool equal(const CharT *a, const CharT *b, size_type n) noexcept;
+
+    const CharT *m_needle;
+    size_type m_length;
+    search_algorithm m_algorithm;
+    size_type m_anchor_a;
+    size_type m_anchor_b;
+    size_type m_shift[256];
+    std::ptrdiff_t m_ell;
+    std::ptrdiff_t m_period;
+    bool m_periodic;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+using searcher = basic_searcher<char>;
+using wsearcher = basic_searcher<wchar_t>;
+using u16searcher = basic_searcher<char16_t>;
+using u32searcher = basic_searcher<char32_t>;
+
+/// <summary>
+/// Preprocesses the needle v, at compile time when the result is constexpr.
+/// </summary>
+template <typename CharT, typename Traits>
+inline constexpr basic_searcher<CharT> make_searcher(basic_str_view<CharT, Traits> v,
+                                                     search_algorithm algorithm = search_algorithm::automatic) noexcept
+{
+    return basic_searcher<CharT>(v.data(), v.size(), algorithm);
+}
+
+namespace detail
+{
+
+/// <summary>
+/// Rough commonness of a code unit in text and markup, higher is more common. Only the order matters: the searcher
+/// anchors on the lowest ranked needle units, which produce the fewest candidates.
+/// </summary>
+constexpr unsigned _unit_rank_(uint32_t u) noexcept
+{
+    constexpr const char *letters = "etaoinsrhldcumfpgwybvkxjqz";
+    if (u == ' ')
+    {
+        return 250;
+    }
+    if (u >= 'a' && u <= 'z')
+    {
+        unsigned i = 0;
+        while (static_cast<uint32_t>(letters[i]) != u)
+        {
+            ++i;
+        }
+        return 240 - 8 * i;
+    }
+    if (u >= 'A' && u <= 'Z')
+    {
+        unsigned i = 0;
+        while (static_cast<uint32_t>(letters[i]) != u + ('a' - 'A'))
+        {
+            ++i;
+        }
+        return 120 - 4 * i;
+    }
+    if (u >= '0' && u <= '9')
+    {
+        return 95;
+    }
+    switch (u)
+    {
+    case 0:
+    case '\n':
+    case '\r':
+    case '\t':
+    case ',':
+    case '.':
+    case '/':
+    case '-':
+    case '_':
+    case ':':
+    case '=':
+    case '"':
+    case '\'':
+    case '<':
+    case '>':
+        return 110;
+    default:
+        break;
+    }
+    if (u < 0x20)
+    {
+        return 5;
+    }
+    if (u < 0x80)
+    {
+        return 30;
+    }
+    // UTF-8 continuation and lead bytes are common in non-ASCII text; wide units are spread over a large range.
+    return u < 0xC0 ? 60 : (u < 0x100 ? 50 : 10);
+}
+
+} // namespace detail
+
+template <typename CharT> constexpr typename basic_searcher<CharT>::size_type basic_searcher<CharT>::npos;
+
+template <typename CharT>
+inline constexpr basic_searcher<CharT>::basic_searcher() noexcept : basic_searcher(nullptr, 0)
+{
+}
+
+template <typename CharT>
+inline constexpr basic_searcher<CharT>::basic_searcher(const CharT *s, size_type count,
+                                                       search_algorithm algorithm) noexcept
+    : m_needle(s), m_length(count), m_algorithm(search_algorithm::anchored), m_anchor_a(0), m_anchor_b(0),
+      m_shift{}, m_ell(-1), m_period(1), m_periodic(false)
+{
+    if (m_length < 2)
+    {
+        // find() takes the trivial paths; the table is still needed for constant evaluation.
+        prepare_horspool();
+        return;
+    }
+
+    prepare_anchors();
+    prepare_horspool();
+    prepare_two_way();
+
+    if (algorithm != search_algorithm::automatic)
+    {
+        m_algorithm = algorithm;
+        return;
+    }
+
+    // The SIMD filter steps a vector at a time whatever the needle; Horspool wins once its expected jump, with the
+    // haystack units weighted by detail::_unit_rank_, is several vectors long. Periodic needles (period at most a
+    // quarter of the needle) trigger a full compare at every repetition under both, so they get the linear two-way.
+    if (m_length >= 32 && m_periodic && static_cast<size_type>(m_period) * 4 <= m_length)
+    {
+        m_algorithm = search_algorithm::two_way;
+        return;
+    }
+
+    size_type weight = 0, weighted_shift = 0;
+    for (uint32_t u = 0; u < 256; ++u)
+    {
+        weight += detail::_unit_rank_(u);
+        weighted_shift += detail::_unit_rank_(u) * m_shift[u];
+    }
+    if (weighted_shift >= 96 * weight)
+    {
+        m_algorithm = search_algorithm::horspool;
+    }
+}
+
+template <typename CharT>
+template <typename Traits>
+inline constexpr basic_searcher<CharT>::basic_searcher(basic_str_view<CharT, Traits> v,
+                                                       search_algorithm algorithm) noexcept
+    : basic_searcher(v.data(), v.size(), algorithm)
+{
+}
+
+template <typename CharT> inline constexpr const CharT *basic_searcher<CharT>::data() const noexcept
+{
+    return m_needle;
+}
+
+template <typename CharT>
+inline constexpr typename basic_searcher<CharT>::size_type basic_searcher<CharT>::size() const noexcept
+{
+    return m_length;
+}
+
+template <typename CharT> inline constexpr search_algorithm basic_searcher<CharT>::algorithm() const noexcept
+{
+    return m_algorithm;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+/// The rarest unit is the first anchor; the second is the rarest unit with a different value, so that the pair
+/// filters better than either alone. A needle of one repeated unit anchors on both of its ends.
+template <typename CharT> inline constexpr void basic_searcher<CharT>::prepare_anchors() noexcept
+{
+    size_type a = 0;
+    for (size_type i = 1; i < m_length; ++i)
+    {
+        if (detail::_unit_rank_(static_cast<unit_type>(m_needle[i])) <
+            detail::_unit_rank_(static_cast<unit_type>(m_needle[a])))
+        {
+            a = i;
+        }
+    }
+
+    size_type b = npos;
+    for (size_type i = 0; i < m_length; ++i)
+    {
+        if (m_needle[i] != m_needle[a] &&
+            (b == npos || detail::_unit_rank_(static_cast<unit_type>(m_needle[i])) <
+                              detail::_unit_rank_(static_cast<unit_type>(m_needle[b]))))
+        {
+            b = i;
+        }
+    }
+
+    if (b == npos)
+    {
+        a = 0;
+        b = m_length - 1;
+    }
+    m_anchor_a = a;
+    m_anchor_b = b;
+}
+
+/// Units are bucketed by their low byte; later positions overwrite earlier ones, which keeps the smallest shift of
+/// every bucket and so stays correct for wide units that share one.
+template <typename CharT> inline constexpr void basic_searcher<CharT>::prepare_horspool() noexcept
+{
+    for (size_type &shift : m_shift)
+    {
+        shift = m_length != 0 ? m_length : 1;
+    }
+    for (size_type i = 0; i + 1 < m_length; ++i)
+    {
+        m_shift[static_cast<unit_type>(m_needle[i]) & 0xFFu] = m_length - 1 - i;
+    }
+}
+
+/// Critical factorization: the later of the maximal suffixes under both unit orders, and the period of the needle
+/// if its left part repeats (otherwise a shift larger than either half, which is then always safe).
+template <typename CharT> inline constexpr void basic_searcher<CharT>::prepare_two_way() noexcept
+{
+    std::ptrdiff_t s1 = -1, p1 = 1, s2 = -1, p2 = 1;
+    maximal_suffix(false, s1, p1);
+    maximal_suffix(true, s2, p2);
+
+    m_ell = s1 > s2 ? s1 : s2;
+    m_period = s1 > s2 ? p1 : p2;
+
+    const std::ptrdiff_t m = static_cast<std::ptrdiff_t>(m_length);
+    m_periodic = m_ell + 1 + m_period <= m;
+    for (std::ptrdiff_t i = 0; m_periodic && i <= m_ell; ++i)
+    {
+        m_periodic = m_needle[i] == m_needle[i + m_period];
+    }
+    if (!m_periodic)
+    {
+        m_period = (m_ell + 1 > m - m_ell - 1 ? m_ell + 1 : m - m_ell - 1) + 1;
+    }
+}
+
+template <typename CharT>
+inline constexpr void basic_searcher<CharT>::maximal_suffix(bool reversed, std::ptrdiff_t &suffix,
+                                                            std::ptrdiff_t &period) const noexcept
+{
+    const std::ptrdiff_t m = static_cast<std::ptrdiff_t>(m_length);
+    std::ptrdiff_t ms = -1, j = 0, k = 1, p = 1;
+    while (j + k < m)
+    {
+        const unit_type a = static_cast<unit_type>(m_needle[j + k]);
+        const unit_type b = static_cast<unit_type>(m_needle[ms + k]);
+        if (reversed ? a > b : a < b)
+        {
+            j += k;
+            k = 1;
+            p = j - ms;
+        }
+        else if (a == b)
+        {
+            if (k != p)
+            {
+                ++k;
+            }
+            else
+            {
+                j += p;
+                k = 1;
+            }
+        }
+        else
+        {
+            ms = j;
+            j = ms + 1;
+            k = p = 1;
+        }
+    }
+    suffix = ms;
+    period = p;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT>
+inline constexpr typename basic_searcher<CharT>::size_type basic_searcher<CharT>::find(const CharT *h, size_type n,
+                                                                                      size_type pos) const noexcept
+{
+    if (pos > n || m_length > n - pos)
+    {
+        return npos;
+    }
+    if (m_length == 0)
+    {
+        return pos;
+    }
+
+    if (!LAMBDA_IS_CONSTANT_EVALUATED() && (m_length == 1 || m_algorithm == search_algorithm::anchored))
+    {
+        const size_type idx = m_length == 1 ? simd::find_char(h + pos, n - pos, m_needle[0])
+                                            : simd::find_anchored(h + pos, n - pos, m_needle, m_length, m_anchor_a,
+                                                                  m_anchor_b);
+        return idx == simd::npos ? npos : idx + pos;
+    }
+
+    // Constant evaluation of the anchored filter falls back to Horspool, whose table is always built.
+    return m_algorithm == search_algorithm::two_way && m_length > 1 ? find_two_way(h, n, pos)
+                                                                     : find_horspool(h, n, pos);
+}
+
+template <typename CharT>
+inline constexpr typename basic_searcher<CharT>::size_type basic_searcher<CharT>::find_horspool(
+    const CharT *h, size_type n, size_type pos) const noexcept
+{
+    const CharT last = m_needle[m_length - 1];
+    for (size_type i = pos; i + m_length <= n;)
+    {
+        const CharT c = h[i + m_length - 1];
+        if (c == last && equal(h + i, m_needle, m_length - 1))
+        {
+            return i;
+        }
+        i += m_shift[static_cast<unit_type>(c) & 0xFFu];
+    }
+    return npos;
+}
+
+/// Matches the right part left to right, then the left part right to left. For periodic needles the prefix already
+/// known to match after a shift by the period is remembered and not compared again.
+template <typename CharT>
+inline constexpr typename basic_searcher<CharT>::size_type basic_searcher<CharT>::find_two_way(
+    const CharT *h, size_type n, size_type pos) const noexcept
+{
+    const std::ptrdiff_t m = static_cast<std::ptrdiff_t>(m_length);
+    const CharT *s = m_needle;
+
+    std::ptrdiff_t memory = -1;
+    for (size_type j = pos; j + m_length <= n;)
+    {
+        const CharT *y = h + j;
+        std::ptrdiff_t i = (m_ell > memory ? m_ell : memory) + 1;
+        while (i < m && s[i] == y[i])
+        {
+            ++i;
+        }
+        if (i < m)
+        {
+            j += static_cast<size_type>(i - m_ell);
+            memory = -1;
+            continue;
+        }
+
+        i = m_ell;
+        while (i > memory && s[i] == y[i])
+        {
+            --i;
+        }
+        if (i <= memory)
+        {
+            return j;
+        }
+        j += static_cast<size_type>(m_period);
+        memory = m_periodic ? m - m_period - 1 : -1;
+    }
+    return npos;
+}
+
+template <typename CharT>
+inline constexpr bool basic_searcher<CharT>::equal(const CharT *a, const CharT *b, size_type n) noexcept
+{
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return n == 0 || std::memcmp(a, b, n * sizeof(CharT)) == 0;
+    }
+    for (size_type i = 0; i < n; ++i)
+    {
+        if (a[i] != b[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace lambda
+
+#endif
@@ -0,0 +1,977 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : basic_str_view over a sequence of fragments, for scatter-gather buffers
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_SEGMENTED_VIEW_H
+#define STR_VIEW_SEGMENTED_VIEW_H
+
+#include "str_view.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+// For WSABUF. The guards are those of mapped_file.hpp: no min/max macros, and no winsock.h from windows.h.
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#define LAMBDA_UNDEF_NOMINMAX
+#endif
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#define LAMBDA_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#if defined(LAMBDA_UNDEF_WIN32_LEAN_AND_MEAN)
+#undef WIN32_LEAN_AND_MEAN
+#undef LAMBDA_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#if defined(LAMBDA_UNDEF_NOMINMAX)
+#undef NOMINMAX
+#undef LAMBDA_UNDEF_NOMINMAX
+#endif
+#else
+#include <sys/uio.h>
+#endif
+
+namespace lambda
+{
+
+/// <summary>
+/// A string made of several non-owning basic_str_view fragments, searched and compared as if it were contiguous.
+/// Matches may span fragment boundaries. The first N fragments are stored inline; more spill into a heap array.
+/// Empty fragments are dropped on append.
+///
+/// Only the fragment table is copied, never the characters, so a received scatter-gather payload can be inspected in
+/// place and written out again with writev()/WSASend() through to_iovec()/to_wsabuf():
+///
+///     lambda::segmented_str_view msg{header, body, trailer};
+///     if (msg.starts_with("HTTP/1.1 200") && msg.find("\r\n\r\n") != msg.npos) { ... }
+///
+/// Positions are offsets into the concatenation. Iterators are invalidated by any modification, and by copying or
+/// moving the view itself.
+/// </summary>
+template <typename CharT, typename Traits = std::char_traits<CharT>, size_t N = 8> struct basic_segmented_str_view
+{
+    using view_type = basic_str_view<CharT, Traits>;
+    using trait_type = Traits;
+    using value_type = CharT;
+    using size_type = typename view_type::size_type;
+    using const_reference = const CharT &;
+
+    static constexpr size_type npos = view_type::npos;
+    static constexpr size_type inline_capacity = N;
+
+    struct const_iterator;
+    using iterator = const_iterator;
+
+    basic_segmented_str_view() noexcept;
+    basic_segmented_str_view(std::initializer_list<view_type> fragments);
+
+    /// <summary>
+    /// Appends every view in [first, last).
+    /// </summary>
+    template <typename It> basic_segmented_str_view(It first, It last);
+
+    /// <summary>
+    /// Appends a fragment at the end. Does nothing for an empty fragment.
+    /// </summary>
+    /// <param name="fragment"></param>
+    void append(view_type fragment);
+    void clear() noexcept;
+
+    size_type size() const noexcept;
+    size_type length() const noexcept;
+    bool empty() const noexcept;
+
+    size_type fragment_count() const noexcept;
+
+    /// <summary>
+    /// The i-th non-empty fragment. Requires i &lt; fragment_count().
+    /// </summary>
+    /// <param name="i"></param>
+    /// <returns></returns>
+    view_type fragment(size_type i) const noexcept;
+
+    /// <summary>
+    /// Position of the first character of the i-th fragment. Requires i &lt; fragment_count().
+    /// </summary>
+    /// <param name="i"></param>
+    /// <returns></returns>
+    size_type fragment_offset(size_type i) const noexcept;
+
+    const_reference operator[](size_type pos) const noexcept;
+    const_reference at(size_type pos) const;
+    const_reference front() const noexcept;
+    const_reference back() const noexcept;
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+
+    // --------------------------------------------------------------------------------------------------
+    // Slicing and copying
+    // --------------------------------------------------------------------------------------------------
+
+    /// <summary>
+    /// The fragments covering [pos, pos + min(count, size() - pos)), trimmed at both ends.
+    /// </summary>
+    /// <param name="pos"></param>
+    /// <param name="count"></param>
+    /// <returns></returns>
+    basic_segmented_str_view substr(size_type pos = 0, size_type count = npos) const;
+
+    void remove_prefix(size_type n);
+    void remove_suffix(size_type n);
+
+    size_type copy(CharT *dest, size_type count, size_type pos = 0) const;
+
+    template <typename Allocator = std::allocator<CharT>>
+    std::basic_string<CharT, Traits, Allocator> to_string(const Allocator &all) const;
+
+    // --------------------------------------------------------------------------------------------------
+    // Search. Each fragment is searched with basic_str_view (and so with the SIMD kernels); only the
+    // starts within needle.size() - 1 units of a boundary are matched across fragments.
+    // --------------------------------------------------------------------------------------------------
+
+    size_type find(view_type v, size_type pos = 0) const noexcept;
+    size_type find(CharT c, size_type pos = 0) const noexcept;
+    size_type rfind(view_type v, size_type pos = npos) const noexcept;
+    size_type rfind(CharT c, size_type pos = npos) const noexcept;
+
+    bool contains(view_type v) const noexcept;
+    bool contains(CharT c) const noexcept;
+    bool starts_with(view_type v) const noexcept;
+    bool ends_with(view_type v) const noexcept;
+
+    // --------------------------------------------------------------------------------------------------
+    // Comparison, in the same lexicographical order as basic_str_view::compare
+    // --------------------------------------------------------------------------------------------------
+
+    int compare(view_type v) const noexcept;
+    int compare(const basic_segmented_str_view &other) const noexcept;
+    bool equals(view_type v) const noexcept;
+    bool equals(const basic_segmented_str_view &other) const noexcept;
+
+    // --------------------------------------------------------------------------------------------------
+    // Zero-copy export for vectored I/O
+    // --------------------------------------------------------------------------------------------------
+
+#if defined(_WIN32)
+    /// <summary>
+    /// Describes fragments [first, first + capacity) in out for WSASend(). Throws std::length_error for a fragment
+    /// larger than a WSABUF can hold.
+    /// </summary>
+    /// <param name="out"></param>
+    /// <param name="capacity"></param>
+    /// <param name="first"></param>
+    /// <returns>The number of entries written, min(capacity, fragment_count() - first).</returns>
+    size_type to_wsabuf(WSABUF *out, size_type capacity, size_type first = 0) const;
+#else
+    /// <summary>
+    /// Describes fragments [first, first + capacity) in out for writev(). A payload with more than IOV_MAX fragments
+    /// is written in batches by advancing first.
+    /// </summary>
+    /// <param name="out"></param>
+    /// <param name="capacity"></param>
+    /// <param name="first"></param>
+    /// <returns>The number of entries written, min(capacity, fragment_count() - first).</returns>
+    size_type to_iovec(struct iovec *out, size_type capacity, size_type first = 0) const noexcept;
+#endif
+
+  private:
+    struct segment
+    {
+        view_type view;
+        size_type offset;
+    };
+
+    const segment *segments() const noexcept;
+
+    /// <summary>
+    /// Index of the fragment holding pos. Requires pos &lt; size().
+    /// </summary>
+    size_type locate(size_type pos) const noexcept;
+
+    /// <summary>
+    /// Whether v occurs at offset local of fragment f, continuing into the following fragments if needed.
+    /// </summary>
+    bool match_at(size_type f, size_type local, view_type v) const noexcept;
+
+    static int compare_segments(const segment *a, size_type na, const segment *b, size_type nb) noexcept;
+
+    segment m_inline[N];
+    std::vector<segment> m_spill;
+    size_type m_count;
+    size_type m_size;
+};
+
+/// <summary>
+/// Bidirectional iterator over the characters, stepping from one fragment into the next.
+/// </summary>
+template <typename CharT, typename Traits, size_t N> struct basic_segmented_str_view<CharT, Traits, N>::const_iterator
+{
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = CharT;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const CharT *;
+    using reference = const CharT &;
+
+    const_iterator() noexcept;
+
+    reference operator*() const noexcept;
+    pointer operator->() const noexcept;
+
+    const_iterator &operator++() noexcept;
+    const_iterator operator++(int) noexcept;
+    const_iterator &operator--() noexcept;
+    const_iterator operator--(int) noexcept;
+
+    bool operator==(const const_iterator &other) const noexcept;
+    bool operator!=(const const_iterator &other) const noexcept;
+
+  private:
+    friend struct basic_segmented_str_view;
+
+    const_iterator(const segment *segments, size_type fragment, size_type offset) noexcept;
+
+    const segment *m_segments;
+    size_type m_fragment;
+    size_type m_offset;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+using segmented_str_view = basic_segmented_str_view<char>;
+using wsegmented_str_view = basic_segmented_str_view<wchar_t>;
+using u16segmented_str_view = basic_segmented_str_view<char16_t>;
+using u32segmented_str_view = basic_segmented_str_view<char32_t>;
+
+template <typename CharT, typename Traits, size_t N>
+constexpr typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<CharT, Traits,
+                                                                                                    N>::npos;
+
+template <typename CharT, typename Traits, size_t N>
+constexpr typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<CharT, Traits,
+                                                                                                    N>::inline_capacity;
+
+template <typename CharT, typename Traits, size_t N>
+inline basic_segmented_str_view<CharT, Traits, N>::basic_segmented_str_view() noexcept
+    : m_inline(), m_spill(), m_count(0), m_size(0)
+{
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline basic_segmented_str_view<CharT, Traits, N>::basic_segmented_str_view(std::initializer_list<view_type> fragments)
+    : basic_segmented_str_view(fragments.begin(), fragments.end())
+{
+}
+
+template <typename CharT, typename Traits, size_t N>
+template <typename It>
+inline basic_segmented_str_view<CharT, Traits, N>::basic_segmented_str_view(It first, It last)
+    : basic_segmented_str_view()
+{
+    for (; first != last; ++first)
+    {
+        append(*first);
+    }
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline void basic_segmented_str_view<CharT, Traits, N>::append(view_type fragment)
+{
+    if (fragment.empty())
+    {
+        return;
+    }
+
+    const segment s = {fragment, m_size};
+    if (m_spill.empty() && m_count < N)
+    {
+        m_inline[m_count] = s;
+    }
+    else
+    {
+        if (m_spill.empty())
+        {
+            m_spill.reserve(2 * N);
+            m_spill.assign(m_inline, m_inline + m_count);
+        }
+        m_spill.push_back(s);
+    }
+    ++m_count;
+    m_size += fragment.size();
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline void basic_segmented_str_view<CharT, Traits, N>::clear() noexcept
+{
+    m_spill.clear();
+    m_count = 0;
+    m_size = 0;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<CharT, Traits, N>::size()
+    const noexcept
+{
+    return m_size;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<
+    CharT, Traits, N>::length() const noexcept
+{
+    return m_size;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool basic_segmented_str_view<CharT, Traits, N>::empty() const noexcept
+{
+    return m_size == 0;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<
+    CharT, Traits, N>::fragment_count() const noexcept
+{
+    return m_count;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::view_type basic_segmented_str_view<
+    CharT, Traits, N>::fragment(size_type i) const noexcept
+{
+    LAMBDA_STR_VIEW_ASSERT(i < m_count);
+    return segments()[i].view;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<
+    CharT, Traits, N>::fragment_offset(size_type i) const noexcept
+{
+    LAMBDA_STR_VIEW_ASSERT(i < m_count);
+    return segments()[i].offset;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::const_reference basic_segmented_str_view<
+    CharT, Traits, N>::operator[](size_type pos) const noexcept
+{
+    LAMBDA_STR_VIEW_ASSERT(pos < m_size);
+    const segment &s = segments()[locate(pos)];
+    return s.view[pos - s.offset];
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::const_reference basic_segmented_str_view<
+    CharT, Traits, N>::at(size_type pos) const
+{
+    if (pos >= m_size)
+    {
+        utility::_throw_out_of_range_("Index out of range in lambda::segmented_str_view::at");
+    }
+    return (*this)[pos];
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::const_reference basic_segmented_str_view<
+    CharT, Traits, N>::front() const noexcept
+{
+    LAMBDA_STR_VIEW_ASSERT(m_count != 0);
+    return segments()[0].view[0];
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::const_reference basic_segmented_str_view<
+    CharT, Traits, N>::back() const noexcept
+{
+    LAMBDA_STR_VIEW_ASSERT(m_count != 0);
+    const view_type &v = segments()[m_count - 1].view;
+    return v[v.size() - 1];
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::const_iterator basic_segmented_str_view<
+    CharT, Traits, N>::begin() const noexcept
+{
+    return const_iterator(segments(), 0, 0);
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::const_iterator basic_segmented_str_view<
+    CharT, Traits, N>::end() const noexcept
+{
+    return const_iterator(segments(), m_count, 0);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits, size_t N>
+inline basic_segmented_str_view<CharT, Traits, N> basic_segmented_str_view<CharT, Traits, N>::substr(
+    size_type pos, size_type count) const
+{
+    if (pos > m_size)
+    {
+        utility::_throw_out_of_range_("Index out of range in lambda::segmented_str_view::substr");
+    }
+
+    basic_segmented_str_view result;
+    count = std::min(count, m_size - pos);
+    if (count == 0)
+    {
+        return result;
+    }
+
+    const segment *s = segments();
+    for (size_type f = locate(pos), local = pos - s[f].offset; count != 0; ++f, local = 0)
+    {
+        const size_type take = std::min(s[f].view.size() - local, count);
+        result.append(s[f].view.unchecked_substr(local, take));
+        count -= take;
+    }
+    return result;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline void basic_segmented_str_view<CharT, Traits, N>::remove_prefix(size_type n)
+{
+    if (n > m_size)
+    {
+        utility::_throw_out_of_range_("Index out of range in lambda::segmented_str_view::remove_prefix");
+    }
+    *this = substr(n);
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline void basic_segmented_str_view<CharT, Traits, N>::remove_suffix(size_type n)
+{
+    if (n > m_size)
+    {
+        utility::_throw_out_of_range_("Index out of range in lambda::segmented_str_view::remove_suffix");
+    }
+    *this = substr(0, m_size - n);
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<CharT, Traits, N>::copy(
+    CharT *dest, size_type count, size_type pos) const
+{
+    if (pos > m_size)
+    {
+        utility::_throw_out_of_range_("Index out of range in lambda::segmented_str_view::copy");
+    }
+
+    const size_type rc = std::min(count, m_size - pos);
+    if (rc == 0)
+    {
+        return 0;
+    }
+
+    const segment *s = segments();
+    size_type done = 0;
+    for (size_type f = locate(pos), local = pos - s[f].offset; done != rc; ++f, local = 0)
+    {
+        done += s[f].view.copy(dest + done, rc - done, local);
+    }
+    return rc;
+}
+
+template <typename CharT, typename Traits, size_t N>
+template <typename Allocator>
+inline std::basic_string<CharT, Traits, Allocator> basic_segmented_str_view<CharT, Traits, N>::to_string(
+    const Allocator &all) const
+{
+    std::basic_string<CharT, Traits, Allocator> out(all);
+    out.reserve(m_size);
+    const segment *s = segments();
+    for (size_type f = 0; f < m_count; ++f)
+    {
+        out.append(s[f].view.data(), s[f].view.size());
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<CharT, Traits, N>::find(
+    view_type v, size_type pos) const noexcept
+{
+    const size_type m = v.size();
+    if (pos > m_size || m > m_size - pos)
+    {
+        return npos;
+    }
+    if (m == 0)
+    {
+        return pos;
+    }
+
+    const segment *s = segments();
+    for (size_type f = locate(pos), local = pos - s[f].offset; f < m_count; ++f, local = 0)
+    {
+        const view_type frag = s[f].view;
+
+        // Matches inside the fragment come before any that start in its last m - 1 units.
+        if (frag.size() >= m && local <= frag.size() - m)
+        {
+            const size_type j = frag.find(v, local);
+            if (j != view_type::npos)
+            {
+                return s[f].offset + j;
+            }
+            local = frag.size() - m + 1;
+        }
+
+        for (local = frag.find(v[0], local); local != view_type::npos; local = frag.find(v[0], local + 1))
+        {
+            if (s[f].offset + local > m_size - m)
+            {
+                return npos;
+            }
+            if (match_at(f, local, v))
+            {
+                return s[f].offset + local;
+            }
+        }
+    }
+    return npos;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<CharT, Traits, N>::find(
+    CharT c, size_type pos) const noexcept
+{
+    if (pos >= m_size)
+    {
+        return npos;
+    }
+
+    const segment *s = segments();
+    for (size_type f = locate(pos), local = pos - s[f].offset; f < m_count; ++f, local = 0)
+    {
+        const size_type j = s[f].view.find(c, local);
+        if (j != view_type::npos)
+        {
+            return s[f].offset + j;
+        }
+    }
+    return npos;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<
+    CharT, Traits, N>::rfind(view_type v, size_type pos) const noexcept
+{
+    const size_type m = v.size();
+    if (m > m_size)
+    {
+        return npos;
+    }
+    const size_type last = std::min(pos, m_size - m);
+    if (m == 0)
+    {
+        return last;
+    }
+
+    const segment *s = segments();
+    size_type f = locate(last);
+    for (size_type local = last - s[f].offset;; local = s[f].view.size() - 1)
+    {
+        const view_type frag = s[f].view;
+
+        // Starts in the last m - 1 units come after every match inside the fragment.
+        const size_type inside = frag.size() >= m ? frag.size() - m + 1 : 0;
+        for (size_type j = local + 1; j-- > inside;)
+        {
+            if (Traits::eq(frag[j], v[0]) && match_at(f, j, v))
+            {
+                return s[f].offset + j;
+            }
+        }
+        if (inside != 0)
+        {
+            const size_type j = frag.rfind(v, std::min(local, inside - 1));
+            if (j != view_type::npos)
+            {
+                return s[f].offset + j;
+            }
+        }
+
+        if (f == 0)
+        {
+            return npos;
+        }
+        --f;
+    }
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<
+    CharT, Traits, N>::rfind(CharT c, size_type pos) const noexcept
+{
+    if (m_size == 0)
+    {
+        return npos;
+    }
+
+    const segment *s = segments();
+    const size_type last = std::min(pos, m_size - 1);
+    size_type f = locate(last);
+    for (size_type local = last - s[f].offset;; local = npos)
+    {
+        const size_type j = s[f].view.rfind(c, local);
+        if (j != view_type::npos)
+        {
+            return s[f].offset + j;
+        }
+        if (f == 0)
+        {
+            return npos;
+        }
+        --f;
+    }
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool basic_segmented_str_view<CharT, Traits, N>::contains(view_type v) const noexcept
+{
+    return find(v) != npos;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool basic_segmented_str_view<CharT, Traits, N>::contains(CharT c) const noexcept
+{
+    return find(c) != npos;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool basic_segmented_str_view<CharT, Traits, N>::starts_with(view_type v) const noexcept
+{
+    return v.size() <= m_size && (v.empty() || match_at(0, 0, v));
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool basic_segmented_str_view<CharT, Traits, N>::ends_with(view_type v) const noexcept
+{
+    if (v.size() > m_size)
+    {
+        return false;
+    }
+    if (v.empty())
+    {
+        return true;
+    }
+    const size_type pos = m_size - v.size();
+    const size_type f = locate(pos);
+    return match_at(f, pos - segments()[f].offset, v);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits, size_t N>
+inline int basic_segmented_str_view<CharT, Traits, N>::compare(view_type v) const noexcept
+{
+    const segment other = {v, 0};
+    return compare_segments(segments(), m_count, &other, v.empty() ? 0 : 1);
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline int basic_segmented_str_view<CharT, Traits, N>::compare(const basic_segmented_str_view &other) const noexcept
+{
+    return compare_segments(segments(), m_count, other.segments(), other.m_count);
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool basic_segmented_str_view<CharT, Traits, N>::equals(view_type v) const noexcept
+{
+    return m_size == v.size() && starts_with(v);
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool basic_segmented_str_view<CharT, Traits, N>::equals(const basic_segmented_str_view &other) const noexcept
+{
+    return m_size == other.m_size && compare(other) == 0;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline int basic_segmented_str_view<CharT, Traits, N>::compare_segments(const segment *a, size_type na,
+                                                                        const segment *b, size_type nb) noexcept
+{
+    size_type i = 0, j = 0, ai = 0, bj = 0;
+    while (i < na && j < nb)
+    {
+        const size_type n = std::min(a[i].view.size() - ai, b[j].view.size() - bj);
+        const int rc = Traits::compare(a[i].view.data() + ai, b[j].view.data() + bj, n);
+        if (rc != 0)
+        {
+            return rc;
+        }
+        ai += n;
+        bj += n;
+        if (ai == a[i].view.size())
+        {
+            ++i;
+            ai = 0;
+        }
+        if (bj == b[j].view.size())
+        {
+            ++j;
+            bj = 0;
+        }
+    }
+    return i < na ? 1 : (j < nb ? -1 : 0);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+#if defined(_WIN32)
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<
+    CharT, Traits, N>::to_wsabuf(WSABUF *out, size_type capacity, size_type first) const
+{
+    const segment *s = segments();
+    const size_type n = first < m_count ? std::min(capacity, m_count - first) : 0;
+    for (size_type i = 0; i < n; ++i)
+    {
+        const view_type frag = s[first + i].view;
+        if (frag.size() > ULONG(-1) / sizeof(CharT))
+        {
+            throw std::length_error("Fragment too large for a WSABUF in lambda::segmented_str_view::to_wsabuf");
+        }
+        out[i].buf = reinterpret_cast<CHAR *>(const_cast<CharT *>(frag.data()));
+        out[i].len = static_cast<ULONG>(frag.size() * sizeof(CharT));
+    }
+    return n;
+}
+#else
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<
+    CharT, Traits, N>::to_iovec(struct iovec *out, size_type capacity, size_type first) const noexcept
+{
+    const segment *s = segments();
+    const size_type n = first < m_count ? std::min(capacity, m_count - first) : 0;
+    for (size_type i = 0; i < n; ++i)
+    {
+        const view_type frag = s[first + i].view;
+        out[i].iov_base = const_cast<CharT *>(frag.data());
+        out[i].iov_len = frag.size() * sizeof(CharT);
+    }
+    return n;
+}
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits, size_t N>
+inline const typename basic_segmented_str_view<CharT, Traits, N>::segment *basic_segmented_str_view<
+    CharT, Traits, N>::segments() const noexcept
+{
+    return m_spill.empty() ? m_inline : m_spill.data();
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::size_type basic_segmented_str_view<
+    CharT, Traits, N>::locate(size_type pos) const noexcept
+{
+    LAMBDA_STR_VIEW_ASSERT(pos < m_size);
+    const segment *s = segments();
+    const segment *hit = std::upper_bound(s, s + m_count, pos,
+                                          [](size_type p, const segment &seg) { return p < seg.offset; });
+    return static_cast<size_type>(hit - s) - 1;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool basic_segmented_str_view<CharT, Traits, N>::match_at(size_type f, size_type local,
+                                                                 view_type v) const noexcept
+{
+    const segment *s = segments();
+    for (size_type done = 0; done != v.size(); ++f, local = 0)
+    {
+        if (f == m_count)
+        {
+            return false;
+        }
+        const size_type n = std::min(s[f].view.size() - local, v.size() - done);
+        if (Traits::compare(s[f].view.data() + local, v.data() + done, n) != 0)
+        {
+            return false;
+        }
+        done += n;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits, size_t N>
+inline basic_segmented_str_view<CharT, Traits, N>::const_iterator::const_iterator() noexcept
+    : m_segments(nullptr), m_fragment(0), m_offset(0)
+{
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline basic_segmented_str_view<CharT, Traits, N>::const_iterator::const_iterator(const segment *segments,
+                                                                                  size_type fragment,
+                                                                                  size_type offset) noexcept
+    : m_segments(segments), m_fragment(fragment), m_offset(offset)
+{
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::const_iterator::reference basic_segmented_str_view<
+    CharT, Traits, N>::const_iterator::operator*() const noexcept
+{
+    return m_segments[m_fragment].view[m_offset];
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::const_iterator::pointer basic_segmented_str_view<
+    CharT, Traits, N>::const_iterator::operator->() const noexcept
+{
+    return m_segments[m_fragment].view.data() + m_offset;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::const_iterator &basic_segmented_str_view<
+    CharT, Traits, N>::const_iterator::operator++() noexcept
+{
+    if (++m_offset == m_segments[m_fragment].view.size())
+    {
+        ++m_fragment;
+        m_offset = 0;
+    }
+    return *this;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::const_iterator basic_segmented_str_view<
+    CharT, Traits, N>::const_iterator::operator++(int) noexcept
+{
+    const_iterator prev = *this;
+    ++*this;
+    return prev;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::const_iterator &basic_segmented_str_view<
+    CharT, Traits, N>::const_iterator::operator--() noexcept
+{
+    if (m_offset == 0)
+    {
+        --m_fragment;
+        m_offset = m_segments[m_fragment].view.size();
+    }
+    --m_offset;
+    return *this;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline typename basic_segmented_str_view<CharT, Traits, N>::const_iterator basic_segmented_str_view<
+    CharT, Traits, N>::const_iterator::operator--(int) noexcept
+{
+    const_iterator prev = *this;
+    --*this;
+    return prev;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool basic_segmented_str_view<CharT, Traits, N>::const_iterator::operator==(
+    const const_iterator &other) const noexcept
+{
+    return m_fragment == other.m_fragment && m_offset == other.m_offset;
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool basic_segmented_str_view<CharT, Traits, N>::const_iterator::operator!=(
+    const const_iterator &other) const noexcept
+{
+    return !(*this == other);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits, size_t N>
+inline bool operator==(const basic_segmented_str_view<CharT, Traits, N> &lhs,
+                       const basic_segmented_str_view<CharT, Traits, N> &rhs) noexcept
+{
+    return lhs.equals(rhs);
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool operator!=(const basic_segmented_str_view<CharT, Traits, N> &lhs,
+                       const basic_segmented_str_view<CharT, Traits, N> &rhs) noexcept
+{
+    return !lhs.equals(rhs);
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool operator<(const basic_segmented_str_view<CharT, Traits, N> &lhs,
+                      const basic_segmented_str_view<CharT, Traits, N> &rhs) noexcept
+{
+    return lhs.compare(rhs) < 0;
+}
+
+/// The view side is not deduced, so literals and std::string compare against a segmented view directly.
+template <typename CharT, typename Traits, size_t N>
+inline bool operator==(const basic_segmented_str_view<CharT, Traits, N> &lhs,
+                       typename basic_segmented_str_view<CharT, Traits, N>::view_type rhs) noexcept
+{
+    return lhs.equals(rhs);
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool operator==(typename basic_segmented_str_view<CharT, Traits, N>::view_type lhs,
+                       const basic_segmented_str_view<CharT, Traits, N> &rhs) noexcept
+{
+    return rhs.equals(lhs);
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool operator!=(const basic_segmented_str_view<CharT, Traits, N> &lhs,
+                       typename basic_segmented_str_view<CharT, Traits, N>::view_type rhs) noexcept
+{
+    return !lhs.equals(rhs);
+}
+
+template <typename CharT, typename Traits, size_t N>
+inline bool operator!=(typename basic_segmented_str_view<CharT, Traits, N>::view_type lhs,
+                       const basic_segmented_str_view<CharT, Traits, N> &rhs) noexcept
+{
+    return !rhs.equals(lhs);
+}
+
+} // namespace lambda
+
+#endif
@@ -0,0 +1,1289 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Vectorized search kernels used by basic_str_view at runtime
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ *
+ * The kernels compare raw code units, so they are only valid for traits whose eq() is plain equality
+ * (std::char_traits). basic_str_view keeps its constexpr scalar loops for constant evaluation and for other traits.
+ */
+
+#ifndef STR_VIEW_SIMD_H
+#define STR_VIEW_SIMD_H
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if LAMBDA_SIMD_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#elif LAMBDA_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace lambda
+{
+namespace simd
+{
+
+/// <summary>
+/// Returned by the kernels when there is no match.
+/// </summary>
+static constexpr size_t npos = size_t(-1);
+
+/// <summary>
+/// Instruction sets the runtime dispatcher can pick from.
+/// </summary>
+enum class isa
+{
+    scalar,
+    sse2,
+    avx2,
+    neon
+};
+
+namespace detail
+{
+
+/// <summary>
+/// Index of the lowest set bit. x must not be zero.
+/// </summary>
+inline unsigned _ctz_(uint32_t x) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanForward(&idx, x);
+    return static_cast<unsigned>(idx);
+#else
+    return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+}
+
+inline unsigned _ctz_(uint64_t x) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return static_cast<unsigned>(idx);
+#elif defined(_MSC_VER) && !defined(__clang__)
+    const uint32_t lo = static_cast<uint32_t>(x);
+    return lo ? _ctz_(lo) : 32u + _ctz_(static_cast<uint32_t>(x >> 32));
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+/// <summary>
+/// Index of the highest set bit. x must not be zero.
+/// </summary>
+inline unsigned _bsr_(uint32_t x) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanReverse(&idx, x);
+    return static_cast<unsigned>(idx);
+#else
+    return 31u - static_cast<unsigned>(__builtin_clz(x));
+#endif
+}
+
+inline unsigned _bsr_(uint64_t x) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long idx;
+    _BitScanReverse64(&idx, x);
+    return static_cast<unsigned>(idx);
+#elif defined(_MSC_VER) && !defined(__clang__)
+    const uint32_t hi = static_cast<uint32_t>(x >> 32);
+    return hi ? 32u + _bsr_(hi) : _bsr_(static_cast<uint32_t>(x));
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(x));
+#endif
+}
+
+/// <summary>
+/// Bitmask covering one lane of a comparison mask, given the number of mask bits per byte.
+/// </summary>
+template <typename Mask, size_t Width, size_t BitsPerByte = 1> constexpr Mask _lane_bits_()
+{
+    return static_cast<Mask>((Mask(1) << (Width * BitsPerByte)) - 1);
+}
+
+inline uint64_t _load64_(const unsigned char *p) noexcept
+{
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t _load32_(const unsigned char *p) noexcept
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+} // namespace detail
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Portable fallback
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace scalar
+{
+
+/// <summary>
+/// Finds the first occurrence of s[0, m) in h[0, n). Returns npos if there is none.
+/// </summary>
+template <typename CharT> inline size_t find(const CharT *h, size_t n, const CharT *s, size_t m) noexcept
+{
+    if (m == 0)
+    {
+        return 0;
+    }
+    if (m > n)
+    {
+        return npos;
+    }
+
+    const CharT first = s[0];
+    for (size_t i = 0; i <= n - m; ++i)
+    {
+        if (h[i] == first && std::memcmp(h + i + 1, s + 1, (m - 1) * sizeof(CharT)) == 0)
+        {
+            return i;
+        }
+    }
+    return npos;
+}
+
+/// <summary>
+/// Finds the first occurrence of s[0, m) in h[0, n), testing the anchor units s[a] and s[b] before the whole needle.
+/// Requires a, b &lt; m when m != 0.
+/// </summary>
+template <typename CharT>
+inline size_t find_anchored(const CharT *h, size_t n, const CharT *s, size_t m, size_t a, size_t b) noexcept
+{
+    if (m == 0)
+    {
+        return 0;
+    }
+    if (m > n)
+    {
+        return npos;
+    }
+
+    for (size_t i = 0; i <= n - m; ++i)
+    {
+        if (h[i + a] == s[a] && h[i + b] == s[b] && std::memcmp(h + i, s, m * sizeof(CharT)) == 0)
+        {
+            return i;
+        }
+    }
+    return npos;
+}
+
+/// <summary>
+/// Number of code units before the first zero in s.
+/// </summary>
+template <typename CharT> inline size_t length(const CharT *s) noexcept
+{
+    size_t n = 0;
+    while (s[n] != CharT())
+    {
+        ++n;
+    }
+    return n;
+}
+
+/// <summary>
+/// Finds the first c in h[0, n). Returns npos if there is none.
+/// </summary>
+template <typename CharT> inline size_t find_char(const CharT *h, size_t n, CharT c) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (h[i] == c)
+        {
+            return i;
+        }
+    }
+    return npos;
+}
+
+/// <summary>
+/// Finds the last c in h[0, n). Returns npos if there is none.
+/// </summary>
+template <typename CharT> inline size_t rfind_char(const CharT *h, size_t n, CharT c) noexcept
+{
+    for (size_t i = n; i-- > 0;)
+    {
+        if (h[i] == c)
+        {
+            return i;
+        }
+    }
+    return npos;
+}
+
+/// <summary>
+/// Membership test against the nibble tables of a basic_char_set. Bit (hi & 7) of lo[b & 15] (hi < 8) or
+/// hi_tbl[b & 15] (hi >= 8) is set when byte b, with hi = b >> 4, is in the set.
+/// </summary>
+inline bool in_set(uint8_t b, const uint8_t *lo, const uint8_t *hi) noexcept
+{
+    const unsigned h = b >> 4;
+    return (((h < 8 ? lo[b & 15] : hi[b & 15]) >> (h & 7)) & 1u) != 0;
+}
+
+/// <summary>
+/// Finds the first byte whose set membership equals Member. Returns npos if there is none.
+/// </summary>
+template <bool Member>
+inline size_t find_in_set(const uint8_t *h, size_t n, const uint8_t *lo, const uint8_t *hi) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (in_set(h[i], lo, hi) == Member)
+        {
+            return i;
+        }
+    }
+    return npos;
+}
+
+/// <summary>
+/// Finds the last byte whose set membership equals Member. Returns npos if there is none.
+/// </summary>
+template <bool Member>
+inline size_t rfind_in_set(const uint8_t *h, size_t n, const uint8_t *lo, const uint8_t *hi) noexcept
+{
+    for (size_t i = n; i-- > 0;)
+    {
+        if (in_set(h[i], lo, hi) == Member)
+        {
+            return i;
+        }
+    }
+    return npos;
+}
+
+} // namespace scalar
+
+#if LAMBDA_SIMD_X86
+
+// ---------------------------------------------------------------------------------------------------------------------
+// CPU feature detection
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace detail
+{
+
+inline bool _detect_avx2_() noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7)
+    {
+        return false;
+    }
+
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx = (regs[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+    {
+        return false;
+    }
+
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+} // namespace detail
+
+/// <summary>
+/// True if the running CPU (and OS) supports AVX2. Detected once.
+/// </summary>
+inline bool cpu_has_avx2() noexcept
+{
+    static const bool has = detail::_detect_avx2_();
+    return has;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// SSE2 (baseline on x86-64)
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace sse2
+{
+
+namespace detail
+{
+
+template <size_t Width> struct ops;
+
+template <> struct ops<1>
+{
+    static __m128i set1(uint32_t c) noexcept
+    {
+        return _mm_set1_epi8(static_cast<char>(c));
+    }
+    static __m128i eq(__m128i a, __m128i b) noexcept
+    {
+        return _mm_cmpeq_epi8(a, b);
+    }
+};
+
+template <> struct ops<2>
+{
+    static __m128i set1(uint32_t c) noexcept
+    {
+        return _mm_set1_epi16(static_cast<short>(c));
+    }
+    static __m128i eq(__m128i a, __m128i b) noexcept
+    {
+        return _mm_cmpeq_epi16(a, b);
+    }
+};
+
+template <> struct ops<4>
+{
+    static __m128i set1(uint32_t c) noexcept
+    {
+        return _mm_set1_epi32(static_cast<int>(c));
+    }
+    static __m128i eq(__m128i a, __m128i b) noexcept
+    {
+        return _mm_cmpeq_epi32(a, b);
+    }
+};
+
+template <typename CharT> inline __m128i _load_(const CharT *p) noexcept
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+LAMBDA_NO_SANITIZE_ADDRESS inline __m128i _load_aligned_(uintptr_t p) noexcept
+{
+    return _mm_load_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+} // namespace detail
+
+/// <summary>
+/// Two-unit filter: every lane where both anchor units s[a] and s[b] match is verified with memcmp. Requires
+/// a, b &lt; m when m != 0.
+/// </summary>
+template <typename CharT>
+inline size_t find_anchored(const CharT *h, size_t n, const CharT *s, size_t m, size_t a, size_t b) noexcept
+{
+    using op = detail::ops<sizeof(CharT)>;
+    constexpr size_t lanes = 16 / sizeof(CharT);
+    constexpr uint32_t lane_bits = simd::detail::_lane_bits_<uint32_t, sizeof(CharT)>();
+
+    if (m == 0 || m > n)
+    {
+        return scalar::find_anchored(h, n, s, m, a, b);
+    }
+
+    const __m128i first = op::set1(static_cast<uint32_t>(s[a]));
+    const __m128i second = op::set1(static_cast<uint32_t>(s[b]));
+    // The two anchors already cover the whole needle.
+    const bool covered = m <= 2 && a + b == m - 1;
+
+    size_t i = 0;
+    for (; i + lanes + m - 1 <= n; i += lanes)
+    {
+        const __m128i eq_first = op::eq(first, detail::_load_(h + i + a));
+        const __m128i eq_second = op::eq(second, detail::_load_(h + i + b));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(eq_first, eq_second)));
+
+        while (mask != 0)
+        {
+            const unsigned bit = simd::detail::_ctz_(mask);
+            const size_t idx = i + bit / sizeof(CharT);
+            if (covered || std::memcmp(h + idx, s, m * sizeof(CharT)) == 0)
+            {
+                return idx;
+            }
+            mask &= ~(lane_bits << bit);
+        }
+    }
+
+    const size_t tail = scalar::find_anchored(h + i, n - i, s, m, a, b);
+    return tail == npos ? npos : tail + i;
+}
+
+/// <summary>
+/// First-and-last code unit filter.
+/// </summary>
+template <typename CharT> inline size_t find(const CharT *h, size_t n, const CharT *s, size_t m) noexcept
+{
+    return m == 0 ? 0 : find_anchored(h, n, s, m, 0, m - 1);
+}
+
+template <typename CharT> inline size_t find_char(const CharT *h, size_t n, CharT c) noexcept
+{
+    using op = detail::ops<sizeof(CharT)>;
+    constexpr size_t lanes = 16 / sizeof(CharT);
+
+    const __m128i needle = op::set1(static_cast<uint32_t>(c));
+
+    size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes)
+    {
+        const __m128i eq0 = op::eq(needle, detail::_load_(h + i));
+        const __m128i eq1 = op::eq(needle, detail::_load_(h + i + lanes));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(eq0)) |
+                              (static_cast<uint32_t>(_mm_movemask_epi8(eq1)) << 16);
+        if (mask != 0)
+        {
+            return i + simd::detail::_ctz_(mask) / sizeof(CharT);
+        }
+    }
+    for (; i + lanes <= n; i += lanes)
+    {
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(op::eq(needle, detail::_load_(h + i))));
+        if (mask != 0)
+        {
+            return i + simd::detail::_ctz_(mask) / sizeof(CharT);
+        }
+    }
+
+    const size_t tail = scalar::find_char(h + i, n - i, c);
+    return tail == npos ? npos : tail + i;
+}
+
+template <typename CharT> inline size_t rfind_char(const CharT *h, size_t n, CharT c) noexcept
+{
+    using op = detail::ops<sizeof(CharT)>;
+    constexpr size_t lanes = 16 / sizeof(CharT);
+
+    const __m128i needle = op::set1(static_cast<uint32_t>(c));
+
+    size_t i = n;
+    for (; i >= lanes; i -= lanes)
+    {
+        const uint32_t mask =
+            static_cast<uint32_t>(_mm_movemask_epi8(op::eq(needle, detail::_load_(h + i - lanes))));
+        if (mask != 0)
+        {
+            return i - lanes + simd::detail::_bsr_(mask) / sizeof(CharT);
+        }
+    }
+
+    return scalar::rfind_char(h, i, c);
+}
+
+/// <summary>
+/// Zero-lane search over 16 byte aligned blocks, starting with the block that contains s.
+/// </summary>
+template <typename CharT> LAMBDA_NO_SANITIZE_ADDRESS inline size_t length(const CharT *s) noexcept
+{
+    using op = detail::ops<sizeof(CharT)>;
+
+    const uintptr_t start = reinterpret_cast<uintptr_t>(s);
+    const size_t skew = start & 15;
+    if (skew % sizeof(CharT) != 0)
+    {
+        return scalar::length(s);
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+    uintptr_t p = start - skew;
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(op::eq(zero, detail::_load_aligned_(p)))) >> skew;
+    while (mask == 0)
+    {
+        p += 16;
+        mask = static_cast<uint32_t>(_mm_movemask_epi8(op::eq(zero, detail::_load_aligned_(p))));
+        if (mask != 0)
+        {
+            return (p - start + simd::detail::_ctz_(mask)) / sizeof(CharT);
+        }
+    }
+    return simd::detail::_ctz_(mask) / sizeof(CharT);
+}
+
+} // namespace sse2
+
+// ---------------------------------------------------------------------------------------------------------------------
+// AVX2 (runtime detected)
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace avx2
+{
+
+namespace detail
+{
+
+template <size_t Width> struct ops;
+
+template <> struct ops<1>
+{
+    LAMBDA_TARGET_AVX2 static __m256i set1(uint32_t c) noexcept
+    {
+        return _mm256_set1_epi8(static_cast<char>(c));
+    }
+    LAMBDA_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) noexcept
+    {
+        return _mm256_cmpeq_epi8(a, b);
+    }
+};
+
+template <> struct ops<2>
+{
+    LAMBDA_TARGET_AVX2 static __m256i set1(uint32_t c) noexcept
+    {
+        return _mm256_set1_epi16(static_cast<short>(c));
+    }
+    LAMBDA_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) noexcept
+    {
+        return _mm256_cmpeq_epi16(a, b);
+    }
+};
+
+template <> struct ops<4>
+{
+    LAMBDA_TARGET_AVX2 static __m256i set1(uint32_t c) noexcept
+    {
+        return _mm256_set1_epi32(static_cast<int>(c));
+    }
+    LAMBDA_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) noexcept
+    {
+        return _mm256_cmpeq_epi32(a, b);
+    }
+};
+
+template <typename CharT> LAMBDA_TARGET_AVX2 inline __m256i _load_(const CharT *p) noexcept
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+LAMBDA_TARGET_AVX2 LAMBDA_NO_SANITIZE_ADDRESS inline __m256i _load_aligned_(uintptr_t p) noexcept
+{
+    return _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+} // namespace detail
+
+/// <summary>
+/// Same algorithm as sse2::find_anchored on 32 byte blocks. Only call when cpu_has_avx2() is true.
+/// </summary>
+template <typename CharT>
+LAMBDA_TARGET_AVX2 inline size_t find_anchored(const CharT *h, size_t n, const CharT *s, size_t m, size_t a,
+                                               size_t b) noexcept
+{
+    using op = detail::ops<sizeof(CharT)>;
+    constexpr size_t lanes = 32 / sizeof(CharT);
+    constexpr uint32_t lane_bits = simd::detail::_lane_bits_<uint32_t, sizeof(CharT)>();
+
+    if (m == 0 || m > n)
+    {
+        return scalar::find_anchored(h, n, s, m, a, b);
+    }
+
+    const __m256i first = op::set1(static_cast<uint32_t>(s[a]));
+    const __m256i second = op::set1(static_cast<uint32_t>(s[b]));
+    // The two anchors already cover the whole needle.
+    const bool covered = m <= 2 && a + b == m - 1;
+
+    size_t i = 0;
+    for (; i + lanes + m - 1 <= n; i += lanes)
+    {
+        const __m256i eq_first = op::eq(first, detail::_load_(h + i + a));
+        const __m256i eq_second = op::eq(second, detail::_load_(h + i + b));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(eq_first, eq_second)));
+
+        while (mask != 0)
+        {
+            const unsigned bit = simd::detail::_ctz_(mask);
+            const size_t idx = i + bit / sizeof(CharT);
+            if (covered || std::memcmp(h + idx, s, m * sizeof(CharT)) == 0)
+            {
+                return idx;
+            }
+            mask &= ~(lane_bits << bit);
+        }
+    }
+
+    const size_t tail = sse2::find_anchored(h + i, n - i, s, m, a, b);
+    return tail == npos ? npos : tail + i;
+}
+
+/// <summary>
+/// Same algorithm as sse2::find on 32 byte blocks. Only call when cpu_has_avx2() is true.
+/// </summary>
+template <typename CharT>
+LAMBDA_TARGET_AVX2 inline size_t find(const CharT *h, size_t n, const CharT *s, size_t m) noexcept
+{
+    return m == 0 ? 0 : find_anchored(h, n, s, m, 0, m - 1);
+}
+
+/// <summary>
+/// 64 bytes per iteration, then one 32 byte step, then the sse2 kernel for the tail.
+/// </summary>
+template <typename CharT> LAMBDA_TARGET_AVX2 inline size_t find_char(const CharT *h, size_t n, CharT c) noexcept
+{
+    using op = detail::ops<sizeof(CharT)>;
+    constexpr size_t lanes = 32 / sizeof(CharT);
+
+    const __m256i needle = op::set1(static_cast<uint32_t>(c));
+
+    size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes)
+    {
+        const __m256i eq0 = op::eq(needle, detail::_load_(h + i));
+        const __m256i eq1 = op::eq(needle, detail::_load_(h + i + lanes));
+        if (!_mm256_testz_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq0, eq1)))
+        {
+            const uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq0)) |
+                                  (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(eq1))) << 32);
+            return i + simd::detail::_ctz_(mask) / sizeof(CharT);
+        }
+    }
+    if (i + lanes <= n)
+    {
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(op::eq(needle, detail::_load_(h + i))));
+        if (mask != 0)
+        {
+            return i + simd::detail::_ctz_(mask) / sizeof(CharT);
+        }
+        i += lanes;
+    }
+
+    const size_t tail = sse2::find_char(h + i, n - i, c);
+    return tail == npos ? npos : tail + i;
+}
+
+template <typename CharT> LAMBDA_TARGET_AVX2 inline size_t rfind_char(const CharT *h, size_t n, CharT c) noexcept
+{
+    using op = detail::ops<sizeof(CharT)>;
+    constexpr size_t lanes = 32 / sizeof(CharT);
+
+    const __m256i needle = op::set1(static_cast<uint32_t>(c));
+
+    size_t i = n;
+    for (; i >= 2 * lanes; i -= 2 * lanes)
+    {
+        const __m256i eq0 = op::eq(needle, detail::_load_(h + i - 2 * lanes));
+        const __m256i eq1 = op::eq(needle, detail::_load_(h + i - lanes));
+        if (!_mm256_testz_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq0, eq1)))
+        {
+            const uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq0)) |
+                                  (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(eq1))) << 32);
+            return i - 2 * lanes + simd::detail::_bsr_(mask) / sizeof(CharT);
+        }
+    }
+
+    return sse2::rfind_char(h, i, c);
+}
+
+namespace detail
+{
+
+/// <summary>
+/// Classifies 32 bytes against the nibble tables with three pshufb lookups. Member lanes are 0xFF.
+/// </summary>
+LAMBDA_TARGET_AVX2 inline __m256i _classify_(__m256i v, __m256i lo_tbl, __m256i hi_tbl) noexcept
+{
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+    const __m256i bit_tbl = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, //
+                                             1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+    const __m256i lo = _mm256_and_si256(v, low_nibbles);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles);
+
+    const __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(hi_tbl, lo), _mm256_shuffle_epi8(lo_tbl, lo),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8(8), hi));
+    const __m256i bit = _mm256_shuffle_epi8(bit_tbl, hi);
+
+    return _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+}
+
+LAMBDA_TARGET_AVX2 inline __m256i _load_table_(const uint8_t *tbl) noexcept
+{
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tbl)));
+}
+
+} // namespace detail
+
+template <bool Member>
+LAMBDA_TARGET_AVX2 inline size_t find_in_set(const uint8_t *h, size_t n, const uint8_t *lo, const uint8_t *hi) noexcept
+{
+    const __m256i lo_tbl = detail::_load_table_(lo);
+    const __m256i hi_tbl = detail::_load_table_(hi);
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        uint32_t mask =
+            static_cast<uint32_t>(_mm256_movemask_epi8(detail::_classify_(detail::_load_(h + i), lo_tbl, hi_tbl)));
+        mask = Member ? mask : ~mask;
+        if (mask != 0)
+        {
+            return i + simd::detail::_ctz_(mask);
+        }
+    }
+
+    const size_t tail = scalar::find_in_set<Member>(h + i, n - i, lo, hi);
+    return tail == npos ? npos : tail + i;
+}
+
+template <bool Member>
+LAMBDA_TARGET_AVX2 inline size_t rfind_in_set(const uint8_t *h, size_t n, const uint8_t *lo, const uint8_t *hi) noexcept
+{
+    const __m256i lo_tbl = detail::_load_table_(lo);
+    const __m256i hi_tbl = detail::_load_table_(hi);
+
+    size_t i = n;
+    for (; i >= 32; i -= 32)
+    {
+        uint32_t mask =
+            static_cast<uint32_t>(_mm256_movemask_epi8(detail::_classify_(detail::_load_(h + i - 32), lo_tbl, hi_tbl)));
+        mask = Member ? mask : ~mask;
+        if (mask != 0)
+        {
+            return i - 32 + simd::detail::_bsr_(mask);
+        }
+    }
+
+    return scalar::rfind_in_set<Member>(h, i, lo, hi);
+}
+
+/// <summary>
+/// Zero-lane search over 32 byte aligned blocks: the block that contains s first, then 64 byte aligned pairs.
+/// </summary>
+template <typename CharT> LAMBDA_TARGET_AVX2 LAMBDA_NO_SANITIZE_ADDRESS inline size_t length(const CharT *s) noexcept
+{
+    using op = detail::ops<sizeof(CharT)>;
+
+    const uintptr_t start = reinterpret_cast<uintptr_t>(s);
+    const size_t skew = start & 31;
+    if (skew % sizeof(CharT) != 0)
+    {
+        return scalar::length(s);
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+    uintptr_t p = start - skew;
+    const uint32_t head = static_cast<uint32_t>(_mm256_movemask_epi8(op::eq(zero, detail::_load_aligned_(p)))) >> skew;
+    if (head != 0)
+    {
+        return simd::detail::_ctz_(head) / sizeof(CharT);
+    }
+
+    // The pairs of blocks below must not straddle a 64 byte boundary, or the second block may be on the next page.
+    p += 32;
+    if ((p & 63) != 0)
+    {
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(op::eq(zero, detail::_load_aligned_(p))));
+        if (mask != 0)
+        {
+            return (p - start + simd::detail::_ctz_(mask)) / sizeof(CharT);
+        }
+        p += 32;
+    }
+
+    for (;; p += 64)
+    {
+        const __m256i eq0 = op::eq(zero, detail::_load_aligned_(p));
+        const __m256i eq1 = op::eq(zero, detail::_load_aligned_(p + 32));
+        if (!_mm256_testz_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq0, eq1)))
+        {
+            const uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq0)) |
+                                  (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(eq1))) << 32);
+            return (p - start + simd::detail::_ctz_(mask)) / sizeof(CharT);
+        }
+    }
+}
+
+} // namespace avx2
+
+#endif // LAMBDA_SIMD_X86
+
+#if LAMBDA_SIMD_NEON
+
+// ---------------------------------------------------------------------------------------------------------------------
+// NEON (baseline on AArch64)
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace neon
+{
+
+namespace detail
+{
+
+template <size_t Width> struct ops;
+
+template <> struct ops<1>
+{
+    static uint8x16_t set1(uint32_t c) noexcept
+    {
+        return vdupq_n_u8(static_cast<uint8_t>(c));
+    }
+    static uint8x16_t eq(uint8x16_t a, uint8x16_t b) noexcept
+    {
+        return vceqq_u8(a, b);
+    }
+};
+
+template <> struct ops<2>
+{
+    static uint8x16_t set1(uint32_t c) noexcept
+    {
+        return vreinterpretq_u8_u16(vdupq_n_u16(static_cast<uint16_t>(c)));
+    }
+    static uint8x16_t eq(uint8x16_t a, uint8x16_t b) noexcept
+    {
+        return vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+    }
+};
+
+template <> struct ops<4>
+{
+    static uint8x16_t set1(uint32_t c) noexcept
+    {
+        return vreinterpretq_u8_u32(vdupq_n_u32(c));
+    }
+    static uint8x16_t eq(uint8x16_t a, uint8x16_t b) noexcept
+    {
+        return vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+    }
+};
+
+template <typename CharT> inline uint8x16_t _load_(const CharT *p) noexcept
+{
+    return vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+}
+
+/// <summary>
+/// NEON has no movemask; narrowing by 4 bits leaves one nibble per byte lane in a 64 bit mask.
+/// </summary>
+inline uint64_t _mask_(uint8x16_t v) noexcept
+{
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(v), 4)), 0);
+}
+
+} // namespace detail
+
+template <typename CharT>
+inline size_t find_anchored(const CharT *h, size_t n, const CharT *s, size_t m, size_t a, size_t b) noexcept
+{
+    using op = detail::ops<sizeof(CharT)>;
+    constexpr size_t lanes = 16 / sizeof(CharT);
+    constexpr uint64_t lane_bits = simd::detail::_lane_bits_<uint64_t, sizeof(CharT), 4>();
+
+    if (m == 0 || m > n)
+    {
+        return scalar::find_anchored(h, n, s, m, a, b);
+    }
+
+    const uint8x16_t first = op::set1(static_cast<uint32_t>(s[a]));
+    const uint8x16_t second = op::set1(static_cast<uint32_t>(s[b]));
+    // The two anchors already cover the whole needle.
+    const bool covered = m <= 2 && a + b == m - 1;
+
+    size_t i = 0;
+    for (; i + lanes + m - 1 <= n; i += lanes)
+    {
+        const uint8x16_t eq_first = op::eq(first, detail::_load_(h + i + a));
+        const uint8x16_t eq_second = op::eq(second, detail::_load_(h + i + b));
+        uint64_t mask = detail::_mask_(vandq_u8(eq_first, eq_second));
+
+        while (mask != 0)
+        {
+            const unsigned bit = simd::detail::_ctz_(mask);
+            const size_t idx = i + bit / (4 * sizeof(CharT));
+            if (covered || std::memcmp(h + idx, s, m * sizeof(CharT)) == 0)
+            {
+                return idx;
+            }
+            mask &= ~(lane_bits << bit);
+        }
+    }
+
+    const size_t tail = scalar::find_anchored(h + i, n - i, s, m, a, b);
+    return tail == npos ? npos : tail + i;
+}
+
+template <typename CharT> inline size_t find(const CharT *h, size_t n, const CharT *s, size_t m) noexcept
+{
+    return m == 0 ? 0 : find_anchored(h, n, s, m, 0, m - 1);
+}
+
+template <typename CharT> inline size_t find_char(const CharT *h, size_t n, CharT c) noexcept
+{
+    using op = detail::ops<sizeof(CharT)>;
+    constexpr size_t lanes = 16 / sizeof(CharT);
+
+    const uint8x16_t needle = op::set1(static_cast<uint32_t>(c));
+
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+    {
+        const uint64_t mask = detail::_mask_(op::eq(needle, detail::_load_(h + i)));
+        if (mask != 0)
+        {
+            return i + simd::detail::_ctz_(mask) / (4 * sizeof(CharT));
+        }
+    }
+
+    const size_t tail = scalar::find_char(h + i, n - i, c);
+    return tail == npos ? npos : tail + i;
+}
+
+template <typename CharT> inline size_t rfind_char(const CharT *h, size_t n, CharT c) noexcept
+{
+    using op = detail::ops<sizeof(CharT)>;
+    constexpr size_t lanes = 16 / sizeof(CharT);
+
+    const uint8x16_t needle = op::set1(static_cast<uint32_t>(c));
+
+    size_t i = n;
+    for (; i >= lanes; i -= lanes)
+    {
+        const uint64_t mask = detail::_mask_(op::eq(needle, detail::_load_(h + i - lanes)));
+        if (mask != 0)
+        {
+            return i - lanes + simd::detail::_bsr_(mask) / (4 * sizeof(CharT));
+        }
+    }
+
+    return scalar::rfind_char(h, i, c);
+}
+
+/// <summary>
+/// Zero-lane search over 16 byte aligned blocks, starting with the block that contains s.
+/// </summary>
+template <typename CharT> LAMBDA_NO_SANITIZE_ADDRESS inline size_t length(const CharT *s) noexcept
+{
+    using op = detail::ops<sizeof(CharT)>;
+
+    const uintptr_t start = reinterpret_cast<uintptr_t>(s);
+    const size_t skew = start & 15;
+    if (skew % sizeof(CharT) != 0)
+    {
+        return scalar::length(s);
+    }
+
+    const uint8x16_t zero = vdupq_n_u8(0);
+    uintptr_t p = start - skew;
+    uint64_t mask = detail::_mask_(op::eq(zero, vld1q_u8(reinterpret_cast<const uint8_t *>(p)))) >> (4 * skew);
+    while (mask == 0)
+    {
+        p += 16;
+        mask = detail::_mask_(op::eq(zero, vld1q_u8(reinterpret_cast<const uint8_t *>(p))));
+        if (mask != 0)
+        {
+            return (p - start + simd::detail::_ctz_(mask) / 4) / sizeof(CharT);
+        }
+    }
+    return simd::detail::_ctz_(mask) / (4 * sizeof(CharT));
+}
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define LAMBDA_SIMD_NEON_TBL 1
+
+namespace detail
+{
+
+/// <summary>
+/// Classifies 16 bytes against the nibble tables with three tbl lookups. Member lanes are 0xFF.
+/// </summary>
+inline uint8x16_t _classify_(uint8x16_t v, uint8x16_t lo_tbl, uint8x16_t hi_tbl) noexcept
+{
+    static const uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+
+    const uint8x16_t lo = vandq_u8(v, vdupq_n_u8(0x0f));
+    const uint8x16_t hi = vshrq_n_u8(v, 4);
+
+    const uint8x16_t row = vbslq_u8(vcltq_u8(hi, vdupq_n_u8(8)), vqtbl1q_u8(lo_tbl, lo), vqtbl1q_u8(hi_tbl, lo));
+    return vtstq_u8(row, vqtbl1q_u8(vld1q_u8(bits), hi));
+}
+
+} // namespace detail
+
+template <bool Member>
+inline size_t find_in_set(const uint8_t *h, size_t n, const uint8_t *lo, const uint8_t *hi) noexcept
+{
+    const uint8x16_t lo_tbl = vld1q_u8(lo);
+    const uint8x16_t hi_tbl = vld1q_u8(hi);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const uint8x16_t match = detail::_classify_(vld1q_u8(h + i), lo_tbl, hi_tbl);
+        const uint64_t mask = detail::_mask_(Member ? match : vmvnq_u8(match));
+        if (mask != 0)
+        {
+            return i + simd::detail::_ctz_(mask) / 4;
+        }
+    }
+
+    const size_t tail = scalar::find_in_set<Member>(h + i, n - i, lo, hi);
+    return tail == npos ? npos : tail + i;
+}
+
+template <bool Member>
+inline size_t rfind_in_set(const uint8_t *h, size_t n, const uint8_t *lo, const uint8_t *hi) noexcept
+{
+    const uint8x16_t lo_tbl = vld1q_u8(lo);
+    const uint8x16_t hi_tbl = vld1q_u8(hi);
+
+    size_t i = n;
+    for (; i >= 16; i -= 16)
+    {
+        const uint8x16_t match = detail::_classify_(vld1q_u8(h + i - 16), lo_tbl, hi_tbl);
+        const uint64_t mask = detail::_mask_(Member ? match : vmvnq_u8(match));
+        if (mask != 0)
+        {
+            return i - 16 + simd::detail::_bsr_(mask) / 4;
+        }
+    }
+
+    return scalar::rfind_in_set<Member>(h, i, lo, hi);
+}
+
+#endif
+
+} // namespace neon
+
+#endif // LAMBDA_SIMD_NEON
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Runtime dispatch
+// ---------------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Checks whether a[0, n) and b[0, n) hold the same bytes. Up to 32 bytes this is a head and a tail load of the widest
+/// word that fits (the two may overlap), combined without a loop or an ordering result; longer inputs use memcmp.
+/// </summary>
+inline bool equal_bytes(const void *a, const void *b, size_t n) noexcept
+{
+    const unsigned char *pa = static_cast<const unsigned char *>(a);
+    const unsigned char *pb = static_cast<const unsigned char *>(b);
+
+    if (n > 32)
+    {
+        return std::memcmp(pa, pb, n) == 0;
+    }
+    if (n > 16)
+    {
+#if LAMBDA_SIMD_X86
+        const __m128i head = _mm_cmpeq_epi8(sse2::detail::_load_(pa), sse2::detail::_load_(pb));
+        const __m128i tail = _mm_cmpeq_epi8(sse2::detail::_load_(pa + n - 16), sse2::detail::_load_(pb + n - 16));
+        return _mm_movemask_epi8(_mm_and_si128(head, tail)) == 0xffff;
+#else
+        return ((detail::_load64_(pa) ^ detail::_load64_(pb)) | (detail::_load64_(pa + 8) ^ detail::_load64_(pb + 8)) |
+                (detail::_load64_(pa + n - 16) ^ detail::_load64_(pb + n - 16)) |
+                (detail::_load64_(pa + n - 8) ^ detail::_load64_(pb + n - 8))) == 0;
+#endif
+    }
+    if (n >= 8)
+    {
+        return ((detail::_load64_(pa) ^ detail::_load64_(pb)) |
+                (detail::_load64_(pa + n - 8) ^ detail::_load64_(pb + n - 8))) == 0;
+    }
+    if (n >= 4)
+    {
+        return ((detail::_load32_(pa) ^ detail::_load32_(pb)) |
+                (detail::_load32_(pa + n - 4) ^ detail::_load32_(pb + n - 4))) == 0;
+    }
+    if (n == 0)
+    {
+        return true;
+    }
+    return pa[0] == pb[0] && pa[n >> 1] == pb[n >> 1] && pa[n - 1] == pb[n - 1];
+}
+
+/// <summary>
+/// Best instruction set available on the running CPU.
+/// </summary>
+inline isa active_isa() noexcept
+{
+#if LAMBDA_SIMD_X86
+    return cpu_has_avx2() ? isa::avx2 : isa::sse2;
+#elif LAMBDA_SIMD_NEON
+    return isa::neon;
+#else
+    return isa::scalar;
+#endif
+}
+
+/// <summary>
+/// Finds the first occurrence of s[0, m) in h[0, n). Returns npos if there is none.
+/// </summary>
+template <typename CharT> inline size_t find(const CharT *h, size_t n, const CharT *s, size_t m) noexcept
+{
+#if LAMBDA_SIMD_X86
+    return cpu_has_avx2() ? avx2::find(h, n, s, m) : sse2::find(h, n, s, m);
+#elif LAMBDA_SIMD_NEON
+    return neon::find(h, n, s, m);
+#else
+    return scalar::find(h, n, s, m);
+#endif
+}
+
+/// <summary>
+/// Finds the first occurrence of s[0, m) in h[0, n), filtering candidates on the anchor units s[a] and s[b]. Rare
+/// anchors make fewer candidates; basic_searcher picks them from the needle. Requires a, b &lt; m when m != 0.
+/// </summary>
+template <typename CharT>
+inline size_t find_anchored(const CharT *h, size_t n, const CharT *s, size_t m, size_t a, size_t b) noexcept
+{
+#if LAMBDA_SIMD_X86
+    return cpu_has_avx2() ? avx2::find_anchored(h, n, s, m, a, b) : sse2::find_anchored(h, n, s, m, a, b);
+#elif LAMBDA_SIMD_NEON
+    return neon::find_anchored(h, n, s, m, a, b);
+#else
+    return scalar::find_anchored(h, n, s, m, a, b);
+#endif
+}
+
+namespace detail
+{
+
+/// <summary>
+/// Single-byte strings go to strlen, which every libc already vectorizes (and which sanitizers understand).
+/// </summary>
+template <typename CharT> inline size_t _length_(const CharT *s, std::true_type) noexcept
+{
+    return std::strlen(reinterpret_cast<const char *>(s));
+}
+
+template <typename CharT> inline size_t _length_(const CharT *s, std::false_type) noexcept
+{
+#if LAMBDA_SIMD_X86
+    return cpu_has_avx2() ? avx2::length(s) : sse2::length(s);
+#elif LAMBDA_SIMD_NEON
+    return neon::length(s);
+#else
+    return scalar::length(s);
+#endif
+}
+
+/// <summary>
+/// Single-byte searches go to memchr, which the libc tunes per microarchitecture and which outruns the kernels above.
+/// </summary>
+template <typename CharT> inline size_t _find_char_(const CharT *h, size_t n, CharT c, std::true_type) noexcept
+{
+    if (n == 0)
+    {
+        return npos;
+    }
+    const void *p = std::memchr(h, static_cast<unsigned char>(c), n);
+    return p == nullptr ? npos : static_cast<size_t>(static_cast<const CharT *>(p) - h);
+}
+
+template <typename CharT> inline size_t _find_char_(const CharT *h, size_t n, CharT c, std::false_type) noexcept
+{
+#if LAMBDA_SIMD_X86
+    return cpu_has_avx2() ? avx2::find_char(h, n, c) : sse2::find_char(h, n, c);
+#elif LAMBDA_SIMD_NEON
+    return neon::find_char(h, n, c);
+#else
+    return scalar::find_char(h, n, c);
+#endif
+}
+
+} // namespace detail
+
+/// <summary>
+/// Number of code units before the first zero in s.
+/// </summary>
+template <typename CharT> inline size_t length(const CharT *s) noexcept
+{
+    return detail::_length_(s, std::integral_constant<bool, sizeof(CharT) == 1>());
+}
+
+/// <summary>
+/// Finds the first c in h[0, n). Returns npos if there is none.
+/// </summary>
+template <typename CharT> inline size_t find_char(const CharT *h, size_t n, CharT c) noexcept
+{
+    return detail::_find_char_(h, n, c, std::integral_constant<bool, sizeof(CharT) == 1>());
+}
+
+/// <summary>
+/// Finds the last c in h[0, n). Returns npos if there is none.
+/// </summary>
+template <typename CharT> inline size_t rfind_char(const CharT *h, size_t n, CharT c) noexcept
+{
+#if LAMBDA_SIMD_X86
+    return cpu_has_avx2() ? avx2::rfind_char(h, n, c) : sse2::rfind_char(h, n, c);
+#elif LAMBDA_SIMD_NEON
+    return neon::rfind_char(h, n, c);
+#else
+    return scalar::rfind_char(h, n, c);
+#endif
+}
+
+/// <summary>
+/// Finds the first byte of h[0, n) whose membership in the nibble tables equals Member.
+/// </summary>
+template <bool Member>
+inline size_t find_in_set(const uint8_t *h, size_t n, const uint8_t *lo, const uint8_t *hi) noexcept
+{
+#if LAMBDA_SIMD_X86
+    return cpu_has_avx2() ? avx2::find_in_set<Member>(h, n, lo, hi) : scalar::find_in_set<Member>(h, n, lo, hi);
+#elif defined(LAMBDA_SIMD_NEON_TBL)
+    return neon::find_in_set<Member>(h, n, lo, hi);
+#else
+    return scalar::find_in_set<Member>(h, n, lo, hi);
+#endif
+}
+
+/// <summary>
+/// Finds the last byte of h[0, n) whose membership in the nibble tables equals Member.
+/// </summary>
+template <bool Member>
+inline size_t rfind_in_set(const uint8_t *h, size_t n, const uint8_t *lo, const uint8_t *hi) noexcept
+{
+#if LAMBDA_SIMD_X86
+    return cpu_has_avx2() ? avx2::rfind_in_set<Member>(h, n, lo, hi) : scalar::rfind_in_set<Member>(h, n, lo, hi);
+#elif defined(LAMBDA_SIMD_NEON_TBL)
+    return neon::rfind_in_set<Member>(h, n, lo, hi);
+#else
+    return scalar::rfind_in_set<Member>(h, n, lo, hi);
+#endif
+}
+
+} // namespace simd
+} // namespace lambda
+
+#endif
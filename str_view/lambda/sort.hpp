@@ -0,0 +1,363 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Sorting arrays of str_views by cached 8 byte keys, sequential and parallel
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_SORT_H
+#define STR_VIEW_SORT_H
+
+#include "parallel.hpp"
+#include "str_view.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lambda
+{
+
+namespace detail
+{
+
+template <typename CharT, typename Traits> struct _sort_item_
+{
+    uint64_t key;
+    basic_str_view<CharT, Traits> view;
+};
+
+/// <summary>
+/// Sorts a[0, n) by key: one pass counts all eight key bytes, then a stable counting pass runs per byte, least
+/// significant first, skipping the bytes that are the same in every key. tmp has room for n items.
+/// </summary>
+template <typename Item> inline void _radix_sort_keys_(Item *a, Item *tmp, size_t n)
+{
+    std::vector<size_t> counts(8 * 256, 0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const uint64_t key = a[i].key;
+        for (unsigned b = 0; b < 8; ++b)
+        {
+            ++counts[b * 256 + ((key >> (8 * b)) & 0xff)];
+        }
+    }
+
+    Item *from = a;
+    Item *to = tmp;
+    for (unsigned b = 0; b < 8; ++b)
+    {
+        size_t *const count = counts.data() + b * 256;
+        if (count[(from[0].key >> (8 * b)) & 0xff] == n)
+        {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t v = 0; v < 256; ++v)
+        {
+            const size_t k = count[v];
+            count[v] = offset;
+            offset += k;
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            to[count[(from[i].key >> (8 * b)) & 0xff]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+    if (from != a)
+    {
+        std::copy(from, from + n, a);
+    }
+}
+
+/// <summary>
+/// Sorts a[0, n), whose views all agree on their first depth units and are longer than that, using tmp[0, n) as
+/// scratch. Each level sorts on the integer key of the next 8 bytes, by radix passes for large ranges. A run of equal
+/// keys puts the views that end inside those units first, shortest first (each is a prefix of the longer ones), and
+/// goes on 8 bytes deeper with the rest. The largest run continues in the loop instead of a recursive call, so the
+/// recursion depth stays below log2(n) whatever the key lengths. keyed says that the keys at depth are already in
+/// a[i].key.
+/// </summary>
+template <typename CharT, typename Traits>
+inline void _msd_sort_(_sort_item_<CharT, Traits> *a, _sort_item_<CharT, Traits> *tmp, size_t n, size_t depth,
+                       bool keyed)
+{
+    using item = _sort_item_<CharT, Traits>;
+    const size_t units = sizeof(uint64_t) / sizeof(CharT);
+
+    while (n > 1)
+    {
+        if (n <= 16)
+        {
+            for (size_t i = 1; i < n; ++i)
+            {
+                const item x = a[i];
+                size_t j = i;
+                while (j > 0 && x.view.drop(depth).compare(a[j - 1].view.drop(depth)) < 0)
+                {
+                    a[j] = a[j - 1];
+                    --j;
+                }
+                a[j] = x;
+            }
+            return;
+        }
+
+        if (!keyed)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                a[i].key = utility::_prefix_key_(a[i].view.data() + depth, a[i].view.size() - depth);
+            }
+        }
+        // Shared prefixes make all keys of a level equal; that needs no sort.
+        size_t first_other = 1;
+        while (first_other < n && a[first_other].key == a[0].key)
+        {
+            ++first_other;
+        }
+        if (first_other != n && n >= 1024)
+        {
+            _radix_sort_keys_(a, tmp, n);
+        }
+        else if (first_other != n)
+        {
+            std::sort(a, a + n, [](const item &x, const item &y) { return x.key < y.key; });
+        }
+
+        item *largest = nullptr;
+        size_t largest_size = 0;
+        for (size_t i = 0; i < n;)
+        {
+            size_t j = i + 1;
+            while (j < n && a[j].key == a[i].key)
+            {
+                ++j;
+            }
+            if (j - i > 1)
+            {
+                item *const rest =
+                    std::partition(a + i, a + j, [&](const item &x) { return x.view.size() - depth <= units; });
+                std::sort(a + i, rest, [](const item &x, const item &y) { return x.view.size() < y.view.size(); });
+
+                size_t rest_size = static_cast<size_t>(a + j - rest);
+                item *next = rest;
+                if (rest_size > largest_size)
+                {
+                    std::swap(next, largest);
+                    std::swap(rest_size, largest_size);
+                }
+                if (rest_size > 1)
+                {
+                    _msd_sort_(next, tmp + (next - a), rest_size, depth + units, false);
+                }
+            }
+            i = j;
+        }
+
+        if (largest_size < 2)
+        {
+            return;
+        }
+        tmp += largest - a;
+        a = largest;
+        n = largest_size;
+        depth += units;
+        keyed = false;
+    }
+}
+
+template <typename CharT, typename Traits>
+inline bool _view_less_(basic_str_view<CharT, Traits> x, basic_str_view<CharT, Traits> y) noexcept
+{
+    return x.compare(y) < 0;
+}
+
+} // namespace detail
+
+/// <summary>
+/// Sorts views into the order of std::sort with operator< (compare() < 0); equal views may be reordered. The
+/// sort is a most significant digit sort over 8 byte digits: every element carries its next 8 bytes as an integer,
+/// so nearly all comparisons are integer compares, and a prefix shared by many views is read once per level
+/// instead of once per comparison. Large ranges sort their keys with radix passes. Needs room for two copies of
+/// the views with their keys.
+///
+/// Traits that do not order code units as unsigned integers, ci_char_traits among them, fall back to std::sort.
+/// </summary>
+/// <param name="first"></param>
+/// <param name="last"></param>
+template <typename CharT, typename Traits>
+inline void sort_views(basic_str_view<CharT, Traits> *first, basic_str_view<CharT, Traits> *last)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!utility::_ordered_units_<CharT, Traits>::value || n <= 16)
+    {
+        std::sort(first, last, detail::_view_less_<CharT, Traits>);
+        return;
+    }
+
+    std::vector<detail::_sort_item_<CharT, Traits>> items(2 * n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        items[i].view = first[i];
+    }
+    detail::_msd_sort_(items.data(), items.data() + n, n, 0, false);
+    for (size_t i = 0; i < n; ++i)
+    {
+        first[i] = items[i].view;
+    }
+}
+
+/// <summary>
+/// sort_views over a contiguous container of views: std::vector, std::array, or anything with data() and size().
+/// </summary>
+template <typename Container>
+inline auto sort_views(Container &views) -> decltype(sort_views(views.data(), views.data() + views.size()))
+{
+    sort_views(views.data(), views.data() + views.size());
+}
+
+/// <summary>
+/// sort_views on several threads, a sample sort:
+///  1. the first 8 byte key of every view is computed in parallel chunks;
+///  2. a regular sample of the keys picks 8 buckets per thread;
+///  3. every chunk counts and then scatters its views into the buckets, each chunk writing a range of its own;
+///  4. the buckets are sorted concurrently, each with the sequential algorithm.
+/// Equal keys always land in one bucket, so the concatenated buckets are in order. Inputs below 64K views, a single
+/// thread, or traits sort_views falls back for, are sorted sequentially.
+/// </summary>
+/// <param name="first"></param>
+/// <param name="last"></param>
+/// <param name="opt">threads as for the other parallel_* functions; chunk_size is not used.</param>
+template <typename CharT, typename Traits>
+inline void parallel_sort_views(basic_str_view<CharT, Traits> *first, basic_str_view<CharT, Traits> *last,
+                                const parallel_options &opt = parallel_options())
+{
+    using item = detail::_sort_item_<CharT, Traits>;
+
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t threads = detail::_parallel_threads_(opt);
+    if (!utility::_ordered_units_<CharT, Traits>::value || threads == 1 || n < 65536)
+    {
+        sort_views(first, last);
+        return;
+    }
+
+    const size_t chunk = (n + 4 * threads - 1) / (4 * threads);
+    const size_t chunks = (n + chunk - 1) / chunk;
+
+    std::vector<item> items(n);
+    auto load = [&](size_t c) {
+        for (size_t i = c * chunk, end = std::min(n, i + chunk); i < end; ++i)
+        {
+            items[i].key = utility::_prefix_key_(first[i].data(), first[i].size());
+            items[i].view = first[i];
+        }
+        return true;
+    };
+    detail::_parallel_chunks_(chunks, threads, load);
+
+    const size_t buckets = 8 * threads;
+    const size_t oversampling = 32;
+    std::vector<uint64_t> sample(buckets * oversampling);
+    for (size_t s = 0; s < sample.size(); ++s)
+    {
+        sample[s] = items[s * (n / sample.size())].key;
+    }
+    std::sort(sample.begin(), sample.end());
+    std::vector<uint64_t> splitters(buckets - 1);
+    for (size_t b = 0; b + 1 < buckets; ++b)
+    {
+        splitters[b] = sample[(b + 1) * oversampling];
+    }
+    auto bucket_of = [&](uint64_t key) {
+        return static_cast<size_t>(std::upper_bound(splitters.begin(), splitters.end(), key) - splitters.begin());
+    };
+
+    // offsets[c * buckets + b] is where chunk c writes its first view of bucket b.
+    std::vector<size_t> offsets(chunks * buckets, 0);
+    auto count = [&](size_t c) {
+        for (size_t i = c * chunk, end = std::min(n, i + chunk); i < end; ++i)
+        {
+            ++offsets[c * buckets + bucket_of(items[i].key)];
+        }
+        return true;
+    };
+    detail::_parallel_chunks_(chunks, threads, count);
+
+    std::vector<size_t> bucket_begin(buckets + 1, 0);
+    size_t total = 0;
+    for (size_t b = 0; b < buckets; ++b)
+    {
+        bucket_begin[b] = total;
+        for (size_t c = 0; c < chunks; ++c)
+        {
+            const size_t k = offsets[c * buckets + b];
+            offsets[c * buckets + b] = total;
+            total += k;
+        }
+    }
+    bucket_begin[buckets] = total;
+
+    std::vector<item> sorted(n);
+    auto scatter = [&](size_t c) {
+        for (size_t i = c * chunk, end = std::min(n, i + chunk); i < end; ++i)
+        {
+            sorted[offsets[c * buckets + bucket_of(items[i].key)]++] = items[i];
+        }
+        return true;
+    };
+    detail::_parallel_chunks_(chunks, threads, scatter);
+
+    auto sort_bucket = [&](size_t b) {
+        detail::_msd_sort_(sorted.data() + bucket_begin[b], items.data() + bucket_begin[b],
+                           bucket_begin[b + 1] - bucket_begin[b], 0, true);
+        return true;
+    };
+    detail::_parallel_chunks_(buckets, threads, sort_bucket);
+
+    auto store = [&](size_t c) {
+        for (size_t i = c * chunk, end = std::min(n, i + chunk); i < end; ++i)
+        {
+            first[i] = sorted[i].view;
+        }
+        return true;
+    };
+    detail::_parallel_chunks_(chunks, threads, store);
+}
+
+template <typename Container>
+inline auto parallel_sort_views(Container &views, const parallel_options &opt = parallel_options())
+    -> decltype(parallel_sort_views(views.data(), views.data() + views.size(), opt))
+{
+    parallel_sort_views(views.data(), views.data() + views.size(), opt);
+}
+
+} // namespace lambda
+
+#endif
@@ -0,0 +1,299 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : Lazy, allocation free split range over basic_str_view
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_SPLIT_H
+#define STR_VIEW_SPLIT_H
+
+#include "str_view.hpp"
+
+#include <cstddef>
+#include <iterator>
+
+namespace lambda
+{
+
+/// <summary>
+/// Whether empty tokens (between adjacent delimiters, or at either end) are produced.
+/// </summary>
+enum class split_mode
+{
+    keep_empty,
+    skip_empty
+};
+
+/// <summary>
+/// Forward range of the tokens of a view, separated by a single character or by a delimiter view. Tokens are
+/// basic_str_view slices of the input; nothing is copied or allocated, and the whole range is usable in constant
+/// expressions.
+///
+/// After max_split delimiters have been consumed the rest of the input is returned as the last token. An empty
+/// delimiter view never matches. An empty input yields one empty token, unless empty tokens are skipped.
+/// </summary>
+template <typename CharT, typename Traits = std::char_traits<CharT>> struct basic_split_view
+{
+    using view_type = basic_str_view<CharT, Traits>;
+    using size_type = typename view_type::size_type;
+
+    struct iterator;
+    using const_iterator = iterator;
+
+    /// <summary>
+    /// Splits s at every ch.
+    /// </summary>
+    constexpr basic_split_view(view_type s, CharT ch, split_mode mode = split_mode::keep_empty,
+                               size_type max_split = view_type::npos) noexcept;
+
+    /// <summary>
+    /// Splits s at every occurrence of delim.
+    /// </summary>
+    constexpr basic_split_view(view_type s, view_type delim, split_mode mode = split_mode::keep_empty,
+                               size_type max_split = view_type::npos) noexcept;
+
+    constexpr iterator begin() const noexcept;
+    constexpr iterator end() const noexcept;
+
+  private:
+    view_type m_rest;
+    view_type m_delim;
+    CharT m_ch;
+    bool m_single;
+    split_mode m_mode;
+    size_type m_splits_left;
+};
+
+/// <summary>
+/// Forward iterator over the tokens. Holds its own copy of the split state, so it stays valid when the range is a
+/// temporary.
+/// </summary>
+template <typename CharT, typename Traits> struct basic_split_view<CharT, Traits>::iterator
+{
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = view_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const view_type *;
+    using reference = const view_type &;
+
+    /// <summary>
+    /// Constructs the end iterator.
+    /// </summary>
+    constexpr iterator() noexcept;
+
+    constexpr reference operator*() const noexcept;
+    constexpr pointer operator->() const noexcept;
+
+    constexpr iterator &operator++() noexcept;
+    constexpr iterator operator++(int) noexcept;
+
+    constexpr bool operator==(const iterator &other) const noexcept;
+    constexpr bool operator!=(const iterator &other) const noexcept;
+
+  private:
+    friend struct basic_split_view;
+
+    constexpr explicit iterator(const basic_split_view &parent) noexcept;
+
+    constexpr void next() noexcept;
+
+    basic_split_view m_parent;
+    view_type m_token;
+    bool m_has_rest;
+    bool m_done;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+using split_view = basic_split_view<char>;
+using wsplit_view = basic_split_view<wchar_t>;
+using u16split_view = basic_split_view<char16_t>;
+using u32split_view = basic_split_view<char32_t>;
+
+template <typename CharT, typename Traits>
+inline constexpr basic_split_view<CharT, Traits>::basic_split_view(view_type s, CharT ch, split_mode mode,
+                                                                   size_type max_split) noexcept
+    : m_rest(s), m_delim(), m_ch(ch), m_single(true), m_mode(mode), m_splits_left(max_split)
+{
+}
+
+template <typename CharT, typename Traits>
+inline constexpr basic_split_view<CharT, Traits>::basic_split_view(view_type s, view_type delim, split_mode mode,
+                                                                   size_type max_split) noexcept
+    : m_rest(s), m_delim(delim), m_ch(), m_single(false), m_mode(mode), m_splits_left(max_split)
+{
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_split_view<CharT, Traits>::iterator basic_split_view<CharT, Traits>::begin()
+    const noexcept
+{
+    return iterator(*this);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_split_view<CharT, Traits>::iterator basic_split_view<CharT, Traits>::end()
+    const noexcept
+{
+    return iterator();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT, typename Traits>
+inline constexpr basic_split_view<CharT, Traits>::iterator::iterator() noexcept
+    : m_parent(view_type(), CharT()), m_token(), m_has_rest(false), m_done(true)
+{
+}
+
+template <typename CharT, typename Traits>
+inline constexpr basic_split_view<CharT, Traits>::iterator::iterator(const basic_split_view &parent) noexcept
+    : m_parent(parent), m_token(), m_has_rest(true), m_done(false)
+{
+    next();
+}
+
+template <typename CharT, typename Traits> inline constexpr void basic_split_view<CharT, Traits>::iterator::next() noexcept
+{
+    while (m_has_rest)
+    {
+        view_type &rest = m_parent.m_rest;
+
+        size_type pos = view_type::npos;
+        size_type delim_length = 1;
+        if (m_parent.m_splits_left != 0)
+        {
+            if (m_parent.m_single)
+            {
+                pos = rest.find(m_parent.m_ch);
+            }
+            else if (!m_parent.m_delim.empty())
+            {
+                pos = rest.find(m_parent.m_delim);
+                delim_length = m_parent.m_delim.size();
+            }
+        }
+
+        if (pos == view_type::npos)
+        {
+            m_token = rest;
+            m_has_rest = false;
+        }
+        else
+        {
+            m_token = rest.first(pos);
+            rest = rest.unchecked_substr(pos + delim_length, rest.size() - pos - delim_length);
+            --m_parent.m_splits_left;
+        }
+
+        if (m_parent.m_mode == split_mode::keep_empty || !m_token.empty())
+        {
+            return;
+        }
+    }
+
+    m_done = true;
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_split_view<CharT, Traits>::iterator::reference basic_split_view<
+    CharT, Traits>::iterator::operator*() const noexcept
+{
+    return m_token;
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_split_view<CharT, Traits>::iterator::pointer basic_split_view<
+    CharT, Traits>::iterator::operator->() const noexcept
+{
+    return &m_token;
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_split_view<CharT, Traits>::iterator &basic_split_view<
+    CharT, Traits>::iterator::operator++() noexcept
+{
+    next();
+    return *this;
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_split_view<CharT, Traits>::iterator basic_split_view<
+    CharT, Traits>::iterator::operator++(int) noexcept
+{
+    iterator tmp = *this;
+    next();
+    return tmp;
+}
+
+template <typename CharT, typename Traits>
+inline constexpr bool basic_split_view<CharT, Traits>::iterator::operator==(const iterator &other) const noexcept
+{
+    return m_done == other.m_done &&
+           (m_done || (m_token.data() == other.m_token.data() && m_token.size() == other.m_token.size() &&
+                       m_has_rest == other.m_has_rest));
+}
+
+template <typename CharT, typename Traits>
+inline constexpr bool basic_split_view<CharT, Traits>::iterator::operator!=(const iterator &other) const noexcept
+{
+    return !(*this == other);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Returns a lazy range over the tokens of s separated by ch / delim. See basic_split_view.
+/// </summary>
+template <typename CharT, typename Traits>
+inline constexpr basic_split_view<CharT, Traits> split(basic_str_view<CharT, Traits> s, CharT ch,
+                                                       split_mode mode = split_mode::keep_empty,
+                                                       size_t max_split = basic_str_view<CharT, Traits>::npos) noexcept
+{
+    return basic_split_view<CharT, Traits>(s, ch, mode, max_split);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr basic_split_view<CharT, Traits> split(basic_str_view<CharT, Traits> s,
+                                                       basic_str_view<CharT, Traits> delim,
+                                                       split_mode mode = split_mode::keep_empty,
+                                                       size_t max_split = basic_str_view<CharT, Traits>::npos) noexcept
+{
+    return basic_split_view<CharT, Traits>(s, delim, mode, max_split);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr basic_split_view<CharT, Traits> split(basic_str_view<CharT, Traits> s, const CharT *delim,
+                                                       split_mode mode = split_mode::keep_empty,
+                                                       size_t max_split = basic_str_view<CharT, Traits>::npos)
+{
+    return basic_split_view<CharT, Traits>(s, basic_str_view<CharT, Traits>(delim), mode, max_split);
+}
+
+} // namespace lambda
+
+#endif
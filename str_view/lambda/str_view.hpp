@@ -31,10 +31,43 @@
 #ifndef STR_VIEW_H
 #define STR_VIEW_H
 
+#include "arena.hpp"
+#include "char_set.hpp"
+#include "config.hpp"
+#include "hash.hpp"
+#include "searcher.hpp"
+#include "simd.hpp"
+
+#if LAMBDA_INSTRUMENT
+#include "instrument.hpp"
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+
+/// Counts a runtime call of `which` on n units with second size m, returning expr from inside the probe. Constant
+/// evaluation, and every build without LAMBDA_STR_VIEW_INSTRUMENT, fall through to the plain call that follows.
+#if LAMBDA_INSTRUMENT
+#define LAMBDA_STR_VIEW_PROBE(which, n, m, expr)                                                                       \
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())                                                                               \
+    {                                                                                                                  \
+        const ::lambda::instrument::probe lambda_probe_ =                                                              \
+            ::lambda::instrument::enter(::lambda::instrument::op::which, (n), (m));                                    \
+        auto &&lambda_result_ = expr;                                                                                  \
+        ::lambda::instrument::leave(lambda_probe_);                                                                    \
+        return lambda_result_;                                                                                         \
+    }
+#else
+#define LAMBDA_STR_VIEW_PROBE(which, n, m, expr)
+#endif
 
 namespace lambda
 {
@@ -43,15 +76,111 @@ namespace utility
 {
 
 /// <summary>
-/// Returns size of CharT array in compile time.
-/// With C++11/14 std::char_traits::length constexpr evaluation won't work. (msvc compiler)
+/// The vectorized kernels compare raw code units. That is only equivalent to Traits::eq for the standard traits.
+/// </summary>
+template <typename CharT, typename Traits> struct _bitwise_traits_ : std::is_same<Traits, std::char_traits<CharT>>
+{
+};
+
+/// <summary>
+/// Whether Traits orders code units as unsigned integers, which makes the big endian packing of _prefix_key_ sort
+/// like compare(): the standard traits of char (compared as unsigned char) and of the unsigned wide types.
+/// </summary>
+template <typename CharT, typename Traits>
+struct _ordered_units_
+    : std::integral_constant<bool, _bitwise_traits_<CharT, Traits>::value &&
+                                       (sizeof(CharT) == 1 || std::is_unsigned<CharT>::value) &&
+                                       sizeof(CharT) <= sizeof(uint32_t)>
+{
+};
+
+/// <summary>
+/// The first 8 bytes worth of code units of [s, s + n) packed big endian and zero padded. For _ordered_units_,
+/// comparing two keys orders the strings the way compare() does, except that strings agreeing on those units tie.
+/// A tie includes "ab" against "ab\0", which only the lengths tell apart.
+/// </summary>
+template <typename CharT> inline uint64_t _prefix_key_(const CharT *s, size_t n) noexcept
+{
+    using unit = typename std::make_unsigned<CharT>::type;
+    const size_t units = sizeof(uint64_t) / sizeof(CharT);
+    uint64_t x = 0;
+    for (size_t i = 0; i < units; ++i)
+    {
+        x <<= 8 * sizeof(CharT);
+        x |= i < n ? static_cast<uint64_t>(static_cast<unit>(s[i])) : 0;
+    }
+    return x;
+}
+
+/// <summary>
+/// Returns the length of a null-terminated CharT string.
+/// With C++11/14 std::char_traits::length constexpr evaluation won't work (msvc compiler), so compile time evaluation
+/// uses a plain loop, which has no recursion depth limit. At runtime it is a vectorized zero-lane search.
 /// </summary>
 /// <param name="str"></param>
-/// <param name="count"></param>
 /// <returns></returns>
-constexpr size_t _length_(const char *str, size_t count = 0)
+template <typename CharT, typename Traits = std::char_traits<CharT>> constexpr size_t _length_(const CharT *str)
+{
+    if (_bitwise_traits_<CharT, Traits>::value && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return simd::length(str);
+    }
+
+    size_t count = 0;
+    while (!Traits::eq(str[count], CharT()))
+    {
+        ++count;
+    }
+    return count;
+}
+
+/// <summary>
+/// Length of the string held in a CharT array: the units before its first terminator, or the whole array when there is
+/// none. Like the pointer overloads, with the scan bounded by the array.
+/// </summary>
+/// <param name="s"></param>
+/// <returns></returns>
+template <typename CharT, typename Traits, size_t N> constexpr size_t _array_length_(const CharT (&s)[N])
+{
+    if (_bitwise_traits_<CharT, Traits>::value && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        // npos, or below N: written as a bound so the compiler knows the view never reaches past the array.
+        const size_t idx = simd::find_char(s, N, CharT());
+        return idx < N ? idx : N;
+    }
+
+    size_t count = 0;
+    while (count < N && !Traits::eq(s[count], CharT()))
+    {
+        ++count;
+    }
+    return count;
+}
+
+/// <summary>
+/// ASCII white space: ' ', '\t', '\n', '\v', '\f' and '\r', for code units of any width.
+/// </summary>
+template <typename CharT> constexpr bool _is_space_(CharT c) noexcept
+{
+    return c == CharT(' ') || (c >= CharT('\t') && c <= CharT('\r'));
+}
+
+/// <summary>
+/// Enables the pointer overloads for pointers only, so that arrays pick the fixed size overloads.
+/// </summary>
+template <typename CharT, typename Ptr>
+using _if_char_pointer_ =
+    typename std::enable_if<std::is_pointer<Ptr>::value && std::is_convertible<Ptr, const CharT *>::value, int>::type;
+
+/// <summary>
+/// Throws std::out_of_range. Out of line, so the checked accessors stay small enough to inline.
+/// </summary>
+[[noreturn]] LAMBDA_NOINLINE inline void _throw_out_of_range_(const char *what)
 {
-    return *str == '\0' ? count : _length_(str + 1, count + 1);
+#if LAMBDA_INSTRUMENT
+    instrument::on_throw();
+#endif
+    throw std::out_of_range(what);
 }
 
 } // namespace utility
@@ -141,49 +270,50 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     /// Iterator that returns string_view first elem as CharT*
     /// </summary>
     /// <returns></returns>
-    const_iterator begin() const noexcept;
+    constexpr const_iterator begin() const noexcept;
 
     /// <summary>
     /// Iterator that returns string_view first elem as const CharT*
     /// </summary>
     /// <returns></returns>
-    const_iterator cbegin() const noexcept;
+    constexpr const_iterator cbegin() const noexcept;
 
     /// <summary>
     /// Iterator that returns string_view last elem as CharT*
     /// </summary>
     /// <returns> const_iterator </returns>
-    const_iterator end() const noexcept;
+    constexpr const_iterator end() const noexcept;
 
     /// <summary>
     /// Iterator that returns string_view last elem as const CharT*
     /// </summary>
     /// <returns></returns>
-    const_iterator cend() const noexcept;
+    constexpr const_iterator cend() const noexcept;
 
     /// <summary>
-    /// Iterator that returns string_view reverse first elem as CharT*
+    /// Iterator that returns string_view reverse first elem as CharT*. The reverse iterators are constant evaluable
+    /// from C++17, where std::reverse_iterator is.
     /// </summary>
     /// <returns></returns>
-    const_reverse_iterator rbegin() const noexcept;
+    constexpr const_reverse_iterator rbegin() const noexcept;
 
     /// <summary>
     /// Iterator that returns string_view reverse last elem as CharT*
     /// </summary>
     /// <returns></returns>
-    const_reverse_iterator rend() const noexcept;
+    constexpr const_reverse_iterator rend() const noexcept;
 
     /// <summary>
     /// Iterator that returns string_view reverse begin elem as const CharT*
     /// </summary>
     /// <returns></returns>
-    const_reverse_iterator crbegin() const noexcept;
+    constexpr const_reverse_iterator crbegin() const noexcept;
 
     /// <summary>
     /// Iterator that returns string_view reverse last elem as const CharT*
     /// </summary>
     /// <returns></returns>
-    const_reverse_iterator crend() const noexcept;
+    constexpr const_reverse_iterator crend() const noexcept;
 
     // --------------------------------------------------------------------------------------------------
     // Element Access
@@ -273,6 +403,15 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     template <typename Allocator = std::allocator<CharT>>
     constexpr std::basic_string<CharT, Traits, Allocator> to_string(const Allocator &all) const;
 
+    /// <summary>
+    /// Copies the referenced characters into arena and returns a view of the copy. The copy is null terminated and
+    /// stays valid until the arena is reset or destroyed, which makes it a cheap owning replacement for to_string() in
+    /// request-scoped code.
+    /// </summary>
+    /// <param name="arena"></param>
+    /// <returns></returns>
+    basic_str_view materialize(monotonic_arena &arena) const;
+
     // --------------------------------------------------------------------------------------------------
     // Operators
     // --------------------------------------------------------------------------------------------------
@@ -295,6 +434,71 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     /// <returns></returns>
     constexpr basic_str_view substr(size_type pos = 0, size_type count = npos) const;
 
+    // --------------------------------------------------------------------------------------------------
+    // Unchecked slicing: noexcept and forced inline, for loops that already know their indices are valid.
+    // Preconditions are asserted in debug builds only (LAMBDA_STR_VIEW_ASSERT).
+    // --------------------------------------------------------------------------------------------------
+
+    /// <summary>
+    /// View of [pos, pos + count). Requires pos + count &lt;= size(); count is not clamped.
+    /// </summary>
+    /// <param name="pos"></param>
+    /// <param name="count"></param>
+    /// <returns></returns>
+    constexpr basic_str_view unchecked_substr(size_type pos, size_type count) const noexcept;
+
+    /// <summary>
+    /// The first n characters. Requires n &lt;= size().
+    /// </summary>
+    /// <param name="n"></param>
+    /// <returns></returns>
+    constexpr basic_str_view first(size_type n) const noexcept;
+
+    /// <summary>
+    /// The last n characters. Requires n &lt;= size().
+    /// </summary>
+    /// <param name="n"></param>
+    /// <returns></returns>
+    constexpr basic_str_view last(size_type n) const noexcept;
+
+    /// <summary>
+    /// The first min(n, size()) characters. Never fails.
+    /// </summary>
+    /// <param name="n"></param>
+    /// <returns></returns>
+    constexpr basic_str_view take(size_type n) const noexcept;
+
+    /// <summary>
+    /// The view without its first min(n, size()) characters. Never fails.
+    /// </summary>
+    /// <param name="n"></param>
+    /// <returns></returns>
+    constexpr basic_str_view drop(size_type n) const noexcept;
+
+    /// <summary>
+    /// {first(pos), the rest from pos}. Requires pos &lt;= size().
+    /// </summary>
+    /// <param name="pos"></param>
+    /// <returns></returns>
+    constexpr std::pair<basic_str_view, basic_str_view> split_at(size_type pos) const noexcept;
+
+    /// <summary>
+    /// The view without its leading and trailing ASCII white space (" \t\n\v\f\r"). Never fails.
+    /// </summary>
+    /// <returns></returns>
+    constexpr basic_str_view trim() const noexcept;
+    constexpr basic_str_view trim_front() const noexcept;
+    constexpr basic_str_view trim_back() const noexcept;
+
+    /// <summary>
+    /// The view without its leading and trailing characters that occur in chars. Never fails.
+    /// </summary>
+    /// <param name="chars"></param>
+    /// <returns></returns>
+    constexpr basic_str_view trim(basic_str_view chars) const noexcept;
+    constexpr basic_str_view trim_front(basic_str_view chars) const noexcept;
+    constexpr basic_str_view trim_back(basic_str_view chars) const noexcept;
+
     /// <summary>
     /// The length rlen of the sequences to compare is the smaller of size() and v.size(). The function compares the two
     /// views by calling traits::compare(data(), v.data(), rlen), and returns 0 based compare result.
@@ -310,11 +514,22 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     constexpr int compare(size_type pos1, size_type count1, const CharT *s) const;
     constexpr int compare(size_type pos1, size_type count1, const CharT *s, size_type count2) const;
 
+    /// <summary>
+    /// Checks whether the two views hold the same characters. Cheaper than compare() == 0: lengths are checked first,
+    /// and at runtime the characters are compared with a few wide (possibly overlapping) loads without computing an
+    /// ordering. Used by operator== and operator!=.
+    /// </summary>
+    /// <param name="v"></param>
+    /// <returns></returns>
+    constexpr bool equals(basic_str_view v) const noexcept;
+
     /// <summary>
     /// Checks if the string view begins with the given prefix, where
     ///  - the prefix is a string view.Effectively returns substr(0, sv.size()) == sv
     ///  - the prefix is a single character.Effectively returns !empty() && Traits::eq(front(), c)
     ///  - the prefix is a null - terminated character string.Effectively returns starts_with(basic_string_view(s))
+    ///  - the prefix is a const CharT array (a literal). Its length is a compile time constant, so no length scan
+    ///    runs and the comparison is a fixed size load
     ///
     /// https://en.cppreference.com/w/cpp/string/basic_string_view/starts_with
     /// </summary>
@@ -322,7 +537,9 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     /// <returns></returns>
     constexpr bool starts_with(basic_str_view sv) const noexcept;
     constexpr bool starts_with(CharT c) const noexcept;
-    constexpr bool starts_with(const CharT *s) const;
+    template <typename Ptr, utility::_if_char_pointer_<CharT, Ptr> = 0> constexpr bool starts_with(const Ptr &s) const;
+    template <size_t N> constexpr bool starts_with(const CharT (&s)[N]) const;
+    template <size_t N> constexpr bool starts_with(CharT (&s)[N]) const;
 
     /// <summary>
     ///  Checks if the string view ends with the given suffix, where
@@ -330,6 +547,7 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     ///         size() >= sv.size() && compare(size() - sv.size(), npos, sv) == 0
     ///   - the suffix is a single character.Effectively returns !empty() && Traits::eq(back(), c)
     ///   - the suffix is a null - terminated character string.Effectively returns ends_with(basic_string_view(s))
+    ///   - the suffix is a const CharT array (a literal), with a compile time length as for starts_with
     ///
     /// https://en.cppreference.com/w/cpp/string/basic_string_view/ends_with
     /// </summary>
@@ -337,7 +555,9 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     /// <returns></returns>
     constexpr bool ends_with(basic_str_view sv) const noexcept;
     constexpr bool ends_with(CharT c) const noexcept;
-    constexpr bool ends_with(const CharT *s) const;
+    template <typename Ptr, utility::_if_char_pointer_<CharT, Ptr> = 0> constexpr bool ends_with(const Ptr &s) const;
+    template <size_t N> constexpr bool ends_with(const CharT (&s)[N]) const;
+    template <size_t N> constexpr bool ends_with(CharT (&s)[N]) const;
 
     /// <summary>
     /// Checks if the string view contains the given substring, where
@@ -352,9 +572,12 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     constexpr bool contains(basic_str_view sv) const noexcept;
     constexpr bool contains(CharT c) const noexcept;
     constexpr bool contains(const CharT *s) const;
+    constexpr bool contains(const basic_searcher<CharT> &s) const noexcept;
 
     /// <summary>
     /// Finds the first substring equal to the given character sequence.
+    /// The basic_searcher overload reuses a preprocessed needle, e.g. one built at compile time from a literal. It
+    /// matches raw units, so it only exists for std::char_traits views.
     /// </summary>
     /// <param name="v"></param>
     /// <param name="pos"></param>
@@ -363,6 +586,7 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     constexpr size_type find(CharT ch, size_type pos = 0) const noexcept;
     constexpr size_type find(const CharT *s, size_type pos, size_type count) const;
     constexpr size_type find(const CharT *s, size_type pos = 0) const;
+    constexpr size_type find(const basic_searcher<CharT> &s, size_type pos = 0) const noexcept;
 
     /// <summary>
     /// Finds the last substring equal to the given character sequence.
@@ -380,6 +604,8 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     /// Equivalent to find_first_of(basic_string_view(std::addressof(c), 1), pos).
     /// Equivalent to find_first_of(basic_string_view(s, count), pos).
     /// Equivalent to find_first_of(basic_string_view(s), pos).
+    /// The basic_char_set overload reuses a precomputed set, e.g. one built at compile time from a literal. The set
+    /// matches raw units, so that overload (and the ones of the other find_*_of families) needs std::char_traits.
     ///
     /// https://en.cppreference.com/w/cpp/string/basic_string_view/find_first_of
     /// </summary>
@@ -392,12 +618,14 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     constexpr size_type find_first_of(CharT c, size_type pos = 0) const noexcept;
     constexpr size_type find_first_of(const CharT *s, size_type pos, size_type count) const;
     constexpr size_type find_first_of(const CharT *s, size_type pos = 0) const;
+    constexpr size_type find_first_of(const basic_char_set<CharT> &set, size_type pos = 0) const noexcept;
 
     /// <summary>
     /// Finds the last occurence of any of the characters of v in this view, ending at position pos.
     /// Equivalent to find_last_of(basic_string_view(std::addressof(c), 1), pos).
     /// Equivalent to find_last_of(basic_string_view(s, count), pos).
     /// Equivalent to find_last_of(basic_string_view(s), pos).
+    /// The basic_char_set overload reuses a precomputed set.
     ///
     /// https://en.cppreference.com/w/cpp/string/basic_string_view/find_last_of
     /// </summary>
@@ -408,12 +636,14 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     constexpr size_type find_last_of(CharT c, size_type pos = npos) const noexcept;
     constexpr size_type find_last_of(const CharT *s, size_type pos, size_type count) const;
     constexpr size_type find_last_of(const CharT *s, size_type pos = npos) const;
+    constexpr size_type find_last_of(const basic_char_set<CharT> &set, size_type pos = npos) const noexcept;
 
     /// <summary>
     /// Finds the first character not equal to any of the characters of v in this view, starting at position pos.
     /// Equivalent to find_first_not_of(basic_string_view(std::addressof(c), 1), pos).
     /// Equivalent to find_first_not_of(basic_string_view(s, count), pos).
     /// Equivalent to find_first_not_of(basic_string_view(s), pos).
+    /// The basic_char_set overload reuses a precomputed set.
     ///
     /// https://en.cppreference.com/w/cpp/string/basic_string_view/find_first_not_of
     /// </summary>
@@ -424,12 +654,14 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     constexpr size_type find_first_not_of(CharT c, size_type pos = 0) const noexcept;
     constexpr size_type find_first_not_of(const CharT *s, size_type pos, size_type count) const;
     constexpr size_type find_first_not_of(const CharT *s, size_type pos = 0) const;
+    constexpr size_type find_first_not_of(const basic_char_set<CharT> &set, size_type pos = 0) const noexcept;
 
     /// <summary>
     /// Finds the last character not equal to any of the characters of v in this view, starting at position pos.
     /// Equivalent to find_last_not_of(basic_string_view(std::addressof(c), 1), pos).
     /// Equivalent to find_last_not_of(basic_string_view(s, count), pos).
     /// Equivalent to find_last_not_of(basic_string_view(s), pos).
+    /// The basic_char_set overload reuses a precomputed set.
     ///
     /// https://en.cppreference.com/w/cpp/string/basic_string_view/find_last_not_of
     /// </summary>
@@ -440,15 +672,31 @@ template <typename CharT, typename Traits = std::char_traits<CharT>> struct basi
     constexpr size_type find_last_not_of(CharT c, size_type pos = npos) const noexcept;
     constexpr size_type find_last_not_of(const CharT *s, size_type pos, size_type count) const;
     constexpr size_type find_last_not_of(const CharT *s, size_type pos = npos) const;
+    constexpr size_type find_last_not_of(const basic_char_set<CharT> &set, size_type pos = npos) const noexcept;
 
-#if 0
-        template <> struct hash<std::string_view>;
-        template <> struct hash<std::wstring_view>;
-        template <> struct hash<std::u8string_view>;
-        template <> struct hash<std::u16string_view>;
-        template <> struct hash<std::u32string_view>;
-#endif
   private:
+    // Bodies of the instrumented operations; the public members wrap them in a probe (see instrument.hpp).
+    constexpr const_referance _at_(size_type pos) const;
+    size_type _copy_(CharT *dest, size_type count, size_type pos) const;
+    constexpr basic_str_view _substr_(size_type pos, size_type count) const;
+    constexpr int _compare_(basic_str_view v) const noexcept;
+    constexpr bool _equals_(basic_str_view v) const noexcept;
+    constexpr bool _starts_with_(basic_str_view sv) const noexcept;
+    constexpr bool _ends_with_(basic_str_view sv) const noexcept;
+    constexpr size_type _find_(basic_str_view v, size_type pos) const noexcept;
+    constexpr size_type _find_(CharT ch, size_type pos) const noexcept;
+    constexpr size_type _find_(const basic_searcher<CharT> &s, size_type pos) const noexcept;
+    constexpr size_type _rfind_(basic_str_view v, size_type pos) const noexcept;
+    constexpr size_type _rfind_(CharT c, size_type pos) const noexcept;
+    constexpr size_type _find_first_of_(basic_str_view v, size_type pos) const noexcept;
+    constexpr size_type _find_first_of_(const basic_char_set<CharT> &set, size_type pos) const noexcept;
+    constexpr size_type _find_last_of_(basic_str_view v, size_type pos) const noexcept;
+    constexpr size_type _find_last_of_(const basic_char_set<CharT> &set, size_type pos) const noexcept;
+    constexpr size_type _find_first_not_of_(basic_str_view v, size_type pos) const noexcept;
+    constexpr size_type _find_first_not_of_(const basic_char_set<CharT> &set, size_type pos) const noexcept;
+    constexpr size_type _find_last_not_of_(basic_str_view v, size_type pos) const noexcept;
+    constexpr size_type _find_last_not_of_(const basic_char_set<CharT> &set, size_type pos) const noexcept;
+
     const CharT *m_str;
     size_type m_length;
 };
@@ -460,6 +708,9 @@ using wstr_view = basic_str_view<wchar_t>;
 using u16str_view = basic_str_view<char16_t>;
 using u32str_view = basic_str_view<char32_t>;
 
+template <typename CharT, typename Traits>
+constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::npos;
+
 template <typename CharT, typename Traits>
 inline constexpr basic_str_view<CharT, Traits>::basic_str_view() noexcept : m_str(nullptr), m_length(0)
 {
@@ -473,7 +724,7 @@ inline constexpr basic_str_view<CharT, Traits>::basic_str_view(const CharT *s, s
 
 template <typename CharT, typename Traits>
 inline constexpr basic_str_view<CharT, Traits>::basic_str_view(const CharT *s)
-    : m_str(s), m_length(utility::_length_(s))
+    : m_str(s), m_length(utility::_length_<CharT, Traits>(s))
 {
 }
 
@@ -487,55 +738,59 @@ inline basic_str_view<CharT, Traits>::basic_str_view(const std::basic_string<Cha
 // -----------------------------------------------------------------------------------------------------------------------
 
 template <typename CharT, typename Traits>
-inline typename basic_str_view<CharT, Traits>::const_iterator basic_str_view<CharT, Traits>::begin() const noexcept
+inline constexpr typename basic_str_view<CharT, Traits>::const_iterator basic_str_view<CharT, Traits>::begin()
+    const noexcept
 {
     return m_str;
 }
 
 template <typename CharT, typename Traits>
-inline typename basic_str_view<CharT, Traits>::const_iterator basic_str_view<CharT, Traits>::cbegin() const noexcept
+inline constexpr typename basic_str_view<CharT, Traits>::const_iterator basic_str_view<CharT, Traits>::cbegin()
+    const noexcept
 {
     return m_str;
 }
 
 template <typename CharT, typename Traits>
-inline typename basic_str_view<CharT, Traits>::const_iterator basic_str_view<CharT, Traits>::end() const noexcept
+inline constexpr typename basic_str_view<CharT, Traits>::const_iterator basic_str_view<CharT, Traits>::end()
+    const noexcept
 {
     return m_str + m_length;
 }
 
 template <typename CharT, typename Traits>
-inline typename basic_str_view<CharT, Traits>::const_iterator basic_str_view<CharT, Traits>::cend() const noexcept
+inline constexpr typename basic_str_view<CharT, Traits>::const_iterator basic_str_view<CharT, Traits>::cend()
+    const noexcept
 {
     return m_str + m_length;
 }
 
 template <typename CharT, typename Traits>
-inline typename basic_str_view<CharT, Traits>::const_reverse_iterator basic_str_view<CharT, Traits>::rbegin()
+inline constexpr typename basic_str_view<CharT, Traits>::const_reverse_iterator basic_str_view<CharT, Traits>::rbegin()
     const noexcept
 {
-    return m_str + m_length;
+    return const_reverse_iterator(end());
 }
 
 template <typename CharT, typename Traits>
-inline typename basic_str_view<CharT, Traits>::const_reverse_iterator basic_str_view<CharT, Traits>::rend()
+inline constexpr typename basic_str_view<CharT, Traits>::const_reverse_iterator basic_str_view<CharT, Traits>::rend()
     const noexcept
 {
-    return m_str;
+    return const_reverse_iterator(begin());
 }
 
 template <typename CharT, typename Traits>
-inline typename basic_str_view<CharT, Traits>::const_reverse_iterator basic_str_view<CharT, Traits>::crbegin()
+inline constexpr typename basic_str_view<CharT, Traits>::const_reverse_iterator basic_str_view<CharT, Traits>::crbegin()
     const noexcept
 {
-    return m_str + m_length;
+    return const_reverse_iterator(end());
 }
 
 template <typename CharT, typename Traits>
-inline typename basic_str_view<CharT, Traits>::const_reverse_iterator basic_str_view<CharT, Traits>::crend()
+inline constexpr typename basic_str_view<CharT, Traits>::const_reverse_iterator basic_str_view<CharT, Traits>::crend()
     const noexcept
 {
-    return m_str;
+    return const_reverse_iterator(begin());
 }
 
 // -----------------------------------------------------------------------------------------------------------------------
@@ -563,7 +818,19 @@ template <typename CharT, typename Traits>
 inline constexpr typename basic_str_view<CharT, Traits>::const_referance basic_str_view<CharT, Traits>::at(
     size_type pos) const
 {
-    return pos < m_length ? m_str[pos] : throw std::out_of_range("Index out of range lambda::str_view::at");
+    LAMBDA_STR_VIEW_PROBE(at, m_length, pos, _at_(pos));
+    return _at_(pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::const_referance basic_str_view<CharT, Traits>::_at_(
+    size_type pos) const
+{
+    if (pos >= m_length)
+    {
+        utility::_throw_out_of_range_("Index out of range lambda::str_view::at");
+    }
+    return m_str[pos];
 }
 
 template <typename CharT, typename Traits>
@@ -575,7 +842,7 @@ inline constexpr typename basic_str_view<CharT, Traits>::const_referance basic_s
 template <typename CharT, typename Traits>
 inline constexpr typename basic_str_view<CharT, Traits>::const_referance basic_str_view<CharT, Traits>::back() const
 {
-    return *m_str[m_length - 1];
+    return m_str[m_length - 1];
 }
 
 // -----------------------------------------------------------------------------------------------------------------------
@@ -612,24 +879,31 @@ inline constexpr void basic_str_view<CharT, Traits>::remove_prefix(size_type n)
 {
     if (n > m_length)
     {
-        throw std::out_of_range("Index out of range in lambda::str_view::remove_prefix");
+        utility::_throw_out_of_range_("Index out of range in lambda::str_view::remove_prefix");
     }
-
-    m_str = m_str + n;
-    m_length -= n;
+    *this = unchecked_substr(n, m_length - n);
 }
 
 template <typename CharT, typename Traits>
 inline constexpr void basic_str_view<CharT, Traits>::remove_suffix(size_type n)
 {
+    if (n > m_length)
+    {
+        utility::_throw_out_of_range_("Index out of range in lambda::str_view::remove_suffix");
+    }
     m_length -= n;
 }
 
 template <typename CharT, typename Traits>
 inline constexpr void basic_str_view<CharT, Traits>::swap(basic_str_view &v) noexcept
 {
-    std::swap(m_str, v.m_str);
-    std::swap(m_length, v.m_length);
+    // std::swap is only constexpr from C++20.
+    const CharT *const str = m_str;
+    const size_type length = m_length;
+    m_str = v.m_str;
+    m_length = v.m_length;
+    v.m_str = str;
+    v.m_length = length;
 }
 
 // -----------------------------------------------------------------------------------------------------------------------
@@ -646,39 +920,191 @@ template <typename CharT, typename Traits>
 typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::copy(CharT *dest, size_type count,
                                                                                       size_type pos) const
 {
-    if (pos >= m_length)
+    LAMBDA_STR_VIEW_PROBE(copy, m_length, std::min(count, m_length), _copy_(dest, count, pos));
+    return _copy_(dest, count, pos);
+}
+
+template <typename CharT, typename Traits>
+typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_copy_(CharT *dest, size_type count,
+                                                                                        size_type pos) const
+{
+    if (pos > m_length)
     {
-        throw std::out_of_range("Index out of range in std::string_view::copy");
+        utility::_throw_out_of_range_("Index out of range in lambda::str_view::copy");
     }
 
-    const size_type rc = std::min(m_length - pos, count + 1);
-    std::copy(m_str + pos, m_str + pos + rc, dest);
+    const size_type rc = std::min(m_length - pos, count);
+    if (utility::_bitwise_traits_<CharT, Traits>::value)
+    {
+        if (rc != 0)
+        {
+            std::memcpy(dest, m_str + pos, rc * sizeof(CharT));
+        }
+    }
+    else
+    {
+        Traits::copy(dest, m_str + pos, rc);
+    }
     return rc;
 }
 
+template <typename CharT, typename Traits>
+inline basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::materialize(monotonic_arena &arena) const
+{
+    CharT *dest = arena.allocate_array<CharT>(m_length + 1);
+    copy(dest, m_length);
+    dest[m_length] = CharT();
+    return basic_str_view(dest, m_length);
+}
+
 template <typename CharT, typename Traits>
 inline constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::substr(size_type pos,
                                                                                      size_type count) const
 {
-    const size_type max_length = pos > m_length ? 0 : m_length - pos;
+    LAMBDA_STR_VIEW_PROBE(substr, m_length, std::min(count, m_length), _substr_(pos, count));
+    return _substr_(pos, count);
+}
 
+template <typename CharT, typename Traits>
+inline constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::_substr_(size_type pos,
+                                                                                       size_type count) const
+{
     if (pos > m_length)
     {
-        throw std::out_of_range("Index out of range in basic_string_view::substr");
+        utility::_throw_out_of_range_("Index out of range in lambda::str_view::substr");
+    }
+    return unchecked_substr(pos, std::min(count, m_length - pos));
+}
+
+template <typename CharT, typename Traits>
+LAMBDA_FORCE_INLINE constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::unchecked_substr(
+    size_type pos, size_type count) const noexcept
+{
+    LAMBDA_STR_VIEW_ASSERT(pos <= m_length && count <= m_length - pos);
+    return basic_str_view(m_str + pos, count);
+}
+
+template <typename CharT, typename Traits>
+LAMBDA_FORCE_INLINE constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::first(
+    size_type n) const noexcept
+{
+    return unchecked_substr(0, n);
+}
+
+template <typename CharT, typename Traits>
+LAMBDA_FORCE_INLINE constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::last(
+    size_type n) const noexcept
+{
+    LAMBDA_STR_VIEW_ASSERT(n <= m_length);
+    return unchecked_substr(m_length - n, n);
+}
+
+template <typename CharT, typename Traits>
+LAMBDA_FORCE_INLINE constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::take(
+    size_type n) const noexcept
+{
+    return unchecked_substr(0, n < m_length ? n : m_length);
+}
+
+template <typename CharT, typename Traits>
+LAMBDA_FORCE_INLINE constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::drop(
+    size_type n) const noexcept
+{
+    const size_type k = n < m_length ? n : m_length;
+    return unchecked_substr(k, m_length - k);
+}
+
+template <typename CharT, typename Traits>
+LAMBDA_FORCE_INLINE constexpr std::pair<basic_str_view<CharT, Traits>, basic_str_view<CharT, Traits>> basic_str_view<
+    CharT, Traits>::split_at(size_type pos) const noexcept
+{
+    LAMBDA_STR_VIEW_ASSERT(pos <= m_length);
+    return std::pair<basic_str_view, basic_str_view>(unchecked_substr(0, pos), unchecked_substr(pos, m_length - pos));
+}
+
+template <typename CharT, typename Traits>
+inline constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::trim() const noexcept
+{
+    return trim_front().trim_back();
+}
+
+template <typename CharT, typename Traits>
+inline constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::trim_front() const noexcept
+{
+    size_type i = 0;
+    while (i < m_length && utility::_is_space_(m_str[i]))
+    {
+        ++i;
+    }
+    return unchecked_substr(i, m_length - i);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::trim_back() const noexcept
+{
+    size_type n = m_length;
+    while (n != 0 && utility::_is_space_(m_str[n - 1]))
+    {
+        --n;
     }
+    return unchecked_substr(0, n);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::trim(basic_str_view chars) const noexcept
+{
+    return trim_front(chars).trim_back(chars);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::trim_front(
+    basic_str_view chars) const noexcept
+{
+    const size_type i = find_first_not_of(chars);
+    return i == npos ? unchecked_substr(m_length, 0) : unchecked_substr(i, m_length - i);
+}
 
-    return basic_str_view(m_str + pos, std::min(count, max_length));
+template <typename CharT, typename Traits>
+inline constexpr basic_str_view<CharT, Traits> basic_str_view<CharT, Traits>::trim_back(
+    basic_str_view chars) const noexcept
+{
+    const size_type i = find_last_not_of(chars);
+    return unchecked_substr(0, i == npos ? 0 : i + 1);
 }
 
 // -----------------------------------------------------------------------------------------------------------------------
 
 template <typename CharT, typename Traits>
 inline constexpr int basic_str_view<CharT, Traits>::compare(basic_str_view v) const noexcept
+{
+    LAMBDA_STR_VIEW_PROBE(compare, m_length, v.m_length, _compare_(v));
+    return _compare_(v);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr int basic_str_view<CharT, Traits>::_compare_(basic_str_view v) const noexcept
 {
     const size_type rlen = std::min(m_length, v.length());
-    const int compare = trait_type::compare(m_str, v.m_str, rlen);
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        const int compare = trait_type::compare(m_str, v.m_str, rlen);
+        if (compare != 0)
+        {
+            return compare;
+        }
+    }
+    else
+    {
+        for (size_type i = 0; i < rlen; ++i)
+        {
+            if (!trait_type::eq(m_str[i], v.m_str[i]))
+            {
+                return trait_type::lt(m_str[i], v.m_str[i]) ? -1 : 1;
+            }
+        }
+    }
 
-    return (compare ? compare : (m_length < v.m_length ? -1 : (m_length > v.m_length ? 1 : 0)));
+    return m_length < v.m_length ? -1 : (m_length > v.m_length ? 1 : 0);
 }
 
 template <typename CharT, typename Traits>
@@ -713,42 +1139,120 @@ inline constexpr int basic_str_view<CharT, Traits>::compare(size_type pos1, size
     return substr(pos1, count1).compare(basic_str_view<CharT, Traits>(s, count2));
 }
 
+template <typename CharT, typename Traits>
+inline constexpr bool basic_str_view<CharT, Traits>::equals(basic_str_view v) const noexcept
+{
+    LAMBDA_STR_VIEW_PROBE(equals, m_length, v.m_length, _equals_(v));
+    return _equals_(v);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr bool basic_str_view<CharT, Traits>::_equals_(basic_str_view v) const noexcept
+{
+    if (m_length != v.m_length)
+    {
+        return false;
+    }
+    if (utility::_bitwise_traits_<CharT, Traits>::value && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return simd::equal_bytes(m_str, v.m_str, m_length * sizeof(CharT));
+    }
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return trait_type::compare(m_str, v.m_str, m_length) == 0;
+    }
+
+    for (size_type i = 0; i < m_length; ++i)
+    {
+        if (!trait_type::eq(m_str[i], v.m_str[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 // starts with
 template <typename CharT, typename Traits>
 inline constexpr bool basic_str_view<CharT, Traits>::starts_with(basic_str_view sv) const noexcept
 {
-    return compare(0, sv.size(), sv) == 0;
+    LAMBDA_STR_VIEW_PROBE(starts_with, m_length, sv.m_length, _starts_with_(sv));
+    return _starts_with_(sv);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr bool basic_str_view<CharT, Traits>::_starts_with_(basic_str_view sv) const noexcept
+{
+    return m_length >= sv.m_length && first(sv.m_length).equals(sv);
 }
 
 template <typename CharT, typename Traits>
 inline constexpr bool basic_str_view<CharT, Traits>::starts_with(CharT c) const noexcept
 {
-    return c == m_str;
+    return m_length != 0 && trait_type::eq(m_str[0], c);
+}
+
+template <typename CharT, typename Traits>
+template <typename Ptr, utility::_if_char_pointer_<CharT, Ptr>>
+inline constexpr bool basic_str_view<CharT, Traits>::starts_with(const Ptr &s) const
+{
+    return starts_with(basic_str_view(s));
 }
 
 template <typename CharT, typename Traits>
-inline constexpr bool basic_str_view<CharT, Traits>::starts_with(const CharT *s) const
+template <size_t N>
+inline constexpr bool basic_str_view<CharT, Traits>::starts_with(const CharT (&s)[N]) const
 {
-    return compare(0, trait_type::length(s), basic_str_view<CharT, Traits>(s)) == 0;
+    return starts_with(basic_str_view(s, utility::_array_length_<CharT, Traits>(s)));
+}
+
+/// Writable arrays are buffers rather than literals, so their length is scanned.
+template <typename CharT, typename Traits>
+template <size_t N>
+inline constexpr bool basic_str_view<CharT, Traits>::starts_with(CharT (&s)[N]) const
+{
+    return starts_with(basic_str_view(static_cast<const CharT *>(s)));
 }
 
 // ends with
 template <typename CharT, typename Traits>
 inline constexpr bool basic_str_view<CharT, Traits>::ends_with(basic_str_view sv) const noexcept
 {
-    return compare(m_length - sv.length(), sv.length(), sv);
+    LAMBDA_STR_VIEW_PROBE(ends_with, m_length, sv.m_length, _ends_with_(sv));
+    return _ends_with_(sv);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr bool basic_str_view<CharT, Traits>::_ends_with_(basic_str_view sv) const noexcept
+{
+    return m_length >= sv.m_length && last(sv.m_length).equals(sv);
 }
 
 template <typename CharT, typename Traits>
 inline constexpr bool basic_str_view<CharT, Traits>::ends_with(CharT c) const noexcept
 {
-    return c == *m_str[m_length - 1];
+    return m_length != 0 && trait_type::eq(m_str[m_length - 1], c);
+}
+
+template <typename CharT, typename Traits>
+template <typename Ptr, utility::_if_char_pointer_<CharT, Ptr>>
+inline constexpr bool basic_str_view<CharT, Traits>::ends_with(const Ptr &s) const
+{
+    return ends_with(basic_str_view(s));
+}
+
+template <typename CharT, typename Traits>
+template <size_t N>
+inline constexpr bool basic_str_view<CharT, Traits>::ends_with(const CharT (&s)[N]) const
+{
+    return ends_with(basic_str_view(s, utility::_array_length_<CharT, Traits>(s)));
 }
 
 template <typename CharT, typename Traits>
-inline constexpr bool basic_str_view<CharT, Traits>::ends_with(const CharT *s) const
+template <size_t N>
+inline constexpr bool basic_str_view<CharT, Traits>::ends_with(CharT (&s)[N]) const
 {
-    return compare(m_length - trait_type::length(s), trait_type::length(s), basic_str_view<CharT, Traits>(s));
+    return ends_with(basic_str_view(static_cast<const CharT *>(s)));
 }
 
 // contains
@@ -770,21 +1274,67 @@ inline constexpr bool basic_str_view<CharT, Traits>::contains(const CharT *s) co
     return find(basic_str_view<CharT, Traits>(s)) != npos;
 }
 
+template <typename CharT, typename Traits>
+inline constexpr bool basic_str_view<CharT, Traits>::contains(const basic_searcher<CharT> &s) const noexcept
+{
+    static_assert(utility::_bitwise_traits_<CharT, Traits>::value,
+                  "basic_searcher compares raw code units and needs std::char_traits");
+    return find(s) != npos;
+}
+
 // ------------------------------------------------------------------------------------------------------------------
 
 template <typename CharT, typename Traits>
 inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::find(
     basic_str_view v, size_type pos) const noexcept
 {
-    if (pos > m_length || pos + v.size() > m_length)
+    LAMBDA_STR_VIEW_PROBE(find, m_length, v.m_length, _find_(v, pos));
+    return _find_(v, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_find_(
+    basic_str_view v, size_type pos) const noexcept
+{
+    if (pos > m_length || v.size() > m_length - pos)
+    {
+        return npos;
+    }
+    if (v.empty())
+    {
+        return pos;
+    }
+
+    if (utility::_bitwise_traits_<CharT, Traits>::value && !LAMBDA_IS_CONSTANT_EVALUATED())
     {
+        const size_type idx = simd::find(m_str + pos, m_length - pos, v.m_str, v.m_length);
+        return idx == simd::npos ? npos : idx + pos;
+    }
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        // Other traits: trait_type::find skips to the candidates for the first unit, trait_type::compare checks them.
+        const CharT *p = m_str + pos;
+        const CharT *const last = m_str + (m_length - v.m_length);
+        while ((p = trait_type::find(p, static_cast<size_type>(last - p) + 1, v.m_str[0])) != nullptr)
+        {
+            if (trait_type::compare(p + 1, v.m_str + 1, v.m_length - 1) == 0)
+            {
+                return static_cast<size_type>(p - m_str);
+            }
+            ++p;
+        }
         return npos;
     }
-    const auto increments = m_length - v.size() - pos;
-    for (auto i = 0u; i <= increments; ++i)
+
+    const size_type last = m_length - v.size();
+    for (size_type j = pos; j <= last; ++j)
     {
-        const auto j = i + pos;
-        if (substr(j, v.size()) == v)
+        size_type k = 0;
+        while (k < v.size() && trait_type::eq(m_str[j + k], v.m_str[k]))
+        {
+            ++k;
+        }
+        if (k == v.size())
         {
             return j;
         }
@@ -797,15 +1347,33 @@ template <typename CharT, typename Traits>
 inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::find(
     CharT ch, size_type pos) const noexcept
 {
-    if (pos > m_length)
+    LAMBDA_STR_VIEW_PROBE(find, m_length, 1, _find_(ch, pos));
+    return _find_(ch, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_find_(
+    CharT ch, size_type pos) const noexcept
+{
+    if (pos >= m_length)
     {
         return npos;
     }
-    const auto increments = m_length - 1 - pos;
-    for (auto i = 0u; i <= increments; ++i)
+
+    if (utility::_bitwise_traits_<CharT, Traits>::value && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        const size_type idx = simd::find_char(m_str + pos, m_length - pos, ch);
+        return idx == simd::npos ? npos : idx + pos;
+    }
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        const CharT *p = trait_type::find(m_str + pos, m_length - pos, ch);
+        return p == nullptr ? npos : static_cast<size_type>(p - m_str);
+    }
+
+    for (size_type j = pos; j < m_length; ++j)
     {
-        const auto j = i + pos;
-        if (m_str[j] == ch)
+        if (trait_type::eq(m_str[j], ch))
         {
             return j;
         }
@@ -828,33 +1396,74 @@ inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_vie
     return find(basic_str_view<CharT, Traits>(s), pos);
 }
 
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::find(
+    const basic_searcher<CharT> &s, size_type pos) const noexcept
+{
+    static_assert(utility::_bitwise_traits_<CharT, Traits>::value,
+                  "basic_searcher compares raw code units and needs std::char_traits");
+    LAMBDA_STR_VIEW_PROBE(find, m_length, s.size(), _find_(s, pos));
+    return _find_(s, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_find_(
+    const basic_searcher<CharT> &s, size_type pos) const noexcept
+{
+    const size_type idx = s.find(m_str, m_length, pos);
+    return idx == basic_searcher<CharT>::npos ? npos : idx;
+}
+
 // ------------------------------------------------------------------------------------------------------------------
 
 template <typename CharT, typename Traits>
 inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::rfind(
     basic_str_view v, size_type pos) const noexcept
 {
-    if (empty())
+    LAMBDA_STR_VIEW_PROBE(rfind, m_length, v.m_length, _rfind_(v, pos));
+    return _rfind_(v, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_rfind_(
+    basic_str_view v, size_type pos) const noexcept
+{
+    if (v.m_length > m_length)
     {
-        return v.empty() ? 0u : npos;
+        return npos;
     }
+    const size_type last = std::min(pos, m_length - v.m_length);
     if (v.empty())
     {
-        return std::min(size() - 1, pos);
+        return last;
     }
-    if (v.size() > size())
+
+    if (utility::_bitwise_traits_<CharT, Traits>::value && !LAMBDA_IS_CONSTANT_EVALUATED())
     {
+        // Jump between occurrences of the first unit and compare only the rest there.
+        size_type count = last + 1;
+        while (count != 0)
+        {
+            const size_type j = simd::rfind_char(m_str, count, v.m_str[0]);
+            if (j == simd::npos)
+            {
+                return npos;
+            }
+            if (unchecked_substr(j + 1, v.m_length - 1).equals(v.drop(1)))
+            {
+                return j;
+            }
+            count = j;
+        }
         return npos;
     }
 
-    auto i = std::min(pos, (size() - v.size()));
-    while (i != npos)
+    for (size_type j = last + 1; j-- > 0;)
     {
-        if (substr(i, v.size()) == v)
+        if (unchecked_substr(j, v.m_length).equals(v))
         {
-            return i;
+            return j;
         }
-        --i;
     }
 
     return npos;
@@ -864,7 +1473,34 @@ template <typename CharT, typename Traits>
 inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::rfind(
     CharT c, size_type pos) const noexcept
 {
-    return rfind(basic_str_view<CharT, Traits>(&c, 1), pos);
+    LAMBDA_STR_VIEW_PROBE(rfind, m_length, 1, _rfind_(c, pos));
+    return _rfind_(c, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_rfind_(
+    CharT c, size_type pos) const noexcept
+{
+    if (empty())
+    {
+        return npos;
+    }
+
+    const size_type count = std::min(pos, m_length - 1) + 1;
+    if (utility::_bitwise_traits_<CharT, Traits>::value && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return simd::rfind_char(m_str, count, c);
+    }
+
+    for (size_type j = count; j-- > 0;)
+    {
+        if (trait_type::eq(m_str[j], c))
+        {
+            return j;
+        }
+    }
+
+    return npos;
 }
 
 template <typename CharT, typename Traits>
@@ -895,14 +1531,32 @@ template <typename CharT, typename Traits>
 inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::find_first_of(
     basic_str_view v, size_type pos) const noexcept
 {
+    LAMBDA_STR_VIEW_PROBE(find_first_of, m_length, v.m_length, _find_first_of_(v, pos));
+    return _find_first_of_(v, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_find_first_of_(
+    basic_str_view v, size_type pos) const noexcept
+{
+    if (v.size() == 1)
+    {
+        return find(v[0], pos);
+    }
+    if (pos >= m_length || v.empty())
+    {
+        return npos;
+    }
+    if (sizeof(CharT) == 1 && utility::_bitwise_traits_<CharT, Traits>::value && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return _find_first_of_(basic_char_set<CharT>(v.data(), v.size()), pos);
+    }
+
     for (size_type idx = pos; idx < m_length; ++idx)
     {
-        for (size_type j = 0; j < v.size(); ++j)
+        if (v.find(m_str[idx]) != npos)
         {
-            if (m_str[j] == v[idx])
-            {
-                return j;
-            }
+            return idx;
         }
     }
     return npos;
@@ -929,25 +1583,72 @@ inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_vie
     return find_first_of(basic_str_view<CharT, Traits>(s), pos);
 }
 
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::find_first_of(
+    const basic_char_set<CharT> &set, size_type pos) const noexcept
+{
+    static_assert(utility::_bitwise_traits_<CharT, Traits>::value,
+                  "basic_char_set compares raw code units and needs std::char_traits");
+    LAMBDA_STR_VIEW_PROBE(find_first_of, m_length, 0, _find_first_of_(set, pos));
+    return _find_first_of_(set, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_find_first_of_(
+    const basic_char_set<CharT> &set, size_type pos) const noexcept
+{
+    if (pos >= m_length)
+    {
+        return npos;
+    }
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        const size_type idx = set.template find<true>(m_str + pos, m_length - pos);
+        return idx == simd::npos ? npos : idx + pos;
+    }
+
+    for (size_type idx = pos; idx < m_length; ++idx)
+    {
+        if (set.contains(m_str[idx]) == true)
+        {
+            return idx;
+        }
+    }
+    return npos;
+}
+
 // -------------------------------------------------------------------------------------------------------------
 
 template <typename CharT, typename Traits>
 inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::find_last_of(
     basic_str_view v, size_type pos /*where to end*/) const noexcept
 {
-    if (v.empty())
+    LAMBDA_STR_VIEW_PROBE(find_last_of, m_length, v.m_length, _find_last_of_(v, pos));
+    return _find_last_of_(v, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_find_last_of_(
+    basic_str_view v, size_type pos /*where to end*/) const noexcept
+{
+    if (v.size() == 1)
+    {
+        return rfind(v[0], pos);
+    }
+    if (empty() || v.empty())
+    {
         return npos;
+    }
+    if (sizeof(CharT) == 1 && utility::_bitwise_traits_<CharT, Traits>::value && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return _find_last_of_(basic_char_set<CharT>(v.data(), v.size()), pos);
+    }
 
-    const auto len = std::min(m_length - 1, pos);
-    for (size_type idx{0}; idx <= len; ++idx)
+    for (size_type idx = std::min(pos, m_length - 1) + 1; idx-- > 0;)
     {
-        const auto j = len - idx;
-        for (size_type jdx{0}; jdx < j; ++jdx)
+        if (v.find(m_str[idx]) != npos)
         {
-            if (m_str[idx] == v[jdx])
-            {
-                return jdx;
-            }
+            return idx;
         }
     }
     return npos;
@@ -974,18 +1675,67 @@ inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_vie
     return find_last_of(basic_str_view<CharT, Traits>(s), pos);
 }
 
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::find_last_of(
+    const basic_char_set<CharT> &set, size_type pos) const noexcept
+{
+    static_assert(utility::_bitwise_traits_<CharT, Traits>::value,
+                  "basic_char_set compares raw code units and needs std::char_traits");
+    LAMBDA_STR_VIEW_PROBE(find_last_of, m_length, 0, _find_last_of_(set, pos));
+    return _find_last_of_(set, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_find_last_of_(
+    const basic_char_set<CharT> &set, size_type pos) const noexcept
+{
+    if (empty())
+    {
+        return npos;
+    }
+
+    const size_type count = std::min(pos, m_length - 1) + 1;
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return set.template rfind<true>(m_str, count);
+    }
+
+    for (size_type idx = count; idx-- > 0;)
+    {
+        if (set.contains(m_str[idx]) == true)
+        {
+            return idx;
+        }
+    }
+    return npos;
+}
+
 template <typename CharT, typename Traits>
 inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::find_first_not_of(
     basic_str_view v, size_type pos) const noexcept
 {
+    LAMBDA_STR_VIEW_PROBE(find_first_not_of, m_length, v.m_length, _find_first_not_of_(v, pos));
+    return _find_first_not_of_(v, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_find_first_not_of_(
+    basic_str_view v, size_type pos) const noexcept
+{
+    if (pos >= m_length)
+    {
+        return npos;
+    }
+    if (sizeof(CharT) == 1 && utility::_bitwise_traits_<CharT, Traits>::value && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return _find_first_not_of_(basic_char_set<CharT>(v.data(), v.size()), pos);
+    }
+
     for (size_type idx = pos; idx < m_length; ++idx)
     {
-        for (size_type j = 0; j < v.size(); ++j)
+        if (v.find(m_str[idx]) == npos)
         {
-            if (m_str[j] != v[idx])
-            {
-                return j;
-            }
+            return idx;
         }
     }
     return npos;
@@ -1012,23 +1762,66 @@ inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_vie
     return find_first_not_of(basic_str_view<CharT, Traits>(s), pos);
 }
 
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::find_first_not_of(
+    const basic_char_set<CharT> &set, size_type pos) const noexcept
+{
+    static_assert(utility::_bitwise_traits_<CharT, Traits>::value,
+                  "basic_char_set compares raw code units and needs std::char_traits");
+    LAMBDA_STR_VIEW_PROBE(find_first_not_of, m_length, 0, _find_first_not_of_(set, pos));
+    return _find_first_not_of_(set, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_find_first_not_of_(
+    const basic_char_set<CharT> &set, size_type pos) const noexcept
+{
+    if (pos >= m_length)
+    {
+        return npos;
+    }
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        const size_type idx = set.template find<false>(m_str + pos, m_length - pos);
+        return idx == simd::npos ? npos : idx + pos;
+    }
+
+    for (size_type idx = pos; idx < m_length; ++idx)
+    {
+        if (set.contains(m_str[idx]) == false)
+        {
+            return idx;
+        }
+    }
+    return npos;
+}
+
 template <typename CharT, typename Traits>
 inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::find_last_not_of(
     basic_str_view v, size_type pos) const noexcept
 {
-    if (v.empty())
+    LAMBDA_STR_VIEW_PROBE(find_last_not_of, m_length, v.m_length, _find_last_not_of_(v, pos));
+    return _find_last_not_of_(v, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_find_last_not_of_(
+    basic_str_view v, size_type pos) const noexcept
+{
+    if (empty())
+    {
         return npos;
+    }
+    if (sizeof(CharT) == 1 && utility::_bitwise_traits_<CharT, Traits>::value && !LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return _find_last_not_of_(basic_char_set<CharT>(v.data(), v.size()), pos);
+    }
 
-    const auto len = std::min(m_length - 1, pos);
-    for (size_type idx{0}; idx <= len; ++idx)
+    for (size_type idx = std::min(pos, m_length - 1) + 1; idx-- > 0;)
     {
-        const auto j = len - idx;
-        for (size_type jdx{0}; jdx < j; ++jdx)
+        if (v.find(m_str[idx]) == npos)
         {
-            if (m_str[idx] != v[jdx])
-            {
-                return jdx;
-            }
+            return idx;
         }
     }
     return npos;
@@ -1055,200 +1848,235 @@ inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_vie
     return find_last_not_of(basic_str_view<CharT, Traits>(s), pos);
 }
 
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::find_last_not_of(
+    const basic_char_set<CharT> &set, size_type pos) const noexcept
+{
+    static_assert(utility::_bitwise_traits_<CharT, Traits>::value,
+                  "basic_char_set compares raw code units and needs std::char_traits");
+    LAMBDA_STR_VIEW_PROBE(find_last_not_of, m_length, 0, _find_last_not_of_(set, pos));
+    return _find_last_not_of_(set, pos);
+}
+
+template <typename CharT, typename Traits>
+inline constexpr typename basic_str_view<CharT, Traits>::size_type basic_str_view<CharT, Traits>::_find_last_not_of_(
+    const basic_char_set<CharT> &set, size_type pos) const noexcept
+{
+    if (empty())
+    {
+        return npos;
+    }
+
+    const size_type count = std::min(pos, m_length - 1) + 1;
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return set.template rfind<false>(m_str, count);
+    }
+
+    for (size_type idx = count; idx-- > 0;)
+    {
+        if (set.contains(m_str[idx]) == false)
+        {
+            return idx;
+        }
+    }
+    return npos;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------
+// Non-member comparison operators. Equality goes through equals(), ordering through compare().
+// -----------------------------------------------------------------------------------------------------------------------
+
 template <typename CharT, typename Traits>
 inline constexpr bool operator==(basic_str_view<CharT, Traits> lhs, basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return rhs.compare(rhs) == 0;
+    return lhs.equals(rhs);
 }
 
 template <typename CharT, typename Traits>
-constexpr bool operator==(basic_str_view<CharT, Traits> lhs, const CharT *rhs) noexcept
+inline constexpr bool operator==(basic_str_view<CharT, Traits> lhs, const CharT *rhs) noexcept
 {
     return lhs == basic_str_view<CharT, Traits>(rhs);
 }
 
 template <typename CharT, typename Traits>
-constexpr bool operator==(const CharT *rhs, basic_str_view<CharT, Traits> lhs) noexcept
+inline constexpr bool operator==(const CharT *lhs, basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return basic_str_view<CharT, Traits>(rhs) == lhs;
+    return basic_str_view<CharT, Traits>(lhs) == rhs;
 }
 
 template <typename CharT, typename Traits, typename Allocator>
-constexpr bool operator==(basic_str_view<CharT, Traits> lhs,
-                          const std::basic_string<CharT, Traits, Allocator> &std_str) noexcept
+inline constexpr bool operator==(basic_str_view<CharT, Traits> lhs,
+                                 const std::basic_string<CharT, Traits, Allocator> &rhs) noexcept
 {
-    return lhs == basic_str_view<CharT, Traits>(std_str);
+    return lhs == basic_str_view<CharT, Traits>(rhs);
 }
 
 template <typename CharT, typename Traits, typename Allocator>
-constexpr bool operator==(const std::basic_string<CharT, Traits, Allocator> &std_str,
-                          basic_str_view<CharT, Traits> lhs) noexcept
+inline constexpr bool operator==(const std::basic_string<CharT, Traits, Allocator> &lhs,
+                                 basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return basic_str_view<CharT, Traits>(std_str) == lhs;
+    return basic_str_view<CharT, Traits>(lhs) == rhs;
 }
 
-//
 template <typename CharT, typename Traits>
 inline constexpr bool operator!=(basic_str_view<CharT, Traits> lhs, basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return rhs.compare(rhs) != 0;
+    return !lhs.equals(rhs);
 }
 
 template <typename CharT, typename Traits>
-constexpr bool operator!=(basic_str_view<CharT, Traits> lhs, const CharT *rhs) noexcept
+inline constexpr bool operator!=(basic_str_view<CharT, Traits> lhs, const CharT *rhs) noexcept
 {
     return lhs != basic_str_view<CharT, Traits>(rhs);
 }
 
 template <typename CharT, typename Traits>
-constexpr bool operator!=(const CharT *rhs, basic_str_view<CharT, Traits> lhs) noexcept
+inline constexpr bool operator!=(const CharT *lhs, basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return basic_str_view<CharT, Traits>(rhs) != lhs;
+    return basic_str_view<CharT, Traits>(lhs) != rhs;
 }
 
 template <typename CharT, typename Traits, typename Allocator>
-constexpr bool operator!=(basic_str_view<CharT, Traits> lhs,
-                          const std::basic_string<CharT, Traits, Allocator> &std_str) noexcept
+inline constexpr bool operator!=(basic_str_view<CharT, Traits> lhs,
+                                 const std::basic_string<CharT, Traits, Allocator> &rhs) noexcept
 {
-    return lhs != basic_str_view<CharT, Traits>(std_str);
+    return lhs != basic_str_view<CharT, Traits>(rhs);
 }
 
 template <typename CharT, typename Traits, typename Allocator>
-constexpr bool operator!=(const std::basic_string<CharT, Traits, Allocator> &std_str,
-                          basic_str_view<CharT, Traits> lhs) noexcept
+inline constexpr bool operator!=(const std::basic_string<CharT, Traits, Allocator> &lhs,
+                                 basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return basic_str_view<CharT, Traits>(std_str) == lhs;
+    return basic_str_view<CharT, Traits>(lhs) != rhs;
 }
 
-//
 template <typename CharT, typename Traits>
 inline constexpr bool operator<(basic_str_view<CharT, Traits> lhs, basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return rhs.compare(rhs) < 0;
+    return lhs.compare(rhs) < 0;
 }
 
 template <typename CharT, typename Traits>
-constexpr bool operator<(basic_str_view<CharT, Traits> lhs, const CharT *rhs) noexcept
+inline constexpr bool operator<(basic_str_view<CharT, Traits> lhs, const CharT *rhs) noexcept
 {
     return lhs < basic_str_view<CharT, Traits>(rhs);
 }
 
 template <typename CharT, typename Traits>
-constexpr bool operator<(const CharT *rhs, basic_str_view<CharT, Traits> lhs) noexcept
+inline constexpr bool operator<(const CharT *lhs, basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return basic_str_view<CharT, Traits>(rhs) < lhs;
+    return basic_str_view<CharT, Traits>(lhs) < rhs;
 }
 
 template <typename CharT, typename Traits, typename Allocator>
-constexpr bool operator<(basic_str_view<CharT, Traits> lhs,
-                         const std::basic_string<CharT, Traits, Allocator> &std_str) noexcept
+inline constexpr bool operator<(basic_str_view<CharT, Traits> lhs,
+                                const std::basic_string<CharT, Traits, Allocator> &rhs) noexcept
 {
-    return lhs < basic_str_view<CharT, Traits>(std_str);
+    return lhs < basic_str_view<CharT, Traits>(rhs);
 }
 
 template <typename CharT, typename Traits, typename Allocator>
-constexpr bool operator<(const std::basic_string<CharT, Traits, Allocator> &std_str,
-                         basic_str_view<CharT, Traits> lhs) noexcept
+inline constexpr bool operator<(const std::basic_string<CharT, Traits, Allocator> &lhs,
+                                basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return basic_str_view<CharT, Traits>(std_str) == lhs;
+    return basic_str_view<CharT, Traits>(lhs) < rhs;
 }
 
 template <typename CharT, typename Traits>
 inline constexpr bool operator<=(basic_str_view<CharT, Traits> lhs, basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return rhs.compare(rhs) <= 0;
+    return lhs.compare(rhs) <= 0;
 }
 
 template <typename CharT, typename Traits>
-constexpr bool operator<=(basic_str_view<CharT, Traits> lhs, const CharT *rhs) noexcept
+inline constexpr bool operator<=(basic_str_view<CharT, Traits> lhs, const CharT *rhs) noexcept
 {
     return lhs <= basic_str_view<CharT, Traits>(rhs);
 }
 
 template <typename CharT, typename Traits>
-constexpr bool operator<=(const CharT *rhs, basic_str_view<CharT, Traits> lhs) noexcept
+inline constexpr bool operator<=(const CharT *lhs, basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return basic_str_view<CharT, Traits>(rhs) < lhs;
+    return basic_str_view<CharT, Traits>(lhs) <= rhs;
 }
 
 template <typename CharT, typename Traits, typename Allocator>
-constexpr bool operator<=(basic_str_view<CharT, Traits> lhs,
-                          const std::basic_string<CharT, Traits, Allocator> &std_str) noexcept
+inline constexpr bool operator<=(basic_str_view<CharT, Traits> lhs,
+                                 const std::basic_string<CharT, Traits, Allocator> &rhs) noexcept
 {
-    return lhs < basic_str_view<CharT, Traits>(std_str);
+    return lhs <= basic_str_view<CharT, Traits>(rhs);
 }
 
 template <typename CharT, typename Traits, typename Allocator>
-constexpr bool operator<=(const std::basic_string<CharT, Traits, Allocator> &std_str,
-                          basic_str_view<CharT, Traits> lhs) noexcept
+inline constexpr bool operator<=(const std::basic_string<CharT, Traits, Allocator> &lhs,
+                                 basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return basic_str_view<CharT, Traits>(std_str) == lhs;
+    return basic_str_view<CharT, Traits>(lhs) <= rhs;
 }
-//
 
 template <typename CharT, typename Traits>
 inline constexpr bool operator>(basic_str_view<CharT, Traits> lhs, basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return rhs.compare(rhs) > 0;
+    return lhs.compare(rhs) > 0;
 }
 
 template <typename CharT, typename Traits>
-constexpr bool operator>(basic_str_view<CharT, Traits> lhs, const CharT *rhs) noexcept
+inline constexpr bool operator>(basic_str_view<CharT, Traits> lhs, const CharT *rhs) noexcept
 {
     return lhs > basic_str_view<CharT, Traits>(rhs);
 }
 
 template <typename CharT, typename Traits>
-constexpr bool operator>(const CharT *rhs, basic_str_view<CharT, Traits> lhs) noexcept
+inline constexpr bool operator>(const CharT *lhs, basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return basic_str_view<CharT, Traits>(rhs) < lhs;
+    return basic_str_view<CharT, Traits>(lhs) > rhs;
 }
 
 template <typename CharT, typename Traits, typename Allocator>
-constexpr bool operator>(basic_str_view<CharT, Traits> lhs,
-                         const std::basic_string<CharT, Traits, Allocator> &std_str) noexcept
+inline constexpr bool operator>(basic_str_view<CharT, Traits> lhs,
+                                const std::basic_string<CharT, Traits, Allocator> &rhs) noexcept
 {
-    return lhs < basic_str_view<CharT, Traits>(std_str);
+    return lhs > basic_str_view<CharT, Traits>(rhs);
 }
 
 template <typename CharT, typename Traits, typename Allocator>
-constexpr bool operator>(const std::basic_string<CharT, Traits, Allocator> &std_str,
-                         basic_str_view<CharT, Traits> lhs) noexcept
+inline constexpr bool operator>(const std::basic_string<CharT, Traits, Allocator> &lhs,
+                                basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return basic_str_view<CharT, Traits>(std_str) == lhs;
+    return basic_str_view<CharT, Traits>(lhs) > rhs;
 }
 
-//
 template <typename CharT, typename Traits>
 inline constexpr bool operator>=(basic_str_view<CharT, Traits> lhs, basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return rhs.compare(rhs) >= 0;
+    return lhs.compare(rhs) >= 0;
 }
 
 template <typename CharT, typename Traits>
-constexpr bool operator>=(basic_str_view<CharT, Traits> lhs, const CharT *rhs) noexcept
+inline constexpr bool operator>=(basic_str_view<CharT, Traits> lhs, const CharT *rhs) noexcept
 {
     return lhs >= basic_str_view<CharT, Traits>(rhs);
 }
 
 template <typename CharT, typename Traits>
-constexpr bool operator>=(const CharT *rhs, basic_str_view<CharT, Traits> lhs) noexcept
+inline constexpr bool operator>=(const CharT *lhs, basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return basic_str_view<CharT, Traits>(rhs) < lhs;
+    return basic_str_view<CharT, Traits>(lhs) >= rhs;
 }
 
 template <typename CharT, typename Traits, typename Allocator>
-constexpr bool operator>=(basic_str_view<CharT, Traits> lhs,
-                          const std::basic_string<CharT, Traits, Allocator> &std_str) noexcept
+inline constexpr bool operator>=(basic_str_view<CharT, Traits> lhs,
+                                 const std::basic_string<CharT, Traits, Allocator> &rhs) noexcept
 {
-    return lhs >= basic_str_view<CharT, Traits>(std_str);
+    return lhs >= basic_str_view<CharT, Traits>(rhs);
 }
 
 template <typename CharT, typename Traits, typename Allocator>
-constexpr bool operator>=(const std::basic_string<CharT, Traits, Allocator> &std_str,
-                          basic_str_view<CharT, Traits> lhs) noexcept
+inline constexpr bool operator>=(const std::basic_string<CharT, Traits, Allocator> &lhs,
+                                 basic_str_view<CharT, Traits> rhs) noexcept
 {
-    return basic_str_view<CharT, Traits>(std_str) == lhs;
+    return basic_str_view<CharT, Traits>(lhs) >= rhs;
 }
 
 inline namespace sv_literals
@@ -1274,5 +2102,36 @@ constexpr wstr_view operator""_sv(const wchar_t *str, std::size_t len) noexcept
 }
 
 } // namespace sv_literals
+
+/// <summary>
+/// Hashes the code units of the view (wyhash). Constant evaluable: hash_value("key"_sv) computed at compile time
+/// equals the value computed at runtime for the same characters, with the same seed.
+/// </summary>
+/// <param name="v"></param>
+/// <param name="seed"></param>
+/// <returns></returns>
+template <typename CharT, typename Traits>
+inline constexpr uint64_t hash_value(basic_str_view<CharT, Traits> v,
+                                     uint64_t seed = hashing::default_seed) noexcept
+{
+    return hashing::wyhash(v.data(), v.size(), seed);
+}
+
 } // namespace lambda
+
+namespace std
+{
+
+/// <summary>
+/// std::hash for str_view, wstr_view, u16str_view and u32str_view, so views can key unordered containers.
+/// </summary>
+template <typename CharT> struct hash<lambda::basic_str_view<CharT, std::char_traits<CharT>>>
+{
+    constexpr size_t operator()(lambda::basic_str_view<CharT, std::char_traits<CharT>> v) const noexcept
+    {
+        return static_cast<size_t>(lambda::hash_value(v));
+    }
+};
+
+} // namespace std
 #endif
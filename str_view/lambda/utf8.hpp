@@ -0,0 +1,1012 @@
+/**
+ * MIT License
+
+ * Copyright(c) 2021 Bora Ilgar
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * @brief : UTF-8 validation and transcoding between str_view, u16str_view and u32str_view
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ *
+ * Validation follows RFC 3629: overlong forms, surrogates (U+D800..U+DFFF) and code points above U+10FFFF are errors.
+ * At runtime ASCII runs are skipped with the SIMD kernels below and, on AVX2, whole 64 byte blocks are validated
+ * with the Keiser/Lemire lookup algorithm; the scalar decoder only runs to locate an error. Everything stays usable
+ * in constant expressions through the plain decoder.
+ */
+
+#ifndef STR_VIEW_UTF8_H
+#define STR_VIEW_UTF8_H
+
+#include "arena.hpp"
+#include "simd.hpp"
+#include "str_view.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace lambda
+{
+
+/// <summary>
+/// Thrown by the transcoders for malformed input. position() is the index, in code units of the input, of the first
+/// unit of the bad sequence.
+/// </summary>
+struct utf_error : std::invalid_argument
+{
+    utf_error(const char *what, size_t position);
+
+    size_t position() const noexcept;
+
+  private:
+    size_t m_position;
+};
+
+inline utf_error::utf_error(const char *what, size_t position) : std::invalid_argument(what), m_position(position)
+{
+}
+
+inline size_t utf_error::position() const noexcept
+{
+    return m_position;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Kernels
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace simd
+{
+
+namespace scalar
+{
+
+/// <summary>
+/// Length of the leading run of bytes below 0x80.
+/// </summary>
+inline size_t ascii_prefix(const unsigned char *s, size_t n) noexcept
+{
+    size_t i = 0;
+#if LAMBDA_LITTLE_ENDIAN
+    for (; i + 8 <= n; i += 8)
+    {
+        const uint64_t high = simd::detail::_load64_(s + i) & 0x8080808080808080ull;
+        if (high != 0)
+        {
+            return i + simd::detail::_ctz_(high) / 8;
+        }
+    }
+#endif
+    while (i < n && s[i] < 0x80)
+    {
+        ++i;
+    }
+    return i;
+}
+
+/// <summary>
+/// Number of bytes that are not continuation bytes, plus the 4 byte leads again if supplementary is set: the UTF-32
+/// (or UTF-16) length of valid UTF-8.
+/// </summary>
+inline size_t utf8_leads(const unsigned char *s, size_t n, bool supplementary) noexcept
+{
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        count += ((s[i] & 0xC0u) != 0x80u) + (supplementary && s[i] >= 0xF0u);
+    }
+    return count;
+}
+
+} // namespace scalar
+
+#if LAMBDA_SIMD_X86
+
+namespace sse2
+{
+
+inline size_t ascii_prefix(const unsigned char *s, size_t n) noexcept
+{
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64)
+    {
+        const __m128i a = detail::_load_(s + i);
+        const __m128i b = detail::_load_(s + i + 16);
+        const __m128i c = detail::_load_(s + i + 32);
+        const __m128i d = detail::_load_(s + i + 48);
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) != 0)
+        {
+            break;
+        }
+    }
+    for (; i + 16 <= n; i += 16)
+    {
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(detail::_load_(s + i)));
+        if (mask != 0)
+        {
+            return i + simd::detail::_ctz_(mask);
+        }
+    }
+    return i + scalar::ascii_prefix(s + i, n - i);
+}
+
+/// <summary>
+/// Compares count up by one per lane (subtracting the -1 masks) for at most 255 iterations, then get summed with
+/// psadbw.
+/// </summary>
+inline size_t utf8_leads(const unsigned char *s, size_t n, bool supplementary) noexcept
+{
+    // As signed bytes, continuations are -128..-65 and 4 byte leads -16..-1.
+    const __m128i cont_end = _mm_set1_epi8(-64);
+    const __m128i four_begin = _mm_set1_epi8(-17);
+    const __m128i zero = _mm_setzero_si128();
+
+    __m128i cont = zero;
+    __m128i four = zero;
+    size_t i = 0;
+    while (i + 16 <= n)
+    {
+        __m128i cont8 = zero;
+        __m128i four8 = zero;
+        for (size_t k = 0; k < 255 && i + 16 <= n; ++k, i += 16)
+        {
+            const __m128i v = detail::_load_(s + i);
+            cont8 = _mm_sub_epi8(cont8, _mm_cmplt_epi8(v, cont_end));
+            four8 = _mm_sub_epi8(four8, _mm_and_si128(_mm_cmpgt_epi8(v, four_begin), _mm_cmplt_epi8(v, zero)));
+        }
+        cont = _mm_add_epi64(cont, _mm_sad_epu8(cont8, zero));
+        four = _mm_add_epi64(four, _mm_sad_epu8(four8, zero));
+    }
+
+    uint64_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), cont);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes + 2), four);
+    const uint64_t count = i - (lanes[0] + lanes[1]) + (supplementary ? lanes[2] + lanes[3] : 0);
+    return static_cast<size_t>(count) + scalar::utf8_leads(s + i, n - i, supplementary);
+}
+
+} // namespace sse2
+
+namespace avx2
+{
+
+LAMBDA_TARGET_AVX2 inline size_t ascii_prefix(const unsigned char *s, size_t n) noexcept
+{
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64)
+    {
+        const __m256i a = detail::_load_(s + i);
+        const __m256i b = detail::_load_(s + i + 32);
+        if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) != 0)
+        {
+            break;
+        }
+    }
+    for (; i + 32 <= n; i += 32)
+    {
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(detail::_load_(s + i)));
+        if (mask != 0)
+        {
+            return i + simd::detail::_ctz_(mask);
+        }
+    }
+    return i + sse2::ascii_prefix(s + i, n - i);
+}
+
+/// <summary>
+/// Same accumulation as sse2::utf8_leads on 32 byte blocks.
+/// </summary>
+LAMBDA_TARGET_AVX2 inline size_t utf8_leads(const unsigned char *s, size_t n, bool supplementary) noexcept
+{
+    const __m256i cont_end = _mm256_set1_epi8(-64);
+    const __m256i four_begin = _mm256_set1_epi8(-17);
+    const __m256i zero = _mm256_setzero_si256();
+
+    __m256i cont = zero;
+    __m256i four = zero;
+    size_t i = 0;
+    while (i + 32 <= n)
+    {
+        __m256i cont8 = zero;
+        __m256i four8 = zero;
+        for (size_t k = 0; k < 255 && i + 32 <= n; ++k, i += 32)
+        {
+            const __m256i v = detail::_load_(s + i);
+            cont8 = _mm256_sub_epi8(cont8, _mm256_cmpgt_epi8(cont_end, v));
+            const __m256i lead4 = _mm256_and_si256(_mm256_cmpgt_epi8(v, four_begin), _mm256_cmpgt_epi8(zero, v));
+            four8 = _mm256_sub_epi8(four8, lead4);
+        }
+        cont = _mm256_add_epi64(cont, _mm256_sad_epu8(cont8, zero));
+        four = _mm256_add_epi64(four, _mm256_sad_epu8(four8, zero));
+    }
+
+    uint64_t lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), cont);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes + 4), four);
+    const uint64_t removed = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    const uint64_t added = supplementary ? lanes[4] + lanes[5] + lanes[6] + lanes[7] : 0;
+    return static_cast<size_t>(i - removed + added) + sse2::utf8_leads(s + i, n - i, supplementary);
+}
+
+namespace detail
+{
+
+/// <summary>
+/// The 32 bytes ending N bytes before the end of input: the tail of prev followed by the head of input.
+/// </summary>
+template <int N> LAMBDA_TARGET_AVX2 inline __m256i _prev_(__m256i input, __m256i prev) noexcept
+{
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+}
+
+LAMBDA_TARGET_AVX2 inline __m256i _high_nibbles_(__m256i v) noexcept
+{
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+LAMBDA_TARGET_AVX2 inline __m256i _table_(uint8_t a0, uint8_t a1, uint8_t a2, uint8_t a3, uint8_t a4, uint8_t a5,
+                                          uint8_t a6, uint8_t a7, uint8_t a8, uint8_t a9, uint8_t a10, uint8_t a11,
+                                          uint8_t a12, uint8_t a13, uint8_t a14, uint8_t a15) noexcept
+{
+    return _mm256_setr_epi8(char(a0), char(a1), char(a2), char(a3), char(a4), char(a5), char(a6), char(a7), char(a8),
+                            char(a9), char(a10), char(a11), char(a12), char(a13), char(a14), char(a15), char(a0),
+                            char(a1), char(a2), char(a3), char(a4), char(a5), char(a6), char(a7), char(a8), char(a9),
+                            char(a10), char(a11), char(a12), char(a13), char(a14), char(a15));
+}
+
+/// <summary>
+/// Keiser/Lemire "Validating UTF-8 In Less Than One Instruction Per Byte": classifies every byte pair by three 16
+/// entry lookups (high and low nibble of the previous byte, high nibble of the current one) and ANDs the classes;
+/// any bit left over is an error. Continuations that must follow a 3 or 4 byte lead are checked separately.
+/// </summary>
+LAMBDA_TARGET_AVX2 inline __m256i _utf8_errors_(__m256i input, __m256i prev) noexcept
+{
+    constexpr uint8_t too_short = 1 << 0;
+    constexpr uint8_t too_long = 1 << 1;
+    constexpr uint8_t overlong_3 = 1 << 2;
+    constexpr uint8_t too_large = 1 << 3;
+    constexpr uint8_t surrogate = 1 << 4;
+    constexpr uint8_t overlong_2 = 1 << 5;
+    constexpr uint8_t too_large_1000 = 1 << 6;
+    constexpr uint8_t overlong_4 = 1 << 6;
+    constexpr uint8_t two_conts = 1 << 7;
+    constexpr uint8_t carry = too_short | too_long | two_conts;
+    constexpr uint8_t large = carry | too_large | too_large_1000;
+
+    const __m256i prev1 = _prev_<1>(input, prev);
+    const __m256i byte_1_high = _mm256_shuffle_epi8(
+        _table_(too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long, two_conts, two_conts,
+                two_conts, two_conts, too_short | overlong_2, too_short, too_short | overlong_3 | surrogate,
+                too_short | too_large | too_large_1000 | overlong_4),
+        _high_nibbles_(prev1));
+    const __m256i byte_1_low = _mm256_shuffle_epi8(
+        _table_(carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry, carry, carry | too_large,
+                large, large, large, large, large, large, large, large, large | surrogate, large, large),
+        _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+    const __m256i byte_2_high = _mm256_shuffle_epi8(
+        _table_(too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+                too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+                too_long | overlong_2 | two_conts | overlong_3 | too_large,
+                too_long | overlong_2 | two_conts | surrogate | too_large,
+                too_long | overlong_2 | two_conts | surrogate | too_large, too_short, too_short, too_short, too_short),
+        _high_nibbles_(input));
+    const __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    // Only 111_____ two bytes back or 1111____ three bytes back keep their top bit.
+    const __m256i third = _mm256_subs_epu8(_prev_<2>(input, prev), _mm256_set1_epi8(char(0xE0 - 0x80)));
+    const __m256i fourth = _mm256_subs_epu8(_prev_<3>(input, prev), _mm256_set1_epi8(char(0xF0 - 0x80)));
+    const __m256i must_continue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+    return _mm256_xor_si256(must_continue, special);
+}
+
+/// <summary>
+/// Non-zero if the last three bytes start a sequence that needs more bytes than are left.
+/// </summary>
+LAMBDA_TARGET_AVX2 inline __m256i _utf8_incomplete_(__m256i input) noexcept
+{
+    const __m256i max = _mm256_setr_epi8(char(255), char(255), char(255), char(255), char(255), char(255), char(255),
+                                         char(255), char(255), char(255), char(255), char(255), char(255), char(255),
+                                         char(255), char(255), char(255), char(255), char(255), char(255), char(255),
+                                         char(255), char(255), char(255), char(255), char(255), char(255), char(255),
+                                         char(255), char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+    return _mm256_subs_epu8(input, max);
+}
+
+/// <summary>
+/// Validates the 64 bytes at p, carrying the previous block and the incomplete tail state.
+/// </summary>
+LAMBDA_TARGET_AVX2 inline bool _utf8_block_(const unsigned char *p, __m256i &prev, __m256i &incomplete) noexcept
+{
+    const __m256i a = _load_(p);
+    const __m256i b = _load_(p + 32);
+    __m256i error;
+    if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) == 0)
+    {
+        // An all ASCII block is only wrong if the previous one ended inside a sequence.
+        error = incomplete;
+        prev = _mm256_setzero_si256();
+        incomplete = _mm256_setzero_si256();
+    }
+    else
+    {
+        error = _mm256_or_si256(_utf8_errors_(a, prev), _utf8_errors_(b, a));
+        incomplete = _utf8_incomplete_(b);
+        prev = b;
+    }
+    return _mm256_testz_si256(error, error) != 0;
+}
+
+} // namespace detail
+
+/// <summary>
+/// Offset of the 64 byte block in which the first error shows up (it starts at most 3 bytes earlier), or npos if
+/// s[0, n) is valid UTF-8. A sequence cut off by the end of input is reported at n.
+/// </summary>
+LAMBDA_TARGET_AVX2 inline size_t utf8_check(const unsigned char *s, size_t n) noexcept
+{
+    __m256i prev = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64)
+    {
+        if (!detail::_utf8_block_(s + i, prev, incomplete))
+        {
+            return i;
+        }
+    }
+    if (i < n)
+    {
+        // Zero padding is ASCII, so a truncated sequence in the tail shows up as too short.
+        alignas(32) unsigned char tail[64] = {};
+        std::memcpy(tail, s + i, n - i);
+        return detail::_utf8_block_(tail, prev, incomplete) ? npos : i;
+    }
+    return _mm256_testz_si256(incomplete, incomplete) ? npos : n;
+}
+
+} // namespace avx2
+
+#elif LAMBDA_SIMD_NEON
+
+namespace neon
+{
+
+inline size_t ascii_prefix(const unsigned char *s, size_t n) noexcept
+{
+    const uint8x16_t high = vdupq_n_u8(0x80);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const uint64_t mask = detail::_mask_(vcgeq_u8(vld1q_u8(s + i), high));
+        if (mask != 0)
+        {
+            return i + simd::detail::_ctz_(mask) / 4;
+        }
+    }
+    return i + scalar::ascii_prefix(s + i, n - i);
+}
+
+inline size_t utf8_leads(const unsigned char *s, size_t n, bool supplementary) noexcept
+{
+    const uint8x16_t cont_lo = vdupq_n_u8(0x80);
+    const uint8x16_t cont_hi = vdupq_n_u8(0xBF);
+    const uint8x16_t four_lo = vdupq_n_u8(0xF0);
+
+    uint64_t removed = 0;
+    uint64_t added = 0;
+    size_t i = 0;
+    while (i + 16 <= n)
+    {
+        uint8x16_t cont8 = vdupq_n_u8(0);
+        uint8x16_t four8 = vdupq_n_u8(0);
+        for (size_t k = 0; k < 255 && i + 16 <= n; ++k, i += 16)
+        {
+            const uint8x16_t v = vld1q_u8(s + i);
+            cont8 = vsubq_u8(cont8, vandq_u8(vcgeq_u8(v, cont_lo), vcleq_u8(v, cont_hi)));
+            four8 = vsubq_u8(four8, vcgeq_u8(v, four_lo));
+        }
+        const uint64x2_t c = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(cont8)));
+        const uint64x2_t f = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(four8)));
+        removed += vgetq_lane_u64(c, 0) + vgetq_lane_u64(c, 1);
+        added += vgetq_lane_u64(f, 0) + vgetq_lane_u64(f, 1);
+    }
+    const uint64_t count = i - removed + (supplementary ? added : 0);
+    return static_cast<size_t>(count) + scalar::utf8_leads(s + i, n - i, supplementary);
+}
+
+} // namespace neon
+
+#endif
+
+namespace detail
+{
+
+#if LAMBDA_SIMD_X86
+inline void _widen16_(__m128i v, char16_t *out) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi8(v, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), _mm_unpackhi_epi8(v, zero));
+}
+
+inline void _widen16_(__m128i v, char32_t *out) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = _mm_unpacklo_epi8(v, zero);
+    const __m128i hi = _mm_unpackhi_epi8(v, zero);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi16(lo, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4), _mm_unpackhi_epi16(lo, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), _mm_unpacklo_epi16(hi, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 12), _mm_unpackhi_epi16(hi, zero));
+}
+#elif LAMBDA_SIMD_NEON
+inline void _widen16_(uint8x16_t v, char16_t *out) noexcept
+{
+    vst1q_u16(reinterpret_cast<uint16_t *>(out), vmovl_u8(vget_low_u8(v)));
+    vst1q_u16(reinterpret_cast<uint16_t *>(out + 8), vmovl_u8(vget_high_u8(v)));
+}
+
+inline void _widen16_(uint8x16_t v, char32_t *out) noexcept
+{
+    const uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+    const uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+    vst1q_u32(reinterpret_cast<uint32_t *>(out), vmovl_u16(vget_low_u16(lo)));
+    vst1q_u32(reinterpret_cast<uint32_t *>(out + 4), vmovl_u16(vget_high_u16(lo)));
+    vst1q_u32(reinterpret_cast<uint32_t *>(out + 8), vmovl_u16(vget_low_u16(hi)));
+    vst1q_u32(reinterpret_cast<uint32_t *>(out + 12), vmovl_u16(vget_high_u16(hi)));
+}
+#endif
+
+} // namespace detail
+
+/// <summary>
+/// If s[0, 16) is all ASCII, zero extends it into out[0, 16) and returns true. Otherwise writes nothing.
+/// </summary>
+template <typename OutT> inline bool widen_ascii16(const unsigned char *s, OutT *out) noexcept
+{
+#if LAMBDA_SIMD_X86
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+    if (_mm_movemask_epi8(v) != 0)
+    {
+        return false;
+    }
+    detail::_widen16_(v, out);
+    return true;
+#elif LAMBDA_SIMD_NEON
+    const uint8x16_t v = vld1q_u8(s);
+    if (neon::detail::_mask_(vcgeq_u8(v, vdupq_n_u8(0x80))) != 0)
+    {
+        return false;
+    }
+    detail::_widen16_(v, out);
+    return true;
+#else
+    if (((detail::_load64_(s) | detail::_load64_(s + 8)) & 0x8080808080808080ull) != 0)
+    {
+        return false;
+    }
+    for (size_t k = 0; k < 16; ++k)
+    {
+        out[k] = static_cast<OutT>(s[k]);
+    }
+    return true;
+#endif
+}
+
+/// <summary>
+/// Length of the leading run of bytes below 0x80.
+/// </summary>
+inline size_t ascii_prefix(const unsigned char *s, size_t n) noexcept
+{
+#if LAMBDA_SIMD_X86
+    return cpu_has_avx2() ? avx2::ascii_prefix(s, n) : sse2::ascii_prefix(s, n);
+#elif LAMBDA_SIMD_NEON
+    return neon::ascii_prefix(s, n);
+#else
+    return scalar::ascii_prefix(s, n);
+#endif
+}
+
+/// <summary>
+/// Number of bytes that are not continuation bytes, plus the 4 byte leads again if supplementary is set.
+/// </summary>
+inline size_t utf8_leads(const unsigned char *s, size_t n, bool supplementary) noexcept
+{
+#if LAMBDA_SIMD_X86
+    return cpu_has_avx2() ? avx2::utf8_leads(s, n, supplementary) : sse2::utf8_leads(s, n, supplementary);
+#elif LAMBDA_SIMD_NEON
+    return neon::utf8_leads(s, n, supplementary);
+#else
+    return scalar::utf8_leads(s, n, supplementary);
+#endif
+}
+
+} // namespace simd
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Length of a transcoded string
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace detail
+{
+
+/// <summary>
+/// Decodes the sequence starting at s[i]. Returns its length, or 0 if it is malformed or cut off by n.
+/// </summary>
+inline constexpr size_t _decode_utf8_(const char *s, size_t i, size_t n, char32_t &cp) noexcept
+{
+    const unsigned char c = static_cast<unsigned char>(s[i]);
+    if (c < 0x80)
+    {
+        cp = c;
+        return 1;
+    }
+
+    size_t len = 0;
+    char32_t min = 0;
+    if (c >= 0xC2 && c <= 0xDF)
+    {
+        len = 2;
+        min = 0x80;
+        cp = c & 0x1F;
+    }
+    else if (c >= 0xE0 && c <= 0xEF)
+    {
+        len = 3;
+        min = 0x800;
+        cp = c & 0x0F;
+    }
+    else if (c >= 0xF0 && c <= 0xF4)
+    {
+        len = 4;
+        min = 0x10000;
+        cp = c & 0x07;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (n - i < len)
+    {
+        return 0;
+    }
+    for (size_t k = 1; k < len; ++k)
+    {
+        const unsigned char b = static_cast<unsigned char>(s[i + k]);
+        if ((b & 0xC0) != 0x80)
+        {
+            return 0;
+        }
+        cp = (cp << 6) | (b & 0x3F);
+    }
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+    {
+        return 0;
+    }
+    return len;
+}
+
+/// <summary>
+/// Length of the ASCII run at s[i]. Runs in mixed text are short, so the kernel only takes over after 16 bytes.
+/// </summary>
+inline constexpr size_t _ascii_run_(const char *s, size_t i, size_t n) noexcept
+{
+    size_t run = 0;
+    while (i + run < n && static_cast<unsigned char>(s[i + run]) < 0x80)
+    {
+        if (++run == 16 && !LAMBDA_IS_CONSTANT_EVALUATED())
+        {
+            return run + simd::ascii_prefix(reinterpret_cast<const unsigned char *>(s) + i + run, n - i - run);
+        }
+    }
+    return run;
+}
+
+/// <summary>
+/// Index of the first malformed sequence in s[i, n), or npos.
+/// </summary>
+inline constexpr size_t _find_invalid_utf8_(const char *s, size_t i, size_t n) noexcept
+{
+    while (i < n)
+    {
+        if (static_cast<unsigned char>(s[i]) < 0x80)
+        {
+            i += _ascii_run_(s, i, n);
+            continue;
+        }
+        char32_t cp = 0;
+        const size_t len = _decode_utf8_(s, i, n, cp);
+        if (len == 0)
+        {
+            return i;
+        }
+        i += len;
+    }
+    return str_view::npos;
+}
+
+inline size_t _find_invalid_utf8_runtime_(const char *s, size_t n) noexcept
+{
+#if LAMBDA_SIMD_X86
+    if (simd::cpu_has_avx2())
+    {
+        const unsigned char *p = reinterpret_cast<const unsigned char *>(s);
+        const size_t block = simd::avx2::utf8_check(p, n);
+        if (block == simd::npos)
+        {
+            return str_view::npos;
+        }
+        // Everything before the block is valid, so restart at the first sequence that can reach into it.
+        size_t start = block >= 3 ? block - 3 : 0;
+        while (start < block && (p[start] & 0xC0) == 0x80)
+        {
+            ++start;
+        }
+        return _find_invalid_utf8_(s, start, n);
+    }
+#endif
+    return _find_invalid_utf8_(s, 0, n);
+}
+
+} // namespace detail
+
+/// <summary>
+/// True if every byte of s is below 0x80.
+/// </summary>
+inline constexpr bool is_ascii(str_view s) noexcept
+{
+    return detail::_ascii_run_(s.data(), 0, s.size()) == s.size();
+}
+
+/// <summary>
+/// Index of the first byte of the first malformed sequence in s, or str_view::npos if s is valid UTF-8.
+/// </summary>
+inline constexpr size_t find_invalid_utf8(str_view s) noexcept
+{
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return detail::_find_invalid_utf8_runtime_(s.data(), s.size());
+    }
+    return detail::_find_invalid_utf8_(s.data(), 0, s.size());
+}
+
+inline constexpr bool is_valid_utf8(str_view s) noexcept
+{
+#if LAMBDA_SIMD_X86
+    if (!LAMBDA_IS_CONSTANT_EVALUATED() && simd::cpu_has_avx2())
+    {
+        return simd::avx2::utf8_check(reinterpret_cast<const unsigned char *>(s.data()), s.size()) == simd::npos;
+    }
+#endif
+    return find_invalid_utf8(s) == str_view::npos;
+}
+
+namespace detail
+{
+
+/// <summary>
+/// Counts the bytes that start a sequence, plus those starting a 4 byte one if Supplementary.
+/// </summary>
+template <bool Supplementary> inline constexpr size_t _count_leads_(const char *s, size_t n) noexcept
+{
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        return simd::utf8_leads(reinterpret_cast<const unsigned char *>(s), n, Supplementary);
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const unsigned c = static_cast<unsigned char>(s[i]);
+        count += ((c & 0xC0u) != 0x80u) + (Supplementary && c >= 0xF0u);
+    }
+    return count;
+}
+
+} // namespace detail
+
+/// <summary>
+/// Number of UTF-16 / UTF-32 code units valid UTF-8 transcodes to. The input is not validated.
+/// </summary>
+inline constexpr size_t utf16_length(str_view s) noexcept
+{
+    return detail::_count_leads_<true>(s.data(), s.size());
+}
+
+inline constexpr size_t utf32_length(str_view s) noexcept
+{
+    return detail::_count_leads_<false>(s.data(), s.size());
+}
+
+/// <summary>
+/// Number of UTF-8 bytes valid UTF-16 / UTF-32 transcodes to. The input is not validated.
+/// </summary>
+inline constexpr size_t utf8_length(u16str_view s) noexcept
+{
+    size_t count = 0;
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        const char16_t c = s[i];
+        // A surrogate pair is 4 bytes, 2 per half.
+        count += c < 0x80 ? 1 : c < 0x800 ? 2 : (c >= 0xD800 && c <= 0xDFFF) ? 2 : 3;
+    }
+    return count;
+}
+
+inline constexpr size_t utf8_length(u32str_view s) noexcept
+{
+    size_t count = 0;
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        const char32_t c = s[i];
+        count += c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+    }
+    return count;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Transcoding
+//
+// The buffer overloads write to out[0, capacity) and throw std::length_error if that is too small; the *_length()
+// functions above give the exact size, the input length (times 3 from UTF-16, times 4 from UTF-32) is always enough.
+// The arena overloads allocate that upper bound plus a terminating zero. Malformed input throws utf_error.
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace detail
+{
+
+/// <summary>
+/// Decodes input that is known to be valid into an output that is known to be large enough.
+/// </summary>
+template <typename OutT> inline size_t _from_valid_utf8_(const unsigned char *s, size_t n, OutT *out) noexcept
+{
+    size_t i = 0;
+    size_t o = 0;
+    while (i < n)
+    {
+        const unsigned char c = s[i];
+        if (c < 0x80)
+        {
+            if (n - i >= 16 && simd::widen_ascii16(s + i, out + o))
+            {
+                i += 16;
+                o += 16;
+                continue;
+            }
+            out[o++] = static_cast<OutT>(c);
+            i += 1;
+        }
+        else if (c < 0xE0)
+        {
+            out[o++] = static_cast<OutT>(((c & 0x1F) << 6) | (s[i + 1] & 0x3F));
+            i += 2;
+        }
+        else if (c < 0xF0)
+        {
+            out[o++] = static_cast<OutT>(((c & 0x0F) << 12) | ((s[i + 1] & 0x3F) << 6) | (s[i + 2] & 0x3F));
+            i += 3;
+        }
+        else
+        {
+            const char32_t cp = ((c & 0x07u) << 18) | ((s[i + 1] & 0x3Fu) << 12) | ((s[i + 2] & 0x3Fu) << 6) |
+                                (s[i + 3] & 0x3Fu);
+            if (sizeof(OutT) == 2)
+            {
+                out[o++] = static_cast<OutT>(0xD800 + ((cp - 0x10000) >> 10));
+                out[o++] = static_cast<OutT>(0xDC00 + ((cp - 0x10000) & 0x3FF));
+            }
+            else
+            {
+                out[o++] = static_cast<OutT>(cp);
+            }
+            i += 4;
+        }
+    }
+    return o;
+}
+
+template <typename OutT>
+inline constexpr basic_str_view<OutT> _from_utf8_(str_view in, OutT *out, size_t capacity, const char *what)
+{
+    if (!LAMBDA_IS_CONSTANT_EVALUATED())
+    {
+        // Validating and sizing first is cheaper than checking every sequence while decoding.
+        const size_t bad = find_invalid_utf8(in);
+        if (bad != str_view::npos)
+        {
+            throw utf_error(what, bad);
+        }
+        if (capacity < (sizeof(OutT) == 2 ? utf16_length(in) : utf32_length(in)))
+        {
+            throw std::length_error("Output buffer too small in lambda::transcode");
+        }
+        return basic_str_view<OutT>(
+            out, _from_valid_utf8_(reinterpret_cast<const unsigned char *>(in.data()), in.size(), out));
+    }
+
+    const char *s = in.data();
+    const size_t n = in.size();
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i < n)
+    {
+        const unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c < 0x80)
+        {
+            if (!LAMBDA_IS_CONSTANT_EVALUATED() && n - i >= 16 && capacity - o >= 16 &&
+                simd::widen_ascii16(reinterpret_cast<const unsigned char *>(s) + i, out + o))
+            {
+                i += 16;
+                o += 16;
+                continue;
+            }
+            if (o == capacity)
+            {
+                throw std::length_error("Output buffer too small in lambda::transcode");
+            }
+            out[o++] = static_cast<OutT>(c);
+            ++i;
+            continue;
+        }
+
+        char32_t cp = 0;
+        const size_t len = _decode_utf8_(s, i, n, cp);
+        if (len == 0)
+        {
+            throw utf_error(what, i);
+        }
+        const size_t units = sizeof(OutT) == 2 && cp >= 0x10000 ? 2 : 1;
+        if (capacity - o < units)
+        {
+            throw std::length_error("Output buffer too small in lambda::transcode");
+        }
+        if (units == 2)
+        {
+            out[o] = static_cast<OutT>(0xD800 + ((cp - 0x10000) >> 10));
+            out[o + 1] = static_cast<OutT>(0xDC00 + ((cp - 0x10000) & 0x3FF));
+        }
+        else
+        {
+            out[o] = static_cast<OutT>(cp);
+        }
+        i += len;
+        o += units;
+    }
+    return basic_str_view<OutT>(out, o);
+}
+
+inline constexpr size_t _encode_utf8_(char32_t cp, char *out) noexcept
+{
+    if (cp < 0x80)
+    {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800)
+    {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000)
+    {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+template <typename InT> inline constexpr str_view _to_utf8_(basic_str_view<InT> in, char *out, size_t capacity)
+{
+    size_t o = 0;
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        char32_t cp = in[i];
+        const size_t at = i;
+        if (sizeof(InT) == 2 && cp >= 0xD800 && cp <= 0xDFFF)
+        {
+            // A high surrogate has to be followed by a low one.
+            if (cp >= 0xDC00 || i + 1 == in.size() || in[i + 1] < 0xDC00 || in[i + 1] > 0xDFFF)
+            {
+                throw utf_error("Unpaired surrogate in lambda::to_utf8", at);
+            }
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (in[++i] - 0xDC00);
+        }
+        else if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+        {
+            throw utf_error("Invalid code point in lambda::to_utf8", at);
+        }
+
+        const size_t len = cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+        if (capacity - o < len)
+        {
+            throw std::length_error("Output buffer too small in lambda::transcode");
+        }
+        o += _encode_utf8_(cp, out + o);
+    }
+    return str_view(out, o);
+}
+
+template <typename OutT> inline basic_str_view<OutT> _terminate_(basic_str_view<OutT> v, OutT *out)
+{
+    out[v.size()] = OutT();
+    return v;
+}
+
+} // namespace detail
+
+inline constexpr u16str_view to_utf16(str_view in, char16_t *out, size_t capacity)
+{
+    return detail::_from_utf8_(in, out, capacity, "Invalid UTF-8 in lambda::to_utf16");
+}
+
+inline constexpr u32str_view to_utf32(str_view in, char32_t *out, size_t capacity)
+{
+    return detail::_from_utf8_(in, out, capacity, "Invalid UTF-8 in lambda::to_utf32");
+}
+
+inline constexpr str_view to_utf8(u16str_view in, char *out, size_t capacity)
+{
+    return detail::_to_utf8_(in, out, capacity);
+}
+
+inline constexpr str_view to_utf8(u32str_view in, char *out, size_t capacity)
+{
+    return detail::_to_utf8_(in, out, capacity);
+}
+
+inline u16str_view to_utf16(str_view in, monotonic_arena &arena)
+{
+    char16_t *out = arena.allocate_array<char16_t>(in.size() + 1);
+    return detail::_terminate_(to_utf16(in, out, in.size()), out);
+}
+
+inline u32str_view to_utf32(str_view in, monotonic_arena &arena)
+{
+    char32_t *out = arena.allocate_array<char32_t>(in.size() + 1);
+    return detail::_terminate_(to_utf32(in, out, in.size()), out);
+}
+
+inline str_view to_utf8(u16str_view in, monotonic_arena &arena)
+{
+    char *out = arena.allocate_array<char>(3 * in.size() + 1);
+    return detail::_terminate_(to_utf8(in, out, 3 * in.size()), out);
+}
+
+inline str_view to_utf8(u32str_view in, monotonic_arena &arena)
+{
+    char *out = arena.allocate_array<char>(4 * in.size() + 1);
+    return detail::_terminate_(to_utf8(in, out, 4 * in.size()), out);
+}
+
+} // namespace lambda
+
+#endif
@@ -0,0 +1,1546 @@
+// Google Benchmark suite comparing lambda::basic_str_view with std::basic_string_view (needs C++17).
+//
+// Arguments, where they apply:
+//   n     - haystack length in code units
+//   m     - needle / set length
+//   where - match position in percent of the haystack, 101 means "no match"
+//
+// The haystack cycles through 'a'..'p' and the needle through 'q'..'z', so the only match is the one planted at where.
+
+#include "../str_view/lambda/affix_set.hpp"
+#include "../str_view/lambda/batch.hpp"
+#include "../str_view/lambda/ci_traits.hpp"
+#include "../str_view/lambda/fixed_string.hpp"
+#include "../str_view/lambda/flat_str_map.hpp"
+#include "../str_view/lambda/multi_search.hpp"
+#include "../str_view/lambda/parallel.hpp"
+#include "../str_view/lambda/parse.hpp"
+#include "../str_view/lambda/pipeline.hpp"
+#include "../str_view/lambda/record_reader.hpp"
+#include "../str_view/lambda/searcher.hpp"
+#include "../str_view/lambda/segmented_view.hpp"
+#include "../str_view/lambda/sort.hpp"
+#include "../str_view/lambda/str_view.hpp"
+#include "../str_view/lambda/utf8.hpp"
+#include "benchmark/benchmark.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+constexpr int64_t no_match = 101;
+
+template <typename CharT> std::basic_string<CharT> make_haystack(size_t n)
+{
+    std::basic_string<CharT> s(n, CharT());
+    for (size_t i = 0; i < n; ++i)
+    {
+        s[i] = static_cast<CharT>('a' + i % 16);
+    }
+    return s;
+}
+
+template <typename CharT> std::basic_string<CharT> make_needle(size_t m)
+{
+    std::basic_string<CharT> s(m, CharT());
+    for (size_t i = 0; i < m; ++i)
+    {
+        s[i] = static_cast<CharT>('q' + i % 10);
+    }
+    return s;
+}
+
+/// Haystack of length n with needle planted at where percent, or nowhere.
+template <typename CharT>
+std::basic_string<CharT> make_text(size_t n, const std::basic_string<CharT> &needle, int64_t where)
+{
+    std::basic_string<CharT> s = make_haystack<CharT>(n);
+    if (where < no_match && needle.size() <= n)
+    {
+        s.replace((n - needle.size()) * static_cast<size_t>(where) / 100, needle.size(), needle);
+    }
+    return s;
+}
+
+// std::string_view gets starts_with / ends_with in C++20 and contains in C++23, so go through compare / find.
+
+template <typename CharT, typename Traits>
+bool starts_with(lambda::basic_str_view<CharT, Traits> v, lambda::basic_str_view<CharT, Traits> x)
+{
+    return v.starts_with(x);
+}
+
+template <typename CharT, typename Traits>
+bool starts_with(std::basic_string_view<CharT, Traits> v, std::basic_string_view<CharT, Traits> x)
+{
+    return v.size() >= x.size() && v.compare(0, x.size(), x) == 0;
+}
+
+template <typename CharT, typename Traits>
+bool ends_with(lambda::basic_str_view<CharT, Traits> v, lambda::basic_str_view<CharT, Traits> x)
+{
+    return v.ends_with(x);
+}
+
+template <typename CharT, typename Traits>
+bool ends_with(std::basic_string_view<CharT, Traits> v, std::basic_string_view<CharT, Traits> x)
+{
+    return v.size() >= x.size() && v.compare(v.size() - x.size(), x.size(), x) == 0;
+}
+
+template <typename CharT, typename Traits>
+bool contains(lambda::basic_str_view<CharT, Traits> v, lambda::basic_str_view<CharT, Traits> x)
+{
+    return v.contains(x);
+}
+
+template <typename CharT, typename Traits>
+bool contains(std::basic_string_view<CharT, Traits> v, std::basic_string_view<CharT, Traits> x)
+{
+    return v.find(x) != v.npos;
+}
+
+template <typename View> void set_bytes(benchmark::State &state, size_t n)
+{
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * n * sizeof(typename View::value_type)));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Search
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename View> void BM_find(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto needle = make_needle<CharT>(static_cast<size_t>(state.range(1)));
+    const auto text = make_text<CharT>(static_cast<size_t>(state.range(0)), needle, state.range(2));
+    const View hay(text.data(), text.size());
+    const View pat(needle.data(), needle.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hay.find(pat));
+    }
+    set_bytes<View>(state, text.size());
+}
+
+template <typename View> void BM_rfind(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto needle = make_needle<CharT>(static_cast<size_t>(state.range(1)));
+    const auto text = make_text<CharT>(static_cast<size_t>(state.range(0)), needle, state.range(2));
+    const View hay(text.data(), text.size());
+    const View pat(needle.data(), needle.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hay.rfind(pat));
+    }
+    set_bytes<View>(state, text.size());
+}
+
+template <typename View> void BM_find_char(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto needle = make_needle<CharT>(1);
+    const auto text = make_text<CharT>(static_cast<size_t>(state.range(0)), needle, state.range(1));
+    const View hay(text.data(), text.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hay.find(needle[0]));
+    }
+    set_bytes<View>(state, text.size());
+}
+
+template <typename View> void BM_rfind_char(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto needle = make_needle<CharT>(1);
+    const auto text = make_text<CharT>(static_cast<size_t>(state.range(0)), needle, state.range(1));
+    const View hay(text.data(), text.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hay.rfind(needle[0]));
+    }
+    set_bytes<View>(state, text.size());
+}
+
+template <typename View> void BM_find_first_of(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto set = make_needle<CharT>(static_cast<size_t>(state.range(1)));
+    const auto text = make_text<CharT>(static_cast<size_t>(state.range(0)), set.substr(0, 1), state.range(2));
+    const View hay(text.data(), text.size());
+    const View chars(set.data(), set.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hay.find_first_of(chars));
+    }
+    set_bytes<View>(state, text.size());
+}
+
+template <typename View> void BM_find_last_of(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto set = make_needle<CharT>(static_cast<size_t>(state.range(1)));
+    const auto text = make_text<CharT>(static_cast<size_t>(state.range(0)), set.substr(0, 1), state.range(2));
+    const View hay(text.data(), text.size());
+    const View chars(set.data(), set.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hay.find_last_of(chars));
+    }
+    set_bytes<View>(state, text.size());
+}
+
+template <typename View> void BM_find_first_not_of(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto set = make_haystack<CharT>(16);
+    const auto text = make_text<CharT>(static_cast<size_t>(state.range(0)), make_needle<CharT>(1), state.range(1));
+    const View hay(text.data(), text.size());
+    const View chars(set.data(), set.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hay.find_first_not_of(chars));
+    }
+    set_bytes<View>(state, text.size());
+}
+
+template <typename View> void BM_find_last_not_of(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto set = make_haystack<CharT>(16);
+    const auto text = make_text<CharT>(static_cast<size_t>(state.range(0)), make_needle<CharT>(1), state.range(1));
+    const View hay(text.data(), text.size());
+    const View chars(set.data(), set.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hay.find_last_not_of(chars));
+    }
+    set_bytes<View>(state, text.size());
+}
+
+/// The prebuilt lambda::basic_char_set overload, which has no std counterpart.
+template <typename CharT> void BM_find_first_of_char_set(benchmark::State &state)
+{
+    using View = lambda::basic_str_view<CharT>;
+    const auto set = make_needle<CharT>(static_cast<size_t>(state.range(1)));
+    const auto text = make_text<CharT>(static_cast<size_t>(state.range(0)), set.substr(0, 1), state.range(2));
+    const View hay(text.data(), text.size());
+    const lambda::basic_char_set<CharT> chars(set.data(), set.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hay.find_first_of(chars));
+    }
+    set_bytes<View>(state, text.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Comparison. where is the first mismatching position, no_match means the views are equal.
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename CharT> std::basic_string<CharT> make_mismatch(const std::basic_string<CharT> &s, int64_t where)
+{
+    std::basic_string<CharT> t = s;
+    if (where < no_match && !t.empty())
+    {
+        t[(t.size() - 1) * static_cast<size_t>(where) / 100] = CharT('z');
+    }
+    return t;
+}
+
+template <typename View> void BM_compare(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto a = make_haystack<CharT>(static_cast<size_t>(state.range(0)));
+    const auto b = make_mismatch(a, state.range(1));
+    const View x(a.data(), a.size());
+    const View y(b.data(), b.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(x.compare(y));
+    }
+    set_bytes<View>(state, a.size());
+}
+
+template <typename View> void BM_equal(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto a = make_haystack<CharT>(static_cast<size_t>(state.range(0)));
+    const auto b = make_mismatch(a, state.range(1));
+    const View x(a.data(), a.size());
+    const View y(b.data(), b.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(x == y);
+    }
+    set_bytes<View>(state, a.size());
+}
+
+/// n is the haystack length, m the affix length; where is the mismatch position inside the affix.
+template <typename View> void BM_starts_with(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto text = make_haystack<CharT>(static_cast<size_t>(state.range(0)));
+    const auto prefix = make_mismatch(text.substr(0, static_cast<size_t>(state.range(1))), state.range(2));
+    const View hay(text.data(), text.size());
+    const View pat(prefix.data(), prefix.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(starts_with(hay, pat));
+    }
+    set_bytes<View>(state, prefix.size());
+}
+
+template <typename View> void BM_ends_with(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto text = make_haystack<CharT>(static_cast<size_t>(state.range(0)));
+    const auto m = static_cast<size_t>(state.range(1));
+    const auto suffix = make_mismatch(text.substr(text.size() - m), state.range(2));
+    const View hay(text.data(), text.size());
+    const View pat(suffix.data(), suffix.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ends_with(hay, pat));
+    }
+    set_bytes<View>(state, suffix.size());
+}
+
+template <typename View> void BM_contains(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto needle = make_needle<CharT>(static_cast<size_t>(state.range(1)));
+    const auto text = make_text<CharT>(static_cast<size_t>(state.range(0)), needle, state.range(2));
+    const View hay(text.data(), text.size());
+    const View pat(needle.data(), needle.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(contains(hay, pat));
+    }
+    set_bytes<View>(state, text.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Slicing and construction
+// ---------------------------------------------------------------------------------------------------------------------
+
+template <typename View> void BM_substr(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto text = make_haystack<CharT>(static_cast<size_t>(state.range(0)));
+    const View hay(text.data(), text.size());
+    size_t pos = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hay.substr(pos, 8));
+        pos = pos + 1 < text.size() ? pos + 1 : 0;
+    }
+}
+
+template <typename View> void BM_construct(benchmark::State &state)
+{
+    using CharT = typename View::value_type;
+    const auto text = make_haystack<CharT>(static_cast<size_t>(state.range(0)));
+    const CharT *p = text.c_str();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(p);
+        benchmark::DoNotOptimize(View(p));
+    }
+    set_bytes<View>(state, text.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Multi-needle search: k keywords against one contains() per keyword
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::vector<std::string> make_keywords(size_t k)
+{
+    std::vector<std::string> words;
+    for (size_t i = 0; i < k; ++i)
+    {
+        std::string w = make_needle<char>(4 + i % 5);
+        w[0] = static_cast<char>('A' + i % 26);
+        w[1] = static_cast<char>('A' + (i / 26) % 26);
+        words.push_back(w);
+    }
+    return words;
+}
+
+/// Lower case text with a capital every 8 bytes, so every keyword's first byte keeps turning up without a match.
+std::string make_words(size_t n)
+{
+    std::string s = make_haystack<char>(n);
+    for (size_t i = 0; i < n; i += 8)
+    {
+        s[i] = static_cast<char>('A' + (i / 8) % 26);
+    }
+    return s;
+}
+
+void BM_contains_each(benchmark::State &state)
+{
+    const auto words = make_keywords(static_cast<size_t>(state.range(1)));
+    const auto text = make_words(static_cast<size_t>(state.range(0)));
+    const lambda::str_view hay(text);
+
+    for (auto _ : state)
+    {
+        bool any = false;
+        for (const auto &w : words)
+        {
+            any |= hay.contains(lambda::str_view(w));
+        }
+        benchmark::DoNotOptimize(any);
+    }
+    set_bytes<lambda::str_view>(state, text.size());
+}
+
+void BM_multi_matcher(benchmark::State &state)
+{
+    const auto words = make_keywords(static_cast<size_t>(state.range(1)));
+    const auto text = make_words(static_cast<size_t>(state.range(0)));
+    const lambda::str_view hay(text);
+    const lambda::multi_matcher matcher(words.begin(), words.end(), static_cast<lambda::multi_mode>(state.range(2)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(matcher.contains(hay));
+    }
+    set_bytes<lambda::str_view>(state, text.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Parallel search over a large haystack; t is the thread count
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BM_parallel_count(benchmark::State &state)
+{
+    const auto needle = make_needle<char>(8);
+    const auto text = make_text<char>(static_cast<size_t>(state.range(0)), needle, 50);
+    const lambda::str_view hay(text);
+    lambda::parallel_options opt;
+    opt.threads = static_cast<size_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lambda::parallel_count(hay, lambda::str_view(needle), opt));
+    }
+    set_bytes<lambda::str_view>(state, text.size());
+}
+
+void BM_parallel_find(benchmark::State &state)
+{
+    const auto needle = make_needle<char>(8);
+    const auto text = make_text<char>(static_cast<size_t>(state.range(0)), needle, 90);
+    const lambda::str_view hay(text);
+    lambda::parallel_options opt;
+    opt.threads = static_cast<size_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lambda::parallel_find(hay, lambda::str_view(needle), opt));
+    }
+    set_bytes<lambda::str_view>(state, text.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Line reading: m is the line length
+// ---------------------------------------------------------------------------------------------------------------------
+
+// n bytes of lines that are m characters long, newline included.
+std::string make_lines(size_t n, size_t m)
+{
+    std::string s = make_haystack<char>(n);
+    for (size_t i = m - 1; i < n; i += m)
+    {
+        s[i] = '\n';
+    }
+    return s;
+}
+
+void BM_getline(benchmark::State &state)
+{
+    const auto text = make_lines(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)));
+
+    for (auto _ : state)
+    {
+        std::istringstream in(text);
+        size_t total = 0;
+        for (std::string line; std::getline(in, line);)
+        {
+            total += line.size();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    set_bytes<lambda::str_view>(state, text.size());
+}
+
+void BM_record_reader(benchmark::State &state)
+{
+    const auto text = make_lines(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)));
+
+    for (auto _ : state)
+    {
+        std::istringstream in(text);
+        lambda::record_reader<lambda::istream_source> reader{lambda::istream_source(in)};
+        size_t total = 0;
+        for (lambda::str_view line; reader.next(line);)
+        {
+            total += line.size();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    set_bytes<lambda::str_view>(state, text.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// UTF-8: kind 0 is ASCII, 1 Latin with 2 byte letters, 2 mostly 3 byte CJK
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::string make_utf8(size_t n, int64_t kind)
+{
+    const char *pieces[][4] = {{"a", "b", "c", " "}, {"a", "\xC3\xA9", "t", "\xC3\xBC"},
+                               {"\xE4\xB8\xAD", "\xE6\x96\x87", "\xE5\xAD\x97", ","}};
+    std::string s;
+    for (size_t i = 0; s.size() < n; ++i)
+    {
+        s += pieces[kind][(i * 7) % 4];
+    }
+    while ((static_cast<unsigned char>(s.back()) & 0xC0) == 0x80 || static_cast<unsigned char>(s.back()) >= 0xC0)
+    {
+        s.pop_back();
+    }
+    return s;
+}
+
+void BM_is_valid_utf8(benchmark::State &state)
+{
+    const auto text = make_utf8(static_cast<size_t>(state.range(0)), state.range(1));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lambda::is_valid_utf8(text));
+    }
+    set_bytes<lambda::str_view>(state, text.size());
+}
+
+void BM_to_utf16(benchmark::State &state)
+{
+    const auto text = make_utf8(static_cast<size_t>(state.range(0)), state.range(1));
+    std::vector<char16_t> out(text.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lambda::to_utf16(text, out.data(), out.size()).size());
+    }
+    set_bytes<lambda::str_view>(state, text.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Prefix routing: k prefixes, one starts_with() per prefix against a prefix_set. Every other path matches one prefix.
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::vector<std::string> make_paths(const std::vector<std::string> &prefixes)
+{
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < 256; ++i)
+    {
+        const std::string &prefix = prefixes[(i * 7) % prefixes.size()];
+        paths.push_back((i % 2 ? prefix : std::string("/zz") + prefix) + "/items/42?q=1");
+    }
+    return paths;
+}
+
+void BM_starts_with_each(benchmark::State &state)
+{
+    const auto prefixes = make_keywords(static_cast<size_t>(state.range(0)));
+    const auto paths = make_paths(prefixes);
+
+    for (auto _ : state)
+    {
+        for (const auto &path : paths)
+        {
+            const lambda::str_view v(path);
+            size_t found = prefixes.size();
+            for (size_t i = 0; i < prefixes.size() && found == prefixes.size(); ++i)
+            {
+                found = v.starts_with(prefixes[i].c_str()) ? i : found;
+            }
+            benchmark::DoNotOptimize(found);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * paths.size()));
+}
+
+void BM_prefix_set(benchmark::State &state)
+{
+    const auto prefixes = make_keywords(static_cast<size_t>(state.range(0)));
+    const auto paths = make_paths(prefixes);
+    const lambda::prefix_set set(prefixes.begin(), prefixes.end());
+
+    for (auto _ : state)
+    {
+        for (const auto &path : paths)
+        {
+            benchmark::DoNotOptimize(set.match(lambda::str_view(path)));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * paths.size()));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Header lookup: k header lines in mixed case, the looked up one is last. Lower-casing a copy against ci_str_view.
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::string make_headers(size_t k)
+{
+    std::string head = "GET /index.html HTTP/1.1\r\n";
+    for (size_t i = 0; i + 1 < k; ++i)
+    {
+        head += "X-Custom-Header-" + std::to_string(i) + ": Some-Value-" + std::to_string(i) + "\r\n";
+    }
+    return head + "Content-Length: 42\r\n\r\n";
+}
+
+void BM_header_lower_copy(benchmark::State &state)
+{
+    const std::string head = make_headers(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        std::string lower(head);
+        for (char &c : lower)
+        {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        benchmark::DoNotOptimize(lambda::str_view(lower).find("\r\ncontent-length:"));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * head.size()));
+}
+
+void BM_header_ci_find(benchmark::State &state)
+{
+    const std::string head = make_headers(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lambda::ci_str_view(head.data(), head.size()).find("\r\ncontent-length:"));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * head.size()));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Number parsing: 1024 fields, integers of d digits, doubles printed with 6 (kind 0) or 17 (kind 1) digits. The
+// baseline is to_string() followed by std::stoll / std::strtod; std::from_chars is the allocation free reference.
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::vector<std::string> make_integers(size_t digits)
+{
+    std::mt19937_64 rng(digits);
+    std::vector<std::string> fields;
+    for (size_t i = 0; i < 1024; ++i)
+    {
+        std::string s = std::to_string(rng() % 9 + 1);
+        while (s.size() < digits)
+        {
+            s += static_cast<char>('0' + rng() % 10);
+        }
+        fields.push_back(s);
+    }
+    return fields;
+}
+
+std::vector<std::string> make_doubles(int64_t kind)
+{
+    std::mt19937_64 rng(static_cast<uint64_t>(kind));
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+    std::vector<std::string> fields;
+    for (size_t i = 0; i < 1024; ++i)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), kind == 0 ? "%.6g" : "%.17g", dist(rng));
+        fields.push_back(buffer);
+    }
+    return fields;
+}
+
+void BM_stoll(benchmark::State &state)
+{
+    const auto fields = make_integers(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (const auto &field : fields)
+        {
+            benchmark::DoNotOptimize(std::stoll(lambda::str_view(field).to_string(std::allocator<char>())));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * fields.size()));
+}
+
+void BM_from_chars_int(benchmark::State &state)
+{
+    const auto fields = make_integers(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (const auto &field : fields)
+        {
+            int64_t value = 0;
+            std::from_chars(field.data(), field.data() + field.size(), value);
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * fields.size()));
+}
+
+void BM_parse_int(benchmark::State &state)
+{
+    const auto fields = make_integers(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (const auto &field : fields)
+        {
+            benchmark::DoNotOptimize(lambda::parse<int64_t>(lambda::str_view(field)));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * fields.size()));
+}
+
+void BM_strtod(benchmark::State &state)
+{
+    const auto fields = make_doubles(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (const auto &field : fields)
+        {
+            const std::string copy = lambda::str_view(field).to_string(std::allocator<char>());
+            benchmark::DoNotOptimize(std::strtod(copy.c_str(), nullptr));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * fields.size()));
+}
+
+void BM_from_chars_double(benchmark::State &state)
+{
+    const auto fields = make_doubles(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (const auto &field : fields)
+        {
+            double value = 0;
+            std::from_chars(field.data(), field.data() + field.size(), value);
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * fields.size()));
+}
+
+void BM_parse_double(benchmark::State &state)
+{
+    const auto fields = make_doubles(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (const auto &field : fields)
+        {
+            benchmark::DoNotOptimize(lambda::parse<double>(lambda::str_view(field)));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * fields.size()));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Scatter-gather payload: f fragments of 1460 bytes with the blank line that ends the headers split across the last
+// boundary. Concatenating into a std::string first against searching the fragments in place.
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::vector<std::string> make_fragments(size_t f)
+{
+    std::vector<std::string> parts(f, std::string(1460, 'a'));
+    for (std::string &p : parts)
+    {
+        for (size_t i = 0; i < p.size(); ++i)
+        {
+            p[i] = static_cast<char>('a' + i % 16);
+        }
+    }
+    parts[f - 2].replace(1458, 2, "\r\n");
+    parts[f - 1].replace(0, 2, "\r\n");
+    return parts;
+}
+
+void BM_concat_find(benchmark::State &state)
+{
+    const std::vector<std::string> parts = make_fragments(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        std::string payload;
+        for (const std::string &p : parts)
+        {
+            payload += p;
+        }
+        benchmark::DoNotOptimize(lambda::str_view(payload).find("\r\n\r\n"));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * parts.size() * parts[0].size()));
+}
+
+void BM_segmented_find(benchmark::State &state)
+{
+    const std::vector<std::string> parts = make_fragments(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        lambda::segmented_str_view payload;
+        for (const std::string &p : parts)
+        {
+            payload.append(p);
+        }
+        benchmark::DoNotOptimize(payload.find("\r\n\r\n"));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * parts.size() * parts[0].size()));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Fixed needles, 1 MiB haystack, no match. kind 0: English text, an 18 unit phrase with common first and last letters;
+// kind 1: English text, 258 units absent from it; kind 2: "ab" text broken every 62 units, periodic 64 unit needle.
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::string make_fixed_text(int64_t kind)
+{
+    std::string text;
+    if (kind == 2)
+    {
+        while (text.size() < (1u << 20))
+        {
+            text += std::string(60, 'a') + "cc";
+            for (size_t i = text.size() - 62; i < text.size() - 2; i += 2)
+            {
+                text[i + 1] = 'b';
+            }
+        }
+        return text;
+    }
+
+    static const char *const words[] = {"the",    "of",   "and",  "to",   "in",   "is",    "that", "for",
+                                        "it",     "as",   "was",  "with", "be",   "by",    "on",   "not",
+                                        "he",     "this", "are",  "or",   "his",  "from",  "at",   "which",
+                                        "but",    "have", "an",   "had",  "they", "you",   "were", "their",
+                                        "people", "time", "year", "good", "new",  "first", "last", "long"};
+    std::mt19937 rng(7);
+    while (text.size() < (1u << 20))
+    {
+        text += words[rng() % (sizeof(words) / sizeof(words[0]))];
+        text += rng() % 12 == 0 ? ". " : " ";
+    }
+    return text;
+}
+
+std::string fixed_needle(int64_t kind)
+{
+    if (kind == 0)
+    {
+        return "the jukebox of the";
+    }
+
+    std::string needle;
+    if (kind == 1)
+    {
+        const std::string symbols = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ#$%&@^~";
+        std::mt19937 rng(11);
+        while (needle.size() < 258)
+        {
+            needle += symbols[rng() % symbols.size()];
+        }
+        return needle;
+    }
+
+    while (needle.size() < 64)
+    {
+        needle += "ab";
+    }
+    return needle;
+}
+
+void BM_find_fixed(benchmark::State &state)
+{
+    const std::string text = make_fixed_text(state.range(0));
+    const std::string pattern = fixed_needle(state.range(0));
+    const lambda::str_view hay(text), needle(pattern);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hay.find(needle));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+void BM_searcher_fixed(benchmark::State &state)
+{
+    const std::string text = make_fixed_text(state.range(0));
+    const lambda::str_view hay(text);
+    const std::string pattern = fixed_needle(state.range(0));
+    const lambda::searcher needle = lambda::make_searcher(lambda::str_view(pattern));
+    state.SetLabel(needle.algorithm() == lambda::search_algorithm::anchored   ? "anchored"
+                   : needle.algorithm() == lambda::search_algorithm::horspool ? "horspool"
+                                                                               : "two_way");
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hay.find(needle));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Short keys: counting the matches of a key among 4096 keys of m characters sharing a 4 character prefix, held as
+// std::string against fixed_string<23>.
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::vector<std::string> make_keys(int64_t m)
+{
+    std::vector<std::string> keys;
+    std::mt19937 rng(5);
+    while (keys.size() < 4096)
+    {
+        std::string key = "key:";
+        while (key.size() < static_cast<size_t>(m))
+        {
+            key += static_cast<char>('a' + rng() % 26);
+        }
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+void BM_key_scan_string(benchmark::State &state)
+{
+    const std::vector<std::string> keys = make_keys(state.range(0));
+    const std::string probe = keys.back();
+
+    for (auto _ : state)
+    {
+        size_t count = 0;
+        for (const std::string &key : keys)
+        {
+            count += key == probe;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+
+void BM_key_scan_fixed(benchmark::State &state)
+{
+    std::vector<lambda::fixed_string<23>> keys;
+    for (const std::string &key : make_keys(state.range(0)))
+    {
+        keys.emplace_back(lambda::str_view(key));
+    }
+    const lambda::fixed_string<23> probe = keys.back();
+
+    for (auto _ : state)
+    {
+        size_t count = 0;
+        for (const lambda::fixed_string<23> &key : keys)
+        {
+            count += key == probe;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Dictionary lookup: n keys "user:" + 8 to 16 random letters, looking up present keys in random order.
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::map<std::string, int> make_dictionary(int64_t n)
+{
+    std::map<std::string, int> dict;
+    std::mt19937 rng(9);
+    while (dict.size() < static_cast<size_t>(n))
+    {
+        std::string key = "user:";
+        const size_t length = 8 + rng() % 9;
+        while (key.size() < 5 + length)
+        {
+            key += static_cast<char>('a' + rng() % 26);
+        }
+        dict.emplace(key, static_cast<int>(dict.size()));
+    }
+    return dict;
+}
+
+std::vector<std::string> make_lookups(const std::map<std::string, int> &dict)
+{
+    std::vector<std::string> keys;
+    for (const auto &entry : dict)
+    {
+        keys.push_back(entry.first);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(10));
+    keys.resize(std::min<size_t>(keys.size(), 4096));
+    return keys;
+}
+
+void BM_std_map_find(benchmark::State &state)
+{
+    const std::map<std::string, int> dict = make_dictionary(state.range(0));
+    const std::vector<std::string> lookups = make_lookups(dict);
+
+    for (auto _ : state)
+    {
+        int sum = 0;
+        for (const std::string &key : lookups)
+        {
+            sum += dict.find(key)->second;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * lookups.size()));
+}
+
+void BM_flat_str_map_find(benchmark::State &state)
+{
+    const std::map<std::string, int> source = make_dictionary(state.range(0));
+    const lambda::flat_str_map<int> dict(source.begin(), source.end());
+    const std::vector<std::string> lookups = make_lookups(source);
+
+    for (auto _ : state)
+    {
+        int sum = 0;
+        for (const std::string &key : lookups)
+        {
+            sum += dict.find(lambda::str_view(key)).value();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * lookups.size()));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Sorting n log keys "2021-10-20T<time> <host> <service> <request id>": a long shared prefix, then few distinct
+// values per field.
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::vector<std::string> make_log_keys(int64_t n)
+{
+    static const char *const services[] = {"auth", "billing", "gateway", "search", "storage"};
+    std::vector<std::string> keys;
+    std::mt19937 rng(13);
+    char line[96];
+    for (int64_t i = 0; i < n; ++i)
+    {
+        // One draw per statement: the evaluation order of function arguments is unspecified.
+        const unsigned hour = static_cast<unsigned>(rng() % 3);
+        const unsigned minute = static_cast<unsigned>(rng() % 60);
+        const unsigned second = static_cast<unsigned>(rng() % 60);
+        const unsigned host = static_cast<unsigned>(rng() % 16);
+        const char *service = services[rng() % 5];
+        const unsigned request = static_cast<unsigned>(rng());
+        std::snprintf(line, sizeof(line), "2021-10-20T%02u:%02u:%02u host-%02u %s req=%08x", hour, minute, second, host,
+                      service, request);
+        keys.push_back(line);
+    }
+    return keys;
+}
+
+template <typename Sort> void run_sort_views(benchmark::State &state, Sort sort)
+{
+    const std::vector<std::string> keys = make_log_keys(state.range(0));
+    const std::vector<lambda::str_view> input(keys.begin(), keys.end());
+    std::vector<lambda::str_view> views;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        views = input;
+        state.ResumeTiming();
+        sort(views);
+        benchmark::DoNotOptimize(views.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+
+void BM_std_sort_views(benchmark::State &state)
+{
+    run_sort_views(state, [](std::vector<lambda::str_view> &v) { std::sort(v.begin(), v.end()); });
+}
+
+void BM_sort_views(benchmark::State &state)
+{
+    run_sort_views(state, [](std::vector<lambda::str_view> &v) { lambda::sort_views(v); });
+}
+
+void BM_parallel_sort_views(benchmark::State &state)
+{
+    run_sort_views(state, [](std::vector<lambda::str_view> &v) { lambda::parallel_sort_views(v); });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Columnar batches: n HTTP methods and paths of which a quarter are "GET", each heap allocated, filtered and hashed a
+// row at a time and with the batch kernels.
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::vector<std::string> make_rows(int64_t n)
+{
+    static const char *const methods[] = {"GET", "POST", "GETX", "HEAD"};
+    std::vector<std::string> rows;
+    std::mt19937 rng(27);
+    for (int64_t i = 0; i < n; ++i)
+    {
+        std::string row = methods[rng() % 4];
+        if (row != "GET")
+        {
+            row += " /api/v1/" + std::string(16 + rng() % 32, 'a' + static_cast<char>(rng() % 26));
+        }
+        rows.push_back(row);
+    }
+    std::shuffle(rows.begin(), rows.end(), rng);
+    return rows;
+}
+
+void BM_equals_each(benchmark::State &state)
+{
+    const std::vector<std::string> rows = make_rows(state.range(0));
+    const std::vector<lambda::str_view> views(rows.begin(), rows.end());
+    std::vector<uint64_t> mask(lambda::batch_mask_words(views.size()));
+
+    for (auto _ : state)
+    {
+        std::fill(mask.begin(), mask.end(), 0);
+        for (size_t i = 0; i < views.size(); ++i)
+        {
+            mask[i / 64] |= static_cast<uint64_t>(views[i] == lambda::str_view("GET")) << (i % 64);
+        }
+        benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows.size()));
+}
+
+void BM_equals_batch(benchmark::State &state)
+{
+    const std::vector<std::string> rows = make_rows(state.range(0));
+    const lambda::view_batch batch(rows.begin(), rows.end());
+    std::vector<uint64_t> mask(lambda::batch_mask_words(batch.size()));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lambda::equals_batch(batch, lambda::str_view("GET"), mask.data()));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows.size()));
+}
+
+void BM_hash_each(benchmark::State &state)
+{
+    const std::vector<std::string> rows = make_rows(state.range(0));
+    const std::vector<lambda::str_view> views(rows.begin(), rows.end());
+    std::vector<uint64_t> hashes(views.size());
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < views.size(); ++i)
+        {
+            hashes[i] = lambda::hash_value(views[i]);
+        }
+        benchmark::DoNotOptimize(hashes.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows.size()));
+}
+
+void BM_hash_batch(benchmark::State &state)
+{
+    const std::vector<std::string> rows = make_rows(state.range(0));
+    const lambda::view_batch batch(rows.begin(), rows.end());
+    std::vector<uint64_t> hashes(batch.size());
+
+    for (auto _ : state)
+    {
+        lambda::hash_batch(batch, hashes.data());
+        benchmark::DoNotOptimize(hashes.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows.size()));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Streaming: n bytes of log lines read through a read()-like source in 64 KiB pieces, either read fully and then
+// searched, or searched chunk by chunk while the next chunks are read.
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::string make_log(int64_t n)
+{
+    std::string log;
+    std::mt19937 rng(28);
+    while (static_cast<int64_t>(log.size()) < n)
+    {
+        log += rng() % 64 == 0 ? "2021-10-20 ERROR disk quota exceeded\n" : "2021-10-20 INFO request served in 3ms\n";
+    }
+    return log;
+}
+
+struct memory_source
+{
+    const std::string *text;
+    size_t at;
+
+    size_t operator()(char *dst, size_t capacity)
+    {
+        const size_t n = std::min({capacity, text->size() - at, size_t(64 * 1024)});
+        std::copy(text->begin() + at, text->begin() + at + n, dst);
+        at += n;
+        return n;
+    }
+};
+
+void BM_read_then_find_all(benchmark::State &state)
+{
+    const std::string log = make_log(state.range(0));
+
+    for (auto _ : state)
+    {
+        memory_source source{&log, 0};
+        std::string all;
+        char piece[64 * 1024];
+        for (size_t got; (got = source(piece, sizeof(piece))) != 0;)
+        {
+            all.append(piece, got);
+        }
+        size_t count = 0;
+        const lambda::str_view h(all);
+        for (size_t pos = h.find("ERROR"); pos != h.npos; pos = h.find("ERROR", pos + 1))
+        {
+            ++count;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * log.size()));
+}
+
+void BM_stream_find_all(benchmark::State &state)
+{
+    const std::string log = make_log(state.range(0));
+
+    for (auto _ : state)
+    {
+        size_t count = 0;
+        lambda::stream_find_all(memory_source{&log, 0}, lambda::str_view("ERROR"), [&count](size_t) { ++count; });
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * log.size()));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Argument grids
+// ---------------------------------------------------------------------------------------------------------------------
+
+const int64_t lengths[] = {16, 256, 4096, 65536};
+
+void search_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"n", "m", "where"});
+    for (int64_t n : lengths)
+    {
+        for (int64_t m : {2, 8, 32})
+        {
+            for (int64_t where : {int64_t(0), int64_t(50), no_match})
+            {
+                if (m <= n)
+                {
+                    b->Args({n, m, where});
+                }
+            }
+        }
+    }
+}
+
+void char_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"n", "where"});
+    for (int64_t n : lengths)
+    {
+        for (int64_t where : {int64_t(50), no_match})
+        {
+            b->Args({n, where});
+        }
+    }
+}
+
+void set_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"n", "m", "where"});
+    for (int64_t n : lengths)
+    {
+        for (int64_t m : {2, 8})
+        {
+            for (int64_t where : {int64_t(50), no_match})
+            {
+                b->Args({n, m, where});
+            }
+        }
+    }
+}
+
+void affix_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"n", "m", "where"});
+    for (int64_t m : {4, 16, 64})
+    {
+        for (int64_t where : {int64_t(0), int64_t(100), no_match})
+        {
+            b->Args({256, m, where});
+        }
+    }
+}
+
+void length_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"n"});
+    for (int64_t n : lengths)
+    {
+        b->Args({n});
+    }
+}
+
+void multi_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"n", "k", "mode"});
+    for (int64_t k : {8, 64, 512})
+    {
+        for (lambda::multi_mode mode : {lambda::multi_mode::filtered, lambda::multi_mode::automaton})
+        {
+            b->Args({65536, k, static_cast<int64_t>(mode)});
+        }
+    }
+}
+
+void parallel_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"n", "t"});
+    for (int64_t t : {1, 2, 4, 8})
+    {
+        b->Args({int64_t(64) << 20, t});
+    }
+    b->UseRealTime();
+}
+
+void lines_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"n", "m"});
+    for (int64_t m : {16, 80, 1024})
+    {
+        b->Args({int64_t(16) << 20, m});
+    }
+}
+
+void prefix_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"k"});
+    for (int64_t k : {4, 32, 256})
+    {
+        b->Args({k});
+    }
+}
+
+void header_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"k"});
+    for (int64_t k : {8, 32})
+    {
+        b->Args({k});
+    }
+}
+
+void fragment_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"f"});
+    for (int64_t f : {4, 16, 64})
+    {
+        b->Args({f});
+    }
+}
+
+void fixed_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"kind"});
+    for (int64_t kind : {0, 1, 2})
+    {
+        b->Args({kind});
+    }
+}
+
+void integer_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"d"});
+    for (int64_t d : {4, 8, 16})
+    {
+        b->Args({d});
+    }
+}
+
+void double_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"kind"});
+    for (int64_t kind : {0, 1})
+    {
+        b->Args({kind});
+    }
+}
+
+void utf8_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"n", "kind"});
+    for (int64_t kind : {0, 1, 2})
+    {
+        b->Args({65536, kind});
+    }
+}
+
+void key_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"m"});
+    for (int64_t m : {8, 15, 23})
+    {
+        b->Args({m});
+    }
+}
+
+void dictionary_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"n"});
+    for (int64_t n : {4096, 65536, 1048576})
+    {
+        b->Args({n});
+    }
+}
+
+void sort_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"n"});
+    for (int64_t n : {65536, 1048576})
+    {
+        b->Args({n});
+    }
+}
+
+void batch_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"rows"});
+    for (int64_t n : {1024, 1048576})
+    {
+        b->Args({n});
+    }
+}
+
+void stream_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"n"});
+    for (int64_t n : {1 << 20, 64 << 20})
+    {
+        b->Args({n});
+    }
+}
+
+} // namespace
+
+#define SV_BENCHMARK_VIEWS(fn, args)                                                                                   \
+    BENCHMARK_TEMPLATE(fn, lambda::str_view)->Apply(args);                                                             \
+    BENCHMARK_TEMPLATE(fn, std::string_view)->Apply(args);                                                             \
+    BENCHMARK_TEMPLATE(fn, lambda::wstr_view)->Apply(args);                                                            \
+    BENCHMARK_TEMPLATE(fn, std::wstring_view)->Apply(args);                                                            \
+    BENCHMARK_TEMPLATE(fn, lambda::u16str_view)->Apply(args);                                                          \
+    BENCHMARK_TEMPLATE(fn, std::u16string_view)->Apply(args);                                                          \
+    BENCHMARK_TEMPLATE(fn, lambda::u32str_view)->Apply(args);                                                          \
+    BENCHMARK_TEMPLATE(fn, std::u32string_view)->Apply(args)
+
+SV_BENCHMARK_VIEWS(BM_find, search_args);
+SV_BENCHMARK_VIEWS(BM_rfind, search_args);
+SV_BENCHMARK_VIEWS(BM_find_char, char_args);
+SV_BENCHMARK_VIEWS(BM_rfind_char, char_args);
+SV_BENCHMARK_VIEWS(BM_find_first_of, set_args);
+SV_BENCHMARK_VIEWS(BM_find_last_of, set_args);
+SV_BENCHMARK_VIEWS(BM_find_first_not_of, char_args);
+SV_BENCHMARK_VIEWS(BM_find_last_not_of, char_args);
+SV_BENCHMARK_VIEWS(BM_compare, char_args);
+SV_BENCHMARK_VIEWS(BM_equal, char_args);
+SV_BENCHMARK_VIEWS(BM_starts_with, affix_args);
+SV_BENCHMARK_VIEWS(BM_ends_with, affix_args);
+SV_BENCHMARK_VIEWS(BM_contains, search_args);
+SV_BENCHMARK_VIEWS(BM_substr, length_args);
+
+BENCHMARK_TEMPLATE(BM_find_first_of_char_set, char)->Apply(set_args);
+BENCHMARK_TEMPLATE(BM_find_first_of_char_set, wchar_t)->Apply(set_args);
+BENCHMARK_TEMPLATE(BM_find_first_of_char_set, char16_t)->Apply(set_args);
+BENCHMARK_TEMPLATE(BM_find_first_of_char_set, char32_t)->Apply(set_args);
+
+SV_BENCHMARK_VIEWS(BM_construct, length_args);
+BENCHMARK(BM_contains_each)->Apply(multi_args);
+BENCHMARK(BM_multi_matcher)->Apply(multi_args);
+BENCHMARK(BM_parallel_count)->Apply(parallel_args);
+BENCHMARK(BM_parallel_find)->Apply(parallel_args);
+BENCHMARK(BM_getline)->Apply(lines_args);
+BENCHMARK(BM_record_reader)->Apply(lines_args);
+BENCHMARK(BM_is_valid_utf8)->Apply(utf8_args);
+BENCHMARK(BM_to_utf16)->Apply(utf8_args);
+BENCHMARK(BM_starts_with_each)->Apply(prefix_args);
+BENCHMARK(BM_prefix_set)->Apply(prefix_args);
+BENCHMARK(BM_header_lower_copy)->Apply(header_args);
+BENCHMARK(BM_header_ci_find)->Apply(header_args);
+BENCHMARK(BM_stoll)->Apply(integer_args);
+BENCHMARK(BM_from_chars_int)->Apply(integer_args);
+BENCHMARK(BM_parse_int)->Apply(integer_args);
+BENCHMARK(BM_strtod)->Apply(double_args);
+BENCHMARK(BM_from_chars_double)->Apply(double_args);
+BENCHMARK(BM_parse_double)->Apply(double_args);
+BENCHMARK(BM_find_fixed)->Apply(fixed_args);
+BENCHMARK(BM_searcher_fixed)->Apply(fixed_args);
+BENCHMARK(BM_concat_find)->Apply(fragment_args);
+BENCHMARK(BM_segmented_find)->Apply(fragment_args);
+BENCHMARK(BM_key_scan_string)->Apply(key_args);
+BENCHMARK(BM_key_scan_fixed)->Apply(key_args);
+BENCHMARK(BM_std_map_find)->Apply(dictionary_args);
+BENCHMARK(BM_flat_str_map_find)->Apply(dictionary_args);
+BENCHMARK(BM_std_sort_views)->Apply(sort_args)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_sort_views)->Apply(sort_args)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_parallel_sort_views)->Apply(sort_args)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_equals_each)->Apply(batch_args);
+BENCHMARK(BM_equals_batch)->Apply(batch_args);
+BENCHMARK(BM_hash_each)->Apply(batch_args);
+BENCHMARK(BM_hash_batch)->Apply(batch_args);
+BENCHMARK(BM_read_then_find_all)->Apply(stream_args)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_stream_find_all)->Apply(stream_args)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_construct, std::string)->Apply(length_args);
+
+BENCHMARK_MAIN();
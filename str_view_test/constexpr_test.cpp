@@ -0,0 +1,173 @@
+#include "../str_view/lambda/ci_traits.hpp"
+#include "../str_view/lambda/fixed_string.hpp"
+#include "../str_view/lambda/hash.hpp"
+#include "../str_view/lambda/parse.hpp"
+#include "../str_view/lambda/perfect_hash.hpp"
+#include "../str_view/lambda/searcher.hpp"
+#include "../str_view/lambda/split.hpp"
+#include "../str_view/lambda/str_view.hpp"
+#include "../str_view/lambda/utf8.hpp"
+
+// Compile only: every check is a static_assert, so this translation unit building in C++14 is the test. C++14
+// constexpr functions cannot hold lambdas, hence the small named helpers. Building it with
+// -DLAMBDA_HAS_CONSTANT_EVALUATED=0 checks the same operations on the fallback that never takes the runtime branches.
+
+namespace
+{
+
+using namespace lambda::sv_literals;
+
+constexpr lambda::str_view config = "  key = value ; other\t\n"_sv;
+constexpr lambda::str_view s = "key = value ; other"_sv;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Construction, iteration and element access
+// ---------------------------------------------------------------------------------------------------------------------
+
+static_assert(lambda::str_view("abc").size() == 3, "");
+static_assert(lambda::str_view("abc", 2) == "ab"_sv, "");
+static_assert(lambda::str_view().empty() && lambda::str_view().data() == nullptr, "");
+static_assert(*s.begin() == 'k' && *s.cbegin() == 'k', "");
+static_assert(s.end() - s.begin() == 19 && *(s.cend() - 1) == 'r', "");
+static_assert(s[4] == '=' && s.at(4) == '=' && s.front() == 'k' && s.back() == 'r', "");
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+static_assert(*s.rbegin() == 'r' && *(s.rend() - 1) == 'k', "");
+static_assert(*s.crbegin() == 'r' && s.crend() - s.crbegin() == 19, "");
+#endif
+
+constexpr size_t count_units(lambda::str_view v, char c)
+{
+    size_t n = 0;
+    for (char u : v)
+    {
+        n += u == c;
+    }
+    return n;
+}
+static_assert(count_units(s, 'e') == 3, "");
+
+constexpr lambda::str_view shrink(lambda::str_view v)
+{
+    v.remove_prefix(4);
+    v.remove_suffix(8);
+    return v;
+}
+static_assert(shrink(s) == "= value"_sv, "");
+
+constexpr bool swapped()
+{
+    lambda::str_view a = "a"_sv;
+    lambda::str_view b = "bc"_sv;
+    a.swap(b);
+    return a == "bc"_sv && b == "a"_sv;
+}
+static_assert(swapped(), "");
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Slicing and trimming
+// ---------------------------------------------------------------------------------------------------------------------
+
+static_assert(s.substr(6, 5) == "value"_sv && s.substr(14) == "other"_sv, "");
+static_assert(s.first(3) == "key"_sv && s.last(5) == "other"_sv, "");
+static_assert(s.take(100) == s && s.drop(14) == "other"_sv && s.drop(100).empty(), "");
+static_assert(s.split_at(3).first == "key"_sv && s.split_at(3).second.size() == 16, "");
+static_assert(s.unchecked_substr(6, 5) == "value"_sv, "");
+
+static_assert(config.trim() == s, "");
+static_assert(config.trim_front() == "key = value ; other\t\n"_sv, "");
+static_assert(config.trim_back() == "  key = value ; other"_sv, "");
+static_assert(lambda::str_view(" \t\r\n").trim().empty() && ""_sv.trim().empty(), "");
+static_assert("--=x=--"_sv.trim("-="_sv) == "x"_sv, "");
+static_assert("--=x=--"_sv.trim_front("-"_sv) == "=x=--"_sv, "");
+static_assert("--=x=--"_sv.trim_back("-"_sv) == "--=x="_sv, "");
+static_assert("----"_sv.trim("-"_sv).empty(), "");
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Comparison
+// ---------------------------------------------------------------------------------------------------------------------
+
+static_assert(s.compare("key"_sv) > 0 && s.compare("z") < 0 && s.compare(s) == 0, "");
+static_assert(s.compare(0, 3, "key"_sv) == 0 && s.compare(0, 3, "xkey"_sv, 1, 3) == 0, "");
+static_assert(s.compare(0, 3, "key") == 0 && s.compare(0, 3, "keys", 3) == 0, "");
+static_assert(s.equals(s) && !s.equals("key"_sv), "");
+static_assert(s == s && !(s != s) && !(s < s) && s <= s && s >= s && !(s > s), "");
+static_assert("abc"_sv == "abc" && "abc" == "abc"_sv && "abc"_sv < "abd"_sv, "");
+static_assert(s.starts_with("key"_sv) && s.starts_with('k') && s.starts_with("key"), "");
+static_assert(s.ends_with("other"_sv) && s.ends_with('r') && s.ends_with("her"), "");
+static_assert(s.contains("value"_sv) && s.contains(';') && s.contains("other") && !s.contains("none"), "");
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Search, every overload
+// ---------------------------------------------------------------------------------------------------------------------
+
+static_assert(s.find("value"_sv) == 6 && s.find('=') == 4 && s.find("val", 0, 3) == 6 && s.find("other") == 14, "");
+static_assert(s.find("none"_sv) == s.npos && s.find('e', 11) == 17, "");
+static_assert(s.rfind("e"_sv) == 17 && s.rfind('e') == 17 && s.rfind("e", 16, 1) == 10 && s.rfind("key") == 0, "");
+static_assert(s.find_first_of("=;"_sv) == 4 && s.find_first_of('=') == 4, "");
+static_assert(s.find_first_of("=;", 5, 2) == 12 && s.find_first_of(";") == 12, "");
+static_assert(s.find_last_of("=;"_sv) == 12 && s.find_last_of('=') == 4, "");
+static_assert(s.find_last_of("=;", 11, 2) == 4 && s.find_last_of("=") == 4, "");
+static_assert(s.find_first_not_of("key "_sv) == 4 && s.find_first_not_of('k') == 1, "");
+static_assert(s.find_first_not_of("ke", 0, 2) == 2 && s.find_first_not_of("key") == 3, "");
+static_assert(s.find_last_not_of("ehtor"_sv) == 13 && s.find_last_not_of('r') == 17, "");
+static_assert(s.find_last_not_of("er", s.npos, 2) == 16 && s.find_last_not_of("other ") == 12, "");
+static_assert(s.find_first_of(lambda::basic_char_set<char>(";="_sv)) == 4, "");
+
+constexpr auto other = lambda::make_searcher("other"_sv);
+static_assert(s.find(other) == 14 && s.contains(other), "");
+
+static_assert(lambda::wstr_view(L"abcabc").rfind(L"bc") == 4, "");
+static_assert(lambda::u16str_view(u"héllo").find(u'l') == 2, "");
+static_assert(lambda::u32str_view(U"abc").compare(U"abd") < 0, "");
+static_assert(lambda::u32str_view(U" x ").trim() == lambda::u32str_view(U"x"), "");
+
+static_assert(lambda::ci_str_view("HeLLo") == lambda::ci_str_view("hello"), "");
+static_assert(lambda::ci_str_view("HeLLo").find(lambda::ci_str_view("ll")) == 2, "");
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Split
+// ---------------------------------------------------------------------------------------------------------------------
+
+constexpr size_t field_count(lambda::str_view v, lambda::str_view delim)
+{
+    size_t n = 0;
+    for (lambda::str_view field : lambda::split(v, delim))
+    {
+        n += !field.trim().empty();
+    }
+    return n;
+}
+static_assert(field_count("a :: b ::  :: c"_sv, "::"_sv) == 3, "");
+
+constexpr lambda::str_view nth_field(lambda::str_view v, char delim, size_t n)
+{
+    for (lambda::str_view field : lambda::split(v, delim))
+    {
+        if (n-- == 0)
+        {
+            return field.trim();
+        }
+    }
+    return lambda::str_view();
+}
+static_assert(nth_field(s, ';', 1) == "other"_sv && nth_field(s, '=', 0) == "key"_sv, "");
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Fixed buffers: replace, concatenation, hashing and validation of literals
+// ---------------------------------------------------------------------------------------------------------------------
+
+constexpr auto route = lambda::replace_all<32>("/users/{id}/posts/{id}"_sv, "{id}"_sv, "42"_sv);
+static_assert(route.view() == "/users/42/posts/42"_sv, "");
+static_assert(lambda::replace_all<8>("aaa"_sv, "a"_sv, "bb"_sv) == "bbbbbb"_sv, "");
+static_assert(lambda::replace_all<8>("aaaa"_sv, "aa"_sv, ""_sv).empty(), "");
+static_assert(lambda::replace_all<4>("abc"_sv, ""_sv, "x"_sv) == "abc"_sv, "");
+
+constexpr auto key = lambda::make_fixed_string("user:") + "42";
+static_assert(key.view() == "user:42"_sv && key.capacity() == 7, "");
+
+static_assert(lambda::hash_value("abc"_sv) == lambda::hashing::wyhash("abc", 3), "");
+static_assert(lambda::make_perfect_hash("GET"_sv, "HEAD"_sv, "POST"_sv).contains("HEAD"_sv), "");
+static_assert(lambda::parse<int>("-42 apples"_sv).value == -42, "");
+static_assert(lambda::is_valid_utf8("h\xc3\xa9llo"_sv) && !lambda::is_valid_utf8("\xc3"_sv), "");
+
+} // namespace
@@ -0,0 +1,348 @@
+/**
+ * @brief : Differential check of every basic_str_view operation against the standard library, shared by the gtest
+ *          suite and the libFuzzer entry point (fuzz.cpp)
+ * @date  : 20.10.2021
+ * @author: Bora Ilgar
+ */
+
+#ifndef STR_VIEW_TEST_DIFFERENTIAL_H
+#define STR_VIEW_TEST_DIFFERENTIAL_H
+
+#include "../str_view/lambda/char_set.hpp"
+#include "../str_view/lambda/hash.hpp"
+#include "../str_view/lambda/searcher.hpp"
+#include "../str_view/lambda/split.hpp"
+#include "../str_view/lambda/str_view.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#define SV_DIFF_HAS_STRING_VIEW 1
+#else
+#define SV_DIFF_HAS_STRING_VIEW 0
+#endif
+
+namespace sv_diff
+{
+
+/// The oracle: std::basic_string_view where it exists, else std::basic_string, whose search and compare members have
+/// the same contract.
+#if SV_DIFF_HAS_STRING_VIEW
+template <typename CharT> using reference_view = std::basic_string_view<CharT>;
+#else
+template <typename CharT> using reference_view = std::basic_string<CharT>;
+#endif
+
+/// Input layout shared by the fuzzer and the random tests: mode, needle shape, pos, count, alignment, then one byte
+/// per code unit.
+static constexpr size_t header_size = 5;
+
+namespace detail
+{
+
+/// <summary>
+/// Result of f(), or the fact that it threw std::out_of_range.
+/// </summary>
+template <typename T> struct _outcome_
+{
+    bool threw;
+    T value;
+
+    bool operator==(const _outcome_ &other) const
+    {
+        return threw == other.threw && (threw || value == other.value);
+    }
+};
+
+template <typename F> inline auto _run_(F f) -> _outcome_<decltype(f())>
+{
+    try
+    {
+        return {false, f()};
+    }
+    catch (const std::out_of_range &)
+    {
+        return {true, decltype(f())()};
+    }
+}
+
+inline int _sign_(int x)
+{
+    return (x > 0) - (x < 0);
+}
+
+template <typename CharT> inline std::basic_string<CharT> _units_(lambda::basic_str_view<CharT> v)
+{
+    return std::basic_string<CharT>(v.data(), v.size());
+}
+
+template <typename CharT> inline std::basic_string<CharT> _units_(const reference_view<CharT> &v)
+{
+    return std::basic_string<CharT>(v.data(), v.size());
+}
+
+template <typename CharT> inline bool _ref_starts_with_(const reference_view<CharT> &h, const reference_view<CharT> &n)
+{
+    return h.size() >= n.size() && h.compare(0, n.size(), n) == 0;
+}
+
+template <typename CharT> inline bool _ref_ends_with_(const reference_view<CharT> &h, const reference_view<CharT> &n)
+{
+    return h.size() >= n.size() && h.compare(h.size() - n.size(), n.size(), n) == 0;
+}
+
+} // namespace detail
+
+#define SV_DIFF_CHECK(lhs, rhs, what)                                                                                 \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!((lhs) == (rhs)))                                                                                         \
+        {                                                                                                              \
+            return std::string(what) + " (size " + std::to_string(h.size()) + ", needle " +                            \
+                   std::to_string(n.size()) + ", pos " + std::to_string(pos) + ", count " + std::to_string(count) +   \
+                   ")";                                                                                                \
+        }                                                                                                              \
+    } while (false)
+
+/// <summary>
+/// Runs every operation of h (and of h against the needle n) on both implementations.
+/// </summary>
+/// <returns>An empty string, or the first operation whose result differs.</returns>
+template <typename CharT>
+inline std::string check_operations(lambda::basic_str_view<CharT> h, lambda::basic_str_view<CharT> n, size_t pos,
+                                    size_t count)
+{
+    using view = lambda::basic_str_view<CharT>;
+    using reference = reference_view<CharT>;
+    using detail::_run_;
+    using detail::_sign_;
+    using detail::_units_;
+
+    const reference rh(h.data(), h.size());
+    const reference rn(n.data(), n.size());
+    const std::basic_string<CharT> n_string(n.data(), n.size());
+    const CharT *const n_ptr = n_string.c_str();
+    const reference rn_ptr(n_ptr);
+    const size_t n_count = count < n.size() ? count : n.size();
+    const CharT c = n.empty() ? CharT('a') : n[0];
+
+    // Element access and slicing.
+    SV_DIFF_CHECK(h.size(), rh.size(), "size");
+    SV_DIFF_CHECK(h.empty(), rh.empty(), "empty");
+    SV_DIFF_CHECK(_run_([&] { return h.at(pos); }), _run_([&] { return rh.at(pos); }), "at");
+    if (!h.empty())
+    {
+        SV_DIFF_CHECK(h.front(), rh.front(), "front");
+        SV_DIFF_CHECK(h.back(), rh.back(), "back");
+        SV_DIFF_CHECK(std::basic_string<CharT>(h.rbegin(), h.rend()),
+                      std::basic_string<CharT>(rh.rbegin(), rh.rend()), "rbegin");
+    }
+    SV_DIFF_CHECK(_run_([&] { return _units_(h.substr(pos, count)); }),
+                  _run_([&] { return _units_<CharT>(reference(rh.substr(pos, count))); }), "substr");
+    {
+        std::basic_string<CharT> a(h.size() + 1, CharT('#'));
+        std::basic_string<CharT> b(h.size() + 1, CharT('#'));
+        SV_DIFF_CHECK(_run_([&] { return h.copy(&a[0], count, pos); }),
+                      _run_([&] { return rh.copy(&b[0], count, pos); }), "copy");
+        SV_DIFF_CHECK(a, b, "copy contents");
+    }
+    if (pos <= h.size())
+    {
+        view v = h;
+        v.remove_prefix(pos);
+        SV_DIFF_CHECK(_units_(v), _units_<CharT>(reference(rh.substr(pos))), "remove_prefix");
+        v = h;
+        v.remove_suffix(pos);
+        SV_DIFF_CHECK(_units_(v), _units_<CharT>(reference(rh.substr(0, rh.size() - pos))), "remove_suffix");
+        SV_DIFF_CHECK(_units_(h.first(pos)), _units_<CharT>(reference(rh.substr(0, pos))), "first");
+        SV_DIFF_CHECK(_units_(h.last(pos)), _units_<CharT>(reference(rh.substr(rh.size() - pos))), "last");
+    }
+    SV_DIFF_CHECK(_units_(h.take(count)), _units_<CharT>(reference(rh.substr(0, count))), "take");
+    SV_DIFF_CHECK(_units_(h.drop(count)),
+                  _units_<CharT>(reference(rh.substr(count < rh.size() ? count : rh.size()))), "drop");
+
+    // Comparison, every overload including the throwing ones.
+    SV_DIFF_CHECK(_sign_(h.compare(n)), _sign_(rh.compare(rn)), "compare(v)");
+    SV_DIFF_CHECK(_run_([&] { return _sign_(h.compare(pos, count, n)); }),
+                  _run_([&] { return _sign_(rh.compare(pos, count, rn)); }), "compare(pos, count, v)");
+    SV_DIFF_CHECK(_run_([&] { return _sign_(h.compare(pos, count, n, count / 2, pos)); }),
+                  _run_([&] { return _sign_(rh.compare(pos, count, rn, count / 2, pos)); }),
+                  "compare(pos, count, v, pos2, count2)");
+    SV_DIFF_CHECK(_sign_(h.compare(n_ptr)), _sign_(rh.compare(n_ptr)), "compare(s)");
+    SV_DIFF_CHECK(_run_([&] { return _sign_(h.compare(pos, count, n_ptr)); }),
+                  _run_([&] { return _sign_(rh.compare(pos, count, n_ptr)); }), "compare(pos, count, s)");
+    SV_DIFF_CHECK(_run_([&] { return _sign_(h.compare(pos, count, n_ptr, n_count)); }),
+                  _run_([&] { return _sign_(rh.compare(pos, count, n_ptr, n_count)); }),
+                  "compare(pos, count, s, count2)");
+    SV_DIFF_CHECK(h == n, rh == rn, "==");
+    SV_DIFF_CHECK(h != n, rh != rn, "!=");
+    SV_DIFF_CHECK(h < n, rh < rn, "<");
+    SV_DIFF_CHECK(h <= n, rh <= rn, "<=");
+    SV_DIFF_CHECK(h > n, rh > rn, ">");
+    SV_DIFF_CHECK(h >= n, rh >= rn, ">=");
+    SV_DIFF_CHECK(h == n_ptr, rh == rn_ptr, "== s");
+    SV_DIFF_CHECK(n_ptr != h, rn_ptr != rh, "s !=");
+    SV_DIFF_CHECK(h.equals(n), rh == rn, "equals");
+
+    // Affixes and containment; the std answers are spelled with compare() and find() so C++14 has them too.
+    SV_DIFF_CHECK(h.starts_with(n), detail::_ref_starts_with_<CharT>(rh, rn), "starts_with(v)");
+    SV_DIFF_CHECK(h.starts_with(n_ptr), detail::_ref_starts_with_<CharT>(rh, rn_ptr), "starts_with(s)");
+    SV_DIFF_CHECK(h.starts_with(c), !rh.empty() && rh.front() == c, "starts_with(c)");
+    SV_DIFF_CHECK(h.ends_with(n), detail::_ref_ends_with_<CharT>(rh, rn), "ends_with(v)");
+    SV_DIFF_CHECK(h.ends_with(n_ptr), detail::_ref_ends_with_<CharT>(rh, rn_ptr), "ends_with(s)");
+    SV_DIFF_CHECK(h.ends_with(c), !rh.empty() && rh.back() == c, "ends_with(c)");
+    SV_DIFF_CHECK(h.contains(n), rh.find(rn) != reference::npos, "contains(v)");
+    SV_DIFF_CHECK(h.contains(c), rh.find(c) != reference::npos, "contains(c)");
+
+    // Search, every overload, from pos.
+    SV_DIFF_CHECK(h.find(n, pos), rh.find(rn, pos), "find(v)");
+    SV_DIFF_CHECK(h.find(c, pos), rh.find(c, pos), "find(c)");
+    SV_DIFF_CHECK(h.find(n_ptr, pos, n_count), rh.find(n_ptr, pos, n_count), "find(s, pos, count)");
+    SV_DIFF_CHECK(h.find(n_ptr, pos), rh.find(n_ptr, pos), "find(s)");
+    SV_DIFF_CHECK(h.find(lambda::basic_searcher<CharT>(n), pos), rh.find(rn, pos), "find(searcher)");
+    SV_DIFF_CHECK(h.rfind(n, pos), rh.rfind(rn, pos), "rfind(v)");
+    SV_DIFF_CHECK(h.rfind(n), rh.rfind(rn), "rfind(v, npos)");
+    SV_DIFF_CHECK(h.rfind(c, pos), rh.rfind(c, pos), "rfind(c)");
+    SV_DIFF_CHECK(h.rfind(n_ptr, pos, n_count), rh.rfind(n_ptr, pos, n_count), "rfind(s, pos, count)");
+    SV_DIFF_CHECK(h.rfind(n_ptr, pos), rh.rfind(n_ptr, pos), "rfind(s)");
+
+    const lambda::basic_char_set<CharT> set(n);
+    SV_DIFF_CHECK(h.find_first_of(n, pos), rh.find_first_of(rn, pos), "find_first_of(v)");
+    SV_DIFF_CHECK(h.find_first_of(c, pos), rh.find_first_of(c, pos), "find_first_of(c)");
+    SV_DIFF_CHECK(h.find_first_of(n_ptr, pos, n_count), rh.find_first_of(n_ptr, pos, n_count),
+                  "find_first_of(s, pos, count)");
+    SV_DIFF_CHECK(h.find_first_of(n_ptr, pos), rh.find_first_of(n_ptr, pos), "find_first_of(s)");
+    SV_DIFF_CHECK(h.find_first_of(set, pos), rh.find_first_of(rn, pos), "find_first_of(set)");
+    SV_DIFF_CHECK(h.find_last_of(n, pos), rh.find_last_of(rn, pos), "find_last_of(v)");
+    SV_DIFF_CHECK(h.find_last_of(n), rh.find_last_of(rn), "find_last_of(v, npos)");
+    SV_DIFF_CHECK(h.find_last_of(c, pos), rh.find_last_of(c, pos), "find_last_of(c)");
+    SV_DIFF_CHECK(h.find_last_of(n_ptr, pos, n_count), rh.find_last_of(n_ptr, pos, n_count),
+                  "find_last_of(s, pos, count)");
+    SV_DIFF_CHECK(h.find_last_of(n_ptr, pos), rh.find_last_of(n_ptr, pos), "find_last_of(s)");
+    SV_DIFF_CHECK(h.find_last_of(set, pos), rh.find_last_of(rn, pos), "find_last_of(set)");
+    SV_DIFF_CHECK(h.find_first_not_of(n, pos), rh.find_first_not_of(rn, pos), "find_first_not_of(v)");
+    SV_DIFF_CHECK(h.find_first_not_of(c, pos), rh.find_first_not_of(c, pos), "find_first_not_of(c)");
+    SV_DIFF_CHECK(h.find_first_not_of(n_ptr, pos, n_count), rh.find_first_not_of(n_ptr, pos, n_count),
+                  "find_first_not_of(s, pos, count)");
+    SV_DIFF_CHECK(h.find_first_not_of(n_ptr, pos), rh.find_first_not_of(n_ptr, pos), "find_first_not_of(s)");
+    SV_DIFF_CHECK(h.find_first_not_of(set, pos), rh.find_first_not_of(rn, pos), "find_first_not_of(set)");
+    SV_DIFF_CHECK(h.find_last_not_of(n, pos), rh.find_last_not_of(rn, pos), "find_last_not_of(v)");
+    SV_DIFF_CHECK(h.find_last_not_of(n), rh.find_last_not_of(rn), "find_last_not_of(v, npos)");
+    SV_DIFF_CHECK(h.find_last_not_of(c, pos), rh.find_last_not_of(c, pos), "find_last_not_of(c)");
+    SV_DIFF_CHECK(h.find_last_not_of(n_ptr, pos, n_count), rh.find_last_not_of(n_ptr, pos, n_count),
+                  "find_last_not_of(s, pos, count)");
+    SV_DIFF_CHECK(h.find_last_not_of(n_ptr, pos), rh.find_last_not_of(n_ptr, pos), "find_last_not_of(s)");
+    SV_DIFF_CHECK(h.find_last_not_of(set, pos), rh.find_last_not_of(rn, pos), "find_last_not_of(set)");
+
+    // Trimming by a set, against the first / last not-of positions of the oracle.
+    {
+        const size_t first = rh.find_first_not_of(rn);
+        const size_t last = rh.find_last_not_of(rn);
+        SV_DIFF_CHECK(_units_(h.trim(n)),
+                      first == reference::npos ? std::basic_string<CharT>()
+                                               : _units_<CharT>(reference(rh.substr(first, last - first + 1))),
+                      "trim(chars)");
+    }
+
+    // Split at the first needle unit, against a find() loop of the oracle.
+    {
+        std::vector<std::basic_string<CharT>> fields;
+        for (const view field : lambda::split(h, c))
+        {
+            fields.push_back(_units_(field));
+        }
+        std::vector<std::basic_string<CharT>> expected;
+        size_t begin = 0;
+        for (size_t at; (at = rh.find(c, begin)) != reference::npos; begin = at + 1)
+        {
+            expected.push_back(_units_<CharT>(reference(rh.substr(begin, at - begin))));
+        }
+        expected.push_back(_units_<CharT>(reference(rh.substr(begin))));
+        SV_DIFF_CHECK(fields, expected, "split(c)");
+    }
+
+    // Hashing depends on the units only, not on where they live.
+    {
+        const std::basic_string<CharT> copy(h.data(), h.size());
+        SV_DIFF_CHECK(lambda::hash_value(h), lambda::hash_value(view(copy.data(), copy.size())), "hash_value");
+    }
+    return std::string();
+}
+
+#undef SV_DIFF_CHECK
+
+namespace detail
+{
+
+template <typename CharT> inline std::string _check_typed_(const uint8_t *data, size_t size)
+{
+    // Few distinct units (NUL, the signed / unsigned edge and the all ones unit among them) make matches likely;
+    // raw mode maps each byte to the unit of the same value.
+    const CharT alphabet[] = {CharT('a'), CharT('b'), CharT('c'), CharT(0), CharT(0x7f), CharT(0x80),
+                              CharT(~CharT(0)), CharT('A')};
+    const bool raw = (data[0] & 4) != 0;
+
+    // Leading filler moves the haystack across vector alignments.
+    const size_t shift = data[4] % 32;
+    std::vector<CharT> buffer(shift, CharT('#'));
+    for (size_t i = header_size; i < size; ++i)
+    {
+        buffer.push_back(raw ? CharT(data[i]) : alphabet[data[i] % 8]);
+    }
+    const lambda::basic_str_view<CharT> all(buffer.data() + shift, buffer.size() - shift);
+
+    // The needle is either a slice of the haystack, so that it matches, or the tail of the input.
+    const size_t needle_size = (data[1] & 0x3f) < all.size() ? (data[1] & 0x3f) : all.size();
+    lambda::basic_str_view<CharT> h = all;
+    lambda::basic_str_view<CharT> n = all.last(needle_size);
+    if ((data[1] & 0x40) != 0)
+    {
+        const size_t at = data[2] % (all.size() - needle_size + 1);
+        n = all.unchecked_substr(at, needle_size);
+    }
+    else
+    {
+        h = all.first(all.size() - needle_size);
+    }
+
+    const size_t npos = lambda::basic_str_view<CharT>::npos;
+    const size_t pos = data[2] == 0xff ? npos : data[2] % (h.size() + 2);
+    const size_t count = data[3] == 0xff ? npos : data[3] % (h.size() + 2);
+    return check_operations(h, n, pos, count);
+}
+
+} // namespace detail
+
+/// <summary>
+/// Decodes one fuzzer input and checks it; byte 0 selects the code unit type and the alphabet. Inputs shorter than
+/// the header are accepted and ignored.
+/// </summary>
+/// <returns>An empty string, or a description of the first mismatch.</returns>
+inline std::string check_input(const uint8_t *data, size_t size)
+{
+    if (size < header_size)
+    {
+        return std::string();
+    }
+    switch (data[0] & 3)
+    {
+    case 0:
+        return detail::_check_typed_<char>(data, size);
+    case 1:
+        return detail::_check_typed_<wchar_t>(data, size);
+    case 2:
+        return detail::_check_typed_<char16_t>(data, size);
+    default:
+        return detail::_check_typed_<char32_t>(data, size);
+    }
+}
+
+} // namespace sv_diff
+
+#endif
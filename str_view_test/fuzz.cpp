@@ -0,0 +1,45 @@
+// libFuzzer entry point for the differential check of differential.hpp: every basic_str_view operation against
+// std::basic_string_view on the decoded input, aborting on the first disagreement.
+//
+//     clang++ -std=c++17 -O1 -g -fsanitize=fuzzer,address,undefined str_view_test/fuzz.cpp -o sv_fuzz
+//     ./sv_fuzz -max_len=512 corpus/
+//
+// Without libFuzzer, -DLAMBDA_FUZZ_STANDALONE builds a main() that replays the files named on the command line, e.g.
+// the crash inputs libFuzzer wrote.
+
+#include "differential.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    const std::string mismatch = sv_diff::check_input(data, size);
+    if (!mismatch.empty())
+    {
+        std::fprintf(stderr, "str_view differs from the standard library: %s\n", mismatch.c_str());
+        std::abort();
+    }
+    return 0;
+}
+
+#if defined(LAMBDA_FUZZ_STANDALONE)
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::ifstream in(argv[i], std::ios::binary);
+        const std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size());
+    }
+    std::printf("%d inputs checked\n", argc - 1);
+    return 0;
+}
+
+#endif
@@ -1,6 +1,47 @@
+#include "../str_view/lambda/affix_set.hpp"
+#include "../str_view/lambda/batch.hpp"
+#include "../str_view/lambda/ci_traits.hpp"
+#include "../str_view/lambda/fixed_string.hpp"
+#include "../str_view/lambda/flat_str_map.hpp"
+#include "../str_view/lambda/instrument.hpp"
+#include "../str_view/lambda/intern_pool.hpp"
+#include "../str_view/lambda/mapped_file.hpp"
+#include "../str_view/lambda/multi_search.hpp"
+#include "../str_view/lambda/parallel.hpp"
+#include "../str_view/lambda/parse.hpp"
+#include "../str_view/lambda/perfect_hash.hpp"
+#include "../str_view/lambda/pipeline.hpp"
+#include "../str_view/lambda/record_reader.hpp"
+#include "../str_view/lambda/searcher.hpp"
+#include "../str_view/lambda/segmented_view.hpp"
+#include "../str_view/lambda/sort.hpp"
+#include "../str_view/lambda/split.hpp"
 #include "../str_view/lambda/str_view.hpp"
+#include "../str_view/lambda/utf8.hpp"
+#include "differential.hpp"
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 // Def. Ctor
 TEST(SV_Empty, SV_Ctor)
 {
@@ -25,3 +66,2070 @@ TEST(CppRefSV_Cpy, SV_Ctor)
 {
     // constexpr lambda::str_view wcstr_v("asdas");
 }
+
+// Ctor from a null-terminated string of every char type
+#define SV_X16 "0123456789abcdef"
+#define SV_X128 SV_X16 SV_X16 SV_X16 SV_X16 SV_X16 SV_X16 SV_X16 SV_X16
+#define SV_X512 SV_X128 SV_X128 SV_X128 SV_X128
+#define SV_X2048 SV_X512 SV_X512 SV_X512 SV_X512
+
+template <typename CharT> static void check_lengths()
+{
+    // Strings at every offset inside a cache line, so the aligned block loads start at every skew.
+    std::vector<CharT> buf(64 + 300 + 1, CharT('x'));
+    for (size_t offset = 0; offset < 64; ++offset)
+    {
+        for (size_t n = 0; n < 300; n += (n < 70 ? 1 : 37))
+        {
+            std::fill(buf.begin(), buf.end(), CharT('x'));
+            buf[offset + n] = CharT();
+            const CharT *s = buf.data() + offset;
+            EXPECT_EQ(lambda::simd::scalar::length(s), n);
+#if LAMBDA_SIMD_X86
+            EXPECT_EQ(lambda::simd::sse2::length(s), n);
+            if (lambda::simd::cpu_has_avx2())
+            {
+                EXPECT_EQ(lambda::simd::avx2::length(s), n);
+            }
+#endif
+            const lambda::basic_str_view<CharT> v(s);
+            EXPECT_EQ(v.size(), n);
+            EXPECT_EQ(v.data(), buf.data() + offset);
+        }
+    }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+template <typename CharT> static void check_lengths_at_page_end()
+{
+    // Strings ending right before an inaccessible page: the block loads must not touch it.
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    void *map = mmap(nullptr, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(map, MAP_FAILED);
+    char *bytes = static_cast<char *>(map);
+    ASSERT_EQ(mprotect(bytes + page, page, PROT_NONE), 0);
+    CharT *end = reinterpret_cast<CharT *>(bytes + page);
+    for (size_t n = 0; n < 200; ++n)
+    {
+        CharT *s = end - n - 1;
+        std::fill(s, end, CharT('x'));
+        end[-1] = CharT();
+        EXPECT_EQ(lambda::simd::scalar::length(s), n);
+#if LAMBDA_SIMD_X86
+        EXPECT_EQ(lambda::simd::sse2::length(s), n);
+        if (lambda::simd::cpu_has_avx2())
+        {
+            EXPECT_EQ(lambda::simd::avx2::length(s), n);
+        }
+#endif
+        EXPECT_EQ(lambda::basic_str_view<CharT>(s).size(), n);
+    }
+    munmap(map, 2 * page);
+}
+#endif
+
+TEST(SV_Length, SV_Ctor)
+{
+    constexpr lambda::str_view wcstr_v("asdas");
+    static_assert(wcstr_v.size() == 5, "");
+    static_assert(lambda::wstr_view(L"wide").size() == 4, "");
+    static_assert(lambda::u16str_view(u"wide").size() == 4, "");
+    static_assert(lambda::u32str_view(U"wide").size() == 4, "");
+    static_assert(lambda::str_view("").empty(), "");
+
+    // Far past the constexpr recursion depth the recursive version had.
+    static_assert(lambda::str_view(SV_X2048).size() == 2048, "");
+    static_assert(lambda::u32str_view(U"" SV_X2048).size() == 2048, "");
+
+    EXPECT_EQ(lambda::wstr_view(L"runtime").size(), 7u);
+    EXPECT_EQ(lambda::str_view(SV_X2048).size(), 2048u);
+
+    check_lengths<char>();
+    check_lengths<wchar_t>();
+    check_lengths<char16_t>();
+    check_lengths<char32_t>();
+#if defined(__unix__) || defined(__APPLE__)
+    check_lengths_at_page_end<char>();
+    check_lengths_at_page_end<wchar_t>();
+    check_lengths_at_page_end<char16_t>();
+    check_lengths_at_page_end<char32_t>();
+#endif
+}
+
+// unchecked slicing
+TEST(SV_Slice, SV_Ctor)
+{
+    using namespace lambda::sv_literals;
+
+    constexpr auto v = "key=value"_sv;
+    static_assert(v.unchecked_substr(4, 5) == "value"_sv, "");
+    static_assert(v.first(3) == "key"_sv && v.last(5) == "value"_sv, "");
+    static_assert(v.first(0).empty() && v.last(v.size()) == v, "");
+    static_assert(v.take(3) == "key"_sv && v.take(100) == v, "");
+    static_assert(v.drop(4) == "value"_sv && v.drop(100).empty(), "");
+    static_assert(v.split_at(3).first == "key"_sv && v.split_at(3).second == "=value"_sv, "");
+    static_assert(noexcept(v.take(1)) && noexcept(v.split_at(0)), "");
+    static_assert(v.rfind("e"_sv) == 8 && v.rfind("e"_sv, 7) == 1, "");
+
+    auto rest = v;
+    rest.remove_suffix(6);
+    EXPECT_EQ(rest, "key"_sv);
+    EXPECT_THROW(rest.remove_suffix(4), std::out_of_range);
+    EXPECT_THROW(rest.remove_prefix(4), std::out_of_range);
+    EXPECT_THROW(rest.substr(4), std::out_of_range);
+
+    // rfind is built on the unchecked slices; check it against std::string, including the empty needle.
+    const std::string hay = "abcabcab" + std::string(100, 'x') + "abcab";
+    const lambda::str_view h(hay);
+    const std::string long_run(26, 'x');
+    for (const char *needle : {"", "a", "ab", "abc", "bca", "cab", "xa", "abcabcab", "abd", long_run.c_str()})
+    {
+        for (size_t pos : {size_t(0), size_t(1), size_t(5), size_t(50), hay.size() - 1, hay.size(), std::string::npos})
+        {
+            EXPECT_EQ(h.rfind(needle, pos), hay.rfind(needle, pos)) << needle << " @ " << pos;
+        }
+    }
+    EXPECT_EQ(""_sv.rfind(""_sv), 0u);
+    EXPECT_EQ("ab"_sv.rfind(""_sv), 2u);
+    EXPECT_EQ("ab"_sv.rfind("abc"_sv), lambda::str_view::npos);
+    EXPECT_EQ(lambda::wstr_view(L"wide wide").rfind(L"wide"_sv), 5u);
+}
+
+// find(basic_str_view)
+TEST(SV_FindSubstr, SV_Search)
+{
+    using namespace lambda::sv_literals;
+
+    constexpr auto hay = "GET /index.html HTTP/1.1"_sv;
+    static_assert(hay.find("HTTP"_sv) == 16, "");
+    static_assert(hay.find("HTTP/2"_sv) == lambda::str_view::npos, "");
+
+    const std::string body = std::string(1000, 'a') + "needle" + std::string(100, 'a') + "needle";
+    const lambda::str_view v(body);
+
+    EXPECT_EQ(v.find("needle"_sv), 1000u);
+    EXPECT_EQ(v.find("needle"_sv, 1001), 1106u);
+    EXPECT_EQ(v.find("needle"_sv, 1107), lambda::str_view::npos);
+    EXPECT_EQ(v.find(""_sv, 5), 5u);
+    EXPECT_EQ(v.find("x"_sv), lambda::str_view::npos);
+    EXPECT_EQ("ab"_sv.find("abc"_sv), lambda::str_view::npos);
+
+    const std::u32string wide = U"0123456789abcdef0123456789abcdef!";
+    EXPECT_EQ(lambda::u32str_view(wide.data(), wide.size()).find(U"f!"_sv), 31u);
+}
+
+template <typename CharT> static void check_find_kernels()
+{
+    std::basic_string<CharT> hay;
+    for (int i = 0; i < 300; ++i)
+    {
+        hay.push_back(static_cast<CharT>('a' + (i * 7) % 5));
+    }
+
+    for (size_t m = 1; m < 40; ++m)
+    {
+        for (size_t at = 0; at + m <= hay.size(); at += 13)
+        {
+            const auto needle = hay.substr(at, m);
+            const size_t expected = lambda::simd::scalar::find(hay.data(), hay.size(), needle.data(), m);
+            EXPECT_EQ(hay.find(needle), expected);
+            EXPECT_EQ(lambda::simd::find_anchored(hay.data(), hay.size(), needle.data(), m, m / 2, m / 3), expected);
+#if LAMBDA_SIMD_X86
+            EXPECT_EQ(lambda::simd::sse2::find(hay.data(), hay.size(), needle.data(), m), expected);
+            EXPECT_EQ(lambda::simd::sse2::find_anchored(hay.data(), hay.size(), needle.data(), m, m - 1, 0), expected);
+            if (lambda::simd::cpu_has_avx2())
+            {
+                EXPECT_EQ(lambda::simd::avx2::find(hay.data(), hay.size(), needle.data(), m), expected);
+                EXPECT_EQ(lambda::simd::avx2::find_anchored(hay.data(), hay.size(), needle.data(), m, m / 2, m / 2),
+                          expected);
+            }
+#endif
+        }
+    }
+}
+
+TEST(SV_FindKernels, SV_Search)
+{
+    check_find_kernels<char>();
+    check_find_kernels<wchar_t>();
+    check_find_kernels<char16_t>();
+    check_find_kernels<char32_t>();
+}
+
+template <typename CharT> static void check_searcher(unsigned alphabet)
+{
+    using algo = lambda::search_algorithm;
+
+    std::mt19937 rng(alphabet);
+    for (int round = 0; round < 3000; ++round)
+    {
+        std::basic_string<CharT> hay(rng() % 200, CharT()), needle(1 + rng() % 12, CharT());
+        for (CharT &c : hay)
+        {
+            c = static_cast<CharT>('a' + rng() % alphabet);
+        }
+        for (CharT &c : needle)
+        {
+            c = static_cast<CharT>('a' + rng() % alphabet);
+        }
+        if (round % 3 == 0)
+        {
+            // Periodic needles exercise the memory of the two-way scan.
+            const auto unit = needle.substr(0, 1 + rng() % 3);
+            needle.clear();
+            while (needle.size() < 40)
+            {
+                needle += unit;
+            }
+            needle.resize(1 + rng() % 40);
+        }
+
+        const size_t pos = rng() % (hay.size() + 2);
+        const lambda::basic_str_view<CharT, std::char_traits<CharT>> view(hay.data(), hay.size());
+        for (algo a : {algo::automatic, algo::anchored, algo::horspool, algo::two_way})
+        {
+            const lambda::basic_searcher<CharT> searcher(needle.data(), needle.size(), a);
+            EXPECT_EQ(view.find(searcher, pos), hay.find(needle, pos)) << static_cast<int>(a);
+        }
+    }
+}
+
+// find(basic_searcher)
+TEST(SV_Searcher, SV_Search)
+{
+    using namespace lambda::sv_literals;
+    using algo = lambda::search_algorithm;
+
+    constexpr auto phrase = lambda::make_searcher("jukebox"_sv);
+    static_assert(phrase.algorithm() == algo::anchored && phrase.size() == 7, "");
+    static_assert("the jukebox of the"_sv.find(phrase) == 4, "");
+    static_assert("the jukebox"_sv.find(phrase, 5) == lambda::str_view::npos, "");
+    static_assert(!"the juke box"_sv.contains(phrase), "");
+
+    constexpr auto periodic = lambda::make_searcher("abababababababababababababababababababab"_sv);
+    static_assert(periodic.algorithm() == algo::two_way, "");
+    static_assert("xabababababababababababababababababababababc"_sv.find(periodic) == 1, "");
+
+    constexpr auto forced = lambda::make_searcher("ab"_sv, algo::two_way);
+    static_assert("aab"_sv.find(forced) == 1 && "aab"_sv.find(lambda::make_searcher(""_sv), 2) == 2, "");
+
+    // Letters are absent from a long run of digits, so Horspool jumps by nearly the whole needle over text.
+    std::string digits;
+    for (int i = 0; digits.size() < 200; ++i)
+    {
+        digits += std::to_string(i);
+    }
+    const auto numbers = lambda::make_searcher(lambda::str_view(digits));
+    EXPECT_EQ(numbers.algorithm(), algo::horspool);
+    EXPECT_EQ(lambda::str_view("x" + digits).find(numbers), 1u);
+
+    check_searcher<char>(2);
+    check_searcher<char>(4);
+    check_searcher<wchar_t>(26);
+    check_searcher<char16_t>(3);
+    check_searcher<char32_t>(2);
+}
+
+// find(CharT) / rfind(CharT)
+TEST(SV_FindChar, SV_Search)
+{
+    using namespace lambda::sv_literals;
+
+    constexpr auto line = "key=value;key2=value2"_sv;
+    static_assert(line.find('=') == 3, "");
+    static_assert(line.find('=', 4) == 14, "");
+    static_assert(line.rfind('=') == 14, "");
+    static_assert(line.rfind('=', 13) == 3, "");
+    static_assert(""_sv.rfind('=') == lambda::str_view::npos, "");
+
+    EXPECT_EQ(lambda::str_view().find('a'), lambda::str_view::npos);
+    EXPECT_EQ(line.find(';', 9), 9u);
+    EXPECT_EQ(line.find('#'), lambda::str_view::npos);
+    EXPECT_EQ(line.rfind('k', 0), 0u);
+    EXPECT_EQ(line.rfind('#'), lambda::str_view::npos);
+}
+
+template <typename CharT> static void check_char_kernels()
+{
+    const CharT ch = static_cast<CharT>('x');
+    for (size_t n = 0; n < 200; n += 7)
+    {
+        for (size_t at = 0; at <= n; ++at)
+        {
+            std::basic_string<CharT> hay(n, static_cast<CharT>('a'));
+            if (at < n)
+            {
+                hay[at] = ch;
+            }
+            const size_t first = at < n ? at : lambda::simd::npos;
+            EXPECT_EQ(lambda::simd::scalar::find_char(hay.data(), n, ch), first);
+            EXPECT_EQ(lambda::simd::scalar::rfind_char(hay.data(), n, ch), first);
+#if LAMBDA_SIMD_X86
+            EXPECT_EQ(lambda::simd::sse2::find_char(hay.data(), n, ch), first);
+            EXPECT_EQ(lambda::simd::sse2::rfind_char(hay.data(), n, ch), first);
+            if (lambda::simd::cpu_has_avx2())
+            {
+                EXPECT_EQ(lambda::simd::avx2::find_char(hay.data(), n, ch), first);
+                EXPECT_EQ(lambda::simd::avx2::rfind_char(hay.data(), n, ch), first);
+            }
+#endif
+            const lambda::basic_str_view<CharT> v(hay.data(), n);
+            EXPECT_EQ(v.find(ch), hay.find(ch));
+            EXPECT_EQ(v.rfind(ch), hay.rfind(ch));
+        }
+    }
+}
+
+TEST(SV_FindCharKernels, SV_Search)
+{
+    check_char_kernels<char>();
+    check_char_kernels<wchar_t>();
+    check_char_kernels<char16_t>();
+    check_char_kernels<char32_t>();
+}
+
+// find_first_of / find_last_of / *_not_of
+TEST(SV_FindOf, SV_Search)
+{
+    using namespace lambda::sv_literals;
+
+    constexpr lambda::char_set ws(" \t\r\n"_sv);
+    static_assert(ws.contains('\t') && !ws.contains('a'), "");
+
+    constexpr auto line = "  key = value \r\n"_sv;
+    static_assert(line.find_first_not_of(ws) == 2, "");
+    static_assert(line.find_last_not_of(ws) == 12, "");
+    static_assert(line.find_first_of("=;"_sv) == 6, "");
+    static_assert(line.find_last_of(ws, 11) == 7, "");
+
+    EXPECT_EQ(line.find_first_of(ws, 2), 5u);
+    EXPECT_EQ(line.find_last_of(ws), 15u);
+    EXPECT_EQ(line.find_first_of("#;!"), lambda::str_view::npos);
+    EXPECT_EQ(line.find_first_not_of(""_sv, 3), 3u);
+    EXPECT_EQ(""_sv.find_last_of(ws), lambda::str_view::npos);
+
+    const std::u16string wide = u"aéb中c";
+    const lambda::u16str_view wv(wide.data(), wide.size());
+    const lambda::u16char_set wide_set(u"中é"_sv);
+    EXPECT_EQ(wv.find_first_of(wide_set), 1u);
+    EXPECT_EQ(wv.find_last_of(wide_set), 3u);
+    EXPECT_EQ(wv.find_last_not_of(wide_set, 3), 2u);
+}
+
+TEST(SV_FindOfKernels, SV_Search)
+{
+    std::string hay;
+    for (int i = 0; i < 700; ++i)
+    {
+        hay.push_back(static_cast<char>((i * 131 + 7) & 0xff));
+    }
+    const std::string sets[] = {"", "a", "\x80\xff", "0123456789", std::string("\0 \t", 3), hay.substr(0, 200)};
+
+    for (const auto &chars : sets)
+    {
+        const lambda::char_set set(chars.data(), chars.size());
+        for (size_t pos = 0; pos <= hay.size(); pos += 37)
+        {
+            const lambda::str_view v(hay);
+            EXPECT_EQ(v.find_first_of(set, pos), hay.find_first_of(chars, pos));
+            EXPECT_EQ(v.find_first_not_of(set, pos), hay.find_first_not_of(chars, pos));
+            EXPECT_EQ(v.find_last_of(set, pos), hay.find_last_of(chars, pos));
+            EXPECT_EQ(v.find_last_not_of(set, pos), hay.find_last_not_of(chars, pos));
+            EXPECT_EQ(v.find_first_of(lambda::str_view(chars), pos), hay.find_first_of(chars, pos));
+            EXPECT_EQ(v.find_last_not_of(lambda::str_view(chars), pos), hay.find_last_not_of(chars, pos));
+        }
+    }
+}
+
+// split
+static constexpr size_t count_tokens(lambda::str_view s, char delim, lambda::split_mode mode)
+{
+    size_t n = 0;
+    for (auto token : lambda::split(s, delim, mode))
+    {
+        n += token.size() > 0 ? 1 : 0;
+        n += 100;
+    }
+    return n;
+}
+
+TEST(SV_Split, SV_Split)
+{
+    using namespace lambda::sv_literals;
+
+    static_assert(count_tokens("a,b,,c"_sv, ',', lambda::split_mode::keep_empty) == 403, "");
+    static_assert(count_tokens("a,b,,c"_sv, ',', lambda::split_mode::skip_empty) == 303, "");
+    static_assert(count_tokens(""_sv, ',', lambda::split_mode::keep_empty) == 100, "");
+    static_assert(count_tokens(",,"_sv, ',', lambda::split_mode::skip_empty) == 0, "");
+
+    std::vector<std::string> tokens;
+    for (auto token : lambda::split("GET /index.html HTTP/1.1"_sv, ' '))
+    {
+        tokens.push_back(token.to_string(std::allocator<char>()));
+    }
+    EXPECT_EQ(tokens, (std::vector<std::string>{"GET", "/index.html", "HTTP/1.1"}));
+
+    tokens.clear();
+    for (auto token : lambda::split("a: 1\r\nb: 2\r\n\r\n"_sv, "\r\n"_sv, lambda::split_mode::skip_empty))
+    {
+        tokens.push_back(token.to_string(std::allocator<char>()));
+    }
+    EXPECT_EQ(tokens, (std::vector<std::string>{"a: 1", "b: 2"}));
+
+    tokens.clear();
+    for (auto token : lambda::split("k=v=w"_sv, '=', lambda::split_mode::keep_empty, 1))
+    {
+        tokens.push_back(token.to_string(std::allocator<char>()));
+    }
+    EXPECT_EQ(tokens, (std::vector<std::string>{"k", "v=w"}));
+
+    const auto range = lambda::split("x;y"_sv, ";");
+    EXPECT_EQ(std::distance(range.begin(), range.end()), 2);
+    EXPECT_EQ((++range.begin())->compare("y"_sv), 0);
+}
+
+// hash
+TEST(SV_Hash, SV_Hash)
+{
+    using namespace lambda::sv_literals;
+
+    constexpr uint64_t content_type = lambda::hash_value("content-type"_sv);
+    constexpr uint64_t wide_key = lambda::hash_value(u"content-type"_sv);
+    static_assert(content_type != lambda::hash_value("content-length"_sv), "");
+
+    const std::string runtime_key = "content-type";
+    EXPECT_EQ(lambda::hash_value(lambda::str_view(runtime_key)), content_type);
+    EXPECT_EQ(lambda::hash_value(u"content-type"_sv), wide_key);
+    EXPECT_NE(lambda::hash_value("content-type"_sv, 42), content_type);
+
+    // Every length class of the algorithm, compile time vs runtime reader.
+    std::string data;
+    for (size_t n = 0; n < 200; ++n)
+    {
+        const uint64_t expected =
+            lambda::hashing::detail::_wyhash_(lambda::hashing::detail::_unit_reader_<char>{data.data()}, n, 7);
+        EXPECT_EQ(lambda::hashing::wyhash(data.data(), n, 7), expected);
+        data.push_back(static_cast<char>(n * 37));
+    }
+    const std::u32string wide(100, U'\x1F600');
+    EXPECT_EQ(lambda::hashing::wyhash(wide.data(), wide.size()),
+              lambda::hashing::detail::_wyhash_(lambda::hashing::detail::_unit_reader_<char32_t>{wide.data()},
+                                                wide.size() * 4, 0));
+
+    std::unordered_map<lambda::str_view, int> headers;
+    headers["host"_sv] = 1;
+    headers["accept"_sv] = 2;
+    EXPECT_EQ(headers.count("accept"_sv), 1u);
+    EXPECT_EQ(headers.count("accept-encoding"_sv), 0u);
+    EXPECT_EQ(headers.at("host"_sv), 1);
+    EXPECT_EQ(std::hash<lambda::str_view>()("host"_sv), static_cast<size_t>(lambda::hash_value("host"_sv)));
+}
+
+// perfect hash
+TEST(SV_PerfectHash, SV_Hash)
+{
+    using namespace lambda::sv_literals;
+
+    static constexpr lambda::str_view header_names[] = {
+        "accept"_sv,         "accept-encoding"_sv, "accept-language"_sv, "authorization"_sv, "cache-control"_sv,
+        "connection"_sv,     "content-length"_sv,  "content-type"_sv,    "cookie"_sv,        "date"_sv,
+        "etag"_sv,           "expect"_sv,          "host"_sv,            "if-match"_sv,      "if-none-match"_sv,
+        "last-modified"_sv,  "location"_sv,        "origin"_sv,          "pragma"_sv,        "range"_sv,
+        "referer"_sv,        "server"_sv,          "set-cookie"_sv,      "te"_sv,            "trailer"_sv,
+        "transfer-encoding"_sv, "upgrade"_sv,      "user-agent"_sv,      "vary"_sv,          "via"_sv};
+
+    constexpr auto headers = lambda::make_perfect_hash(header_names);
+    static_assert(headers.size() == 30, "");
+
+    for (size_t i = 0; i < headers.size(); ++i)
+    {
+        const std::string probe = header_names[i].to_string(std::allocator<char>());
+        EXPECT_EQ(headers.find(lambda::str_view(probe)), i);
+        EXPECT_EQ(headers[i], header_names[i]);
+    }
+    EXPECT_EQ(headers.find("x-forwarded-for"_sv), headers.npos);
+    EXPECT_EQ(headers.find(""_sv), headers.npos);
+    EXPECT_FALSE(headers.contains("Host"_sv));
+
+    enum class method
+    {
+        get,
+        head,
+        post,
+        unknown
+    };
+    constexpr auto methods = lambda::make_perfect_hash("GET"_sv, "HEAD"_sv, "POST"_sv);
+    EXPECT_EQ(methods.find_as("POST"_sv, method::unknown), method::post);
+    EXPECT_EQ(methods.find_as("PUT"_sv, method::unknown), method::unknown);
+
+    const lambda::str_view duplicates[] = {"a"_sv, "b"_sv, "a"_sv};
+    EXPECT_THROW(lambda::make_perfect_hash(duplicates), std::invalid_argument);
+}
+
+// equals / compare / relational operators
+TEST(SV_Compare, SV_Compare)
+{
+    using namespace lambda::sv_literals;
+
+    static_assert("abc"_sv == "abc"_sv && "abc"_sv != "abd"_sv, "");
+    static_assert("abc"_sv < "abd"_sv && "ab"_sv < "abc"_sv && !("abc"_sv < "abc"_sv), "");
+    static_assert("b"_sv > "abc"_sv && "abc"_sv >= "abc"_sv && "abc"_sv <= "abd"_sv, "");
+    static_assert("abc"_sv.compare("abd"_sv) < 0 && "abd"_sv.compare("abc"_sv) > 0, "");
+
+    const std::string abc = "abc";
+    EXPECT_TRUE("abc"_sv == abc && abc == "abc"_sv && "abc"_sv == "abc" && "abc" == "abc"_sv);
+    EXPECT_TRUE("abd"_sv != abc && abc != "abd"_sv && "abd"_sv != "abc" && "abc" != "abd"_sv);
+    EXPECT_TRUE("abb"_sv < abc && abc < "abd"_sv && "abb"_sv < "abc" && "abb" < "abc"_sv);
+    EXPECT_TRUE("abc"_sv <= abc && abc <= "abd"_sv && "abc"_sv <= "abc" && "abc" <= "abd"_sv);
+    EXPECT_TRUE("abd"_sv > abc && abc > "abb"_sv && "abd"_sv > "abc" && "abd" > "abc"_sv);
+    EXPECT_TRUE("abc"_sv >= abc && abc >= "abb"_sv && "abc"_sv >= "abc" && "abd" >= "abc"_sv);
+    EXPECT_FALSE("abc"_sv == "abcd"_sv);
+    EXPECT_TRUE(lambda::str_view() == ""_sv);
+}
+
+TEST(SV_EqualsKernel, SV_Compare)
+{
+    std::string a;
+    for (size_t n = 0; n < 80; ++n)
+    {
+        std::string b = a;
+        EXPECT_TRUE(lambda::simd::equal_bytes(a.data(), b.data(), n));
+        EXPECT_TRUE(lambda::str_view(a).equals(lambda::str_view(b)));
+        for (size_t i = 0; i < n; ++i)
+        {
+            b[i] ^= 0x20;
+            EXPECT_FALSE(lambda::simd::equal_bytes(a.data(), b.data(), n)) << n << " " << i;
+            EXPECT_NE(lambda::str_view(a), lambda::str_view(b));
+            b[i] ^= 0x20;
+        }
+        a.push_back(static_cast<char>('a' + n % 26));
+    }
+
+    const std::u16string w0 = u"0123456789abcdefghij", w1 = u"0123456789abcdefghiJ";
+    EXPECT_FALSE(lambda::u16str_view(w0.data(), w0.size()) == lambda::u16str_view(w1.data(), w1.size()));
+    EXPECT_TRUE(lambda::u16str_view(w0.data(), w0.size()) > lambda::u16str_view(w1.data(), w1.size()));
+}
+
+static int brute_ci_compare(const std::string &a, const std::string &b)
+{
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        const int x = std::tolower(static_cast<unsigned char>(a[i]));
+        const int y = std::tolower(static_cast<unsigned char>(b[i]));
+        if (x != y)
+        {
+            return x < y ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+TEST(SV_CaseInsensitive, SV_Compare)
+{
+    using namespace lambda::sv_literals;
+
+    static_assert(lambda::ci_str_view("Content-Type") == "content-TYPE", "");
+    static_assert(lambda::ci_str_view("ABC") < "abd" && lambda::ci_str_view("[") < "Z", "");
+    static_assert(lambda::ci_str_view("X-Forwarded-For").starts_with("x-forwarded"), "");
+    static_assert(lambda::ci_str_view("Accept: TEXT/HTML").find("text") == 8, "");
+    static_assert(lambda::hash_value(lambda::ci_str_view("HoSt")) == lambda::hash_value("host"_sv), "");
+
+    // Every length around the block sizes, every mismatch position, for the dispatcher and each kernel.
+    std::mt19937 rng(18);
+    const std::string alphabet = "aAzZ@[`{09-_\x80\xC3";
+    for (size_t n = 0; n < 80; ++n)
+    {
+        std::string a(n, ' ');
+        for (char &c : a)
+        {
+            c = alphabet[rng() % alphabet.size()];
+        }
+        for (size_t i = 0; i <= n; ++i)
+        {
+            std::string b = a;
+            for (size_t k = 0; k < n; ++k)
+            {
+                const int c = static_cast<unsigned char>(b[k]);
+                b[k] = static_cast<char>(std::isupper(c) ? std::tolower(c) : std::toupper(c));
+            }
+            if (i < n)
+            {
+                b[i] = alphabet[rng() % alphabet.size()];
+            }
+            const int expect = brute_ci_compare(a, b);
+            const int got = lambda::ci_char_traits<char>::compare(a.data(), b.data(), n);
+            EXPECT_EQ(got, expect) << n << " " << i;
+
+            const auto *pa = reinterpret_cast<const unsigned char *>(a.data());
+            const auto *pb = reinterpret_cast<const unsigned char *>(b.data());
+            const size_t mismatch = lambda::simd::scalar::ci_mismatch(pa, pb, n);
+            EXPECT_EQ(mismatch == n, expect == 0);
+            EXPECT_EQ(lambda::simd::ci_mismatch(pa, pb, n), mismatch);
+#if LAMBDA_SIMD_X86
+            EXPECT_EQ(lambda::simd::sse2::ci_mismatch(pa, pb, n), mismatch);
+            if (lambda::simd::cpu_has_avx2())
+            {
+                EXPECT_EQ(lambda::simd::avx2::ci_mismatch(pa, pb, n), mismatch);
+            }
+#endif
+            EXPECT_EQ(lambda::as_ci(lambda::str_view(a)) == lambda::as_ci(lambda::str_view(b)), expect == 0);
+        }
+        for (const char c : alphabet)
+        {
+            size_t expect = lambda::simd::npos;
+            for (size_t k = 0; k < n && expect == lambda::simd::npos; ++k)
+            {
+                expect = std::tolower(static_cast<unsigned char>(a[k])) == std::tolower(static_cast<unsigned char>(c))
+                             ? k
+                             : expect;
+            }
+            const auto *pa = reinterpret_cast<const unsigned char *>(a.data());
+            const auto uc = static_cast<unsigned char>(c);
+            EXPECT_EQ(lambda::simd::ci_find_char(pa, n, uc), expect);
+            EXPECT_EQ(lambda::simd::scalar::ci_find_char(pa, n, uc), expect);
+#if LAMBDA_SIMD_X86
+            EXPECT_EQ(lambda::simd::sse2::ci_find_char(pa, n, uc), expect);
+            if (lambda::simd::cpu_has_avx2())
+            {
+                EXPECT_EQ(lambda::simd::avx2::ci_find_char(pa, n, uc), expect);
+            }
+#endif
+            EXPECT_EQ(lambda::as_ci(lambda::str_view(a)).find(c),
+                      expect == lambda::simd::npos ? lambda::str_view::npos : expect);
+        }
+    }
+
+    // Zero-copy header lookup.
+    const std::string request = "GET / HTTP/1.1\r\nHost: example.com\r\nCONTENT-LENGTH: 12\r\nAccept: */*\r\n";
+    const lambda::ci_str_view head(request.data(), request.size());
+    EXPECT_EQ(head.find("content-length:"_sv.data()), request.find("CONTENT-LENGTH:"));
+    EXPECT_EQ(head.find("\r\nhOsT:"), request.find("\r\nHost:"));
+    EXPECT_EQ(head.find("accept-encoding"), head.npos);
+
+    std::unordered_map<lambda::ci_str_view, int> headers;
+    headers["Content-Length"] = 1;
+    headers["Accept"] = 2;
+    EXPECT_EQ(headers.count("content-length"), 1u);
+    EXPECT_EQ(headers.at("ACCEPT"), 2);
+    EXPECT_EQ(headers.count("Host"), 0u);
+    EXPECT_EQ(std::hash<lambda::ci_str_view>()("ACCEPT"), std::hash<lambda::str_view>()("accept"));
+
+    // Simple folding for the wide views; 1 byte units stay ASCII.
+    using u16fold = lambda::basic_ci_str_view<char16_t, lambda::case_fold::simple>;
+    static_assert(u16fold(u"\u0394\u0399\u039A\u0397 \u00C9T\u00C9") == u"\u03B4\u03B9\u03BA\u03B7 \u00E9t\u00E9",
+                  "");
+    static_assert(u16fold(u"\u0416\u0401\u0179\u212A") == u"\u0436\u0451\u017Ak", "");
+    static_assert(u16fold(u"\u03A3").find(u'\u03C2') == 0 && u16fold(u"\u00D7") != u"\u00F7", "");
+    static_assert(lambda::u16ci_str_view(u"\u00C9") != u"\u00E9" && lambda::u16ci_str_view(u"AB") == u"ab", "");
+    static_assert(lambda::basic_ci_str_view<char, lambda::case_fold::simple>("\xC3\x89") != "\xC3\xA9", "");
+}
+
+template <typename T> static void check_parse_float(const std::string &s)
+{
+    char *end = nullptr;
+    const T expect = sizeof(T) == sizeof(double) ? static_cast<T>(std::strtod(s.c_str(), &end))
+                                                 : static_cast<T>(std::strtof(s.c_str(), &end));
+    const auto r = lambda::parse<T>(lambda::str_view(s));
+    ASSERT_EQ(r.consumed, static_cast<size_t>(end - s.c_str())) << s;
+    if (std::isnan(expect))
+    {
+        EXPECT_TRUE(std::isnan(r.value)) << s;
+        return;
+    }
+    EXPECT_EQ(std::memcmp(&r.value, &expect, sizeof(T)), 0) << s << " " << r.value << " " << expect;
+    const bool overflow = std::isinf(expect) && !lambda::as_ci(lambda::str_view(s)).contains("inf");
+    EXPECT_EQ(r.ec, end == s.c_str() ? std::errc::invalid_argument
+                                     : (overflow ? std::errc::result_out_of_range : std::errc()));
+}
+
+TEST(SV_Parse, SV_Convert)
+{
+    using namespace lambda::sv_literals;
+
+    static_assert(lambda::parse<int>("-42"_sv).value == -42 && lambda::parse<int>("-42"_sv).consumed == 3, "");
+    static_assert(lambda::parse<uint64_t>("18446744073709551615"_sv).value == 18446744073709551615ull, "");
+    static_assert(lambda::parse<unsigned>("-1"_sv).ec == std::errc::invalid_argument, "");
+    static_assert(lambda::parse<int8_t>("-129"_sv).ec == std::errc::result_out_of_range, "");
+    static_assert(lambda::parse<int8_t>("-128"_sv).value == -128, "");
+    static_assert(lambda::parse<uint8_t>("0255x"_sv).value == 255 && lambda::parse<uint8_t>("0255x"_sv).consumed == 4,
+                  "");
+    static_assert(lambda::parse<int>("7fffFFFF"_sv, 16).value == 0x7fffffff && !lambda::parse<int>("1"_sv, 37), "");
+    static_assert(lambda::parse<int>(u"123456789"_sv).value == 123456789, "");
+
+    // Every width around its limits, with and without the SWAR blocks.
+    std::mt19937_64 rng(19);
+    for (int k = 0; k < 20000; ++k)
+    {
+        const uint64_t u = rng() >> (rng() % 64);
+        const int64_t i = static_cast<int64_t>(u) * (k % 2 ? -1 : 1);
+        const std::string us = (k % 3 == 0 ? "000" : "") + std::to_string(u) + (k % 5 == 0 ? "x" : "");
+        const std::string is = std::to_string(i);
+
+        const auto r64 = lambda::parse<uint64_t>(lambda::str_view(us));
+        EXPECT_TRUE(r64 && r64.value == u && r64.consumed == us.size() - (k % 5 == 0)) << us;
+        EXPECT_EQ(lambda::parse<int64_t>(lambda::str_view(is)).value, i);
+
+        const auto r32 = lambda::parse<int32_t>(lambda::str_view(is));
+        const bool fits32 = i >= INT32_MIN && i <= INT32_MAX;
+        EXPECT_EQ(r32.ec, fits32 ? std::errc() : std::errc::result_out_of_range) << is;
+        EXPECT_EQ(r32.value, fits32 ? i : 0);
+        EXPECT_EQ(r32.consumed, is.size());
+
+        const auto r16 = lambda::parse<uint16_t>(lambda::str_view(us));
+        EXPECT_EQ(static_cast<bool>(r16), u <= 0xffff) << us;
+    }
+    EXPECT_EQ(lambda::parse<uint64_t>("18446744073709551616"_sv).ec, std::errc::result_out_of_range);
+    EXPECT_EQ(lambda::parse<int64_t>("-9223372036854775808"_sv).value, INT64_MIN);
+    EXPECT_EQ(lambda::parse<int64_t>("9223372036854775808"_sv).ec, std::errc::result_out_of_range);
+    EXPECT_EQ(lambda::parse<int>(""_sv).ec, std::errc::invalid_argument);
+    EXPECT_EQ(lambda::parse<int>("-"_sv).consumed, 0u);
+    EXPECT_EQ(lambda::parse<int>("+1"_sv).ec, std::errc::invalid_argument);
+
+    // Floats against strtod: syntax corners, limits, halfway points with long expansions, random bit patterns.
+    for (const char *s : {"0", "-0", "1.5", ".5", "5.", ".", "-", "-.", "1e", "1e+", "1e-5x", "1E5", "inf", "-Infinity",
+                          "infinit", "nan", "-NaN(chars_1)", "nan(", "1.7976931348623157e308", "1.7976931348623159e308",
+                          "1e309", "-1e309", "4.9e-324", "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-400",
+                          "2.2250738585072011e-308", "9007199254740993", "9007199254740992.000000000000000000001",
+                          "123456789012345678901234567890e-10", "0.0000000000000000000000000000012345", "3.4028235e38",
+                          "3.4028236e38", "7e-46", "1e999999999999999999", "00000000000000000000000001.25e0000001"})
+    {
+        check_parse_float<double>(s);
+        check_parse_float<float>(s);
+    }
+    char buffer[1100];
+    for (int k = 0; k < 20000; ++k)
+    {
+        const uint64_t bits = rng();
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+        if (std::isfinite(d))
+        {
+            std::snprintf(buffer, sizeof(buffer), k % 2 ? "%.17g" : "%.16g", d);
+            check_parse_float<double>(buffer);
+        }
+        float f;
+        const uint32_t bits32 = static_cast<uint32_t>(bits);
+        std::memcpy(&f, &bits32, sizeof(f));
+        if (std::isfinite(f))
+        {
+            std::snprintf(buffer, sizeof(buffer), "%.9g", f);
+            check_parse_float<float>(buffer);
+        }
+
+        // The exact midpoint between two doubles needs many digits and must round to even.
+        const double a = std::fabs(d) < 1e300 && std::isfinite(d) ? std::fabs(d) : 1.0;
+        const double b = std::nextafter(a, INFINITY);
+        std::snprintf(buffer, sizeof(buffer), "%.*e", 30 + k % 800, a / 2 + b / 2 == a ? a : a / 2 + b / 2);
+        check_parse_float<double>(buffer);
+    }
+
+    const std::u32string wide = U"-2.5e3 ";
+    EXPECT_EQ(lambda::parse<double>(lambda::u32str_view(wide.data(), wide.size())).value, -2500.0);
+}
+
+// intern pool
+TEST(SV_InternPool, SV_Intern)
+{
+    using namespace lambda::sv_literals;
+
+    lambda::intern_pool pool(16);
+    const std::string a = "trace_id", b = "trace_id";
+
+    const auto ia = pool.intern(lambda::str_view(a));
+    const auto ib = pool.intern(lambda::str_view(b));
+    EXPECT_TRUE(lambda::intern_pool::same(ia, ib));
+    EXPECT_NE(ia.data(), a.data());
+    EXPECT_EQ(ia, "trace_id"_sv);
+    EXPECT_EQ(ia.data()[ia.size()], '\0');
+
+    EXPECT_EQ(pool.find("span_id"_sv).data(), nullptr);
+    const auto span = pool.intern("span_id"_sv);
+    EXPECT_FALSE(lambda::intern_pool::same(ia, span));
+    EXPECT_TRUE(lambda::intern_pool::same(pool.find("span_id"_sv), span));
+    EXPECT_TRUE(lambda::intern_pool::same(pool.intern(""_sv), pool.intern(lambda::str_view())));
+    EXPECT_EQ(pool.size(), 3u);
+
+    std::vector<std::string> names;
+    for (int i = 0; i < 2000; ++i)
+    {
+        names.push_back("field_" + std::to_string(i));
+    }
+
+    std::vector<std::vector<const char *>> seen(4);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < seen.size(); ++t)
+    {
+        workers.emplace_back([&, t] {
+            for (size_t i = 0; i < names.size(); ++i)
+            {
+                const auto &name = names[(i * (t + 1)) % names.size()];
+                seen[t].push_back(pool.intern(lambda::str_view(name)).data());
+            }
+        });
+    }
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+
+    EXPECT_EQ(pool.size(), names.size() + 3);
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        const auto canonical = pool.find(lambda::str_view(names[i]));
+        EXPECT_EQ(canonical, lambda::str_view(names[i]));
+        EXPECT_EQ(seen[0][i], canonical.data());
+    }
+}
+
+TEST(SV_Materialize, SV_Arena)
+{
+    const lambda::str_view sv("materialize me");
+
+    char buf[32] = {};
+    EXPECT_EQ(sv.copy(buf, 5), 5u);
+    EXPECT_EQ(lambda::str_view(buf, 5), "mater");
+    EXPECT_EQ(sv.copy(buf, 100, 12), 2u);
+    EXPECT_EQ(lambda::str_view(buf, 2), "me");
+    EXPECT_EQ(sv.copy(buf, 4, sv.size()), 0u);
+    EXPECT_THROW(sv.copy(buf, 1, sv.size() + 1), std::out_of_range);
+
+    lambda::monotonic_arena arena(64);
+    std::vector<lambda::str_view> copies;
+    std::string source;
+    for (int i = 0; i < 100; ++i)
+    {
+        source = "record_" + std::to_string(i);
+        copies.push_back(lambda::str_view(source).materialize(arena));
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(copies[i], lambda::str_view("record_" + std::to_string(i)));
+        EXPECT_EQ(copies[i].data()[copies[i].size()], '\0');
+    }
+
+    const auto w = lambda::wstr_view(L"wide", 4).materialize(arena);
+    EXPECT_EQ(w, lambda::wstr_view(L"wide", 4));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(w.data()) % alignof(wchar_t), 0u);
+    EXPECT_TRUE(lambda::str_view().materialize(arena).empty());
+
+    // A reset rewinds into the blocks that are already there.
+    const size_t capacity = arena.capacity();
+    EXPECT_GT(arena.used(), 0u);
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+    for (int i = 0; i < 100; ++i)
+    {
+        lambda::str_view("record_" + std::to_string(i)).materialize(arena);
+    }
+    EXPECT_EQ(arena.capacity(), capacity);
+
+    char *big = arena.allocate_array<char>(1000);
+    EXPECT_NE(big, nullptr);
+    arena.release();
+    EXPECT_EQ(arena.capacity(), 0u);
+
+    // Aligning the cursor can move it past the end of the block; that allocation must go to a new block.
+    lambda::monotonic_arena tail(1000);
+    std::memset(tail.allocate(993, 1), 1, 993);
+    void *aligned = tail.allocate(8, 16);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 16, 0u);
+    std::memset(aligned, 2, 8);
+    lambda::monotonic_arena mixed;
+    std::memset(mixed.allocate(70001, 1), 3, 70001);
+    std::memset(mixed.allocate(4, 16), 4, 4);
+    std::mt19937 rng(9);
+    for (int i = 0; i < 2000; ++i)
+    {
+        const size_t align = size_t(1) << (rng() % 7);
+        const size_t bytes = 1 + rng() % 200;
+        void *p = tail.allocate(bytes, align);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % align, 0u);
+        std::memset(p, 5, bytes);
+    }
+}
+
+// Every occurrence of every needle by brute force, ordered like find_all()
+template <typename CharT>
+static std::vector<lambda::multi_match> brute_matches(const std::basic_string<CharT> &hay,
+                                                      const std::vector<std::basic_string<CharT>> &needles)
+{
+    std::vector<lambda::multi_match> all;
+    for (size_t pos = 0; pos < hay.size(); ++pos)
+    {
+        for (size_t k = 0; k < needles.size(); ++k)
+        {
+            if (hay.compare(pos, needles[k].size(), needles[k]) == 0)
+            {
+                all.push_back(lambda::multi_match{pos, k});
+            }
+        }
+    }
+    return all;
+}
+
+template <typename CharT> static void check_multi_matcher(size_t needle_count)
+{
+    using view = lambda::basic_str_view<CharT>;
+
+    std::mt19937 rng(static_cast<unsigned>(needle_count));
+    // A small alphabet with one unit above 0xff, so the wide automaton sees multi-byte units.
+    const CharT alphabet[] = {CharT('a'), CharT('b'), CharT('c'), static_cast<CharT>(sizeof(CharT) > 1 ? 0x161 : 'd')};
+    auto pick = [&] { return alphabet[rng() % 4]; };
+
+    std::vector<std::basic_string<CharT>> needles;
+    while (needles.size() < needle_count)
+    {
+        std::basic_string<CharT> s(1 + rng() % 6, CharT());
+        for (auto &c : s)
+        {
+            c = pick();
+        }
+        if (std::find(needles.begin(), needles.end(), s) == needles.end())
+        {
+            needles.push_back(s);
+        }
+    }
+    std::vector<view> views(needles.begin(), needles.end());
+
+    const lambda::basic_multi_matcher<CharT> filtered(views.begin(), views.end(), lambda::multi_mode::filtered);
+    const lambda::basic_multi_matcher<CharT> automaton(views.begin(), views.end(), lambda::multi_mode::automaton);
+    EXPECT_EQ(filtered.mode(), lambda::multi_mode::filtered);
+    EXPECT_EQ(automaton.mode(), lambda::multi_mode::automaton);
+
+    for (int round = 0; round < 20; ++round)
+    {
+        std::basic_string<CharT> hay(rng() % 200, CharT());
+        for (auto &c : hay)
+        {
+            c = rng() % 3 ? pick() : CharT('z');
+        }
+
+        const auto expected = brute_matches(hay, needles);
+        EXPECT_EQ(filtered.find_all(view(hay)), expected);
+        EXPECT_EQ(automaton.find_all(view(hay)), expected);
+        EXPECT_EQ(filtered.count(view(hay)), expected.size());
+        EXPECT_EQ(automaton.count(view(hay)), expected.size());
+
+        for (size_t pos = 0; pos <= hay.size(); pos += 17)
+        {
+            lambda::multi_match first{lambda::multi_match::npos, lambda::multi_match::npos};
+            for (const auto &m : expected)
+            {
+                if (m.position >= pos)
+                {
+                    first = m;
+                    break;
+                }
+            }
+            EXPECT_EQ(filtered.find(view(hay), pos), first);
+            EXPECT_EQ(automaton.find(view(hay), pos), first);
+        }
+    }
+}
+
+TEST(SV_MultiMatcher, SV_Search)
+{
+    using namespace lambda::sv_literals;
+
+    const lambda::multi_matcher m({"he", "she", "hers", "his"});
+    const std::vector<lambda::multi_match> ushers = {{1, 1}, {2, 0}, {2, 2}};
+    EXPECT_EQ(m.find_all("ushers"_sv), ushers);
+    EXPECT_EQ(m.find("ushers"_sv), (lambda::multi_match{1, 1}));
+    EXPECT_TRUE(m.contains("this"_sv));
+    EXPECT_FALSE(m.contains("hi"_sv));
+    EXPECT_EQ(m[2], "hers"_sv);
+
+    EXPECT_THROW(lambda::multi_matcher({"a", ""}), std::invalid_argument);
+    EXPECT_THROW(lambda::multi_matcher({"a", "b", "a"}), std::invalid_argument);
+    EXPECT_THROW(lambda::multi_matcher({"a", "a"}, lambda::multi_mode::automaton), std::invalid_argument);
+
+    constexpr auto banned = lambda::make_multi_matcher("DROP", "DELETE", "--");
+    static_assert(banned.contains("x; DROP TABLE"_sv), "");
+    static_assert(banned.find("a -- DELETE"_sv) == lambda::multi_match{2, 2}, "");
+    static_assert(banned.count("----"_sv) == 3, "");
+    static_assert(!banned.contains("drop"_sv), "");
+    EXPECT_EQ(banned.find_all("DROP--"_sv).size(), 2u);
+
+    constexpr lambda::u32str_view keys[] = {U"ab"_sv, U"b\u4e00"_sv};
+    constexpr lambda::u32static_multi_matcher<2, lambda::multi_matcher_states(keys)> wide(keys);
+    static_assert(wide.find(U"xb\u4e00"_sv) == lambda::multi_match{1, 1}, "");
+
+    check_multi_matcher<char>(5);
+    check_multi_matcher<char>(100);
+    check_multi_matcher<wchar_t>(30);
+    check_multi_matcher<char16_t>(30);
+    check_multi_matcher<char32_t>(30);
+}
+
+template <typename CharT> static void check_parallel()
+{
+    using view = lambda::basic_str_view<CharT>;
+
+    // Needles planted across chunk boundaries, overlapping each other and at both ends.
+    std::basic_string<CharT> hay(100000, CharT('a'));
+    const std::basic_string<CharT> needle = {CharT('x'), CharT('y'), CharT('x')};
+    for (size_t pos : {size_t(0), size_t(998), size_t(1000), size_t(1002), size_t(4999), size_t(50000), hay.size() - 3})
+    {
+        hay.replace(pos, 3, needle);
+    }
+
+    std::vector<size_t> expected;
+    for (size_t pos = hay.find(needle); pos != std::basic_string<CharT>::npos; pos = hay.find(needle, pos + 1))
+    {
+        expected.push_back(pos);
+    }
+
+    lambda::parallel_options opt;
+    opt.threads = 4;
+    opt.chunk_size = 1000 * sizeof(CharT);
+
+    const view h(hay);
+    const view n(needle);
+    EXPECT_EQ(lambda::parallel_find_all(h, n, opt), expected);
+    EXPECT_EQ(lambda::parallel_count(h, n, opt), expected.size());
+    EXPECT_EQ(lambda::parallel_find(h, n, opt), 0u);
+    EXPECT_EQ(lambda::parallel_find(h.substr(1), n, opt), 997u);
+    EXPECT_EQ(lambda::parallel_find(h.substr(0, 998), n, opt), 0u);
+    EXPECT_EQ(lambda::parallel_find(h.substr(3, 90000), n, opt), 995u);
+    EXPECT_EQ(lambda::parallel_find(h.substr(50001), n, opt), hay.size() - 3 - 50001);
+    EXPECT_EQ(lambda::parallel_find(h.substr(50001, 1000), n, opt), view::npos);
+
+    EXPECT_EQ(lambda::parallel_count(h, CharT('y'), opt), expected.size());
+    EXPECT_EQ(lambda::parallel_find(h, CharT('y'), opt), 1u);
+    EXPECT_EQ(lambda::parallel_find_all(h, CharT('y'), opt).size(), expected.size());
+
+    // The serial fallback gives the same answers.
+    opt.threads = 1;
+    EXPECT_EQ(lambda::parallel_find_all(h, n, opt), expected);
+    EXPECT_EQ(lambda::parallel_count(h, n, opt), expected.size());
+    EXPECT_EQ(lambda::parallel_find(h.substr(1), n, opt), 997u);
+}
+
+TEST(SV_Parallel, SV_Search)
+{
+    check_parallel<char>();
+    check_parallel<char16_t>();
+
+    const lambda::str_view empty;
+    EXPECT_EQ(lambda::parallel_find(empty, lambda::str_view("x")), empty.npos);
+    EXPECT_EQ(lambda::parallel_count(lambda::str_view("aaa"), lambda::str_view("aa")), 2u);
+    EXPECT_EQ(lambda::parallel_count(lambda::str_view("aaa"), lambda::str_view()), 0u);
+    EXPECT_EQ(lambda::parallel_find(lambda::str_view("abc"), lambda::str_view()), 0u);
+}
+
+TEST(SV_MappedFile, SV_File)
+{
+    const char *path = "lambda_mapped_file_test.txt";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "first\nsecond\n\nlast";
+    }
+
+    lambda::map_options opt;
+    opt.hint = lambda::access_hint::sequential;
+    opt.populate = true;
+    opt.huge_pages = true;
+    lambda::mapped_file file(path, opt);
+    EXPECT_TRUE(file.is_open());
+    EXPECT_EQ(file.view(), lambda::str_view("first\nsecond\n\nlast"));
+
+    std::vector<lambda::str_view> lines;
+    for (auto line : lambda::split(file.view(), '\n'))
+    {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 4u);
+    EXPECT_EQ(lines[1], lambda::str_view("second"));
+    EXPECT_TRUE(lines[2].empty());
+    // Zero copy: the pieces point into the mapping.
+    EXPECT_EQ(lines[3].data(), file.data() + 14);
+
+    file.advise(lambda::access_hint::random);
+    file.prefetch(7, 3);
+    file.prefetch(1000);
+
+    lambda::mapped_file moved(std::move(file));
+    EXPECT_FALSE(file.is_open());
+    EXPECT_TRUE(file.view().empty());
+    EXPECT_EQ(moved.size(), 18u);
+    moved.close();
+    EXPECT_FALSE(moved.is_open());
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    }
+    lambda::mapped_file empty(path);
+    EXPECT_TRUE(empty.is_open());
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.data(), nullptr);
+    std::remove(path);
+
+    EXPECT_THROW(lambda::mapped_file("lambda_mapped_file_missing.txt"), std::system_error);
+}
+
+template <typename CharT> void check_record_reader(size_t capacity)
+{
+    using view = lambda::basic_str_view<CharT>;
+    std::mt19937 gen(capacity);
+    std::basic_string<CharT> text;
+    std::vector<std::basic_string<CharT>> expected;
+    for (int i = 0; i < 300; ++i)
+    {
+        // Mostly short records, some empty, a few longer than the buffer.
+        const size_t len = i % 50 == 7 ? capacity * 3 : gen() % 12;
+        expected.emplace_back(len, CharT('a' + i % 26));
+        text += expected.back();
+        text += CharT(';');
+    }
+    text += CharT('z');
+    expected.emplace_back(1, CharT('z'));
+
+    // Hands the text out in short, uneven reads.
+    size_t offset = 0;
+    auto source = [&](CharT *dst, size_t n) {
+        n = std::min<size_t>({n, gen() % 9 + 1, text.size() - offset});
+        std::copy(text.data() + offset, text.data() + offset + n, dst);
+        offset += n;
+        return n;
+    };
+    auto reader = lambda::make_record_reader(source, CharT(';'), capacity);
+
+    size_t count = 0;
+    for (view record; reader.next(record); ++count)
+    {
+        ASSERT_LT(count, expected.size());
+        EXPECT_EQ(record, view(expected[count]));
+    }
+    EXPECT_EQ(count, expected.size());
+    EXPECT_GE(reader.capacity(), capacity * 3);
+    view record;
+    EXPECT_FALSE(reader.next(record));
+}
+
+TEST(SV_RecordReader, SV_Stream)
+{
+    check_record_reader<char>(16);
+    check_record_reader<char>(1);
+    check_record_reader<char16_t>(32);
+
+    std::istringstream in("alpha\nbeta\n\ngamma\n");
+    lambda::record_reader<lambda::istream_source> reader(lambda::istream_source(in), '\n', 8);
+    std::vector<std::string> lines;
+    for (lambda::str_view line; reader.next(line);)
+    {
+        lines.emplace_back(line.data(), line.size());
+    }
+    EXPECT_EQ(lines, (std::vector<std::string>{"alpha", "beta", "", "gamma"}));
+    // Every record fits, so the buffer is reused as is.
+    EXPECT_EQ(reader.capacity(), 8u);
+}
+
+// Straightforward RFC 3629 reference: index of the first bad sequence, or npos.
+size_t brute_invalid_utf8(const std::string &s)
+{
+    for (size_t i = 0; i < s.size();)
+    {
+        const unsigned char c = static_cast<unsigned char>(s[i]);
+        const size_t len = c < 0x80 ? 1 : c < 0xC2 ? 0 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : c < 0xF5 ? 4 : 0;
+        if (len == 0 || s.size() - i < len)
+        {
+            return i;
+        }
+        uint32_t cp = len == 1 ? c : c & (0x7F >> len);
+        for (size_t k = 1; k < len; ++k)
+        {
+            const unsigned char b = static_cast<unsigned char>(s[i + k]);
+            if ((b >> 6) != 2)
+            {
+                return i;
+            }
+            cp = cp << 6 | (b & 0x3F);
+        }
+        const uint32_t min[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (cp < min[len] || cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000))
+        {
+            return i;
+        }
+        i += len;
+    }
+    return std::string::npos;
+}
+
+TEST(SV_Segmented, SV_Search)
+{
+    using namespace lambda::sv_literals;
+
+    const lambda::segmented_str_view msg{"HTTP/1.1 200 OK\r"_sv, ""_sv, "\nContent-Length: 2\r\n\r"_sv, "\nok"_sv};
+    EXPECT_EQ(msg.fragment_count(), 3u);
+    EXPECT_EQ(msg.size(), 40u);
+    EXPECT_EQ(msg, "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok"_sv);
+    EXPECT_EQ(msg.find("\r\n\r\n"_sv), 34u);
+    EXPECT_EQ(msg.find("OK\r\nContent"_sv), 13u);
+    EXPECT_EQ(msg.rfind("\r\n"_sv), 36u);
+    EXPECT_TRUE(msg.starts_with("HTTP/1.1 200 OK\r\nC"_sv));
+    EXPECT_TRUE(msg.ends_with("\r\n\r\nok"_sv));
+    EXPECT_EQ(msg.substr(13, 6), "OK\r\nCo"_sv);
+    EXPECT_EQ(msg.substr(13, 6).fragment_count(), 2u);
+    EXPECT_EQ(msg.at(16), '\n');
+    EXPECT_THROW(msg.at(40), std::out_of_range);
+    EXPECT_EQ(std::string(msg.begin(), msg.end()), msg.to_string(std::allocator<char>()));
+
+    struct iovec iov[2];
+    ASSERT_EQ(msg.to_iovec(iov, 2, 1), 2u);
+    EXPECT_EQ(iov[0].iov_base, msg.fragment(1).data());
+    EXPECT_EQ(iov[1].iov_len, 3u);
+
+    // Against the concatenation, with fragments of 0-4 units over a two letter alphabet and spilling past N = 4.
+    std::mt19937 rng(21);
+    const auto word = [&](size_t max) {
+        std::string w(rng() % (max + 1), 'a');
+        for (char &c : w)
+        {
+            c = "ab"[rng() % 2];
+        }
+        return w;
+    };
+    for (int round = 0; round < 2000; ++round)
+    {
+        std::vector<std::string> parts(rng() % 12);
+        lambda::basic_segmented_str_view<char, std::char_traits<char>, 4> seg;
+        std::string whole;
+        for (std::string &p : parts)
+        {
+            p = word(4);
+            seg.append(lambda::str_view(p));
+            whole += p;
+        }
+        EXPECT_EQ(seg.to_string(std::allocator<char>()), whole);
+
+        for (int q = 0; q < 8; ++q)
+        {
+            const std::string n = word(4);
+            const lambda::str_view v(n);
+            const size_t pos = rng() % (whole.size() + 2);
+            EXPECT_EQ(seg.find(v, pos), whole.find(n, pos)) << whole << " / " << n;
+            EXPECT_EQ(seg.rfind(v, pos), whole.rfind(n, pos)) << whole << " / " << n;
+            EXPECT_EQ(seg.find('b', pos), whole.find('b', pos));
+            EXPECT_EQ(seg.rfind('a', pos), whole.rfind('a', pos));
+            EXPECT_EQ(seg.compare(v) < 0, whole.compare(n) < 0);
+            EXPECT_EQ(seg.equals(v), whole == n);
+            if (pos <= whole.size())
+            {
+                EXPECT_EQ(seg.substr(pos, 3).to_string(std::allocator<char>()), whole.substr(pos, 3));
+            }
+        }
+    }
+}
+
+TEST(SV_Utf8, SV_Utf)
+{
+    static_assert(lambda::is_valid_utf8(lambda::str_view("h\xC3\xA9llo \xE2\x82\xAC \xF0\x9F\x98\x80")), "");
+    static_assert(lambda::find_invalid_utf8(lambda::str_view("ab\xC0\x80")) == 2, "");
+    static_assert(lambda::is_ascii(lambda::str_view("plain")), "");
+    static_assert(lambda::utf16_length(lambda::str_view("a\xC3\xA9\xF0\x9F\x98\x80")) == 4, "");
+
+    const char *bad[] = {"\x80", "\xC0\x80", "\xC1\xBF", "\xE0\x80\x80", "\xED\xA0\x80", "\xF0\x80\x80\x80",
+                         "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xFF", "\xE2\x82", "\xC3\xC3", "\xE2\x28\xA1"};
+    const char *good[] = {"\x7F", "\xC2\x80", "\xDF\xBF", "\xE0\xA0\x80", "\xED\x9F\xBF", "\xEE\x80\x80",
+                          "\xF0\x90\x80\x80", "\xF4\x8F\xBF\xBF"};
+
+    // Every case at every offset around the 64 byte blocks, padded with ASCII or with multi-byte text.
+    std::mt19937 gen(16);
+    for (size_t offset : {0, 1, 29, 31, 32, 33, 61, 62, 63, 64, 65, 127, 200})
+    {
+        for (const char *pad : {"x", "\xC3\xA9"})
+        {
+            std::string prefix;
+            while (prefix.size() < offset)
+            {
+                prefix += pad;
+            }
+            for (const char *seq : bad)
+            {
+                const std::string s = prefix + seq + std::string(gen() % 100, 'y');
+                EXPECT_EQ(lambda::find_invalid_utf8(s), brute_invalid_utf8(s)) << offset << ' ' << seq;
+                EXPECT_FALSE(lambda::is_valid_utf8(s));
+            }
+            for (const char *seq : good)
+            {
+                const std::string s = prefix + seq + std::string(gen() % 100, 'y');
+                EXPECT_EQ(lambda::find_invalid_utf8(s), lambda::str_view::npos) << offset << ' ' << seq;
+                EXPECT_TRUE(lambda::is_valid_utf8(s));
+                // A sequence cut short by the end of input.
+                const std::string cut = prefix + std::string(seq, std::strlen(seq) - 1);
+                EXPECT_EQ(lambda::find_invalid_utf8(cut), brute_invalid_utf8(cut));
+                EXPECT_EQ(lambda::is_valid_utf8(cut), brute_invalid_utf8(cut) == std::string::npos);
+            }
+        }
+    }
+
+    // Random bytes biased towards UTF-8 structure.
+    for (int round = 0; round < 2000; ++round)
+    {
+        std::string s;
+        const size_t len = gen() % 300;
+        while (s.size() < len)
+        {
+            const unsigned r = gen() % 16;
+            s += r < 10 ? char('a' + r) : r < 13 ? char(0x80 | gen() % 64) : char(0xC0 | gen() % 64);
+        }
+        EXPECT_EQ(lambda::find_invalid_utf8(s), brute_invalid_utf8(s));
+        EXPECT_EQ(lambda::is_valid_utf8(s), brute_invalid_utf8(s) == std::string::npos);
+    }
+
+    EXPECT_TRUE(lambda::is_ascii(lambda::str_view(std::string(1000, 'a'))));
+    EXPECT_FALSE(lambda::is_ascii(lambda::str_view(std::string(999, 'a') + "\xC3\xA9")));
+    EXPECT_TRUE(lambda::is_valid_utf8(lambda::str_view()));
+}
+
+TEST(SV_Transcode, SV_Utf)
+{
+    std::mt19937 gen(32);
+    std::u32string text;
+    for (int i = 0; i < 5000; ++i)
+    {
+        const unsigned r = gen() % 8;
+        char32_t cp = r < 4 ? gen() % 0x80 : r < 5 ? gen() % 0x800 : r < 7 ? gen() % 0x10000 : gen() % 0x110000;
+        text += (cp >= 0xD800 && cp < 0xE000) ? char32_t('?') : cp;
+    }
+
+    lambda::monotonic_arena arena;
+    const lambda::str_view utf8 = lambda::to_utf8(lambda::u32str_view(text), arena);
+    EXPECT_TRUE(lambda::is_valid_utf8(utf8));
+    EXPECT_EQ(utf8.size(), lambda::utf8_length(lambda::u32str_view(text)));
+    EXPECT_EQ(utf8.data()[utf8.size()], '\0');
+
+    const lambda::u32str_view utf32 = lambda::to_utf32(utf8, arena);
+    EXPECT_EQ(utf32, lambda::u32str_view(text));
+    EXPECT_EQ(utf32.size(), lambda::utf32_length(utf8));
+
+    const lambda::u16str_view utf16 = lambda::to_utf16(utf8, arena);
+    EXPECT_EQ(utf16.size(), lambda::utf16_length(utf8));
+    EXPECT_EQ(lambda::utf8_length(utf16), utf8.size());
+    EXPECT_EQ(lambda::to_utf8(utf16, arena), utf8);
+
+    // Exact sized buffers are enough, one unit less is not.
+    std::vector<char16_t> out(utf16.size());
+    EXPECT_EQ(lambda::to_utf16(utf8, out.data(), out.size()), utf16);
+    EXPECT_THROW(lambda::to_utf16(utf8, out.data(), out.size() - 1), std::length_error);
+
+    try
+    {
+        lambda::to_utf32(lambda::str_view("abc\xE2\x82"), arena);
+        ADD_FAILURE();
+    }
+    catch (const lambda::utf_error &e)
+    {
+        EXPECT_EQ(e.position(), 3u);
+    }
+    const char16_t lone[] = {u'a', 0xD800, u'b'};
+    EXPECT_THROW(lambda::to_utf8(lambda::u16str_view(lone, 3), arena), lambda::utf_error);
+    const char32_t big[] = {0x110000};
+    EXPECT_THROW(lambda::to_utf8(lambda::u32str_view(big, 1), arena), std::invalid_argument);
+}
+
+template <typename CharT, lambda::affix Side> void check_affix_set()
+{
+    using view = lambda::basic_str_view<CharT>;
+    std::mt19937 gen(Side == lambda::affix::prefix ? 17 : 71);
+    auto random_text = [&](size_t len) {
+        std::basic_string<CharT> s;
+        for (size_t i = 0; i < len; ++i)
+        {
+            s += CharT('a' + gen() % 3);
+        }
+        return s;
+    };
+
+    std::vector<std::basic_string<CharT>> keys;
+    while (keys.size() < 40)
+    {
+        auto key = random_text(1 + gen() % 14);
+        if (std::find(keys.begin(), keys.end(), key) == keys.end())
+        {
+            keys.push_back(key);
+        }
+    }
+    std::vector<view> views(keys.begin(), keys.end());
+    const lambda::basic_affix_set<CharT, Side> set(views.begin(), views.end());
+    keys.clear(); // the set keeps its own copy
+
+    for (int round = 0; round < 3000; ++round)
+    {
+        const auto text = random_text(gen() % 20);
+        const view v(text);
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < set.size(); ++i)
+        {
+            if (Side == lambda::affix::prefix ? v.starts_with(set[i]) : v.ends_with(set[i]))
+            {
+                expected.push_back(i);
+            }
+        }
+        std::sort(expected.begin(), expected.end(), [&](size_t a, size_t b) { return set[a].size() > set[b].size(); });
+
+        std::vector<size_t> found;
+        set.for_each_match(v, [&](size_t i) { found.push_back(i); });
+        EXPECT_EQ(found, expected);
+        EXPECT_EQ(set.match(v), expected.empty() ? set.npos : expected.front());
+        EXPECT_EQ(set.matches(v), !expected.empty());
+    }
+}
+
+TEST(SV_AffixSet, SV_Compare)
+{
+    using namespace lambda::sv_literals;
+
+    check_affix_set<char, lambda::affix::prefix>();
+    check_affix_set<char, lambda::affix::suffix>();
+    check_affix_set<char16_t, lambda::affix::prefix>();
+    check_affix_set<char32_t, lambda::affix::suffix>();
+
+    const lambda::prefix_set routes{"/api/v1/"_sv, "/api/"_sv, "/static/"_sv, "/api/v1/users/by-name/"_sv};
+    EXPECT_EQ(routes.match("/api/v1/users/by-name/bob"_sv), 3u);
+    EXPECT_EQ(routes.match("/api/v1/users"_sv), 0u);
+    EXPECT_EQ(routes.match("/api/v2"_sv), 1u);
+    EXPECT_EQ(routes.match("/apx"_sv), routes.npos);
+    EXPECT_EQ(routes.match(""_sv), routes.npos);
+
+    const lambda::suffix_set types{".tar.gz"_sv, ".gz"_sv, ""_sv};
+    EXPECT_EQ(types.match("a.tar.gz"_sv), 0u);
+    EXPECT_EQ(types.match("a.gz"_sv), 1u);
+    EXPECT_EQ(types.match("a.txt"_sv), 2u);
+    EXPECT_THROW((lambda::prefix_set{"a"_sv, "b"_sv, "a"_sv}), std::invalid_argument);
+
+    // Fixed size overloads stop at the first terminator inside the array, like the pointer overloads.
+    constexpr auto uri = "http://example.com"_sv;
+    static_assert(uri.starts_with("http") && !uri.starts_with("https") && uri.ends_with(".com"), "");
+    static_assert(uri.starts_with('h') && uri.ends_with('m') && !lambda::str_view().starts_with('h'), "");
+    static_assert(!"ab"_sv.ends_with("xab") && !"ab"_sv.ends_with('a'), "");
+    char buffer[32] = "http:";
+    const char padded[32] = "http:/";
+    const char unterminated[] = {'h', 't'};
+    EXPECT_TRUE(uri.starts_with(buffer));
+    EXPECT_TRUE(uri.starts_with(padded));
+    EXPECT_TRUE(uri.starts_with(unterminated));
+    EXPECT_TRUE(uri.ends_with(std::string("example.com").c_str()));
+    static_assert("abc"_sv.starts_with("ab\0zz") && "xab"_sv.ends_with("ab\0zz"), "");
+    EXPECT_TRUE(lambda::str_view("abc").starts_with("ab\0zz"));
+    char reused[8] = "abcdefg";
+    reused[2] = '\0';
+    const char(&name)[8] = reused;
+    EXPECT_TRUE("ab"_sv.starts_with(name));
+    EXPECT_TRUE("xab"_sv.ends_with(name));
+    EXPECT_EQ("ab"_sv.starts_with(name), "ab"_sv.starts_with(static_cast<const char *>(name)));
+}
+
+TEST(SV_FixedString, SV_Ctor)
+{
+    using namespace lambda::sv_literals;
+
+    // Built and joined in constant expressions, padded to whole words, and trivially copyable.
+    constexpr auto key = lambda::make_fixed_string("user:") + "42";
+    static_assert(std::is_same<decltype(key), const lambda::fixed_string<7>>::value, "");
+    static_assert(key.size() == 7 && key.view() == "user:42"_sv && key.c_str()[7] == '\0', "");
+    constexpr lambda::fixed_string<8> prefix(key.view().substr(0, 4));
+    static_assert(prefix == lambda::fixed_string<8>("user") && prefix != lambda::fixed_string<8>("usex"), "");
+    static_assert("user"_sv == prefix && prefix.view().ends_with('r'), "");
+    static_assert(lambda::fixed_string<15>::storage_size == 16 && lambda::u32fixed_string<2>::storage_size == 4, "");
+    static_assert(sizeof(lambda::fixed_string<23>) == 32, "");
+    static_assert(std::is_trivially_copyable<lambda::fixed_string<23>>::value, "");
+
+    lambda::fixed_string<15> a("hello"_sv);
+    lambda::fixed_string<15> b = a;
+    EXPECT_TRUE(a == b);
+    b.push_back('!');
+    EXPECT_TRUE(a != b);
+    EXPECT_TRUE(a < b);
+    b.pop_back();
+    EXPECT_TRUE(a == b);
+    EXPECT_EQ(std::hash<lambda::fixed_string<15>>()(a), std::hash<lambda::str_view>()("hello"_sv));
+
+    // Embedded zeros are characters: only the length tells these apart.
+    const lambda::fixed_string<15> z1(lambda::str_view("a\0", 2)), z2("a"_sv);
+    EXPECT_FALSE(z1 == z2);
+    EXPECT_EQ(z1.size(), 2u);
+
+    // Overflow throws and leaves the string as it was.
+    EXPECT_THROW(a.append("0123456789ab"_sv), std::length_error);
+    EXPECT_EQ(a.view(), "hello"_sv);
+    a += " world";
+    EXPECT_EQ(a.to_string(), "hello world");
+    EXPECT_THROW((lambda::fixed_string<4>("hello"_sv)), std::length_error);
+    const char unterminated[8] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'};
+    EXPECT_THROW((lambda::fixed_string<7>(unterminated)), std::length_error);
+    EXPECT_EQ((lambda::fixed_string<8>(unterminated)).size(), 8u);
+    static_assert(lambda::fixed_string<7>("ab\0zz").size() == 2, "");
+    const lambda::fixed_string<7> early("ab\0zz");
+    EXPECT_EQ(early.size(), 2u);
+    EXPECT_EQ(lambda::str_view(early).size(), early.view().size());
+    a.clear();
+    EXPECT_TRUE(a.empty() && a == lambda::fixed_string<15>());
+
+    const lambda::u16fixed_string<7> wide(u"caf\u00e9"_sv);
+    EXPECT_EQ(wide.view().find(u'\u00e9'), 3u);
+    EXPECT_TRUE(wide == lambda::u16fixed_string<7>(u"caf\u00e9"));
+    std::vector<lambda::fixed_string<23>> keys{lambda::fixed_string<23>("b"), lambda::fixed_string<23>("a")};
+    std::sort(keys.begin(), keys.end());
+    EXPECT_EQ(keys.front().view(), "a"_sv);
+}
+
+TEST(SV_FlatStrMap, SV_Search)
+{
+    using namespace lambda::sv_literals;
+
+    lambda::flat_str_map<int> ports{{"https"_sv, 443}, {"http"_sv, 80}, {"ssh"_sv, 22}, {"http-alt"_sv, 8080}};
+    ASSERT_EQ(ports.size(), 4u);
+    EXPECT_EQ(ports.key(0), "http"_sv);
+    EXPECT_EQ(ports.key(3), "ssh"_sv);
+    EXPECT_EQ(ports.at("https"_sv), 443);
+    EXPECT_EQ(ports.find("ssh"_sv).value(), 22);
+    EXPECT_TRUE(ports.find("smtp"_sv) == ports.end());
+    EXPECT_THROW(ports.at("ftp"_sv), std::out_of_range);
+    ports.at("ssh"_sv) = 2222;
+    EXPECT_EQ((*ports.find("ssh"_sv)).second, 2222);
+
+    EXPECT_EQ(ports.lower_bound("http+"_sv).key(), "http-alt"_sv);
+    EXPECT_EQ(ports.upper_bound("http"_sv).key(), "http-alt"_sv);
+    EXPECT_EQ(ports.equal_range("https"_sv).second - ports.equal_range("https"_sv).first, 1);
+    EXPECT_EQ(ports.equal_range("httpz"_sv).second - ports.equal_range("httpz"_sv).first, 0);
+    auto http = ports.prefix_range("http"_sv);
+    EXPECT_EQ(http.second - http.first, 3);
+    EXPECT_EQ(ports.prefix_range(""_sv).second - ports.prefix_range(""_sv).first, 4);
+    EXPECT_EQ(ports.prefix_range("z"_sv).first, ports.end());
+    EXPECT_THROW((lambda::flat_str_map<int>{{"a"_sv, 1}, {"a"_sv, 2}}), std::invalid_argument);
+    const lambda::flat_str_map<int> none;
+    EXPECT_TRUE(none.find("a"_sv) == none.end() && none.prefix_range(""_sv).first == none.end());
+
+    // Against std::map with a shared prefix, embedded zeros and high bytes, so node prefixes tie and full keys decide.
+    std::mt19937 rng(21);
+    std::map<std::string, int> reference;
+    while (reference.size() < 3000)
+    {
+        std::string key = "user:";
+        const size_t length = rng() % 11;
+        for (size_t i = 0; i < length; ++i)
+        {
+            key += "ab\0\xe0"[rng() % 4];
+        }
+        reference.emplace(key, static_cast<int>(reference.size()));
+    }
+    const lambda::flat_str_map<int> map(reference.begin(), reference.end());
+    EXPECT_EQ(map.common_prefix(), "user:"_sv);
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string probe = i % 3 == 0 ? "use" : "user:";
+        const size_t length = rng() % 12;
+        for (size_t j = 0; j < length; ++j)
+        {
+            probe += "ab\0\xe0"[rng() % 4];
+        }
+        const lambda::str_view p(probe);
+        const size_t rank = static_cast<size_t>(std::distance(reference.begin(), reference.lower_bound(probe)));
+        EXPECT_EQ(map.lower_bound_rank(p), rank);
+        EXPECT_EQ(map.contains(p), reference.count(probe) == 1);
+        const auto range = map.prefix_range(p);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            ASSERT_TRUE(it.key().starts_with(p));
+        }
+        EXPECT_TRUE(range.second == map.end() || !range.second.key().starts_with(p));
+        EXPECT_TRUE(range.first.rank() == 0 || !map.key(range.first.rank() - 1).starts_with(p));
+    }
+}
+
+template <typename CharT> void check_sort_views(size_t n, bool parallel)
+{
+    // Few distinct units, zeros and high units among them, behind a shared prefix: many keys tie on 8 bytes.
+    std::mt19937 rng(static_cast<unsigned>(n) + sizeof(CharT));
+    const CharT alphabet[] = {CharT(0), CharT('a'), CharT('b'), CharT(0xe0)};
+    std::vector<std::basic_string<CharT>> store;
+    for (size_t i = 0; i < n; ++i)
+    {
+        std::basic_string<CharT> s(rng() % 12, CharT('p'));
+        for (size_t len = rng() % 24; len != 0; --len)
+        {
+            s += alphabet[rng() % 4];
+        }
+        store.push_back(s);
+    }
+
+    std::vector<lambda::basic_str_view<CharT>> views(store.begin(), store.end());
+    std::vector<lambda::basic_str_view<CharT>> expected = views;
+    std::sort(expected.begin(), expected.end());
+    if (parallel)
+    {
+        lambda::parallel_options opt;
+        opt.threads = 4;
+        lambda::parallel_sort_views(views, opt);
+    }
+    else
+    {
+        lambda::sort_views(views);
+    }
+    ASSERT_EQ(views.size(), expected.size());
+    for (size_t i = 0; i < views.size(); ++i)
+    {
+        ASSERT_EQ(views[i], expected[i]) << i;
+    }
+}
+
+TEST(SV_SortViews, SV_Compare)
+{
+    using namespace lambda::sv_literals;
+
+    check_sort_views<char>(5000, false);
+    check_sort_views<char16_t>(3000, false);
+    check_sort_views<char32_t>(3000, false);
+    check_sort_views<wchar_t>(2000, false);
+    check_sort_views<char>(100000, true);
+
+    std::vector<lambda::str_view> small{"b"_sv, "ab"_sv, ""_sv, "a"_sv, "a\0"_sv};
+    lambda::sort_views(small);
+    EXPECT_EQ(small, (std::vector<lambda::str_view>{""_sv, "a"_sv, "a\0"_sv, "ab"_sv, "b"_sv}));
+
+    // Long equal prefixes do not deepen the recursion.
+    const std::string long_key(100000, 'x');
+    std::vector<lambda::str_view> deep;
+    for (size_t i = 0; i < 64; ++i)
+    {
+        deep.push_back(lambda::str_view(long_key).first(long_key.size() - i % 5));
+    }
+    lambda::sort_views(deep);
+    EXPECT_TRUE(std::is_sorted(deep.begin(), deep.end()));
+
+    // Traits without an unsigned unit order fall back to compare().
+    std::vector<lambda::ci_str_view> folded{lambda::ci_str_view("B"), lambda::ci_str_view("a"),
+                                            lambda::ci_str_view("C")};
+    lambda::sort_views(folded);
+    EXPECT_EQ(folded[0], lambda::ci_str_view("A"));
+    EXPECT_EQ(folded[2], lambda::ci_str_view("c"));
+}
+
+TEST(SV_Batch, SV_Kernels)
+{
+    using namespace lambda::sv_literals;
+
+    // 200 rows cover three full mask words and a partial one.
+    std::mt19937 rng(27);
+    std::vector<std::string> store;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        std::string s = i % 3 == 0 ? "GET" : i % 3 == 1 ? "GETX" : "PO";
+        for (size_t len = rng() % 40; len != 0; --len)
+        {
+            s += "ab/"[rng() % 3];
+        }
+        store.push_back(i % 7 == 0 ? std::string("GET") : s);
+    }
+    const lambda::view_batch rows(store.begin(), store.end());
+    ASSERT_EQ(rows.size(), store.size());
+    EXPECT_EQ(rows[5], lambda::str_view(store[5]));
+
+    std::vector<uint64_t> hashes(rows.size());
+    lambda::hash_batch(rows, hashes.data(), 42);
+    std::vector<uint64_t> equal(lambda::batch_mask_words(rows.size()), ~uint64_t(0));
+    const size_t equal_count = lambda::equals_batch(rows, "GET"_sv, equal.data());
+    std::vector<uint64_t> prefixed(lambda::batch_mask_words(rows.size()));
+    const size_t prefixed_count = lambda::starts_with_batch(rows, "GETa"_sv, prefixed.data());
+    std::vector<size_t> found(rows.size());
+    lambda::find_batch(rows, "b/a"_sv, found.data());
+
+    size_t expected_equal = 0;
+    size_t expected_prefixed = 0;
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        const lambda::str_view v(store[i]);
+        const bool is_equal = (equal[i / 64] >> (i % 64)) & 1;
+        const bool is_prefixed = (prefixed[i / 64] >> (i % 64)) & 1;
+        EXPECT_EQ(hashes[i], lambda::hash_value(v, 42)) << i;
+        EXPECT_EQ(is_equal, v == "GET"_sv) << i;
+        EXPECT_EQ(is_prefixed, v.starts_with("GETa"_sv)) << i;
+        EXPECT_EQ(found[i], v.find("b/a"_sv)) << i;
+        expected_equal += v == "GET"_sv;
+        expected_prefixed += v.starts_with("GETa"_sv);
+    }
+    EXPECT_EQ(equal_count, expected_equal);
+    EXPECT_EQ(prefixed_count, expected_prefixed);
+    EXPECT_EQ(equal.back() >> (rows.size() % 64), 0u);
+
+    // Case insensitive rows compare and hash folded; the empty batch writes nothing.
+    const lambda::basic_view_batch<char, lambda::ci_char_traits<char>> folded{lambda::ci_str_view("Host"),
+                                                                             lambda::ci_str_view("HOSTNAME")};
+    uint64_t mask = 0;
+    EXPECT_EQ(lambda::starts_with_batch(folded, lambda::ci_str_view("host"), &mask), 2u);
+    EXPECT_EQ(lambda::equals_batch(folded, lambda::ci_str_view("hOST"), &mask), 1u);
+    EXPECT_EQ(mask, 1u);
+    uint64_t folded_hashes[2];
+    lambda::hash_batch(folded, folded_hashes);
+    EXPECT_EQ(folded_hashes[0], lambda::hash_value("host"_sv));
+    size_t positions[2];
+    lambda::find_batch(folded, lambda::ci_str_view("NAME"), positions);
+    EXPECT_EQ(positions[0], lambda::ci_str_view::npos);
+    EXPECT_EQ(positions[1], 4u);
+    EXPECT_EQ(lambda::equals_batch(lambda::view_batch(), "x"_sv, &mask), 0u);
+}
+
+TEST(SV_Pipeline, SV_Stream)
+{
+    using namespace lambda::sv_literals;
+
+    // Small alphabet and chunks down to one unit put many matches and records across chunk boundaries.
+    std::mt19937 rng(28);
+    std::string text;
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        text += "ab\n"[rng() % 3];
+    }
+    const lambda::str_view h(text);
+    const lambda::str_view needle = "abab\nab"_sv;
+
+    std::vector<size_t> expected;
+    for (size_t pos = h.find(needle); pos != h.npos; pos = h.find(needle, pos + 1))
+    {
+        expected.push_back(pos);
+    }
+    std::vector<std::string> expected_records;
+    lambda::str_view rest = h;
+    for (size_t at; (at = rest.find('\n')) != rest.npos; rest.remove_prefix(at + 1))
+    {
+        expected_records.emplace_back(rest.data(), at);
+    }
+    if (!rest.empty())
+    {
+        expected_records.emplace_back(rest.data(), rest.size());
+    }
+
+    lambda::stream_scanner scanner(needle);
+    lambda::stream_splitter splitter('\n');
+    std::vector<size_t> found;
+    std::vector<std::string> records;
+    for (size_t at = 0; at < h.size();)
+    {
+        const size_t n = std::min<size_t>(rng() % 12, h.size() - at);
+        scanner.feed(h.substr(at, n), [&](size_t pos) { found.push_back(pos); });
+        splitter.feed(h.substr(at, n), [&](lambda::str_view r) { records.emplace_back(r.data(), r.size()); });
+        at += n;
+    }
+    splitter.finish([&](lambda::str_view r) { records.emplace_back(r.data(), r.size()); });
+    EXPECT_EQ(found, expected);
+    EXPECT_EQ(records, expected_records);
+    EXPECT_EQ(scanner.offset(), h.size());
+    EXPECT_THROW(lambda::stream_scanner(""_sv), std::invalid_argument);
+
+    // Sources with short reads, matches handed to a downstream thread through a bounded queue.
+    size_t read_at = 0;
+    auto source = [&](char *dst, size_t capacity) {
+        const size_t n = std::min({capacity, h.size() - read_at, size_t(1) + read_at % 97});
+        std::copy(h.begin() + read_at, h.begin() + read_at + n, dst);
+        read_at += n;
+        return n;
+    };
+    lambda::stream_options opt;
+    opt.chunk_size = 64;
+    opt.buffers = 2;
+
+    lambda::bounded_queue<size_t> downstream(2);
+    std::vector<size_t> consumed;
+    std::thread consumer([&] {
+        for (size_t pos; downstream.pop(pos);)
+        {
+            consumed.push_back(pos);
+        }
+    });
+    const size_t count = lambda::stream_find_all(source, needle, [&](size_t pos) { downstream.push(pos); }, opt);
+    downstream.close();
+    consumer.join();
+    EXPECT_EQ(count, expected.size());
+    EXPECT_EQ(consumed, expected);
+    EXPECT_FALSE(downstream.push(0));
+
+    read_at = 0;
+    records.clear();
+    lambda::stream_split(source, '\n', [&](lambda::str_view r) { records.emplace_back(r.data(), r.size()); }, opt);
+    EXPECT_EQ(records, expected_records);
+
+    read_at = 0;
+    auto failing = [&](char *dst, size_t capacity) -> size_t {
+        if (read_at > 1000)
+        {
+            throw std::runtime_error("read failed");
+        }
+        return source(dst, capacity);
+    };
+    EXPECT_THROW(lambda::stream_find_all(failing, needle, [](size_t) {}, opt), std::runtime_error);
+
+#if LAMBDA_HAS_COROUTINES
+    read_at = 0;
+    found.clear();
+    for (const size_t pos : lambda::stream_matches(source, needle, opt))
+    {
+        found.push_back(pos);
+    }
+    EXPECT_EQ(found, expected);
+
+    read_at = 0;
+    records.clear();
+    for (const lambda::str_view r : lambda::stream_records(source, '\n', opt))
+    {
+        records.emplace_back(r.data(), r.size());
+    }
+    EXPECT_EQ(records, expected_records);
+
+    // Leaving early stops the reading thread.
+    read_at = 0;
+    for (const size_t pos : lambda::stream_matches(source, needle, opt))
+    {
+        EXPECT_EQ(pos, expected.front());
+        break;
+    }
+#endif
+}
+
+TEST(SV_Constexpr, SV_Runtime)
+{
+    using namespace lambda::sv_literals;
+
+    // The operations made constant evaluable give the same answers at runtime (constexpr_test.cpp covers compile time).
+    const std::string line = " \t key = value\r\n";
+    const lambda::str_view v(line);
+    EXPECT_EQ(v.trim(), "key = value"_sv);
+    EXPECT_EQ(v.trim_front(), "key = value\r\n"_sv);
+    EXPECT_EQ(v.trim_back(), " \t key = value"_sv);
+    EXPECT_EQ(v.trim(" \t\r\nke"_sv), "y = valu"_sv);
+    EXPECT_TRUE(lambda::str_view("\v\f").trim().empty());
+    EXPECT_EQ(lambda::wstr_view(L"  wide ").trim(), lambda::wstr_view(L"wide"));
+
+    EXPECT_EQ(v.back(), '\n');
+    EXPECT_EQ(std::string(v.rbegin(), v.rend()), std::string(line.rbegin(), line.rend()));
+    EXPECT_EQ(*v.crbegin(), '\n');
+    lambda::str_view a = "a"_sv;
+    lambda::str_view b = "bc"_sv;
+    a.swap(b);
+    EXPECT_EQ(a, "bc"_sv);
+    EXPECT_EQ(b, "a"_sv);
+
+    const std::string path = "/users/{id}/posts/{id}";
+    EXPECT_EQ(lambda::replace_all<32>(lambda::str_view(path), "{id}"_sv, "1234"_sv), "/users/1234/posts/1234"_sv);
+    EXPECT_EQ(lambda::replace_all<4>("abab"_sv, "ab"_sv, "b"_sv), "bb"_sv);
+    EXPECT_THROW(lambda::replace_all<8>(lambda::str_view(path), "{id}"_sv, ""_sv), std::length_error);
+}
+
+TEST(SV_Differential, SV_StringView)
+{
+    // The inputs the fuzzer would start from: empty and tiny views, then random ones around the vector widths.
+    std::mt19937 rng(30);
+    std::vector<uint8_t> input;
+    for (size_t round = 0; round < 6000; ++round)
+    {
+        input.resize(sv_diff::header_size + (round < 1000 ? round % 8 : rng() % 300));
+        for (uint8_t &b : input)
+        {
+            b = static_cast<uint8_t>(rng());
+        }
+        const std::string mismatch = sv_diff::check_input(input.data(), input.size());
+        ASSERT_TRUE(mismatch.empty()) << mismatch << " in round " << round;
+    }
+}
+
+namespace
+{
+
+/// Calls f until the calls last five milliseconds; returns that number of calls.
+template <typename F> size_t calibrate_reps(F f)
+{
+    using clock = std::chrono::steady_clock;
+    volatile size_t sink = 0;
+    for (size_t reps = 1;; reps *= 2)
+    {
+        const clock::time_point start = clock::now();
+        for (size_t i = 0; i < reps; ++i)
+        {
+            sink = sink + f();
+        }
+        if (clock::now() - start > std::chrono::milliseconds(5))
+        {
+            return reps;
+        }
+    }
+}
+
+/// Nanoseconds per call of f over reps calls.
+template <typename F> double time_ns(F f, size_t reps)
+{
+    using clock = std::chrono::steady_clock;
+    volatile size_t sink = 0;
+    const clock::time_point start = clock::now();
+    for (size_t i = 0; i < reps; ++i)
+    {
+        sink = sink + f();
+    }
+    return std::chrono::duration<double, std::nano>(clock::now() - start).count() / reps;
+}
+
+/// Time of f relative to g: the median over eleven back to back runs of both, so a change in machine speed during
+/// the measurement hits both sides of a ratio alike.
+template <typename F, typename G> double time_ratio(F f, G g)
+{
+    const size_t f_reps = calibrate_reps(f);
+    const size_t g_reps = calibrate_reps(g);
+    std::vector<double> ratios;
+    for (int trial = 0; trial < 11; ++trial)
+    {
+        const double f_ns = time_ns(f, f_reps);
+        ratios.push_back(f_ns / time_ns(g, g_reps));
+    }
+    std::nth_element(ratios.begin(), ratios.begin() + ratios.size() / 2, ratios.end());
+    return ratios[ratios.size() / 2];
+}
+
+} // namespace
+
+TEST(SV_Perf, SV_Regression)
+{
+    // Opt-in: LAMBDA_PERF_RECORD=<file> writes the time of every kernel relative to the standard library, and
+    // LAMBDA_PERF_BASELINE=<file> fails when a ratio grew by more than LAMBDA_PERF_THRESHOLD (default 0.25) over the
+    // recorded one. Ratios, measured in the same run, keep a baseline usable across machines of one kind; record and
+    // check with the same optimized build (perf_baseline.txt holds the worst ratios of ten runs of an -O2 build).
+    const char *record = std::getenv("LAMBDA_PERF_RECORD");
+    const char *baseline = std::getenv("LAMBDA_PERF_BASELINE");
+    if (record == nullptr && baseline == nullptr)
+    {
+        return;
+    }
+    const char *threshold_env = std::getenv("LAMBDA_PERF_THRESHOLD");
+    const double threshold = threshold_env != nullptr ? std::atof(threshold_env) : 0.25;
+
+    std::mt19937 rng(30);
+    std::string text(64 * 1024, ' ');
+    for (char &c : text)
+    {
+        c = static_cast<char>('a' + rng() % 26);
+    }
+    const std::string same = text;
+    const std::string run = std::string(64 * 1024, 'a') + "b";
+    const lambda::str_view h(text);
+    const lambda::str_view h_same(same);
+    const lambda::str_view h_run(run);
+    const sv_diff::reference_view<char> r(text.data(), text.size());
+    const sv_diff::reference_view<char> r_same(same.data(), same.size());
+    const sv_diff::reference_view<char> r_run(run.data(), run.size());
+
+    struct kernel
+    {
+        const char *name;
+        double ratio;
+    };
+    std::vector<kernel> kernels;
+    auto measure = [&](const char *name, double ratio) { kernels.push_back(kernel{name, ratio}); };
+    measure("find_char", time_ratio([&] { return h.find('#'); }, [&] { return r.find('#'); }));
+    measure("find", time_ratio([&] { return h.find("needle#"); }, [&] { return r.find("needle#"); }));
+    measure("rfind", time_ratio([&] { return h.rfind("needle#"); }, [&] { return r.rfind("needle#"); }));
+    measure("find_first_of",
+            time_ratio([&] { return h.find_first_of("#$%"); }, [&] { return r.find_first_of("#$%"); }));
+    measure("find_first_not_of", time_ratio([&] { return h_run.find_first_not_of('a'); },
+                                            [&] { return r_run.find_first_not_of('a'); }));
+    measure("compare", time_ratio([&] { return static_cast<size_t>(h.compare(h_same) + 1); },
+                                  [&] { return static_cast<size_t>(r.compare(r_same) + 1); }));
+    measure("equals", time_ratio([&] { return static_cast<size_t>(h == h_same); },
+                                 [&] { return static_cast<size_t>(r == r_same); }));
+
+    if (record != nullptr)
+    {
+        std::ofstream out(record);
+        for (const kernel &k : kernels)
+        {
+            out << k.name << ' ' << k.ratio << '\n';
+        }
+        ASSERT_TRUE(out.good()) << record;
+    }
+    if (baseline != nullptr)
+    {
+        std::ifstream in(baseline);
+        ASSERT_TRUE(in.good()) << baseline;
+        std::map<std::string, double> recorded;
+        std::string name;
+        for (double ratio; in >> name >> ratio;)
+        {
+            recorded[name] = ratio;
+        }
+        for (const kernel &k : kernels)
+        {
+            const auto it = recorded.find(k.name);
+            ASSERT_NE(it, recorded.end()) << k.name << " is missing from " << baseline;
+            EXPECT_LE(k.ratio, it->second * (1 + threshold))
+                << k.name << " takes " << k.ratio << "x the standard library, baseline " << it->second << "x";
+        }
+    }
+}
+
+TEST(SV_Instrument, SV_Stats)
+{
+    namespace in = lambda::instrument;
+
+    static_assert(in::size_bucket(0) == 0 && in::size_bucket(1) == 1 && in::size_bucket(2) == 2, "");
+    static_assert(in::size_bucket(100) == 7 && in::size_bucket(~size_t(0)) == in::size_buckets - 1, "");
+
+    // Only the outermost operation is counted; a throw unwinds the nesting.
+    in::reset();
+    const in::probe outer = in::enter(in::op::find, 100, 3);
+    const in::probe inner = in::enter(in::op::equals, 3, 3);
+    EXPECT_TRUE(outer.outer);
+    EXPECT_FALSE(inner.outer);
+    in::leave(inner);
+    in::leave(outer);
+    in::enter(in::op::at, 5, 9);
+    in::on_throw();
+    in::leave(in::enter(in::op::find, 1, 0));
+
+    const in::snapshot local = in::thread_snapshot();
+    EXPECT_EQ(local[in::op::find].calls, 2u);
+    EXPECT_EQ(local[in::op::find].units, 101u);
+    EXPECT_EQ(local[in::op::find].sizes[in::size_bucket(100)], 1u);
+    EXPECT_EQ(local[in::op::find].arguments[in::size_bucket(3)], 1u);
+    EXPECT_EQ(local[in::op::find].arguments[0], 1u);
+    EXPECT_EQ(local[in::op::equals].calls, 0u);
+    EXPECT_EQ(local[in::op::at].calls, 1u);
+    EXPECT_EQ(local[in::op::at].throws, 1u);
+
+    // Counters of exited threads stay in the global view.
+    std::thread worker([] {
+        for (int i = 0; i < 4; ++i)
+        {
+            in::leave(in::enter(in::op::rfind, 10, 1));
+        }
+    });
+    worker.join();
+    EXPECT_GE(in::global_snapshot()[in::op::rfind].calls, 4u);
+    EXPECT_GE(in::global_snapshot()[in::op::find].calls, 2u);
+    EXPECT_EQ(in::thread_snapshot()[in::op::rfind].calls, 0u);
+
+    std::ostringstream csv;
+    local.write_csv(csv);
+    const std::string text = csv.str();
+    EXPECT_EQ(text.compare(0, 30, "op,calls,throws,cycles,units,s"), 0);
+    EXPECT_NE(text.find("\nfind,2,0,"), std::string::npos);
+    EXPECT_NE(text.find("\nat,1,1,"), std::string::npos);
+    EXPECT_EQ(text.find("\nequals,"), std::string::npos);
+
+    in::reset();
+    EXPECT_EQ(in::thread_snapshot()[in::op::find].calls, 0u);
+
+#if LAMBDA_INSTRUMENT
+    // The hooks stay out of constant evaluation and attribute nested calls to the caller.
+    constexpr lambda::str_view text_view("key=value; key2=value2");
+    static_assert(text_view.find("key2") == 11 && text_view.substr(4, 5).equals("value"), "");
+    const lambda::str_view v(text_view);
+    EXPECT_EQ(v.find_first_of("="), 3u);
+    EXPECT_EQ(v.find("value2"), 16u);
+    EXPECT_THROW(v.at(100), std::out_of_range);
+    EXPECT_EQ(v.at(0), 'k');
+
+    const in::snapshot ops = in::thread_snapshot();
+    EXPECT_EQ(ops[in::op::find_first_of].calls, 1u);
+    EXPECT_EQ(ops[in::op::find].calls, 1u);
+    EXPECT_EQ(ops[in::op::find].arguments[in::size_bucket(6)], 1u);
+    EXPECT_EQ(ops[in::op::at].calls, 2u);
+    EXPECT_EQ(ops[in::op::at].throws, 1u);
+#endif
+}